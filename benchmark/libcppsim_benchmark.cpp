@@ -1,6 +1,9 @@
 
 #include <algorithm>
+#include <cppsim/cache_blocked_executor.hpp>
 #include <cppsim/circuit.hpp>
+#include <cppsim/circuit_optimizer.hpp>
+#include <cppsim/gate_cost_model.hpp>
 #include <cppsim/gate_matrix.hpp>
 #include <cppsim/state.hpp>
 #include <cppsim/type.hpp>
@@ -135,6 +138,132 @@ int main() {
             std::cout << qubit_count << " " << k << " " << elapsed << std::endl;
         }
     }
+
+    // layers of gates on the lower qubits, separated by a CNOT on the top
+    CacheBlockedExecutor executor;
+    for (UINT qubit_count = min_qubit_count; qubit_count < max_qubit_count;
+         ++qubit_count) {
+        const UINT low_qubit_count =
+            std::min(qubit_count - 1, executor.get_block_qubit_count());
+        QuantumCircuit circuit(qubit_count);
+        for (UINT depth = 0; depth < 10; ++depth) {
+            for (UINT i = 0; i < low_qubit_count; ++i) {
+                circuit.add_RX_gate(i, 0.1 * depth);
+                circuit.add_RZ_gate(i, 0.2 * depth);
+                if (i + 1 < low_qubit_count) circuit.add_CNOT_gate(i, i + 1);
+            }
+            circuit.add_CNOT_gate(0, qubit_count - 1);
+        }
+        QuantumState state(qubit_count);
+        Timer timer;
+        timer.reset();
+        circuit.update_quantum_state(&state);
+        const double elapsed = timer.elapsed();
+        executor.update_quantum_state(&circuit, &state);
+        const auto& report = executor.get_last_report();
+        std::cout << "blocked " << qubit_count << " " << elapsed << " "
+                  << report.elapsed_time << " "
+                  << report.get_bandwidth() * 1e-9 << " GB/s "
+                  << report.transferred_bytes /
+                         report.unblocked_transferred_bytes
+                  << std::endl;
+    }
+
+    // optimize time of random circuits, which grows linearly with the gates
+    const UINT optimize_qubit_count = 12;
+    for (UINT gate_count = 1000; gate_count <= 256000; gate_count *= 4) {
+        Random random;
+        random.set_seed(0);
+        QuantumCircuit circuit(optimize_qubit_count);
+        for (UINT i = 0; i < gate_count; ++i) {
+            const UINT target = random.int32() % optimize_qubit_count;
+            const UINT control = (target + 1 + random.int32() %
+                                                   (optimize_qubit_count - 1)) %
+                                 optimize_qubit_count;
+            switch (random.int32() % 4) {
+                case 0:
+                    circuit.add_RX_gate(target, 0.1 * i);
+                    break;
+                case 1:
+                    circuit.add_RZ_gate(target, 0.1 * i);
+                    break;
+                case 2:
+                    circuit.add_CNOT_gate(control, target);
+                    break;
+                default:
+                    circuit.add_CZ_gate(control, target);
+                    break;
+            }
+        }
+        for (UINT block_size = 1; block_size <= 3; ++block_size) {
+            QuantumCircuit* optimized_circuit = circuit.copy();
+            QuantumCircuitOptimizer optimizer;
+            Timer timer;
+            timer.reset();
+            optimizer.optimize(optimized_circuit, block_size);
+            std::cout << "optimize " << gate_count << " " << block_size << " "
+                      << optimized_circuit->gate_list.size() << " "
+                      << timer.elapsed() << std::endl;
+            delete optimized_circuit;
+        }
+    }
+
+    // predicted and measured time of circuits fused with a fixed block size
+    // and with the cost model
+    for (UINT qubit_count = 16; qubit_count <= 22; qubit_count += 3) {
+        Random random;
+        random.set_seed(0);
+        QuantumCircuit circuit(qubit_count);
+        for (UINT i = 0; i < 200; ++i) {
+            const UINT target = random.int32() % qubit_count;
+            const UINT control =
+                (target + 1 + random.int32() % (qubit_count - 1)) % qubit_count;
+            switch (random.int32() % 5) {
+                case 0:
+                    circuit.add_RX_gate(target, 0.1 * i);
+                    break;
+                case 1:
+                    circuit.add_RZ_gate(target, 0.1 * i);
+                    break;
+                case 2:
+                    circuit.add_H_gate(target);
+                    break;
+                case 3:
+                    circuit.add_CNOT_gate(control, target);
+                    break;
+                default:
+                    circuit.add_CZ_gate(control, target);
+                    break;
+            }
+        }
+        GateCostModel cost_model(qubit_count);
+        QuantumState state(qubit_count);
+        auto report = [&](const std::string& name,
+                          QuantumCircuit* optimized_circuit) {
+            double predicted_time = 0.;
+            for (const QuantumGateBase* gate : optimized_circuit->gate_list) {
+                predicted_time += cost_model.get_gate_time(gate);
+            }
+            Timer timer;
+            timer.reset();
+            optimized_circuit->update_quantum_state(&state);
+            std::cout << "cost_model " << qubit_count << " " << name << " "
+                      << optimized_circuit->gate_list.size() << " "
+                      << predicted_time << " " << timer.elapsed() << std::endl;
+        };
+        QuantumCircuitOptimizer optimizer;
+        report("none", &circuit);
+        for (UINT block_size = 1; block_size <= 3; ++block_size) {
+            QuantumCircuit* optimized_circuit = circuit.copy();
+            optimizer.optimize(optimized_circuit, block_size);
+            report("block" + std::to_string(block_size), optimized_circuit);
+            delete optimized_circuit;
+        }
+        QuantumCircuit* optimized_circuit = circuit.copy();
+        optimizer.optimize_with_cost_model(optimized_circuit, cost_model);
+        report("model", optimized_circuit);
+        delete optimized_circuit;
+    }
     fout.close();
     return 0;
 }
@@ -2,6 +2,7 @@
 #include <chrono>
 #include <csim/init_ops.hpp>
 #include <csim/memory_ops.hpp>
+#include <csim/simd_dispatch.hpp>
 #include <csim/stat_ops.hpp>
 #include <csim/update_ops.hpp>
 #include <csim/update_ops_cpp.hpp>
@@ -410,6 +411,21 @@ void show(std::string name, UINT qubit_count, double elapsed_time,
     // fout << name << " " << qubit_count << " " << elapsed << std::endl;
 }
 
+// run the same benchmark with each SIMD variant which this CPU supports
+void show_simd_variants(std::string name, UINT qubit_count,
+    std::function<double()> benchmark, std::string filename) {
+    SIMDutil& simdutil = SIMDutil::get_inst();
+    const SIMDVariant initial = simdutil.get_variant();
+    const SIMDVariant variants[3] = {
+        SIMD_VARIANT_AVX2, SIMD_VARIANT_AVX512, SIMD_VARIANT_SVE};
+    for (SIMDVariant variant : variants) {
+        if (!simdutil.set_variant(variant)) continue;
+        show(name + " [" + SIMDutil::get_variant_name(variant) + "]",
+            qubit_count, benchmark(), filename);
+    }
+    simdutil.set_variant(initial);
+}
+
 int main() {
     const UINT min_qubit_count = 5;
     const UINT max_qubit_count = 25;
@@ -477,6 +493,27 @@ int main() {
         // benchmark_gate_dense_two(qubit_count, 2,3), fname);
         show("gate two_eigen_2,3", qubit_count,
             benchmark_gate_dense_two_eigen(qubit_count, 2, 3), fname);
+
+        show_simd_variants(
+            "gate single_3", qubit_count,
+            [&]() { return benchmark_gate_dense_single(qubit_count, 3); },
+            fname);
+        show_simd_variants(
+            "gate two_2,3", qubit_count,
+            [&]() { return benchmark_gate_dense_two(qubit_count, 2, 3); },
+            fname);
+        show_simd_variants(
+            "gate three_2,3,4", qubit_count,
+            [&]() { return benchmark_gate_dense_three(qubit_count, 2, 3, 4); },
+            fname);
+        show_simd_variants(
+            "gate diag_3", qubit_count,
+            [&]() { return benchmark_gate_diag_single(qubit_count, 3); },
+            fname);
+        show_simd_variants(
+            "gate phase_3", qubit_count,
+            [&]() { return benchmark_gate_phase_single(qubit_count, 3); },
+            fname);
         // show("gate three_1,2,3", qubit_count,
         // benchmark_gate_dense_three(qubit_count, 1,2,3), fname);
 
@@ -1,5 +1,7 @@
 INCLUDE(CheckCSourceRuns)
 INCLUDE(CheckCXXSourceRuns)
+INCLUDE(CheckCSourceCompiles)
+INCLUDE(CheckCXXSourceCompiles)
 
 SET(AVX2_CODE "
 #include <immintrin.h>
@@ -30,12 +32,14 @@ MACRO(CHECK_AVX2_WINDOWS)
   MARK_AS_ADVANCED(AVX2_FOUND)
 ENDMACRO()
 
+# AVX2 kernels are selected at runtime, so only check that the compiler can
+# generate them. The build host itself does not need to support AVX2.
 MACRO(CHECK_AVX2_LINUX)
   SET(CMAKE_REQUIRED_FLAGS_SAVE ${CMAKE_REQUIRED_FLAGS})
 
   SET(CMAKE_REQUIRED_FLAGS "-mavx2")
-  CHECK_C_SOURCE_RUNS("${AVX2_CODE}" C_HAS_AVX2)
-  CHECK_CXX_SOURCE_RUNS("${AVX2_CODE}" CXX_HAS_AVX2)
+  CHECK_C_SOURCE_COMPILES("${AVX2_CODE}" C_HAS_AVX2)
+  CHECK_CXX_SOURCE_COMPILES("${AVX2_CODE}" CXX_HAS_AVX2)
   #message(STATUS "C_HAS_AVX2 = ${C_HAS_AVX2}")
   #message(STATUS "CXX_HAS_AVX2 = ${CXX_HAS_AVX2}")
   IF(C_HAS_AVX2 MATCHES 1 AND CXX_HAS_AVX2 MATCHES 1)
@@ -11,6 +11,8 @@ import scipy.sparse
 from . import circuit, gate, observable, quantum_operator, state
 
 __all__ = [
+    "CacheBlockedExecutionReport",
+    "CacheBlockedExecutor",
     "CausalConeSimulator",
     "ClsNoisyEvolution",
     "ClsNoisyEvolution_fast",
@@ -24,6 +26,7 @@ __all__ = [
     "ClsStateReflectionGate",
     "ClsTwoQubitGate",
     "DensityMatrix",
+    "DensityMatrixPacked",
     "GeneralQuantumOperator",
     "GradCalculator",
     "NoiseSimulator",
@@ -43,17 +46,77 @@ __all__ = [
     "QuantumGate_SingleParameter",
     "QuantumState",
     "QuantumStateBase",
+    "QuantumStateBatch",
+    "QuantumStateFloat",
+    "SimulationHistogramResult",
     "SimulationResult",
     "StateVector",
     "check_build_for_mpi",
     "circuit",
     "gate",
+    "get_simd_variant",
     "observable",
     "quantum_operator",
     "state",
     "to_general_quantum_operator",
 ]
 
+class CacheBlockedExecutionReport:
+    def get_bandwidth(self) -> float:
+        """
+        Get estimated bytes per second
+        """
+    @property
+    def blocked_gate_count(self) -> int:
+        """
+        Number of gates applied inside segments
+        """
+    @property
+    def elapsed_time(self) -> float:
+        """
+        Elapsed time in seconds
+        """
+    @property
+    def segment_count(self) -> int:
+        """
+        Number of segments applied chunk by chunk
+        """
+    @property
+    def transferred_bytes(self) -> float:
+        """
+        Estimated bytes read and written on the state
+        """
+    @property
+    def unblocked_gate_count(self) -> int:
+        """
+        Number of gates applied with a full pass
+        """
+    @property
+    def unblocked_transferred_bytes(self) -> float:
+        """
+        Estimated bytes when every gate makes a full pass
+        """
+
+class CacheBlockedExecutor:
+    def __init__(self, block_qubit_count: int = 0) -> None:
+        """
+        Constructor
+        """
+    def get_block_qubit_count(self) -> int:
+        """
+        Get qubit count of a chunk
+        """
+    def get_last_report(self) -> CacheBlockedExecutionReport:
+        """
+        Get report of the last update
+        """
+    def update_quantum_state(
+        self, circuit: QuantumCircuit, state: QuantumStateBase
+    ) -> None:
+        """
+        Update quantum state with cache blocking
+        """
+
 class CausalConeSimulator:
     def __init__(self, arg0: ParametricQuantumCircuit, arg1: Observable) -> None:
         """
@@ -168,6 +231,11 @@ class DensityMatrix(QuantumStateBase):
         """
         Get probability with which we obtain 0 when we measure a qubit
         """
+    @staticmethod
+    def is_vectorized_execution() -> bool:
+        """
+        Get whether density matrix updates run with state vector kernels on vec(rho)
+        """
     @typing.overload
     def load(self, state: QuantumStateBase) -> None:
         """
@@ -219,6 +287,11 @@ class DensityMatrix(QuantumStateBase):
         """
         Set state to computational basis
         """
+    @staticmethod
+    def set_vectorized_execution(enabled: bool) -> None:
+        """
+        Run density matrix updates with state vector kernels on vec(rho) for all density matrices in the process
+        """
     def set_zero_state(self) -> None:
         """
         Set state to |0>
@@ -232,6 +305,88 @@ class DensityMatrix(QuantumStateBase):
         to string
         """
 
+class DensityMatrixPacked:
+    def __init__(self, qubit_count: int) -> None:
+        """
+        Constructor
+        """
+    def copy(self) -> DensityMatrixPacked:
+        """
+        Create copied instance
+        """
+    def get_entropy(self) -> float:
+        """
+        Get entropy
+        """
+    def get_expectation_value(self, observable: GeneralQuantumOperator) -> complex:
+        """
+        Get expectation value
+        """
+    def get_marginal_probability(self, measured_values: list[int]) -> float:
+        """
+        Get merginal probability for measured values
+        """
+    def get_matrix(self) -> numpy.ndarray:
+        """
+        Get density matrix
+        """
+    def get_qubit_count(self) -> int:
+        """
+        Get qubit count
+        """
+    def get_squared_norm(self) -> float:
+        """
+        Get squared norm
+        """
+    def get_zero_probability(self, index: int) -> float:
+        """
+        Get probability with which we obtain 0 when we measure a qubit
+        """
+    def load(self, state: QuantumStateBase) -> None:
+        """
+        Load quantum state
+        """
+    def normalize(self, squared_norm: float) -> None:
+        """
+        Normalize quantum state
+        """
+    @typing.overload
+    def sampling(self, sampling_count: int) -> list[int]:
+        """
+        Sampling measurement results
+        """
+    @typing.overload
+    def sampling(self, sampling_count: int, random_seed: int) -> list[int]:
+        """
+        Sampling measurement results
+        """
+    def set_Haar_random_state(self, seed: int) -> None:
+        """
+        Set Haar random state
+        """
+    def set_computational_basis(self, comp_basis: int) -> None:
+        """
+        Set state to computational basis
+        """
+    def set_zero_state(self) -> None:
+        """
+        Set state to |0>
+        """
+    def to_density_matrix(self) -> DensityMatrix:
+        """
+        Create DensityMatrix with the same state
+        """
+    @typing.overload
+    def update_quantum_state(self, gate: QuantumGateBase) -> None:
+        """
+        Apply gate
+        """
+    @typing.overload
+    def update_quantum_state(self, circuit: QuantumCircuit) -> None:
+        """
+        Apply circuit
+        """
+
 class GeneralQuantumOperator:
     def __IADD__(self, arg0: PauliOperator) -> GeneralQuantumOperator: ...
     @typing.overload
@@ -303,6 +458,10 @@ class GeneralQuantumOperator:
         """
         Create copied instance of General Quantum operator class
         """
+    def get_diagonal(self) -> list[complex]:
+        """
+        Get diagonal elements of a diagonal operator
+        """
     def get_expectation_value(self, state: QuantumStateBase) -> complex:
         """
         Get expectation value
@@ -337,6 +496,10 @@ class GeneralQuantumOperator:
         """
         Get transition amplitude
         """
+    def is_diagonal(self) -> bool:
+        """
+        Get whether all terms consist of I and Z
+        """
     def is_hermitian(self) -> bool:
         """
         Get is Herimitian
@@ -375,10 +538,24 @@ class NoiseSimulator:
         """
         Sampling & Return result [array]
         """
+    def execute_and_get_histogram(
+        self, sample_count: int, observable: Observable | None = None
+    ) -> SimulationHistogramResult:
+        """
+        Sampling & Return histogram [dict of (basis, count)] and expectation values
+        """
     def execute_and_get_result(self, arg0: int) -> SimulationResult:
         """
         Simulate & Return ressult [array of (state, frequency)]
         """
+    def set_checkpoint_memory_budget(self, byte_count: int) -> None:
+        """
+        Set memory budget of checkpoint states in bytes
+        """
+    def set_seed(self, seed: int) -> None:
+        """
+        Set random seed
+        """
 
 class Observable(GeneralQuantumOperator):
     def __init__(self, qubit_count: int) -> None:
@@ -939,6 +1116,10 @@ class QuantumCircuit:
         """
         Calculate depth of circuit
         """
+    def compile(self) -> None:
+        """
+        Compile circuit into a flat instruction stream used by update_quantum_state until the circuit is edited
+        """
     def copy(self) -> QuantumCircuit:
         """
         Create copied instance
@@ -959,6 +1140,10 @@ class QuantumCircuit:
         """
         Get qubit count
         """
+    def is_compiled(self) -> bool:
+        """
+        Get whether the circuit is compiled
+        """
     def merge_circuit(self, circuit: QuantumCircuit) -> None: ...
     def remove_gate(self, position: int) -> None:
         """
@@ -1317,6 +1502,210 @@ class QuantumState(QuantumStateBase):
 class QuantumStateBase:
     pass
 
+class QuantumStateBatch:
+    def __init__(self, qubit_count: int, batch_size: int) -> None:
+        """
+        Constructor
+        """
+    def apply_RX_gate(self, index: int, angle_list: list[float]) -> None:
+        """
+        Apply X rotation with an angle for each element
+        """
+    def apply_RY_gate(self, index: int, angle_list: list[float]) -> None:
+        """
+        Apply Y rotation with an angle for each element
+        """
+    def apply_RZ_gate(self, index: int, angle_list: list[float]) -> None:
+        """
+        Apply Z rotation with an angle for each element
+        """
+    def apply_multi_Pauli_rotation_gate(
+        self, index_list: list[int], pauli_ids: list[int], angle_list: list[float]
+    ) -> None:
+        """
+        Apply Pauli rotation with an angle for each element
+        """
+    def get_batch_size(self) -> int:
+        """
+        Get batch size
+        """
+    def get_expectation_value(
+        self, observable: GeneralQuantumOperator
+    ) -> list[complex]:
+        """
+        Get expectation value of each element
+        """
+    def get_qubit_count(self) -> int:
+        """
+        Get qubit count
+        """
+    def get_squared_norm(self) -> list[float]:
+        """
+        Get squared norm of each element
+        """
+    def get_vector(self, element: int) -> list[complex]:
+        """
+        Get state vector of an element
+        """
+    @typing.overload
+    def load(self, element: int, state: QuantumStateBase) -> None:
+        """
+        Load quantum state to an element
+        """
+    @typing.overload
+    def load(self, state: QuantumStateBase) -> None:
+        """
+        Load quantum state to all elements
+        """
+    def normalize(self, squared_norm_list: list[float]) -> None:
+        """
+        Normalize each element
+        """
+    @typing.overload
+    def sampling(self, sampling_count: int) -> list[list[int]]:
+        """
+        Sampling measurement results of each element
+        """
+    @typing.overload
+    def sampling(self, sampling_count: int, random_seed: int) -> list[list[int]]:
+        """
+        Sampling measurement results of each element
+        """
+    def set_Haar_random_state(self, seed: int) -> None:
+        """
+        Set Haar random states
+        """
+    def set_computational_basis(self, comp_basis: int) -> None:
+        """
+        Set all states to computational basis
+        """
+    def set_zero_state(self) -> None:
+        """
+        Set all states to |0>
+        """
+    @typing.overload
+    def update_quantum_state(self, gate: QuantumGateBase) -> None:
+        """
+        Apply gate to all elements
+        """
+    @typing.overload
+    def update_quantum_state(self, circuit: QuantumCircuit) -> None:
+        """
+        Apply circuit to all elements
+        """
+
+class QuantumStateFloat(QuantumStateBase):
+    def __init__(self, qubit_count: int) -> None:
+        """
+        Constructor
+        """
+    def __str__(self) -> str:
+        """
+        to string
+        """
+    def copy(self) -> QuantumStateFloat:
+        """
+        Create copied instance
+        """
+    def get_classical_value(self, index: int) -> int:
+        """
+        Get classical value
+        """
+    def get_device_name(self) -> str:
+        """
+        Get allocated device name
+        """
+    def get_entropy(self) -> float:
+        """
+        Get entropy
+        """
+    def get_marginal_probability(self, measured_values: list[int]) -> float:
+        """
+        Get merginal probability for measured values
+        """
+    def get_qubit_count(self) -> int:
+        """
+        Get qubit count
+        """
+    def get_squared_norm(self) -> float:
+        """
+        Get squared norm
+        """
+    def get_vector(self) -> numpy.ndarray:
+        """
+        Get state vector converted to double precision
+        """
+    def get_zero_probability(self, index: int) -> float:
+        """
+        Get probability with which we obtain 0 when we measure a qubit
+        """
+    @typing.overload
+    def load(self, state: QuantumStateBase) -> None:
+        """
+        Load quantum state vector
+        """
+    @typing.overload
+    def load(self, state: list[complex]) -> None:
+        """
+        Load quantum state vector
+        """
+    def normalize(self, squared_norm: float) -> None:
+        """
+        Normalize quantum state
+        """
+    @typing.overload
+    def sampling(self, sampling_count: int) -> list[int]:
+        """
+        Sampling measurement results
+        """
+    @typing.overload
+    def sampling(self, sampling_count: int, random_seed: int) -> list[int]:
+        """
+        Sampling measurement results
+        """
+    @typing.overload
+    def set_Haar_random_state(self) -> None:
+        """
+        Set Haar random state
+        """
+    @typing.overload
+    def set_Haar_random_state(self, seed: int) -> None:
+        """
+        Set Haar random state
+        """
+    def set_classical_value(self, index: int, value: int) -> None:
+        """
+        Set classical value
+        """
+    def set_computational_basis(self, comp_basis: int) -> None:
+        """
+        Set state to computational basis
+        """
+    def set_zero_state(self) -> None:
+        """
+        Set state to |0>
+        """
+    def to_json(self) -> str:
+        """
+        to json string
+        """
+
+class SimulationHistogramResult:
+    def get_expectation_value(self) -> complex:
+        """
+        Get expectation value weighted by frequency
+        """
+    @property
+    def expectation_value_list(self) -> list[tuple[complex, int]]:
+        """
+        Expectation value and frequency of each final state
+        """
+    @property
+    def histogram(self) -> dict[int, int]:
+        """
+        Measured basis and its count
+        """
+
 class SimulationResult:
     def get_count(self) -> int:
         """
@@ -1337,6 +1726,10 @@ def StateVector(arg0: int) -> QuantumState:
     """
 
 def check_build_for_mpi() -> bool: ...
+def get_simd_variant() -> str:
+    """
+    Get the name of the SIMD kernel variant in use
+    """
 def to_general_quantum_operator(
     gate: QuantumGateBase, qubits: int, tol: float
 ) -> GeneralQuantumOperator: ...
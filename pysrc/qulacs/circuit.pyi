@@ -2,7 +2,45 @@ from __future__ import annotations
 
 import qulacs_core
 
-__all__ = ["QuantumCircuitOptimizer", "from_json"]
+__all__ = ["GateCostModel", "QuantumCircuitOptimizer", "from_json"]
+
+class GateCostModel:
+    class KernelType:
+        CONTROLLED_KERNEL: GateCostModel.KernelType
+        DENSE_KERNEL: GateCostModel.KernelType
+        DIAGONAL_KERNEL: GateCostModel.KernelType
+        NAMED_KERNEL: GateCostModel.KernelType
+
+    def __init__(
+        self, qubit_count: int, max_target_count: int = 5, calibrate: bool = True
+    ) -> None:
+        """
+        Constructor. Measure kernel times unless calibrate is False. Kernels are measured on at most 20 qubits and scaled linearly, so the ratios between kernels on larger states are frozen at 20 qubits. Controlled kernels are measured with one control
+        """
+    def get_gate_time(self, gate: qulacs_core.QuantumGateBase) -> float:
+        """
+        Get predicted gate time in seconds, or negative value if the gate is not in the model
+        """
+    def get_kernel_time(
+        self, type: GateCostModel.KernelType, target_count: int
+    ) -> float:
+        """
+        Get kernel time in seconds
+        """
+    def get_max_target_count(self) -> int:
+        """
+        Get max target count of kernels
+        """
+    def get_qubit_count(self) -> int:
+        """
+        Get qubit count
+        """
+    def set_kernel_time(
+        self, type: GateCostModel.KernelType, target_count: int, time: float
+    ) -> None:
+        """
+        Set kernel time in seconds
+        """
 
 class QuantumCircuitOptimizer:
     def __init__(self, mpi_size: int = 0) -> None:
@@ -18,12 +56,44 @@ class QuantumCircuitOptimizer:
         """
         Optimize quantum circuit
         """
+    def optimize_channel(
+        self, circuit: qulacs_core.QuantumCircuit, block_size: int = 2
+    ) -> None:
+        """
+        Fuse gates and noise channels for density matrix simulation
+        """
+    def optimize_for_measurement(
+        self, circuit: qulacs_core.QuantumCircuit, measured_qubit_list: list[int]
+    ) -> None:
+        """
+        Remove gates which do not affect measured qubits
+        """
+    def optimize_for_observable(
+        self,
+        circuit: qulacs_core.QuantumCircuit,
+        observable: qulacs_core.Observable,
+    ) -> None:
+        """
+        Remove gates which do not affect expectation value of observable
+        """
     def optimize_light(
         self, circuit: qulacs_core.QuantumCircuit, swap_level: int = 0
     ) -> None:
         """
         Optimize quantum circuit with light method
         """
+    def optimize_peephole(
+        self, circuit: qulacs_core.QuantumCircuit, block_size: int = 3
+    ) -> None:
+        """
+        Cancel and merge gates while keeping named gates
+        """
+    def optimize_with_cost_model(
+        self, circuit: qulacs_core.QuantumCircuit, cost_model: GateCostModel
+    ) -> None:
+        """
+        Fuse gates to minimize time predicted by cost model
+        """
 
 def from_json(arg0: str) -> qulacs_core.QuantumCircuit:
     """
@@ -70,6 +70,14 @@ def partial_trace(
     Take partial trace
     """
 
+@typing.overload
+def partial_trace(
+    state: qulacs_core.DensityMatrixPacked, target_traceout: list[int]
+) -> qulacs_core.DensityMatrixPacked:
+    """
+    Take partial trace
+    """
+
 @typing.overload
 def permutate_qubit(
     state: qulacs_core.QuantumState, qubit_order: list[int]
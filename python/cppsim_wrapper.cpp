@@ -6,8 +6,10 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <cppsim/cache_blocked_executor.hpp>
 #include <cppsim/circuit.hpp>
 #include <cppsim/circuit_optimizer.hpp>
+#include <cppsim/gate_cost_model.hpp>
 #include <cppsim/gate_factory.hpp>
 #include <cppsim/gate_matrix.hpp>
 #include <cppsim/gate_matrix_diagonal.hpp>
@@ -21,8 +23,12 @@
 #include <cppsim/simulator.hpp>
 #include <cppsim/state.hpp>
 #include <cppsim/state_dm.hpp>
+#include <cppsim/state_dm_packed.hpp>
+#include <cppsim/state_batch.hpp>
+#include <cppsim/state_float.hpp>
 #include <cppsim/utility.hpp>
 #include <csim/memory_ops.hpp>
+#include <csim/simd_dispatch.hpp>
 #include <csim/stat_ops.hpp>
 #include <csim/update_ops.hpp>
 #include <vqcsim/causalcone_simulator.hpp>
@@ -152,6 +158,10 @@ PYBIND11_MODULE(qulacs_core, m) {
             &GeneralQuantumOperator::get_transition_amplitude,
             "Get transition amplitude", py::arg("state_bra"),
             py::arg("state_ket"))
+        .def("is_diagonal", &GeneralQuantumOperator::is_diagonal,
+            "Get whether all terms consist of I and Z")
+        .def("get_diagonal", &GeneralQuantumOperator::get_diagonal,
+            "Get diagonal elements of a diagonal operator")
         .def("__str__", &GeneralQuantumOperator::to_string, "to string")
         .def("copy", &GeneralQuantumOperator::copy,
             py::return_value_policy::take_ownership,
@@ -447,6 +457,153 @@ PYBIND11_MODULE(qulacs_core, m) {
         },
         py::return_value_policy::take_ownership, "StateVector");
 
+    py::class_<QuantumStateFloat, QuantumStateBase>(m, "QuantumStateFloat")
+        .def(py::init<UINT>(), "Constructor", py::arg("qubit_count"))
+        .def("set_zero_state", &QuantumStateFloat::set_zero_state,
+            "Set state to |0>")
+        .def("set_computational_basis",
+            &QuantumStateFloat::set_computational_basis,
+            "Set state to computational basis", py::arg("comp_basis"))
+        .def("set_Haar_random_state",
+            py::overload_cast<>(&QuantumStateFloat::set_Haar_random_state),
+            "Set Haar random state")
+        .def("set_Haar_random_state",
+            py::overload_cast<UINT>(&QuantumStateFloat::set_Haar_random_state),
+            "Set Haar random state", py::arg("seed"))
+        .def("get_zero_probability", &QuantumStateFloat::get_zero_probability,
+            "Get probability with which we obtain 0 when we measure a qubit",
+            py::arg("index"))
+        .def("get_marginal_probability",
+            &QuantumStateFloat::get_marginal_probability,
+            "Get merginal probability for measured values",
+            py::arg("measured_values"))
+        .def("get_entropy", &QuantumStateFloat::get_entropy, "Get entropy")
+        .def("get_squared_norm", &QuantumStateFloat::get_squared_norm,
+            "Get squared norm")
+        .def("normalize", &QuantumStateFloat::normalize,
+            "Normalize quantum state", py::arg("squared_norm"))
+        .def("copy", &QuantumStateFloat::copy,
+            py::return_value_policy::take_ownership, "Create copied instance")
+        .def("load",
+            py::overload_cast<const QuantumStateBase*>(
+                &QuantumStateFloat::load),
+            "Load quantum state vector", py::arg("state"))
+        .def("load",
+            py::overload_cast<const std::vector<CPPCTYPE>&>(
+                &QuantumStateFloat::load),
+            "Load quantum state vector", py::arg("state"))
+        .def("get_device_name", &QuantumStateFloat::get_device_name,
+            "Get allocated device name")
+        .def("get_classical_value", &QuantumStateFloat::get_classical_value,
+            "Get classical value", py::arg("index"))
+        .def("set_classical_value", &QuantumStateFloat::set_classical_value,
+            "Set classical value", py::arg("index"), py::arg("value"))
+        .def("sampling",
+            py::overload_cast<UINT>(&QuantumStateFloat::sampling),
+            "Sampling measurement results", py::arg("sampling_count"))
+        .def("sampling",
+            py::overload_cast<UINT, UINT>(&QuantumStateFloat::sampling),
+            "Sampling measurement results", py::arg("sampling_count"),
+            py::arg("random_seed"))
+        .def(
+            "get_vector",
+            [](const QuantumStateFloat& state) -> Eigen::VectorXcd {
+                CPPCTYPE* ptr = state.duplicate_data_cpp();
+                Eigen::VectorXcd vec =
+                    Eigen::Map<Eigen::VectorXcd>(ptr, state.dim);
+                free(ptr);
+                return vec;
+            },
+            "Get state vector converted to double precision")
+        .def(
+            "get_qubit_count",
+            [](const QuantumStateFloat& state) -> UINT {
+                return state.qubit_count;
+            },
+            "Get qubit count")
+        .def(
+            "__str__",
+            [](const QuantumStateFloat& p) { return p.to_string(); },
+            "to string")
+        .def(
+            "to_json",
+            [](const QuantumStateFloat& state) -> std::string {
+                return ptree::to_json(state.to_ptree());
+            },
+            "to json string");
+
+    py::class_<QuantumStateBatch>(m, "QuantumStateBatch")
+        .def(py::init<UINT, UINT>(), "Constructor", py::arg("qubit_count"),
+            py::arg("batch_size"))
+        .def("set_zero_state", &QuantumStateBatch::set_zero_state,
+            "Set all states to |0>")
+        .def("set_computational_basis",
+            &QuantumStateBatch::set_computational_basis,
+            "Set all states to computational basis", py::arg("comp_basis"))
+        .def("set_Haar_random_state",
+            &QuantumStateBatch::set_Haar_random_state,
+            "Set Haar random states", py::arg("seed"))
+        .def("load",
+            py::overload_cast<UINT, const QuantumStateBase*>(
+                &QuantumStateBatch::load),
+            "Load quantum state to an element", py::arg("element"),
+            py::arg("state"))
+        .def("load",
+            py::overload_cast<const QuantumStateBase*>(
+                &QuantumStateBatch::load),
+            "Load quantum state to all elements", py::arg("state"))
+        .def("get_vector", &QuantumStateBatch::get_vector,
+            "Get state vector of an element", py::arg("element"))
+        .def("get_squared_norm", &QuantumStateBatch::get_squared_norm,
+            "Get squared norm of each element")
+        .def("normalize", &QuantumStateBatch::normalize,
+            "Normalize each element", py::arg("squared_norm_list"))
+        .def("update_quantum_state",
+            py::overload_cast<const QuantumGateBase*>(
+                &QuantumStateBatch::update_quantum_state),
+            "Apply gate to all elements", py::arg("gate"))
+        .def("update_quantum_state",
+            py::overload_cast<const QuantumCircuit*>(
+                &QuantumStateBatch::update_quantum_state),
+            "Apply circuit to all elements", py::arg("circuit"))
+        .def("apply_RX_gate", &QuantumStateBatch::apply_RX_gate,
+            "Apply X rotation with an angle for each element",
+            py::arg("index"), py::arg("angle_list"))
+        .def("apply_RY_gate", &QuantumStateBatch::apply_RY_gate,
+            "Apply Y rotation with an angle for each element",
+            py::arg("index"), py::arg("angle_list"))
+        .def("apply_RZ_gate", &QuantumStateBatch::apply_RZ_gate,
+            "Apply Z rotation with an angle for each element",
+            py::arg("index"), py::arg("angle_list"))
+        .def("apply_multi_Pauli_rotation_gate",
+            &QuantumStateBatch::apply_multi_Pauli_rotation_gate,
+            "Apply Pauli rotation with an angle for each element",
+            py::arg("index_list"), py::arg("pauli_ids"),
+            py::arg("angle_list"))
+        .def("get_expectation_value",
+            &QuantumStateBatch::get_expectation_value,
+            "Get expectation value of each element", py::arg("observable"))
+        .def("sampling",
+            py::overload_cast<UINT>(&QuantumStateBatch::sampling),
+            "Sampling measurement results of each element",
+            py::arg("sampling_count"))
+        .def("sampling",
+            py::overload_cast<UINT, UINT>(&QuantumStateBatch::sampling),
+            "Sampling measurement results of each element",
+            py::arg("sampling_count"), py::arg("random_seed"))
+        .def(
+            "get_qubit_count",
+            [](const QuantumStateBatch& state) -> UINT {
+                return state.qubit_count;
+            },
+            "Get qubit count")
+        .def(
+            "get_batch_size",
+            [](const QuantumStateBatch& state) -> UINT {
+                return state.batch_size;
+            },
+            "Get batch size");
+
     py::class_<DensityMatrix, QuantumStateBase>(m, "DensityMatrix")
         .def(py::init<UINT>(), "Constructor", py::arg("qubit_count"))
         .def("set_zero_state", &DensityMatrix::set_zero_state,
@@ -471,6 +628,15 @@ PYBIND11_MODULE(qulacs_core, m) {
             "Get squared norm")
         .def("normalize", &DensityMatrix::normalize, "Normalize quantum state",
             py::arg("squared_norm"))
+        .def_static("set_vectorized_execution",
+            &DensityMatrix::set_vectorized_execution,
+            "Run density matrix updates with state vector kernels on vec(rho) "
+            "for all density matrices in the process",
+            py::arg("enabled"))
+        .def_static("is_vectorized_execution",
+            &DensityMatrix::is_vectorized_execution,
+            "Get whether density matrix updates run with state vector kernels "
+            "on vec(rho)")
         .def("allocate_buffer", &DensityMatrix::allocate_buffer,
             py::return_value_policy::take_ownership,
             "Allocate buffer with the same size")
@@ -542,11 +708,80 @@ PYBIND11_MODULE(qulacs_core, m) {
             }));
     ;
 
+    py::class_<DensityMatrixPacked>(m, "DensityMatrixPacked")
+        .def(py::init<UINT>(), "Constructor", py::arg("qubit_count"))
+        .def("set_zero_state", &DensityMatrixPacked::set_zero_state,
+            "Set state to |0>")
+        .def("set_computational_basis",
+            &DensityMatrixPacked::set_computational_basis,
+            "Set state to computational basis", py::arg("comp_basis"))
+        .def("set_Haar_random_state",
+            &DensityMatrixPacked::set_Haar_random_state,
+            "Set Haar random state", py::arg("seed"))
+        .def("load", &DensityMatrixPacked::load, "Load quantum state",
+            py::arg("state"))
+        .def("copy", &DensityMatrixPacked::copy,
+            py::return_value_policy::take_ownership, "Create copied instance")
+        .def("to_density_matrix", &DensityMatrixPacked::to_density_matrix,
+            py::return_value_policy::take_ownership,
+            "Create DensityMatrix with the same state")
+        .def("get_zero_probability",
+            &DensityMatrixPacked::get_zero_probability,
+            "Get probability with which we obtain 0 when we measure a qubit",
+            py::arg("index"))
+        .def("get_marginal_probability",
+            &DensityMatrixPacked::get_marginal_probability,
+            "Get merginal probability for measured values",
+            py::arg("measured_values"))
+        .def("get_entropy", &DensityMatrixPacked::get_entropy, "Get entropy")
+        .def("get_squared_norm", &DensityMatrixPacked::get_squared_norm,
+            "Get squared norm")
+        .def("normalize", &DensityMatrixPacked::normalize,
+            "Normalize quantum state", py::arg("squared_norm"))
+        .def("update_quantum_state",
+            py::overload_cast<const QuantumGateBase*>(
+                &DensityMatrixPacked::update_quantum_state),
+            "Apply gate", py::arg("gate"))
+        .def("update_quantum_state",
+            py::overload_cast<const QuantumCircuit*>(
+                &DensityMatrixPacked::update_quantum_state),
+            "Apply circuit", py::arg("circuit"))
+        .def("get_expectation_value",
+            &DensityMatrixPacked::get_expectation_value,
+            "Get expectation value", py::arg("observable"))
+        .def("sampling",
+            py::overload_cast<UINT>(&DensityMatrixPacked::sampling),
+            "Sampling measurement results", py::arg("sampling_count"))
+        .def("sampling",
+            py::overload_cast<UINT, UINT>(&DensityMatrixPacked::sampling),
+            "Sampling measurement results", py::arg("sampling_count"),
+            py::arg("random_seed"))
+        .def(
+            "get_matrix",
+            [](const DensityMatrixPacked& state) -> Eigen::MatrixXcd {
+                Eigen::MatrixXcd mat(state.dim, state.dim);
+                for (ITYPE y = 0; y < state.dim; ++y) {
+                    for (ITYPE x = 0; x < state.dim; ++x) {
+                        mat(y, x) = state.get_element(y, x);
+                    }
+                }
+                return mat;
+            },
+            "Get density matrix")
+        .def(
+            "get_qubit_count",
+            [](const DensityMatrixPacked& state) -> UINT {
+                return state.qubit_count;
+            },
+            "Get qubit count");
+
 #ifdef _USE_MPI
     m.def("check_build_for_mpi", []() { return true; });
 #else
     m.def("check_build_for_mpi", []() { return false; });
 #endif
+    m.def("get_simd_variant", &get_simd_variant_name,
+        "Get the name of the SIMD kernel variant in use");
 
 #ifdef _USE_GPU
     py::class_<QuantumStateGpu, QuantumStateBase>(m, "QuantumStateGpu")
@@ -680,6 +915,11 @@ PYBIND11_MODULE(qulacs_core, m) {
             &state::partial_trace),
         py::return_value_policy::take_ownership, "Take partial trace",
         py::arg("state"), py::arg("target_traceout"));
+    mstate.def("partial_trace",
+        py::overload_cast<const DensityMatrixPacked*, std::vector<UINT>>(
+            &state::partial_trace),
+        py::return_value_policy::take_ownership, "Take partial trace",
+        py::arg("state"), py::arg("target_traceout"));
     mstate.def("make_superposition", &state::make_superposition,
         py::return_value_policy::take_ownership,
         "Create superposition of states", py::arg("coef1"), py::arg("state1"),
@@ -1183,6 +1423,12 @@ PYBIND11_MODULE(qulacs_core, m) {
                 &QuantumCircuit::update_quantum_state),
             "Update quantum state", py::arg("state"), py::arg("start"),
             py::arg("end"), py::arg("seed"))
+        .def(
+            "compile", [](QuantumCircuit& circuit) { circuit.compile(); },
+            "Compile circuit into a flat instruction stream used by "
+            "update_quantum_state until the circuit is edited")
+        .def("is_compiled", &QuantumCircuit::is_compiled,
+            "Get whether the circuit is compiled")
         .def("calculate_depth", &QuantumCircuit::calculate_depth,
             "Calculate depth of circuit")
         .def("to_string", &QuantumCircuit::to_string,
@@ -1527,6 +1773,35 @@ Matrix Representation
         },
         "from json string", py::return_value_policy::take_ownership);
 
+    py::class_<GateCostModel> cost_model_class(mcircuit, "GateCostModel");
+    py::enum_<GateCostModel::KernelType>(cost_model_class, "KernelType")
+        .value("NAMED_KERNEL", GateCostModel::NAMED_KERNEL)
+        .value("DIAGONAL_KERNEL", GateCostModel::DIAGONAL_KERNEL)
+        .value("CONTROLLED_KERNEL", GateCostModel::CONTROLLED_KERNEL)
+        .value("DENSE_KERNEL", GateCostModel::DENSE_KERNEL);
+    cost_model_class
+        .def(py::init<UINT, UINT, bool>(),
+            "Constructor. Measure kernel times unless calibrate is False. "
+            "Kernels are measured on at most 20 qubits and scaled linearly, "
+            "so the ratios between kernels on larger states are frozen at 20 "
+            "qubits. Controlled kernels are measured with one control",
+            py::arg("qubit_count"), py::arg("max_target_count") = 5,
+            py::arg("calibrate") = true)
+        .def("get_qubit_count", &GateCostModel::get_qubit_count,
+            "Get qubit count")
+        .def("get_max_target_count", &GateCostModel::get_max_target_count,
+            "Get max target count of kernels")
+        .def("get_kernel_time", &GateCostModel::get_kernel_time,
+            "Get kernel time in seconds", py::arg("type"),
+            py::arg("target_count"))
+        .def("set_kernel_time", &GateCostModel::set_kernel_time,
+            "Set kernel time in seconds", py::arg("type"),
+            py::arg("target_count"), py::arg("time"))
+        .def("get_gate_time", &GateCostModel::get_gate_time,
+            "Get predicted gate time in seconds, or negative value if the gate "
+            "is not in the model",
+            py::arg("gate"));
+
     py::class_<QuantumCircuitOptimizer>(mcircuit, "QuantumCircuitOptimizer")
         .def(py::init<UINT>(), "Constructor", py::arg("mpi_size") = 0)
         .def("optimize", &QuantumCircuitOptimizer::optimize,
@@ -1535,6 +1810,24 @@ Matrix Representation
         .def("optimize_light", &QuantumCircuitOptimizer::optimize_light,
             "Optimize quantum circuit with light method", py::arg("circuit"),
             py::arg("swap_level") = 0)
+        .def("optimize_channel", &QuantumCircuitOptimizer::optimize_channel,
+            "Fuse gates and noise channels for density matrix simulation",
+            py::arg("circuit"), py::arg("block_size") = 2)
+        .def("optimize_for_measurement",
+            &QuantumCircuitOptimizer::optimize_for_measurement,
+            "Remove gates which do not affect measured qubits",
+            py::arg("circuit"), py::arg("measured_qubit_list"))
+        .def("optimize_for_observable",
+            &QuantumCircuitOptimizer::optimize_for_observable,
+            "Remove gates which do not affect expectation value of observable",
+            py::arg("circuit"), py::arg("observable"))
+        .def("optimize_peephole", &QuantumCircuitOptimizer::optimize_peephole,
+            "Cancel and merge gates while keeping named gates",
+            py::arg("circuit"), py::arg("block_size") = 3)
+        .def("optimize_with_cost_model",
+            &QuantumCircuitOptimizer::optimize_with_cost_model,
+            "Fuse gates to minimize time predicted by cost model",
+            py::arg("circuit"), py::arg("cost_model"))
         .def("merge_all", &QuantumCircuitOptimizer::merge_all,
             py::return_value_policy::take_ownership, py::arg("circuit"));
 
@@ -1569,6 +1862,42 @@ Matrix Representation
             &QuantumCircuitSimulator::swap_state_and_buffer,
             "Swap state and buffer");
 
+    py::class_<CacheBlockedExecutor::Report>(m, "CacheBlockedExecutionReport")
+        .def_readonly("segment_count",
+            &CacheBlockedExecutor::Report::segment_count,
+            "Number of segments applied chunk by chunk")
+        .def_readonly("blocked_gate_count",
+            &CacheBlockedExecutor::Report::blocked_gate_count,
+            "Number of gates applied inside segments")
+        .def_readonly("unblocked_gate_count",
+            &CacheBlockedExecutor::Report::unblocked_gate_count,
+            "Number of gates applied with a full pass")
+        .def_readonly("transferred_bytes",
+            &CacheBlockedExecutor::Report::transferred_bytes,
+            "Estimated bytes read and written on the state")
+        .def_readonly("unblocked_transferred_bytes",
+            &CacheBlockedExecutor::Report::unblocked_transferred_bytes,
+            "Estimated bytes when every gate makes a full pass")
+        .def_readonly("elapsed_time",
+            &CacheBlockedExecutor::Report::elapsed_time,
+            "Elapsed time in seconds")
+        .def("get_bandwidth", &CacheBlockedExecutor::Report::get_bandwidth,
+            "Get estimated bytes per second");
+
+    py::class_<CacheBlockedExecutor>(m, "CacheBlockedExecutor")
+        .def(py::init<UINT>(), "Constructor",
+            py::arg("block_qubit_count") = 0)
+        .def("get_block_qubit_count",
+            &CacheBlockedExecutor::get_block_qubit_count,
+            "Get qubit count of a chunk")
+        .def("update_quantum_state",
+            &CacheBlockedExecutor::update_quantum_state,
+            "Update quantum state with cache blocking", py::arg("circuit"),
+            py::arg("state"))
+        .def("get_last_report", &CacheBlockedExecutor::get_last_report,
+            "Get report of the last update",
+            py::return_value_policy::copy);
+
     py::class_<CausalConeSimulator>(m, "CausalConeSimulator")
         .def(py::init<ParametricQuantumCircuit&, Observable&>(), "Constructor")
         .def("build", &CausalConeSimulator::build, "Build")
@@ -1603,11 +1932,32 @@ Matrix Representation
             },
             "get state frequency");
 
+    py::class_<NoiseSimulator::HistogramResult>(m, "SimulationHistogramResult")
+        .def_readonly("histogram", &NoiseSimulator::HistogramResult::histogram,
+            "Measured basis and its count")
+        .def_readonly("expectation_value_list",
+            &NoiseSimulator::HistogramResult::expectation_value_list,
+            "Expectation value and frequency of each final state")
+        .def("get_expectation_value",
+            &NoiseSimulator::HistogramResult::get_expectation_value,
+            "Get expectation value weighted by frequency");
+
     py::class_<NoiseSimulator>(m, "NoiseSimulator")
         .def(py::init<QuantumCircuit*, QuantumState*>(), "Constructor")
         .def("execute", &NoiseSimulator::execute,
             "Sampling & Return result [array]",
             py::return_value_policy::take_ownership)
         .def("execute_and_get_result", &NoiseSimulator::execute_and_get_result,
-            "Simulate & Return ressult [array of (state, frequency)]");
+            "Simulate & Return ressult [array of (state, frequency)]")
+        .def("execute_and_get_histogram",
+            &NoiseSimulator::execute_and_get_histogram,
+            "Sampling & Return histogram [dict of (basis, count)] and "
+            "expectation values",
+            py::arg("sample_count"), py::arg("observable") = nullptr)
+        .def("set_seed", &NoiseSimulator::set_seed, "Set random seed",
+            py::arg("seed"))
+        .def("set_checkpoint_memory_budget",
+            &NoiseSimulator::set_checkpoint_memory_budget,
+            "Set memory budget of checkpoint states in bytes",
+            py::arg("byte_count"));
 }
@@ -0,0 +1,223 @@
+#include "cache_blocked_executor.hpp"
+
+#include <csim/update_ops.hpp>
+#include <csim/utility.hpp>
+#include <cstdlib>
+
+#include "exception.hpp"
+#include "gate.hpp"
+#include "gate_matrix.hpp"
+#include "gate_matrix_diagonal.hpp"
+#include "gate_matrix_sparse.hpp"
+#include "gate_named_npair.hpp"
+#include "gate_named_one.hpp"
+#include "gate_named_pauli.hpp"
+#include "gate_named_two.hpp"
+#include "gate_reversible.hpp"
+#include "state.hpp"
+#include "utility.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+namespace {
+// A dense matrix of 2^k x 2^k elements is applied for each amplitude group,
+// so only gates with a few targets are worth keeping inside a segment.
+const UINT MAX_BLOCKED_TARGET_COUNT = 4;
+// Used when the L2 cache size is not available: 2^15 amplitudes (512 KiB).
+const UINT DEFAULT_BLOCK_QUBIT_COUNT = 15;
+
+UINT get_default_block_qubit_count() {
+    if (const char* tmp = std::getenv("QULACS_CACHE_BLOCK_QUBIT_COUNT")) {
+        const UINT tmp_val = strtol(tmp, nullptr, 0);
+        if (0 < tmp_val && tmp_val < 64) return tmp_val;
+    }
+    long cache_size = 0;
+#if defined(_SC_LEVEL2_CACHE_SIZE)
+    cache_size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+    if (cache_size <= 0) return DEFAULT_BLOCK_QUBIT_COUNT;
+    // leave half of the cache for the other data of the kernels
+    UINT block_qubit_count = 0;
+    while ((sizeof(CTYPE) << (block_qubit_count + 2)) <= (ITYPE)cache_size) {
+        ++block_qubit_count;
+    }
+    return std::max(block_qubit_count, (UINT)2);
+}
+
+/**
+ * A gate of a segment prepared for applying to a chunk of the state vector
+ */
+struct ChunkOperation {
+    std::vector<UINT> target_index;
+    std::vector<UINT> control_index;
+    std::vector<UINT> control_value;
+    ComplexMatrix matrix;
+    std::vector<CPPCTYPE> diagonal;
+    bool is_diagonal;
+
+    explicit ChunkOperation(const QuantumGateBase* gate) {
+        target_index = gate->get_target_index_list();
+        for (const auto& control : gate->control_qubit_list) {
+            control_index.push_back(control.index());
+            control_value.push_back(control.control_value());
+        }
+        gate->set_matrix(matrix);
+        is_diagonal = gate->is_diagonal() && control_index.empty();
+        if (is_diagonal) {
+            for (ITYPE i = 0; i < (ITYPE)matrix.rows(); ++i) {
+                diagonal.push_back(matrix(i, i));
+            }
+        }
+    }
+
+    // The same kernels as QuantumGateMatrix and QuantumGateDiagonalMatrix,
+    // with the chunk regarded as a state of block_qubit_count qubits.
+    void apply(CTYPE* chunk, ITYPE chunk_dim) const {
+        const CTYPE* matrix_ptr = reinterpret_cast<const CTYPE*>(matrix.data());
+        const UINT target_count = (UINT)target_index.size();
+        const UINT control_count = (UINT)control_index.size();
+        if (is_diagonal) {
+            const CTYPE* diagonal_ptr =
+                reinterpret_cast<const CTYPE*>(diagonal.data());
+            if (target_count == 1) {
+                single_qubit_diagonal_matrix_gate(
+                    target_index[0], diagonal_ptr, chunk, chunk_dim);
+            } else {
+                multi_qubit_diagonal_matrix_gate(target_index.data(),
+                    target_count, diagonal_ptr, chunk, chunk_dim);
+            }
+        } else if (target_count == 1) {
+            if (control_count == 0) {
+                single_qubit_dense_matrix_gate(
+                    target_index[0], matrix_ptr, chunk, chunk_dim);
+            } else if (control_count == 1) {
+                single_qubit_control_single_qubit_dense_matrix_gate(
+                    control_index[0], control_value[0], target_index[0],
+                    matrix_ptr, chunk, chunk_dim);
+            } else {
+                multi_qubit_control_single_qubit_dense_matrix_gate(
+                    control_index.data(), control_value.data(), control_count,
+                    target_index[0], matrix_ptr, chunk, chunk_dim);
+            }
+        } else {
+            if (control_count == 0) {
+                multi_qubit_dense_matrix_gate(target_index.data(),
+                    target_count, matrix_ptr, chunk, chunk_dim);
+            } else {
+                multi_qubit_control_multi_qubit_dense_matrix_gate(
+                    control_index.data(), control_value.data(), control_count,
+                    target_index.data(), target_count, matrix_ptr, chunk,
+                    chunk_dim);
+            }
+        }
+    }
+};
+}  // namespace
+
+CacheBlockedExecutor::CacheBlockedExecutor(UINT block_qubit_count) {
+    _block_qubit_count = (block_qubit_count > 0)
+                             ? block_qubit_count
+                             : get_default_block_qubit_count();
+}
+
+bool CacheBlockedExecutor::is_blockable(
+    const QuantumGateBase* gate, UINT block_qubit_count) {
+    // deterministic linear maps only: measurements, noises, and gates which
+    // depend on the whole state (e.g. reflection) must see the full state
+    const bool is_known_linear =
+        dynamic_cast<const QuantumGateMatrix*>(gate) != nullptr ||
+        dynamic_cast<const QuantumGateDiagonalMatrix*>(gate) != nullptr ||
+        dynamic_cast<const QuantumGateSparseMatrix*>(gate) != nullptr ||
+        dynamic_cast<const ClsOneQubitGate*>(gate) != nullptr ||
+        dynamic_cast<const ClsOneQubitRotationGate*>(gate) != nullptr ||
+        dynamic_cast<const ClsOneControlOneTargetGate*>(gate) != nullptr ||
+        dynamic_cast<const ClsTwoQubitGate*>(gate) != nullptr ||
+        dynamic_cast<const ClsPauliGate*>(gate) != nullptr ||
+        dynamic_cast<const ClsPauliRotationGate*>(gate) != nullptr ||
+        dynamic_cast<const ClsNpairQubitGate*>(gate) != nullptr ||
+        dynamic_cast<const ClsReversibleBooleanGate*>(gate) != nullptr ||
+        gate->is_parametric();
+    if (!is_known_linear) return false;
+    if (gate->target_qubit_list.size() > MAX_BLOCKED_TARGET_COUNT) return false;
+    for (const auto& target : gate->target_qubit_list) {
+        if (target.index() >= block_qubit_count) return false;
+    }
+    for (const auto& control : gate->control_qubit_list) {
+        if (control.index() >= block_qubit_count) return false;
+    }
+    return true;
+}
+
+void CacheBlockedExecutor::update_quantum_state(
+    const QuantumCircuit* circuit, QuantumStateBase* state) {
+    if (state->qubit_count != circuit->qubit_count) {
+        throw InvalidQubitCountException(
+            "Error: "
+            "CacheBlockedExecutor::update_quantum_state(QuantumCircuit, "
+            "QuantumStateBase) : invalid qubit count");
+    }
+
+    _report = Report();
+    Timer timer;
+    const double pass_bytes = 2. * (double)state->dim * sizeof(CTYPE);
+    const auto& gate_list = circuit->gate_list;
+    _report.unblocked_transferred_bytes = pass_bytes * gate_list.size();
+
+    bool use_block = state->is_state_vector() &&
+                     !state->is_single_precision() &&
+                     state->get_device_name() == "cpu" &&
+                     state->qubit_count > _block_qubit_count;
+#ifdef _USE_MPI
+    use_block = use_block && state->outer_qc == 0;
+#endif
+
+    const ITYPE chunk_dim = 1ULL << _block_qubit_count;
+    const ITYPE chunk_count = use_block ? (state->dim >> _block_qubit_count) : 0;
+    CTYPE* state_ptr = use_block ? state->data_c() : nullptr;
+
+    UINT cursor = 0;
+    while (cursor < gate_list.size()) {
+        UINT segment_end = cursor;
+        while (use_block && segment_end < gate_list.size() &&
+               is_blockable(gate_list[segment_end], _block_qubit_count)) {
+            ++segment_end;
+        }
+
+        // a single gate gains nothing from blocking
+        if (segment_end - cursor < 2) {
+            gate_list[cursor]->update_quantum_state(state);
+            _report.unblocked_gate_count++;
+            _report.transferred_bytes += pass_bytes;
+            ++cursor;
+            continue;
+        }
+
+        std::vector<ChunkOperation> operation_list;
+        for (UINT i = cursor; i < segment_end; ++i) {
+            operation_list.emplace_back(gate_list[i]);
+        }
+
+        ITYPE chunk_index;
+#ifdef _OPENMP
+        OMPutil::get_inst().set_qulacs_num_threads(state->dim, 13);
+#pragma omp parallel for
+#endif
+        for (chunk_index = 0; chunk_index < chunk_count; ++chunk_index) {
+            CTYPE* chunk = state_ptr + chunk_index * chunk_dim;
+            for (const auto& operation : operation_list) {
+                operation.apply(chunk, chunk_dim);
+            }
+        }
+#ifdef _OPENMP
+        OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+
+        _report.segment_count++;
+        _report.blocked_gate_count += segment_end - cursor;
+        _report.transferred_bytes += pass_bytes;
+        cursor = segment_end;
+    }
+    _report.elapsed_time = timer.elapsed();
+}
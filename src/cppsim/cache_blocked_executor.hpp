@@ -0,0 +1,92 @@
+#pragma once
+
+#include <vector>
+
+#include "circuit.hpp"
+#include "type.hpp"
+
+class QuantumGateBase;
+class QuantumStateBase;
+
+/**
+ * \~japanese-en キャッシュブロッキングによって量子回路を実行するクラス
+ *
+ * 回路中のゲートを、添え字の小さい量子ビットのみに作用するゲートが連続する区間(セグメント)に分割する。
+ * セグメント内のゲートは、状態ベクトルをL2キャッシュに収まる大きさのチャンクに分け、
+ * チャンクごとにまとめて適用される。これにより、状態ベクトルの読み書きはセグメントあたり一回で済む。
+ * 添え字の大きい量子ビットに作用するゲートや、ランダムな操作を含むゲートはセグメントの境界となり、通常通り適用される。
+ */
+class DllExport CacheBlockedExecutor {
+public:
+    /**
+     * \~japanese-en 直前の実行に関する統計
+     *
+     * 転送量は状態ベクトル全体の読み込みと書き込みを一回ずつ行うパスを単位として見積もる。
+     */
+    struct Report {
+        UINT segment_count = 0; /**< \~japanese-en チャンクごとに適用したセグメントの数 */
+        UINT blocked_gate_count = 0; /**< \~japanese-en セグメント内で適用したゲートの数 */
+        UINT unblocked_gate_count = 0; /**< \~japanese-en 通常通り適用したゲートの数 */
+        double transferred_bytes = 0.; /**< \~japanese-en 状態ベクトルの推定転送量 (byte) */
+        double unblocked_transferred_bytes =
+            0.; /**< \~japanese-en 全ゲートを通常通り適用した場合の推定転送量 (byte) */
+        double elapsed_time = 0.; /**< \~japanese-en 実行時間 (秒) */
+
+        /**
+         * \~japanese-en 推定転送量を実行時間で割った実効バンド幅 (byte/秒)
+         */
+        double get_bandwidth() const {
+            return elapsed_time > 0. ? transferred_bytes / elapsed_time : 0.;
+        }
+    };
+
+private:
+    UINT _block_qubit_count;
+    Report _report;
+
+public:
+    /**
+     * \~japanese-en コンストラクタ
+     *
+     * @param block_qubit_count
+     * チャンクの大きさを量子ビット数で指定する。0の場合は環境変数QULACS_CACHE_BLOCK_QUBIT_COUNT、
+     * またはL2キャッシュの大きさから決める。
+     */
+    explicit CacheBlockedExecutor(UINT block_qubit_count = 0);
+
+    /**
+     * \~japanese-en チャンクの大きさを量子ビット数で取得する
+     *
+     * @return チャンクの量子ビット数
+     */
+    UINT get_block_qubit_count() const { return _block_qubit_count; }
+
+    /**
+     * \~japanese-en 量子回路を量子状態に適用する
+     *
+     * 結果はQuantumCircuit::update_quantum_stateと一致する。
+     * CPU上の倍精度の状態ベクトル以外では、ゲートを順に適用するだけとなる。
+     * @param circuit 適用する量子回路
+     * @param state 更新する量子状態
+     */
+    void update_quantum_state(
+        const QuantumCircuit* circuit, QuantumStateBase* state);
+
+    /**
+     * \~japanese-en 直前のupdate_quantum_stateの統計を取得する
+     *
+     * @return 統計
+     */
+    const Report& get_last_report() const { return _report; }
+
+    /**
+     * \~japanese-en ゲートがチャンクごとに適用できるかどうかを判定する
+     *
+     * ゲートが決定的な線形写像で、作用する全ての量子ビットの添え字がblock_qubit_count未満であれば真となる。
+     * @param gate 判定するゲート
+     * @param block_qubit_count チャンクの量子ビット数
+     * @return チャンクごとに適用できるかどうか
+     */
+    static bool is_blockable(
+        const QuantumGateBase* gate, UINT block_qubit_count);
+};
@@ -10,6 +10,7 @@
 #include <sstream>
 #include <stdexcept>
 
+#include "compiled_circuit.hpp"
 #include "exception.hpp"
 #include "gate.hpp"
 #include "gate_factory.hpp"
@@ -28,11 +29,26 @@ void QuantumCircuit::update_quantum_state(QuantumStateBase* state) {
             "invalid qubit count");
     }
 
+    if (_compiled_circuit != nullptr) {
+        _compiled_circuit->update_quantum_state(state);
+        return;
+    }
     for (const auto& gate : this->_gate_list) {
         gate->update_quantum_state(state);
     }
 }
 
+const CompiledCircuit* QuantumCircuit::compile() {
+    this->clear_compiled_circuit();
+    _compiled_circuit = new CompiledCircuit(this);
+    return _compiled_circuit;
+}
+
+void QuantumCircuit::clear_compiled_circuit() {
+    delete _compiled_circuit;
+    _compiled_circuit = nullptr;
+}
+
 void QuantumCircuit::update_quantum_state(QuantumStateBase* state, UINT seed) {
     Random random;
     random.set_seed(seed);
@@ -115,6 +131,7 @@ void QuantumCircuit::add_gate(QuantumGateBase* gate) {
             "applied to qubits of which the indices are smaller than "
             "qubit_count");
     }
+    this->clear_compiled_circuit();
     this->_gate_list.push_back(gate);
 }
 
@@ -130,6 +147,7 @@ void QuantumCircuit::add_gate(QuantumGateBase* gate, UINT index) {
             "Error: QuantumCircuit::add_gate(QuantumGateBase*, UINT) : "
             "insert index must be smaller than or equal to gate_count");
     }
+    this->clear_compiled_circuit();
     this->_gate_list.insert(this->_gate_list.begin() + index, gate);
 }
 
@@ -230,6 +248,7 @@ void QuantumCircuit::remove_gate(UINT index) {
             "Error: QuantumCircuit::remove_gate(UINT) : index must be "
             "smaller than gate_count");
     }
+    this->clear_compiled_circuit();
     delete this->_gate_list[index];
     this->_gate_list.erase(this->_gate_list.begin() + index);
 }
@@ -241,6 +260,7 @@ void QuantumCircuit::move_gate(UINT from_index, UINT to_index) {
             "Error: QuantumCircuit::move_gate(UINT, UINT) : "
             "index must be smaller than gate_count");
     }
+    this->clear_compiled_circuit();
     if (from_index < to_index) {
         std::rotate(this->_gate_list.begin() + from_index,
             this->_gate_list.begin() + from_index + 1,
@@ -254,6 +274,7 @@ void QuantumCircuit::move_gate(UINT from_index, UINT to_index) {
 }
 
 QuantumCircuit::~QuantumCircuit() {
+    this->clear_compiled_circuit();
     for (auto& gate : this->_gate_list) {
         delete gate;
     }
@@ -461,15 +482,14 @@ void QuantumCircuit::add_diagonal_observable_rotation_gate(
             "Observable& observable, double angle, UINT num_repeats): not "
             "implemented for non hermitian");
     }
+    // checked before adding any gate so that the circuit is left unchanged
+    if (!observable.is_diagonal()) {
+        throw InvalidObservableException("ERROR: Observable is not diagonal");
+    }
     std::vector<PauliOperator*> operator_list = observable.get_terms();
     for (auto pauli : operator_list) {
-        auto pauli_rotation = gate::PauliRotation(pauli->get_index_list(),
-            pauli->get_pauli_id_list(), pauli->get_coef().real() * angle);
-        if (!pauli_rotation->is_diagonal()) {
-            throw InvalidObservableException(
-                "ERROR: Observable is not diagonal");
-        }
-        this->add_gate(pauli_rotation);
+        this->add_gate(gate::PauliRotation(pauli->get_index_list(),
+            pauli->get_pauli_id_list(), pauli->get_coef().real() * angle));
     }
 }
 void QuantumCircuit::add_observable_rotation_gate(
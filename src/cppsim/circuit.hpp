@@ -16,6 +16,7 @@
 
 class QuantumStateBase;
 class QuantumGateBase;
+class CompiledCircuit;
 class PauliOperator;
 class HermitianQuantumOperator;
 using Observable = HermitianQuantumOperator;
@@ -30,6 +31,14 @@ class DllExport QuantumCircuit {
 protected:
     std::vector<QuantumGateBase*> _gate_list;
     UINT _qubit_count;
+    CompiledCircuit* _compiled_circuit = nullptr;
+
+    /**
+     * \~japanese-en 変換済みの命令列を破棄する
+     *
+     * ゲートの追加、削除、移動の際に呼ばれる。
+     */
+    void clear_compiled_circuit();
 
     // prohibit shallow copy
     QuantumCircuit(const QuantumCircuit& obj);
@@ -163,6 +172,23 @@ public:
      */
     void update_quantum_state(QuantumStateBase* state);
 
+    /**
+     * \~japanese-en 量子回路を平坦な命令列に変換する
+     *
+     * 変換後のupdate_quantum_stateは命令列を用いて実行される。
+     * 命令列はゲートの追加、削除、移動によって破棄される。
+     * 量子回路が保持するゲートを直接変更した場合は再度変換する必要がある。
+     * @return 変換された命令列。量子回路が所有する。
+     */
+    const CompiledCircuit* compile();
+
+    /**
+     * \~japanese-en 量子回路が命令列に変換済みかどうかを取得する
+     *
+     * @return 変換済みであればtrue
+     */
+    bool is_compiled() const { return _compiled_circuit != nullptr; }
+
     /**
      * \~japanese-en 量子回路の指定範囲のみを用いて量子状態をを更新する
      *
@@ -2,19 +2,33 @@
 
 #include <stdio.h>
 
+#include <Eigen/Eigenvalues>
 #include <algorithm>
+#include <array>
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/graphviz.hpp>
 #include <fstream>
+#include <functional>
 #include <iterator>
+#include <map>
+#include <memory>
+#include <set>
 #include <stdexcept>
 
 #include "circuit.hpp"
 #include "gate.hpp"
 #include "gate_factory.hpp"
+#include "gate_cost_model.hpp"
+#include "gate_general.hpp"
 #include "gate_matrix.hpp"
+#include "gate_matrix_diagonal.hpp"
+#include "gate_named_one.hpp"
+#include "gate_named_pauli.hpp"
+#include "gate_named_two.hpp"
+#include "observable.hpp"
 #include "gate_merge.hpp"
 #include "qubit_table.hpp"
+#include "utility.hpp"
 
 #define LOG \
     if (log_enabled) std::cerr << "[CircOpt] "
@@ -32,82 +46,445 @@ typedef boost::adjacency_list<boost::vecS,  // OutEdgeList
     DepGraph;
 typedef boost::graph_traits<DepGraph>::vertex_descriptor Vertex;
 
-UINT QuantumCircuitOptimizer::get_rightmost_commute_index(UINT gate_index) {
-    UINT cursor = gate_index + 1;
-    for (; cursor < circuit->gate_list.size(); ++cursor) {
-        if (!circuit->gate_list[gate_index]->is_commute(
-                circuit->gate_list[cursor]))
-            break;
+////////////////////////////////////////////////////////////
+// for gate merging on a dependency DAG
+////////////////////////////////////////////////////////////
+
+// Commutation of a gate on one of its qubits. Two gates commute on a qubit
+// when either has COMMUTE_ALL or both have the same class X, Y or Z. A control
+// commutes as a target commuting with Z. A target commuting with two of X, Y
+// and Z is treated as commuting with none, which only adds dependencies.
+enum CommuteClass {
+    COMMUTE_NONE,
+    COMMUTE_X,
+    COMMUTE_Y,
+    COMMUTE_Z,
+    COMMUTE_ALL,
+    COMMUTE_CLASS_COUNT
+};
+
+static CommuteClass get_commute_class(UINT commute_prop) {
+    switch (commute_prop) {
+        case FLAG_X_COMMUTE:
+            return COMMUTE_X;
+        case FLAG_Y_COMMUTE:
+            return COMMUTE_Y;
+        case FLAG_Z_COMMUTE:
+            return COMMUTE_Z;
+        case FLAG_X_COMMUTE | FLAG_Y_COMMUTE | FLAG_Z_COMMUTE:
+            return COMMUTE_ALL;
+        default:
+            return COMMUTE_NONE;
     }
-    return cursor - 1;
 }
 
-UINT QuantumCircuitOptimizer::get_leftmost_commute_index(UINT gate_index) {
-    // be careful for underflow of unsigned value
-    int cursor = (signed)(gate_index - 1);
-    for (; cursor >= 0; cursor--) {
-        if (!circuit->gate_list[gate_index]->is_commute(
-                circuit->gate_list[cursor]))
-            break;
+// A gate in the dependency DAG. A node has the rank of a gate in the input
+// circuit, and a merged node takes the rank of one of the merged nodes.
+// Edges go from lower to higher ranks, so the ranks of the alive nodes give a
+// topological order. Two alive nodes which do not commute on a common qubit
+// are always connected by a path.
+struct DagNode {
+    QuantumGateBase* gate;
+    bool is_merged; /**< the gate is created by the optimizer */
+    bool is_alive;
+    UINT rank;
+    std::vector<UINT> qubit_list;
+    std::vector<CommuteClass> class_list;
+    std::vector<UINT> parent_list; /**< may contain removed nodes */
+    std::vector<UINT> child_list;  /**< may contain removed nodes */
+    int first_node;  /**< merged node applied first, or -1 */
+    int second_node; /**< merged node applied later, or -1 */
+    double time;     /**< predicted time of the gate */
+};
+
+class GateDag {
+public:
+    std::vector<DagNode> node_list;
+    std::vector<UINT> rank_to_node;
+    std::set<UINT> rank_set;
+    // ranks of the alive nodes on each qubit, for all and for each class
+    std::vector<std::set<UINT>> qubit_rank_list;
+    std::vector<std::array<std::set<UINT>, COMMUTE_CLASS_COUNT>>
+        qubit_class_rank_list;
+    std::function<double(const QuantumGateBase*)> time_func;
+
+    GateDag(UINT qubit_count, UINT gate_count)
+        : rank_to_node(gate_count),
+          qubit_rank_list(qubit_count),
+          qubit_class_rank_list(qubit_count) {}
+
+    ~GateDag() {
+        for (DagNode& node : node_list) {
+            if (node.is_alive && node.is_merged) delete node.gate;
+        }
+    }
+
+    UINT add_node(QuantumGateBase* gate, bool is_merged, UINT rank,
+        const std::vector<UINT>& parent_list,
+        const std::vector<UINT>& child_list) {
+        const UINT id = (UINT)node_list.size();
+        node_list.push_back(DagNode());
+        DagNode& node = node_list.back();
+        node.gate = gate;
+        node.is_merged = is_merged;
+        node.is_alive = true;
+        node.rank = rank;
+        node.first_node = node.second_node = -1;
+        node.time = time_func ? time_func(gate) : 0.;
+        std::vector<std::pair<UINT, CommuteClass>> qubit_class_list;
+        for (const auto& target : gate->target_qubit_list) {
+            qubit_class_list.push_back(std::make_pair(target.index(),
+                get_commute_class(target.get_merged_property(
+                    FLAG_X_COMMUTE | FLAG_Y_COMMUTE | FLAG_Z_COMMUTE))));
+        }
+        for (const auto& control : gate->control_qubit_list) {
+            qubit_class_list.push_back(
+                std::make_pair(control.index(), COMMUTE_Z));
+        }
+        std::sort(qubit_class_list.begin(), qubit_class_list.end());
+        for (const auto& qubit_class : qubit_class_list) {
+            node.qubit_list.push_back(qubit_class.first);
+            node.class_list.push_back(qubit_class.second);
+        }
+        for (UINT parent : parent_list) add_edge(parent, id);
+        for (UINT child : child_list) add_edge(id, child);
+
+        rank_to_node[rank] = id;
+        rank_set.insert(rank);
+        for (UINT i = 0; i < node_list[id].qubit_list.size(); ++i) {
+            const UINT qubit = node_list[id].qubit_list[i];
+            qubit_rank_list[qubit].insert(rank);
+            qubit_class_rank_list[qubit][node_list[id].class_list[i]].insert(
+                rank);
+            connect_on_qubit(id, i, true);
+            connect_on_qubit(id, i, false);
+        }
+        return id;
+    }
+
+    void remove_node(UINT id) {
+        DagNode& node = node_list[id];
+        node.is_alive = false;
+        rank_set.erase(node.rank);
+        for (UINT i = 0; i < node.qubit_list.size(); ++i) {
+            qubit_rank_list[node.qubit_list[i]].erase(node.rank);
+            qubit_class_rank_list[node.qubit_list[i]][node.class_list[i]]
+                .erase(node.rank);
+        }
+    }
+
+    CommuteClass get_class(UINT id, UINT qubit) const {
+        const DagNode& node = node_list[id];
+        auto ite = std::lower_bound(
+            node.qubit_list.begin(), node.qubit_list.end(), qubit);
+        return node.class_list[ite - node.qubit_list.begin()];
+    }
+
+    // keep the paths through removed nodes
+    void connect(const std::vector<UINT>& parent_list,
+        const std::vector<UINT>& child_list) {
+        for (UINT parent : parent_list) {
+            for (UINT child : child_list) add_edge(parent, child);
+        }
+    }
+
+    // alive parents (or children) of a node, excluding another node
+    std::vector<UINT> get_alive_list(
+        const std::vector<UINT>& id_list, UINT excluded) const {
+        std::vector<UINT> alive_list;
+        for (UINT id : id_list) {
+            if (node_list[id].is_alive && id != excluded) {
+                alive_list.push_back(id);
+            }
+        }
+        std::sort(alive_list.begin(), alive_list.end());
+        alive_list.erase(std::unique(alive_list.begin(), alive_list.end()),
+            alive_list.end());
+        return alive_list;
+    }
+
+private:
+    // the nearest rank before (or after) a rank among the nodes on a qubit
+    // whose classes are not in the excluded mask
+    bool find_nearest_rank(UINT qubit, UINT rank, UINT excluded_class_mask,
+        bool backward, UINT& nearest_rank) const {
+        bool found = false;
+        for (UINT class_index = 0; class_index < COMMUTE_CLASS_COUNT;
+             ++class_index) {
+            if ((excluded_class_mask >> class_index) & 1) continue;
+            const std::set<UINT>& rank_list =
+                qubit_class_rank_list[qubit][class_index];
+            if (backward) {
+                auto ite = rank_list.lower_bound(rank);
+                if (ite == rank_list.begin()) continue;
+                --ite;
+                if (!found || *ite > nearest_rank) nearest_rank = *ite;
+            } else {
+                auto ite = rank_list.upper_bound(rank);
+                if (ite == rank_list.end()) continue;
+                if (!found || *ite < nearest_rank) nearest_rank = *ite;
+            }
+            found = true;
+        }
+        return found;
     }
-    return cursor + 1;
+
+    void add_edge(UINT from, UINT to) {
+        node_list[from].child_list.push_back(to);
+        node_list[to].parent_list.push_back(from);
+    }
+
+    // Connect a node with the nodes before (or after) it on its qubit_pos-th
+    // qubit. The nearest non-commuting node is connected, and if it has a
+    // class X, Y or Z, so are the nodes of the same class up to the next node
+    // not commuting with them, which is connected to all of them by a path.
+    void connect_on_qubit(UINT id, UINT qubit_pos, bool backward) {
+        const UINT rank = node_list[id].rank;
+        const UINT qubit = node_list[id].qubit_list[qubit_pos];
+        const CommuteClass node_class = node_list[id].class_list[qubit_pos];
+        if (node_class == COMMUTE_ALL) return;
+        UINT excluded_class_mask = 1U << COMMUTE_ALL;
+        if (node_class != COMMUTE_NONE) excluded_class_mask |= 1U << node_class;
+
+        UINT nearest_rank = 0;
+        if (!find_nearest_rank(
+                qubit, rank, excluded_class_mask, backward, nearest_rank))
+            return;
+        const UINT nearest = rank_to_node[nearest_rank];
+        if (backward) {
+            add_edge(nearest, id);
+        } else {
+            add_edge(id, nearest);
+        }
+        const CommuteClass run_class = get_class(nearest, qubit);
+        if (run_class == COMMUTE_NONE) return;
+
+        UINT bound_rank = 0;
+        const bool has_bound = find_nearest_rank(qubit, nearest_rank,
+            (1U << COMMUTE_ALL) | (1U << run_class), backward, bound_rank);
+        const std::set<UINT>& run = qubit_class_rank_list[qubit][run_class];
+        if (backward) {
+            auto ite = run.find(nearest_rank);
+            while (ite != run.begin()) {
+                --ite;
+                if (has_bound && *ite < bound_rank) break;
+                add_edge(rank_to_node[*ite], id);
+            }
+        } else {
+            for (auto ite = std::next(run.find(nearest_rank));
+                 ite != run.end(); ++ite) {
+                if (has_bound && *ite > bound_rank) break;
+                add_edge(id, rank_to_node[*ite]);
+            }
+        }
+    }
+};
+
+static UINT get_union_size(
+    const std::vector<UINT>& list1, const std::vector<UINT>& list2) {
+    UINT size = 0;
+    auto ite1 = list1.begin();
+    auto ite2 = list2.begin();
+    while (ite1 != list1.end() || ite2 != list2.end()) {
+        if (ite2 == list2.end() || (ite1 != list1.end() && *ite1 < *ite2)) {
+            ++ite1;
+        } else if (ite1 == list1.end() || *ite2 < *ite1) {
+            ++ite2;
+        } else {
+            ++ite1;
+            ++ite2;
+        }
+        ++size;
+    }
+    return size;
 }
 
-UINT QuantumCircuitOptimizer::get_merged_gate_size(
-    UINT gate_index1, UINT gate_index2) {
-    auto fetch_target_index =
-        [](const std::vector<TargetQubitInfo>& info_list) {
-            std::vector<UINT> index_list;
-            std::transform(info_list.cbegin(), info_list.cend(),
-                std::back_inserter(index_list),
-                [](const TargetQubitInfo& info) { return info.index(); });
-            return index_list;
-        };
-    auto fetch_control_index =
-        [](const std::vector<ControlQubitInfo>& info_list) {
-            std::vector<UINT> index_list;
-            std::transform(info_list.cbegin(), info_list.cend(),
-                std::back_inserter(index_list),
-                [](const ControlQubitInfo& info) { return info.index(); });
-            return index_list;
-        };
+// number of the nearby nodes on each qubit and in the whole circuit which are
+// tried as merge partners
+static const UINT merge_window_size = 8;
+
+// Merge two gates into merged_gate, or return false if they are not merged.
+// A null merged_gate means that the two gates cancel each other.
+using MergeFunction = std::function<bool(
+    const QuantumGateBase*, const QuantumGateBase*, QuantumGateBase*&)>;
+// Return the gate itself to keep it, a new gate to replace it, or nullptr to
+// drop it.
+using ConvertFunction = std::function<QuantumGateBase*(QuantumGateBase*)>;
+
+// Add the gates to the DAG in order and merge nearby pairs of nodes into the
+// gates created by merge_func, until no pair can be merged.
+static void merge_on_dag(GateDag& dag,
+    const std::vector<QuantumGateBase*>& gate_list, UINT max_block_size,
+    const MergeFunction& merge_func,
+    const ConvertFunction& convert_func = nullptr) {
+    // Two nodes can be merged when the earlier one can move just before the
+    // later one, or the later one can move just after the earlier one, so
+    // that no path passes between them. The merged node takes the rank of the
+    // node which does not move.
+    const int cancelled = -2;
+    auto try_merge = [&](UINT first, UINT second) -> int {
+        const DagNode& node1 = dag.node_list[first];
+        const DagNode& node2 = dag.node_list[second];
+        if (get_union_size(node1.qubit_list, node2.qubit_list) >
+            max_block_size)
+            return -1;
+
+        std::vector<UINT> child_list =
+            dag.get_alive_list(node1.child_list, second);
+        std::vector<UINT> parent_list =
+            dag.get_alive_list(node2.parent_list, first);
+        const bool move_first = std::all_of(child_list.begin(),
+            child_list.end(), [&](UINT child) {
+                return dag.node_list[child].rank > node2.rank;
+            });
+        const bool move_second = std::all_of(parent_list.begin(),
+            parent_list.end(), [&](UINT parent) {
+                return dag.node_list[parent].rank < node1.rank;
+            });
+        if (!move_first && !move_second) return -1;
+
+        QuantumGateBase* merged_gate = nullptr;
+        if (!merge_func(node1.gate, node2.gate, merged_gate)) return -1;
+        const UINT rank = move_first ? node2.rank : node1.rank;
+        std::vector<UINT> parent_list1 =
+            dag.get_alive_list(node1.parent_list, second);
+        std::vector<UINT> child_list2 =
+            dag.get_alive_list(node2.child_list, first);
+        parent_list.insert(
+            parent_list.end(), parent_list1.begin(), parent_list1.end());
+        child_list.insert(
+            child_list.end(), child_list2.begin(), child_list2.end());
+        for (UINT id : {first, second}) {
+            dag.remove_node(id);
+            if (dag.node_list[id].is_merged) delete dag.node_list[id].gate;
+        }
+        if (merged_gate == nullptr) {
+            dag.connect(parent_list, child_list);
+            return cancelled;
+        }
+        const UINT merged_node =
+            dag.add_node(merged_gate, true, rank, parent_list, child_list);
+        dag.node_list[merged_node].first_node = (int)first;
+        dag.node_list[merged_node].second_node = (int)second;
+        return (int)merged_node;
+    };
+
+    // merge a node with nearby nodes while possible
+    auto merge_node = [&](UINT id) {
+        bool merged = false;
+        bool merged_flag = true;
+        while (merged_flag) {
+            merged_flag = false;
+            const UINT rank = dag.node_list[id].rank;
+            std::vector<UINT> candidate_rank_list;
+            auto collect = [&](const std::set<UINT>& rank_list) {
+                auto center = rank_list.find(rank);
+                auto ite = center;
+                for (UINT count = 0;
+                     count < merge_window_size && ite != rank_list.begin();
+                     ++count) {
+                    candidate_rank_list.push_back(*(--ite));
+                }
+                ite = center;
+                for (UINT count = 0; count < merge_window_size &&
+                                     ++ite != rank_list.end();
+                     ++count) {
+                    candidate_rank_list.push_back(*ite);
+                }
+            };
+            for (UINT qubit : dag.node_list[id].qubit_list) {
+                collect(dag.qubit_rank_list[qubit]);
+            }
+            collect(dag.rank_set);
+
+            for (UINT candidate_rank : candidate_rank_list) {
+                const UINT candidate = dag.rank_to_node[candidate_rank];
+                const int merged_node =
+                    (candidate_rank < rank) ? try_merge(candidate, id)
+                                            : try_merge(id, candidate);
+                if (merged_node == cancelled) return true;
+                if (merged_node >= 0) {
+                    id = (UINT)merged_node;
+                    merged = merged_flag = true;
+                    break;
+                }
+            }
+        }
+        return merged;
+    };
 
-    auto target_index_list1 =
-        fetch_target_index(circuit->gate_list[gate_index1]->target_qubit_list);
-    auto target_index_list2 =
-        fetch_target_index(circuit->gate_list[gate_index2]->target_qubit_list);
-    auto control_index_list1 = fetch_control_index(
-        circuit->gate_list[gate_index1]->control_qubit_list);
-    auto control_index_list2 = fetch_control_index(
-        circuit->gate_list[gate_index2]->control_qubit_list);
-
-    std::sort(target_index_list1.begin(), target_index_list1.end());
-    std::sort(target_index_list2.begin(), target_index_list2.end());
-    std::sort(control_index_list1.begin(), control_index_list1.end());
-    std::sort(control_index_list2.begin(), control_index_list2.end());
-
-    std::vector<UINT> target_index_merge, control_index_merge, whole_index;
-    std::set_union(target_index_list1.begin(), target_index_list1.end(),
-        target_index_list2.begin(), target_index_list2.end(),
-        std::back_inserter(target_index_merge));
-    std::set_union(control_index_list1.begin(), control_index_list1.end(),
-        control_index_list2.begin(), control_index_list2.end(),
-        std::back_inserter(control_index_merge));
-    std::set_union(target_index_merge.begin(), target_index_merge.end(),
-        control_index_merge.begin(), control_index_merge.end(),
-        std::back_inserter(whole_index));
-    return (UINT)(whole_index.size());
-}
-
-/////////////////////////////////////
-
-bool QuantumCircuitOptimizer::is_neighboring(
-    UINT gate_index1, UINT gate_index2) {
-    assert(gate_index1 != gate_index2);
-    if (gate_index1 > gate_index2) std::swap(gate_index1, gate_index2);
-    UINT ind1_right = this->get_rightmost_commute_index(gate_index1);
-    UINT ind2_left = this->get_leftmost_commute_index(gate_index2);
-    return ind2_left <= ind1_right + 1;
+    for (UINT index = 0; index < gate_list.size(); ++index) {
+        QuantumGateBase* gate = gate_list[index];
+        if (convert_func) gate = convert_func(gate);
+        if (gate == nullptr) continue;
+        const UINT id = dag.add_node(gate, gate != gate_list[index], index,
+            std::vector<UINT>(), std::vector<UINT>());
+        merge_node(id);
+    }
+    // merges enabled by later merges
+    bool merged_flag = true;
+    while (merged_flag) {
+        merged_flag = false;
+        for (UINT rank = 0; rank < gate_list.size(); ++rank) {
+            if (dag.rank_set.count(rank) == 0) continue;
+            merged_flag |= merge_node(dag.rank_to_node[rank]);
+        }
+    }
+}
+
+// Replace the gates of the circuit with the alive nodes of the DAG in the
+// order of their ranks. A merged node is replaced with the gates returned by
+// expand_func, which are owned by the circuit afterwards.
+static void rewrite_circuit(QuantumCircuit* circuit, GateDag& dag,
+    const std::function<std::vector<QuantumGateBase*>(UINT)>& expand_func) {
+    // Unmerged gates keep their order, so the circuit is rewritten from the
+    // end. A circuit without parametric gates is rebuilt at once, while the
+    // gates of a circuit with parametric gates are replaced one by one through
+    // remove_gate and add_gate, which keep the parameter positions.
+    const UINT gate_count = (UINT)circuit->gate_list.size();
+    const bool has_parametric_gate = std::any_of(circuit->gate_list.begin(),
+        circuit->gate_list.end(),
+        [](const QuantumGateBase* gate) { return gate->is_parametric(); });
+    if (has_parametric_gate) {
+        // expand_func may refer to the gates of the circuit
+        std::map<UINT, std::vector<QuantumGateBase*>> expanded_map;
+        for (UINT rank : dag.rank_set) {
+            const UINT id = dag.rank_to_node[rank];
+            if (dag.node_list[id].is_merged) {
+                expanded_map[rank] = expand_func(id);
+            }
+        }
+        for (UINT rank = gate_count; rank > 0; --rank) {
+            const bool has_node = dag.rank_set.count(rank - 1) != 0;
+            const bool is_expanded = expanded_map.count(rank - 1) != 0;
+            if (has_node && !is_expanded) continue;
+            circuit->remove_gate(rank - 1);
+            if (is_expanded) {
+                const auto& expanded_list = expanded_map[rank - 1];
+                for (UINT index = 0; index < expanded_list.size(); ++index) {
+                    circuit->add_gate(expanded_list[index], rank - 1 + index);
+                }
+            }
+        }
+    } else {
+        std::vector<QuantumGateBase*> new_gate_list;
+        for (UINT rank : dag.rank_set) {
+            const UINT id = dag.rank_to_node[rank];
+            if (dag.node_list[id].is_merged) {
+                std::vector<QuantumGateBase*> expanded_list = expand_func(id);
+                new_gate_list.insert(new_gate_list.end(),
+                    expanded_list.begin(), expanded_list.end());
+            } else {
+                new_gate_list.push_back(dag.node_list[id].gate->copy());
+            }
+        }
+        while (!circuit->gate_list.empty()) {
+            circuit->remove_gate((UINT)circuit->gate_list.size() - 1);
+        }
+        for (auto gate : new_gate_list) {
+            circuit->add_gate(gate);
+        }
+    }
 }
 
 void QuantumCircuitOptimizer::optimize(
@@ -117,54 +494,602 @@ void QuantumCircuitOptimizer::optimize(
 
     insert_swap_gates(swap_level);
 
-    bool merged_flag = true;
-    while (merged_flag) {
-        merged_flag = false;
-        for (UINT ind1 = 0; ind1 < circuit->gate_list.size(); ++ind1) {
-            for (UINT ind2 = ind1 + 1; ind2 < circuit->gate_list.size();
-                 ++ind2) {
-                // parametric gate cannot be merged
-                if (circuit->gate_list[ind1]->is_parametric() ||
-                    circuit->gate_list[ind2]->is_parametric())
-                    continue;
-
-                // if merged block size is larger than max_block_size, we cannot
-                // merge them
-                if (this->get_merged_gate_size(ind1, ind2) > max_block_size)
-                    continue;
-
-                // we skip merging that would interfere swap insertion
-                if (!can_merge_with_swap_insertion(ind1, ind2, swap_level))
-                    continue;
-
-                // if they are separated by not-commutive gate, we cannot merge
-                // them
-                // TODO: use cache for merging
-                if (!this->is_neighboring(ind1, ind2)) continue;
-
-                // generate merged gate
-                auto merged_gate = gate::merge(
-                    circuit->gate_list[ind1], circuit->gate_list[ind2]);
-
-                // remove merged two gates, and append new one
-                UINT ind2_left = this->get_leftmost_commute_index(ind2);
-                // insert at max(just after first_applied_gate, just before
-                // left-most gate commuting with later_applied_gate ) Insertion
-                // point is always later than the first, and always earlier than
-                // the second.
-                UINT insert_point = std::max(ind2_left, ind1 + 1);
-
-                // Not to change index with removal, process from later ones to
-                // earlier ones.
-                circuit->remove_gate(ind2);
-                circuit->add_gate(merged_gate, insert_point);
-                circuit->remove_gate(ind1);
+    Timer timer;
+    const UINT gate_count = (UINT)circuit->gate_list.size();
+    GateDag dag(circuit->qubit_count, gate_count);
+    merge_on_dag(dag, circuit->gate_list, max_block_size,
+        [&](const QuantumGateBase* gate1, const QuantumGateBase* gate2,
+            QuantumGateBase*& merged_gate) {
+            // parametric gate cannot be merged, and we skip merging that
+            // would interfere swap insertion
+            if (gate1->is_parametric() || gate2->is_parametric() ||
+                !can_merge_with_swap_insertion(gate1, gate2, swap_level))
+                return false;
+            merged_gate = gate::merge(gate1, gate2);
+            return true;
+        });
+    rewrite_circuit(circuit, dag, [&](UINT id) {
+        dag.node_list[id].is_merged = false;
+        return std::vector<QuantumGateBase*>{dag.node_list[id].gate};
+    });
+    LOG << "optimize: " << gate_count << " gates -> "
+        << circuit->gate_list.size() << " gates in " << timer.elapsed()
+        << " s" << std::endl;
+}
+
+// A merged gate which turns out to be diagonal is replaced with a diagonal
+// matrix gate if the diagonal kernel is predicted to be faster. Control
+// qubits are already kept by gate::merge.
+static QuantumGateBase* to_structured_gate(
+    QuantumGateMatrix* gate, const GateCostModel& cost_model) {
+    if (!gate->is_diagonal()) return gate;
+    ComplexMatrix matrix;
+    gate->set_matrix(matrix);
+    ComplexVector diagonal_element = matrix.diagonal();
+    QuantumGateBase* diagonal_gate =
+        new QuantumGateDiagonalMatrix(gate->target_qubit_list,
+            diagonal_element, gate->control_qubit_list);
+    if (cost_model.get_gate_time(diagonal_gate) >
+        cost_model.get_gate_time(gate)) {
+        delete diagonal_gate;
+        return gate;
+    }
+    delete gate;
+    return diagonal_gate;
+}
+
+void QuantumCircuitOptimizer::optimize_with_cost_model(
+    QuantumCircuit* circuit_, const GateCostModel& cost_model) {
+    if (circuit_->qubit_count != cost_model.get_qubit_count()) {
+        throw InvalidQubitCountException(
+            "Error: QuantumCircuitOptimizer::optimize_with_cost_model("
+            "QuantumCircuit*, const GateCostModel&): "
+            "qubit_count of circuit and cost_model must be the same");
+    }
+    circuit = circuit_;
+
+    Timer timer;
+    const UINT gate_count = (UINT)circuit->gate_list.size();
+    auto merge_func = [&](const QuantumGateBase* gate1,
+                          const QuantumGateBase* gate2,
+                          QuantumGateBase*& merged_gate) {
+        GateCostModel::KernelType type;
+        UINT target_count;
+        if (!cost_model.get_kernel(gate1, type, target_count) ||
+            !cost_model.get_kernel(gate2, type, target_count))
+            return false;
+        merged_gate =
+            to_structured_gate(gate::merge(gate1, gate2), cost_model);
+        return true;
+    };
+
+    // Gates are merged up to each block size, and every merge is recorded as
+    // a binary tree. A merge is kept only if the merged gate is predicted to
+    // run faster than the best choice for its two subtrees.
+    std::unique_ptr<GateDag> best_dag;
+    std::vector<double> best_time_list;
+    double best_total_time = 0.;
+    UINT best_block_size = 0;
+    for (UINT block_size = 1; block_size <= cost_model.get_max_target_count();
+         ++block_size) {
+        std::unique_ptr<GateDag> dag(
+            new GateDag(circuit->qubit_count, gate_count));
+        dag->time_func = [&](const QuantumGateBase* gate) {
+            return cost_model.get_gate_time(gate);
+        };
+        merge_on_dag(*dag, circuit->gate_list, block_size, merge_func);
+
+        // children always have smaller ids than the merged node
+        std::vector<double> time_list(dag->node_list.size());
+        for (UINT id = 0; id < dag->node_list.size(); ++id) {
+            const DagNode& node = dag->node_list[id];
+            time_list[id] = node.time;
+            if (node.first_node >= 0) {
+                time_list[id] = std::min(node.time,
+                    time_list[node.first_node] + time_list[node.second_node]);
+            }
+        }
+        double total_time = 0.;
+        for (UINT rank : dag->rank_set) {
+            // gates out of the model are never merged
+            total_time += std::max(time_list[dag->rank_to_node[rank]], 0.);
+        }
+        if (best_dag == nullptr || total_time < best_total_time) {
+            best_dag = std::move(dag);
+            best_time_list = std::move(time_list);
+            best_total_time = total_time;
+            best_block_size = block_size;
+        }
+    }
+    if (best_dag == nullptr) return;
+
+    GateDag& dag = *best_dag;
+    auto is_merge_chosen = [&](const DagNode& node) {
+        return node.first_node >= 0 &&
+               node.time <= best_time_list[node.first_node] +
+                                best_time_list[node.second_node];
+    };
+    auto get_leaf_gate_list = [&](UINT id) {
+        std::vector<QuantumGateBase*> gate_list;
+        std::vector<UINT> stack{id};
+        while (!stack.empty()) {
+            const DagNode& node = dag.node_list[stack.back()];
+            stack.pop_back();
+            if (node.first_node < 0) {
+                gate_list.push_back(node.gate);
+            } else {
+                stack.push_back(node.second_node);
+                stack.push_back(node.first_node);
+            }
+        }
+        return gate_list;
+    };
+    rewrite_circuit(circuit, dag, [&](UINT id) {
+        std::vector<QuantumGateBase*> gate_list;
+        std::vector<UINT> stack{id};
+        while (!stack.empty()) {
+            const UINT node_id = stack.back();
+            DagNode& node = dag.node_list[node_id];
+            stack.pop_back();
+            if (node.first_node < 0) {
+                gate_list.push_back(node.gate->copy());
+            } else if (!is_merge_chosen(node)) {
+                stack.push_back(node.second_node);
+                stack.push_back(node.first_node);
+            } else if (node.is_alive) {
+                node.is_merged = false;
+                gate_list.push_back(node.gate);
+            } else {
+                // the gates of merged nodes inside a tree have been deleted
+                gate_list.push_back(to_structured_gate(
+                    gate::merge(get_leaf_gate_list(node_id)), cost_model));
+            }
+        }
+        return gate_list;
+    });
+    LOG << "optimize_with_cost_model: " << gate_count << " gates -> "
+        << circuit->gate_list.size() << " gates with block size "
+        << best_block_size << ", predicted time " << best_total_time
+        << " s, in " << timer.elapsed() << " s" << std::endl;
+}
+
+////////////////////////////////////////////////////////////
+// for peephole optimization
+////////////////////////////////////////////////////////////
+
+static const double peephole_tolerance = 1e-12;
+
+static bool is_near(CPPCTYPE value1, CPPCTYPE value2) {
+    return std::abs(value1 - value2) < peephole_tolerance;
+}
+
+// unitary gates whose matrices are fixed
+static bool is_peephole_gate(const QuantumGateBase* gate) {
+    if (gate->is_parametric()) return false;
+    return dynamic_cast<const ClsOneQubitGate*>(gate) != nullptr ||
+           dynamic_cast<const ClsOneQubitRotationGate*>(gate) != nullptr ||
+           dynamic_cast<const ClsTwoQubitGate*>(gate) != nullptr ||
+           dynamic_cast<const ClsOneControlOneTargetGate*>(gate) != nullptr ||
+           dynamic_cast<const ClsPauliGate*>(gate) != nullptr ||
+           dynamic_cast<const ClsPauliRotationGate*>(gate) != nullptr ||
+           dynamic_cast<const QuantumGateMatrix*>(gate) != nullptr ||
+           dynamic_cast<const QuantumGateDiagonalMatrix*>(gate) != nullptr;
+}
+
+// A diagonal matrix gate which commutes with Z on its targets.
+static QuantumGateBase* create_diagonal_gate(const QuantumGateBase* gate,
+    const std::vector<CPPCTYPE>& diagonal_list) {
+    std::vector<TargetQubitInfo> target_list;
+    for (const auto& target : gate->target_qubit_list) {
+        target_list.push_back(TargetQubitInfo(target.index(), FLAG_Z_COMMUTE));
+    }
+    ComplexVector diagonal_element(diagonal_list.size());
+    for (UINT i = 0; i < diagonal_list.size(); ++i) {
+        diagonal_element(i) = diagonal_list[i];
+    }
+    return new QuantumGateDiagonalMatrix(
+        target_list, diagonal_element, gate->control_qubit_list);
+}
+
+// Find a faster gate with the same matrix as a gate, which is a named gate, a
+// Pauli gate or a diagonal matrix gate, in this order of preference. Return
+// nullptr if the gate is kept, and set is_identity if it acts as identity.
+static QuantumGateBase* get_specialized_gate(
+    const QuantumGateBase* gate, bool& is_identity) {
+    is_identity = false;
+    ComplexMatrix matrix;
+    gate->set_matrix(matrix);
+    const ITYPE dim = matrix.rows();
+
+    // a monomial matrix maps each basis state to another with a phase
+    std::vector<ITYPE> perm(dim);
+    std::vector<CPPCTYPE> phase(dim);
+    for (ITYPE column = 0; column < dim; ++column) {
+        UINT count = 0;
+        for (ITYPE row = 0; row < dim; ++row) {
+            if (std::abs(matrix(row, column)) < peephole_tolerance) continue;
+            perm[column] = row;
+            phase[column] = matrix(row, column);
+            ++count;
+        }
+        if (count != 1 || !is_near(std::abs(phase[column]), 1.)) {
+            return nullptr;
+        }
+    }
+    bool is_diagonal = true, is_permutation = true;
+    for (ITYPE i = 0; i < dim; ++i) {
+        is_diagonal = is_diagonal && perm[i] == i;
+        is_permutation = is_permutation && is_near(phase[i], 1.);
+    }
+    if (is_diagonal && is_permutation) {
+        is_identity = true;
+        return nullptr;
+    }
 
-                ind2--;
-                merged_flag = true;
+    const std::vector<UINT> target_list = gate->get_target_index_list();
+    const UINT target_count = (UINT)target_list.size();
+    const auto& control_list = gate->control_qubit_list;
+    // diagonal matrix gates created by users may not have the Z flags
+    const bool is_diagonal_gate =
+        dynamic_cast<const QuantumGateDiagonalMatrix*>(gate) != nullptr &&
+        gate->is_diagonal();
+    if (!control_list.empty()) {
+        if (control_list.size() == 1 && control_list[0].control_value() == 1 &&
+            target_count == 1) {
+            const UINT control = control_list[0].index();
+            if (is_permutation && perm[0] == 1) {
+                return gate::CNOT(control, target_list[0]);
+            }
+            if (is_diagonal && is_near(phase[0], 1.) &&
+                is_near(phase[1], -1.)) {
+                return gate::CZ(control, target_list[0]);
             }
         }
+        if (is_diagonal && !is_diagonal_gate) {
+            return create_diagonal_gate(gate, phase);
+        }
+        return nullptr;
+    }
+
+    // P|j> = i^|x & z| (-1)^|j & z| |j ^ x> for a Pauli string whose X and Z
+    // parts are x and z
+    const ITYPE x_mask = perm[0];
+    ITYPE z_mask = 0;
+    for (UINT i = 0; i < target_count; ++i) {
+        if (is_near(phase[1ULL << i], -phase[0])) z_mask |= 1ULL << i;
+    }
+    const CPPCTYPE power_list[4] = {1., 1.i, -1., -1.i};
+    bool is_Pauli = true;
+    for (ITYPE j = 0; j < dim && is_Pauli; ++j) {
+        const UINT y_count = count_population_cpp(x_mask & z_mask);
+        const double sign = count_population_cpp(j & z_mask) % 2 ? -1. : 1.;
+        is_Pauli = perm[j] == (j ^ x_mask) &&
+                   is_near(phase[j], power_list[y_count % 4] * sign);
+    }
+    if (is_Pauli) {
+        std::vector<UINT> index_list, pauli_id_list;
+        for (UINT i = 0; i < target_count; ++i) {
+            const bool x = x_mask >> i & 1, z = z_mask >> i & 1;
+            if (!x && !z) continue;
+            index_list.push_back(target_list[i]);
+            pauli_id_list.push_back(x ? (z ? 2 : 1) : 3);
+        }
+        if (index_list.size() > 1) {
+            return gate::Pauli(index_list, pauli_id_list);
+        }
+        switch (pauli_id_list[0]) {
+            case 1:
+                return gate::X(index_list[0]);
+            case 2:
+                return gate::Y(index_list[0]);
+            default:
+                return gate::Z(index_list[0]);
+        }
+    }
+
+    if (target_count == 2 && is_permutation) {
+        if (perm[1] == 2 && perm[2] == 1) {
+            return gate::SWAP(target_list[0], target_list[1]);
+        }
+        if (perm[1] == 3 && perm[3] == 1) {
+            return gate::CNOT(target_list[0], target_list[1]);
+        }
+        if (perm[2] == 3 && perm[3] == 2) {
+            return gate::CNOT(target_list[1], target_list[0]);
+        }
+    }
+    if (!is_diagonal) return nullptr;
+
+    if (target_count == 1 && is_near(phase[0], 1.)) {
+        const double angle = std::arg(phase[1]);
+        if (is_near(phase[1], 1.i)) return gate::S(target_list[0]);
+        if (is_near(phase[1], -1.i)) return gate::Sdag(target_list[0]);
+        if (is_near(angle, M_PI / 4)) return gate::T(target_list[0]);
+        if (is_near(angle, -M_PI / 4)) return gate::Tdag(target_list[0]);
     }
+    if (target_count == 1 && is_near(phase[0] * phase[1], 1.)) {
+        return gate::RZ(target_list[0], 2 * std::arg(phase[0]));
+    }
+    if (target_count == 2 && is_near(phase[0], 1.) && is_near(phase[1], 1.) &&
+        is_near(phase[2], 1.) && is_near(phase[3], -1.)) {
+        return gate::CZ(target_list[0], target_list[1]);
+    }
+    if (!is_diagonal_gate) return create_diagonal_gate(gate, phase);
+    return nullptr;
+}
+
+// Sum the angles of two rotations around the same axis.
+static bool merge_rotation(const QuantumGateBase* gate1,
+    const QuantumGateBase* gate2, QuantumGateBase*& merged_gate) {
+    auto rotation1 = dynamic_cast<const ClsOneQubitRotationGate*>(gate1);
+    auto rotation2 = dynamic_cast<const ClsOneQubitRotationGate*>(gate2);
+    if (rotation1 != nullptr && rotation2 != nullptr) {
+        const UINT target = gate1->target_qubit_list[0].index();
+        if (gate1->get_name() != gate2->get_name() ||
+            target != gate2->target_qubit_list[0].index())
+            return false;
+        const double angle = rotation1->get_angle() + rotation2->get_angle();
+        if (std::abs(angle) < peephole_tolerance) {
+            merged_gate = nullptr;
+        } else if (gate1->get_name() == "X-rotation") {
+            merged_gate = gate::RX(target, angle);
+        } else if (gate1->get_name() == "Y-rotation") {
+            merged_gate = gate::RY(target, angle);
+        } else {
+            merged_gate = gate::RZ(target, angle);
+        }
+        return true;
+    }
+    auto pauli_rotation1 = dynamic_cast<const ClsPauliRotationGate*>(gate1);
+    auto pauli_rotation2 = dynamic_cast<const ClsPauliRotationGate*>(gate2);
+    if (pauli_rotation1 != nullptr && pauli_rotation2 != nullptr) {
+        const PauliOperator* pauli1 = pauli_rotation1->get_pauli();
+        const PauliOperator* pauli2 = pauli_rotation2->get_pauli();
+        if (pauli1->get_index_list() != pauli2->get_index_list() ||
+            pauli1->get_pauli_id_list() != pauli2->get_pauli_id_list())
+            return false;
+        const double angle =
+            pauli_rotation1->get_angle() + pauli_rotation2->get_angle();
+        if (std::abs(angle) < peephole_tolerance) {
+            merged_gate = nullptr;
+        } else {
+            merged_gate = gate::PauliRotation(pauli1->get_index_list(),
+                pauli1->get_pauli_id_list(), angle);
+        }
+        return true;
+    }
+    return false;
+}
+
+// A gate is diagonal if it commutes with Z on all of its targets
+static bool is_diagonal_gate(const QuantumGateBase* gate) {
+    return gate->is_diagonal() ||
+           dynamic_cast<const QuantumGateDiagonalMatrix*>(gate) != nullptr;
+}
+
+void QuantumCircuitOptimizer::optimize_peephole(
+    QuantumCircuit* circuit_, UINT max_block_size) {
+    circuit = circuit_;
+
+    Timer timer;
+    const UINT gate_count = (UINT)circuit->gate_list.size();
+    // gates acting as identity are dropped, and matrix gates are replaced
+    // with faster gates
+    auto convert_func = [](QuantumGateBase* gate) -> QuantumGateBase* {
+        if (!is_peephole_gate(gate)) return gate;
+        bool is_identity;
+        QuantumGateBase* specialized_gate =
+            get_specialized_gate(gate, is_identity);
+        if (is_identity) return nullptr;
+        if (specialized_gate == nullptr) return gate;
+        if (dynamic_cast<const QuantumGateMatrix*>(gate) == nullptr &&
+            dynamic_cast<const QuantumGateDiagonalMatrix*>(gate) == nullptr) {
+            delete specialized_gate;
+            return gate;
+        }
+        return specialized_gate;
+    };
+    auto merge_func = [&](const QuantumGateBase* gate1,
+                          const QuantumGateBase* gate2,
+                          QuantumGateBase*& merged_gate) {
+        if (!is_peephole_gate(gate1) || !is_peephole_gate(gate2)) {
+            return false;
+        }
+        if (merge_rotation(gate1, gate2, merged_gate)) return true;
+
+        // Gates on the same qubits are merged only if the merged gate is
+        // identity or has a faster form, and diagonal gates are merged into
+        // a diagonal matrix gate while it is not too large.
+        std::vector<UINT> qubit_list1 = gate1->get_target_index_list();
+        std::vector<UINT> qubit_list2 = gate2->get_target_index_list();
+        for (UINT index : gate1->get_control_index_list()) {
+            qubit_list1.push_back(index);
+        }
+        for (UINT index : gate2->get_control_index_list()) {
+            qubit_list2.push_back(index);
+        }
+        std::sort(qubit_list1.begin(), qubit_list1.end());
+        std::sort(qubit_list2.begin(), qubit_list2.end());
+        const bool is_diagonal =
+            is_diagonal_gate(gate1) && is_diagonal_gate(gate2);
+        if (get_union_size(qubit_list1, qubit_list2) > max_block_size ||
+            (!is_diagonal && qubit_list1 != qubit_list2))
+            return false;
+
+        QuantumGateMatrix* product = gate::merge(gate1, gate2);
+        bool is_identity;
+        QuantumGateBase* specialized_gate =
+            get_specialized_gate(product, is_identity);
+        delete product;
+        if (!is_identity && specialized_gate == nullptr) return false;
+        merged_gate = specialized_gate;
+        return true;
+    };
+
+    GateDag dag(circuit->qubit_count, gate_count);
+    merge_on_dag(dag, circuit->gate_list, circuit->qubit_count, merge_func,
+        convert_func);
+    rewrite_circuit(circuit, dag, [&](UINT id) {
+        dag.node_list[id].is_merged = false;
+        return std::vector<QuantumGateBase*>{dag.node_list[id].gate};
+    });
+    LOG << "optimize_peephole: " << gate_count << " gates -> "
+        << circuit->gate_list.size() << " gates in " << timer.elapsed()
+        << " s" << std::endl;
+}
+
+////////////////////////////////////////////////////////////
+// for measurement-aware optimization
+////////////////////////////////////////////////////////////
+
+// Gates which are certainly unitary. Parametric gates are rotations.
+static bool is_unitary_gate(const QuantumGateBase* gate) {
+    if (gate->is_parametric()) return true;
+    if (dynamic_cast<const ClsOneQubitRotationGate*>(gate) != nullptr ||
+        dynamic_cast<const ClsTwoQubitGate*>(gate) != nullptr ||
+        dynamic_cast<const ClsOneControlOneTargetGate*>(gate) != nullptr ||
+        dynamic_cast<const ClsPauliGate*>(gate) != nullptr ||
+        dynamic_cast<const ClsPauliRotationGate*>(gate) != nullptr)
+        return true;
+    // projections and other matrices are not
+    if (dynamic_cast<const ClsOneQubitGate*>(gate) == nullptr &&
+        dynamic_cast<const QuantumGateMatrix*>(gate) == nullptr &&
+        dynamic_cast<const QuantumGateDiagonalMatrix*>(gate) == nullptr)
+        return false;
+    ComplexMatrix matrix;
+    gate->set_matrix(matrix);
+    return (matrix.adjoint() * matrix)
+        .isIdentity(peephole_tolerance * matrix.rows());
+}
+
+// Remove the gates outside the backward light cone of the measured qubits,
+// and the trailing gates which commute with the measurement on each qubit.
+// basis_list[qubit] is the class of the measured Pauli operators on the
+// qubit: COMMUTE_ALL if the qubit is not measured, and COMMUTE_NONE if
+// several Pauli operators are measured on it.
+static UINT remove_unobserved_gates(
+    QuantumCircuit* circuit, const std::vector<CommuteClass>& basis_list) {
+    const UINT gate_count = (UINT)circuit->gate_list.size();
+    std::vector<bool> is_in_cone(circuit->qubit_count);
+    std::vector<bool> is_blocked(circuit->qubit_count);
+    for (UINT qubit = 0; qubit < circuit->qubit_count; ++qubit) {
+        is_in_cone[qubit] = basis_list[qubit] != COMMUTE_ALL;
+    }
+    std::vector<bool> is_removed(gate_count);
+    for (UINT index = gate_count; index > 0; --index) {
+        const QuantumGateBase* gate = circuit->gate_list[index - 1];
+        std::vector<std::pair<UINT, CommuteClass>> qubit_class_list;
+        for (const auto& target : gate->target_qubit_list) {
+            qubit_class_list.push_back(std::make_pair(target.index(),
+                get_commute_class(target.get_merged_property(
+                    FLAG_X_COMMUTE | FLAG_Y_COMMUTE | FLAG_Z_COMMUTE))));
+        }
+        for (const auto& control : gate->control_qubit_list) {
+            qubit_class_list.push_back(
+                std::make_pair(control.index(), COMMUTE_Z));
+        }
+        bool touches_cone = false, commutes = true;
+        for (const auto& qubit_class : qubit_class_list) {
+            const UINT qubit = qubit_class.first;
+            const CommuteClass basis = basis_list[qubit];
+            touches_cone = touches_cone || is_in_cone[qubit];
+            commutes = commutes && !is_blocked[qubit] &&
+                       (basis == COMMUTE_ALL ||
+                           qubit_class.second == COMMUTE_ALL ||
+                           (basis != COMMUTE_NONE &&
+                               qubit_class.second == basis));
+        }
+
+        const bool is_unitary = is_unitary_gate(gate);
+        if (is_unitary && !gate->is_parametric() &&
+            (!touches_cone || commutes)) {
+            is_removed[index - 1] = true;
+            continue;
+        }
+        // a kept gate outside the cone does not change the measured qubits
+        // if it is unitary
+        for (const auto& qubit_class : qubit_class_list) {
+            if (touches_cone || !is_unitary) {
+                is_in_cone[qubit_class.first] = true;
+            }
+            is_blocked[qubit_class.first] = true;
+        }
+    }
+
+    // parameter positions are kept by remove_gate
+    const UINT removed_count =
+        (UINT)std::count(is_removed.begin(), is_removed.end(), true);
+    const bool has_parametric_gate = std::any_of(circuit->gate_list.begin(),
+        circuit->gate_list.end(),
+        [](const QuantumGateBase* gate) { return gate->is_parametric(); });
+    if (has_parametric_gate) {
+        for (UINT index = gate_count; index > 0; --index) {
+            if (is_removed[index - 1]) circuit->remove_gate(index - 1);
+        }
+    } else if (removed_count > 0) {
+        std::vector<QuantumGateBase*> new_gate_list;
+        for (UINT index = 0; index < gate_count; ++index) {
+            if (!is_removed[index]) {
+                new_gate_list.push_back(circuit->gate_list[index]->copy());
+            }
+        }
+        while (!circuit->gate_list.empty()) {
+            circuit->remove_gate((UINT)circuit->gate_list.size() - 1);
+        }
+        for (auto gate : new_gate_list) {
+            circuit->add_gate(gate);
+        }
+    }
+    return removed_count;
+}
+
+void QuantumCircuitOptimizer::optimize_for_measurement(
+    QuantumCircuit* circuit_, const std::vector<UINT>& measured_qubit_list) {
+    circuit = circuit_;
+    std::vector<CommuteClass> basis_list(circuit->qubit_count, COMMUTE_ALL);
+    for (UINT qubit : measured_qubit_list) {
+        if (qubit >= circuit->qubit_count) {
+            throw QubitIndexOutOfRangeException(
+                "Error: QuantumCircuitOptimizer::optimize_for_measurement("
+                "QuantumCircuit*, const std::vector<UINT>&): "
+                "measured qubit index is out of range");
+        }
+        basis_list[qubit] = COMMUTE_Z;
+    }
+    const UINT gate_count = (UINT)circuit->gate_list.size();
+    remove_unobserved_gates(circuit, basis_list);
+    LOG << "optimize_for_measurement: " << gate_count << " gates -> "
+        << circuit->gate_list.size() << " gates" << std::endl;
+}
+
+void QuantumCircuitOptimizer::optimize_for_observable(
+    QuantumCircuit* circuit_, const Observable& observable) {
+    circuit = circuit_;
+    if (observable.get_qubit_count() != circuit->qubit_count) {
+        throw InvalidQubitCountException(
+            "Error: QuantumCircuitOptimizer::optimize_for_observable("
+            "QuantumCircuit*, const Observable&): "
+            "qubit_count of circuit and observable must be the same");
+    }
+    std::vector<CommuteClass> basis_list(circuit->qubit_count, COMMUTE_ALL);
+    const CommuteClass pauli_class_list[4] = {
+        COMMUTE_ALL, COMMUTE_X, COMMUTE_Y, COMMUTE_Z};
+    for (UINT term_index = 0; term_index < observable.get_term_count();
+         ++term_index) {
+        const PauliOperator* term = observable.get_term(term_index);
+        const auto index_list = term->get_index_list();
+        const auto pauli_id_list = term->get_pauli_id_list();
+        for (UINT i = 0; i < index_list.size(); ++i) {
+            const CommuteClass pauli_class = pauli_class_list[pauli_id_list[i]];
+            CommuteClass& basis = basis_list[index_list[i]];
+            if (pauli_class == COMMUTE_ALL || basis == pauli_class) continue;
+            basis = (basis == COMMUTE_ALL) ? pauli_class : COMMUTE_NONE;
+        }
+    }
+    const UINT gate_count = (UINT)circuit->gate_list.size();
+    remove_unobserved_gates(circuit, basis_list);
+    LOG << "optimize_for_observable: " << gate_count << " gates -> "
+        << circuit->gate_list.size() << " gates" << std::endl;
 }
 
 void QuantumCircuitOptimizer::optimize_light(
@@ -200,7 +1125,8 @@ void QuantumCircuitOptimizer::optimize_light(
         if (std::includes(parent_qubits.begin(), parent_qubits.end(),
                 target_qubits.begin(), target_qubits.end())) {
             // we merge gates only when it does not interfere swap insertion
-            if (can_merge_with_swap_insertion(pos, ind1, swap_level)) {
+            if (can_merge_with_swap_insertion(
+                    circuit->gate_list[pos], gate, swap_level)) {
                 auto merged_gate = gate::merge(circuit->gate_list[pos], gate);
                 circuit->remove_gate(ind1);
                 circuit->add_gate(merged_gate, pos + 1);
@@ -236,6 +1162,187 @@ QuantumGateMatrix* QuantumCircuitOptimizer::merge_all(
     return current_gate;
 }
 
+////////////////////////////////////////////////////////////
+// for channel fusion
+////////////////////////////////////////////////////////////
+
+// Gates and channels which are fused into one gate. The qubits of the blocks
+// under construction are disjoint, so they commute with each other.
+struct ChannelBlock {
+    std::vector<UINT> qubit_list;
+    std::vector<const QuantumGateBase*> gate_list;
+    bool has_channel;
+};
+
+static std::vector<UINT> get_sorted_qubit_list(const QuantumGateBase* gate) {
+    std::vector<UINT> qubit_list = gate->get_target_index_list();
+    for (UINT index : gate->get_control_index_list()) {
+        qubit_list.push_back(index);
+    }
+    std::sort(qubit_list.begin(), qubit_list.end());
+    return qubit_list;
+}
+
+static bool is_channel(const QuantumGateBase* gate) {
+    return dynamic_cast<const QuantumGate_Probabilistic*>(gate) != NULL ||
+           dynamic_cast<const QuantumGate_CPTP*>(gate) != NULL;
+}
+
+static bool is_instrument(const QuantumGateBase* gate) {
+    if (auto probabilistic =
+            dynamic_cast<const QuantumGate_Probabilistic*>(gate)) {
+        return probabilistic->is_instrument_gate();
+    }
+    if (auto cptp = dynamic_cast<const QuantumGate_CPTP*>(gate)) {
+        return cptp->is_instrument_gate();
+    }
+    return false;
+}
+
+// A block with channels is converted to the CPTP-map with the fewest Kraus
+// operators, which are the eigenvectors of the Choi matrix
+// C[(r, r'), (c, c')] = S[(r, c), (r', c')] = sum_i K_i[r, r'] conj(K_i[c, c']).
+static QuantumGateBase* create_fused_gate(const ChannelBlock& block) {
+    if (block.gate_list.size() == 1) return block.gate_list[0]->copy();
+    if (!block.has_channel) {
+        std::vector<QuantumGateBase*> gate_list;
+        for (auto gate : block.gate_list) {
+            gate_list.push_back(const_cast<QuantumGateBase*>(gate));
+        }
+        return gate::merge(gate_list);
+    }
+
+    const ITYPE matrix_dim = 1ULL << block.qubit_list.size();
+    const ITYPE superoperator_dim = matrix_dim * matrix_dim;
+    ComplexMatrix superoperator =
+        ComplexMatrix::Identity(superoperator_dim, superoperator_dim);
+    for (auto gate : block.gate_list) {
+        ComplexMatrix gate_superoperator;
+        gate::get_superoperator(gate, block.qubit_list, gate_superoperator);
+        superoperator = gate_superoperator * superoperator;
+    }
+
+    Eigen::MatrixXcd choi(superoperator_dim, superoperator_dim);
+    for (ITYPE row = 0; row < matrix_dim; ++row) {
+        for (ITYPE row2 = 0; row2 < matrix_dim; ++row2) {
+            for (ITYPE column = 0; column < matrix_dim; ++column) {
+                for (ITYPE column2 = 0; column2 < matrix_dim; ++column2) {
+                    choi(row * matrix_dim + row2, column * matrix_dim + column2) =
+                        superoperator(
+                            row * matrix_dim + column, row2 * matrix_dim + column2);
+                }
+            }
+        }
+    }
+    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXcd> solver(choi);
+    const Eigen::VectorXd& eigenvalues = solver.eigenvalues();
+    const double tolerance = 1e-12 * eigenvalues(superoperator_dim - 1);
+
+    // Kraus operators in descending order of their weights
+    std::vector<QuantumGateBase*> kraus_list;
+    for (ITYPE index = superoperator_dim; index > 0; --index) {
+        const double eigenvalue = eigenvalues(index - 1);
+        if (eigenvalue <= tolerance) break;
+        const Eigen::VectorXcd eigenvector =
+            sqrt(eigenvalue) * solver.eigenvectors().col(index - 1);
+        ComplexMatrix kraus(matrix_dim, matrix_dim);
+        for (ITYPE row = 0; row < matrix_dim; ++row) {
+            for (ITYPE row2 = 0; row2 < matrix_dim; ++row2) {
+                kraus(row, row2) = eigenvector(row * matrix_dim + row2);
+            }
+        }
+        kraus_list.push_back(gate::DenseMatrix(block.qubit_list, kraus));
+    }
+    QuantumGateBase* fused_gate = gate::CPTP(kraus_list);
+    for (auto kraus : kraus_list) delete kraus;
+    return fused_gate;
+}
+
+void QuantumCircuitOptimizer::optimize_channel(
+    QuantumCircuit* circuit_, UINT max_block_size) {
+    if (max_block_size == 0 ||
+        max_block_size > superoperator_max_qubit_count) {
+        throw InvalidQubitCountException(
+            "Error: QuantumCircuitOptimizer::optimize_channel("
+            "QuantumCircuit*, UINT): max_block_size must be between 1 and " +
+            std::to_string(superoperator_max_qubit_count));
+    }
+    circuit = circuit_;
+
+    std::vector<QuantumGateBase*> new_gate_list;
+    std::vector<ChannelBlock> block_list;
+    for (auto gate : circuit->gate_list) {
+        const std::vector<UINT> qubit_list = get_sorted_qubit_list(gate);
+        ComplexMatrix superoperator;
+        const bool can_fuse = qubit_list.size() <= max_block_size &&
+                              !gate->is_parametric() && !is_instrument(gate) &&
+                              gate::get_superoperator(
+                                  gate, qubit_list, superoperator);
+
+        // blocks which share qubits with the gate
+        std::vector<UINT> overlap_list;
+        std::vector<UINT> merged_qubit_list = qubit_list;
+        for (UINT block_index = 0; block_index < block_list.size();
+             ++block_index) {
+            const std::vector<UINT>& block_qubit_list =
+                block_list[block_index].qubit_list;
+            std::vector<UINT> common_qubit_list;
+            std::set_intersection(qubit_list.begin(), qubit_list.end(),
+                block_qubit_list.begin(), block_qubit_list.end(),
+                std::back_inserter(common_qubit_list));
+            if (common_qubit_list.empty()) continue;
+            overlap_list.push_back(block_index);
+            std::vector<UINT> union_qubit_list;
+            std::set_union(merged_qubit_list.begin(), merged_qubit_list.end(),
+                block_qubit_list.begin(), block_qubit_list.end(),
+                std::back_inserter(union_qubit_list));
+            merged_qubit_list = union_qubit_list;
+        }
+
+        ChannelBlock new_block;
+        new_block.has_channel = false;
+        if (can_fuse && merged_qubit_list.size() <= max_block_size) {
+            // merge the overlapping blocks and the gate into one block
+            new_block.qubit_list = merged_qubit_list;
+            for (UINT block_index : overlap_list) {
+                const ChannelBlock& block = block_list[block_index];
+                new_block.gate_list.insert(new_block.gate_list.end(),
+                    block.gate_list.begin(), block.gate_list.end());
+                new_block.has_channel |= block.has_channel;
+            }
+        } else {
+            for (UINT block_index : overlap_list) {
+                new_gate_list.push_back(
+                    create_fused_gate(block_list[block_index]));
+            }
+            new_block.qubit_list = qubit_list;
+        }
+        for (auto ite = overlap_list.rbegin(); ite != overlap_list.rend();
+             ++ite) {
+            block_list.erase(block_list.begin() + *ite);
+        }
+        if (can_fuse) {
+            new_block.gate_list.push_back(gate);
+            new_block.has_channel |= is_channel(gate);
+            block_list.push_back(new_block);
+        } else {
+            new_gate_list.push_back(gate->copy());
+        }
+    }
+    for (const ChannelBlock& block : block_list) {
+        new_gate_list.push_back(create_fused_gate(block));
+    }
+
+    LOG << "optimize_channel: " << circuit->gate_list.size() << " gates -> "
+        << new_gate_list.size() << " gates" << std::endl;
+    while (!circuit->gate_list.empty()) {
+        circuit->remove_gate((UINT)circuit->gate_list.size() - 1);
+    }
+    for (auto gate : new_gate_list) {
+        circuit->add_gate(gate);
+    }
+}
+
 ////////////////////////////////////////////////////////////
 // for swap insertion
 ////////////////////////////////////////////////////////////
@@ -419,22 +1526,22 @@ void QuantumCircuitOptimizer::set_qubit_count(void) {
 }
 
 bool QuantumCircuitOptimizer::can_merge_with_swap_insertion(
-    UINT gate_idx1, UINT gate_idx2, UINT swap_level) {
+    const QuantumGateBase* gate1, const QuantumGateBase* gate2,
+    UINT swap_level) {
     // if swap insertion is disabled, can merge
     if (swap_level == 0) {
         return true;
     }
 
-    auto& gate1 = circuit->gate_list[gate_idx1];
-    auto& gate2 = circuit->gate_list[gate_idx2];
-
     auto is_global_qubit = [&](auto idx) { return idx >= local_qc; };
 
-    auto is_swap_or_nocomm_gate_with_global_target = [&](QuantumGateBase* g) {
-        auto targets = g->get_target_index_list();
-        return (is_swap_gate(g) || is_non_communication_gate(g)) &&
-               std::any_of(targets.cbegin(), targets.cend(), is_global_qubit);
-    };
+    auto is_swap_or_nocomm_gate_with_global_target =
+        [&](const QuantumGateBase* g) {
+            auto targets = g->get_target_index_list();
+            return (is_swap_gate(g) || is_non_communication_gate(g)) &&
+                   std::any_of(
+                       targets.cbegin(), targets.cend(), is_global_qubit);
+        };
 
     if (is_swap_or_nocomm_gate_with_global_target(gate1) ||
         is_swap_or_nocomm_gate_with_global_target(gate2)) {
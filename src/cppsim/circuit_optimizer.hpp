@@ -7,6 +7,9 @@
 #include "exception.hpp"
 #include "type.hpp"
 
+class GateCostModel;
+class HermitianQuantumOperator;
+using Observable = HermitianQuantumOperator;
 class QuantumCircuit;
 class QuantumGateBase;
 class QuantumGateMatrix;
@@ -26,17 +29,13 @@ private:
     UINT mpisize;     /**< \~japanese-en MPIプロセスの数*/
     UINT mpirank;     /**< \~japanese-en MPIプロセスのランク*/
     bool log_enabled; /**< \~japanese-en ログ出力が有効かどうか*/
-    UINT get_rightmost_commute_index(UINT gate_index);
-    UINT get_leftmost_commute_index(UINT gate_index);
-    UINT get_merged_gate_size(UINT gate_index1, UINT gate_index2);
-    bool is_neighboring(UINT gate_index1, UINT gate_index2);
 
     ////////////////////////////////////////////////////////////
     // for swap insertion
     ////////////////////////////////////////////////////////////
     void set_qubit_count(void);
-    bool can_merge_with_swap_insertion(
-        UINT gate_idx1, UINT gate_idx2, UINT swap_level);
+    bool can_merge_with_swap_insertion(const QuantumGateBase* gate1,
+        const QuantumGateBase* gate2, UINT swap_level);
     bool needs_communication(const UINT gate_index, const QubitTable& qt);
     UINT move_gates_without_communication(const UINT gate_idx,
         const QubitTable& qt,
@@ -96,9 +95,12 @@ public:
     /**
      * \~japanese-en 与えられた量子回路のゲートを指定されたブロックまで纏める。
      *
-     * 与えられた量子回路において、若い添え字から任意の二つのゲートを選び、二つが他のゲートに影響を与えず合成可能なら合成を行う。
-     * これを合成可能なペアがなくなるまで繰り返す。
+     * 与えられた量子回路において、二つのゲートが他のゲートに影響を与えず合成可能なら合成を行う。
      * 二つのゲートが合成可能であるとは、二つのゲートそれぞれについて隣接するゲートとの交換を繰り返し、二つのゲートが隣接した位置まで移動できることを指す。
+     * ゲートの依存関係を、交換できないゲートの間に辺を持つ有向非巡回グラフとして前から順に構築し、
+     * 追加したゲートと各量子ビット上および回路全体で近くにあるゲートとの合成を試みる。
+     * 合成のたびにグラフを局所的に更新し、合成可能なペアがなくなるまで繰り返す。
+     * パラメトリックゲートは合成しない。
      *
      * @param[in] circuit 量子回路のインスタンス
      * @param[in] max_block_size 合成後に許されるブロックの最大サイズ
@@ -108,6 +110,66 @@ public:
     void optimize(
         QuantumCircuit* circuit, UINT max_block_size = 2, UINT swap_level = 0);
 
+    /**
+     * \~japanese-en コストモデルによる予測実行時間が最小になるようにゲートを纏める。
+     *
+     * 合成後の量子ビット数の上限kごとにoptimizeと同様にゲートを纏め、合成の過程を二分木として記録する。
+     * 木の各節点では、合成したゲートと合成前のゲート列のうち予測実行時間の短い方を選ぶ。
+     * 合成したゲートが対角行列であれば対角行列ゲートに変換し、共通のコントロール量子ビットはそのまま保つ。
+     * 予測実行時間の合計が最小となるkでの結果を用いる。
+     * パラメトリックゲートやコストモデルに含まれないゲートは纏めない。
+     *
+     * @param[in] circuit 量子回路のインスタンス
+     * @param[in] cost_model
+     * ゲートの実行時間を予測するコストモデル。量子ビット数は量子回路と等しい必要がある
+     */
+    void optimize_with_cost_model(
+        QuantumCircuit* circuit, const GateCostModel& cost_model);
+
+    /**
+     * \~japanese-en 名前付きのゲートを保ったまま量子回路を書き換える。
+     *
+     * optimizeと同様の依存関係のグラフ上で、隣接できるゲートの組に次の書き換えを行う。
+     * 積が恒等演算子となるゲートの組を取り除き、同じ軸や同じパウリ演算子の回転ゲートは回転角を足し合わせる。
+     * 対角なゲートは交換して集め、max_block_size量子ビット以下の一つの対角行列ゲートに纏める。
+     * 同じ量子ビットに作用するゲートの組は、積が名前付きのゲート、パウリゲート、対角行列ゲートで表せる場合にのみ纏める。
+     * また、行列ゲートのうち数値的に恒等演算子、パウリ演算子、置換、対角行列であるものは対応するゲートに置き換える。
+     * パラメトリックゲートは書き換えない。
+     *
+     * @param[in] circuit 量子回路のインスタンス
+     * @param[in] max_block_size 纏めた後のゲートが作用する量子ビット数の上限
+     */
+    void optimize_peephole(QuantumCircuit* circuit, UINT max_block_size = 3);
+
+    /**
+     * \~japanese-en 指定した量子ビットを計算基底で測定する場合に、測定結果に影響しないゲートを取り除く。
+     *
+     * 測定する量子ビットから後ろ向きにたどった光円錐の外にあるユニタリなゲートと、
+     * 回路の末尾にあり測定と可換なゲート (対角なゲートなど) を取り除く。
+     * 書き換えた回路は測定する量子ビットの周辺分布のみを保ち、元の回路と等価なユニタリではない。
+     * パラメトリックゲート、およびノイズや測定などユニタリでないゲートは取り除かない。
+     *
+     * @param[in] circuit 量子回路のインスタンス
+     * @param[in] measured_qubit_list 測定する量子ビットの添え字のリスト
+     */
+    void optimize_for_measurement(QuantumCircuit* circuit,
+        const std::vector<UINT>& measured_qubit_list);
+
+    /**
+     * \~japanese-en オブザーバブルの期待値に影響しないゲートを取り除く。
+     *
+     * オブザーバブルの各項が作用する量子ビットから後ろ向きにたどった光円錐の外にあるユニタリなゲートと、
+     * 回路の末尾にあり各量子ビット上でオブザーバブルと可換なゲートを取り除く。
+     * 量子ビット上に異なるパウリ演算子が現れる場合、その量子ビット上で可換とはみなさない。
+     * 書き換えた回路は期待値のみを保ち、元の回路と等価なユニタリではない。
+     * パラメトリックゲート、およびノイズや測定などユニタリでないゲートは取り除かない。
+     *
+     * @param[in] circuit 量子回路のインスタンス
+     * @param[in] observable 期待値を求めるオブザーバブル
+     */
+    void optimize_for_observable(
+        QuantumCircuit* circuit, const Observable& observable);
+
     /**
      * \~japanese-en 与えられた量子回路のゲートを指定されたブロックまで纏める。
      *
@@ -121,6 +183,19 @@ public:
      */
     void optimize_light(QuantumCircuit* circuit, UINT swap_level = 0);
 
+    /**
+     * \~japanese-en 密度行列のシミュレーションのために、ゲートとノイズを指定されたブロックまで纏める。
+     *
+     * 前から順にゲートを見て、作用する量子ビットが重なるゲートとノイズを、量子ビット数がmax_block_size以下である限り一つのブロックに纏める。
+     * ノイズを含むブロックは最小個数のKraus演算子からなるCPTP-mapに、ユニタリなゲートのみのブロックは行列ゲートに変換される。
+     * パラメトリックゲート、古典レジスタに書き込むゲート、行列で表せないゲートは纏めない。
+     * 密度行列に対してCPTP-mapや確率的なゲートはsuperoperatorとして1回の走査で作用する。
+     *
+     * @param[in] circuit 量子回路のインスタンス
+     * @param[in] max_block_size 合成後に許されるブロックの最大サイズ。superoperator_max_qubit_count以下
+     */
+    void optimize_channel(QuantumCircuit* circuit, UINT max_block_size = 2);
+
     /**
      * \~japanese-en 量子回路を纏めて一つの巨大な量子ゲートにする
      *
@@ -0,0 +1,232 @@
+#include "compiled_circuit.hpp"
+
+#include <csim/update_ops.hpp>
+
+#include "circuit.hpp"
+#include "gate.hpp"
+#include "gate_matrix.hpp"
+#include "gate_matrix_diagonal.hpp"
+#include "gate_named_one.hpp"
+#include "gate_named_pauli.hpp"
+#include "gate_named_two.hpp"
+#include "state.hpp"
+
+CompiledCircuit::CompiledCircuit(const QuantumCircuit* circuit)
+    : _qubit_count(circuit->qubit_count) {
+    _instruction_list.reserve(circuit->gate_list.size());
+    for (QuantumGateBase* gate : circuit->gate_list) {
+        this->add_instruction(gate);
+    }
+    for (Instruction& instruction : _instruction_list) {
+        instruction.target_list = _index_arena.data() + instruction.index_offset;
+        instruction.control_list =
+            instruction.target_list + instruction.target_count;
+        instruction.matrix = _matrix_arena.data() + instruction.matrix_offset;
+    }
+}
+
+void CompiledCircuit::add_instruction(QuantumGateBase* gate) {
+    Instruction instruction = Instruction();
+    instruction.type = GENERIC_GATE;
+    instruction.gate = gate;
+    instruction.index_offset = _index_arena.size();
+    instruction.matrix_offset = _matrix_arena.size();
+
+    if (auto named = dynamic_cast<const ClsOneQubitGate*>(gate)) {
+        instruction.type = ONE_QUBIT;
+        instruction.qubit_index_0 = named->_target_qubit_list[0].index();
+        instruction.one_qubit_func = named->_update_func;
+    } else if (auto rotation =
+                   dynamic_cast<const ClsOneQubitRotationGate*>(gate)) {
+        instruction.type = ONE_QUBIT_ROTATION;
+        instruction.qubit_index_0 = rotation->_target_qubit_list[0].index();
+        instruction.angle = rotation->_angle;
+        instruction.rotation_func = rotation->_update_func;
+    } else if (auto two = dynamic_cast<const ClsTwoQubitGate*>(gate)) {
+        instruction.type = TWO_QUBIT;
+        instruction.qubit_index_0 = two->_target_qubit_list[0].index();
+        instruction.qubit_index_1 = two->_target_qubit_list[1].index();
+        instruction.two_qubit_func = two->_update_func;
+    } else if (auto controlled =
+                   dynamic_cast<const ClsOneControlOneTargetGate*>(gate)) {
+        instruction.type = TWO_QUBIT;
+        instruction.qubit_index_0 = controlled->_control_qubit_list[0].index();
+        instruction.qubit_index_1 = controlled->_target_qubit_list[0].index();
+        instruction.two_qubit_func = controlled->_update_func;
+    } else if (dynamic_cast<const QuantumGateMatrix*>(gate) != nullptr) {
+        // the same kernels as QuantumGateMatrix::update_quantum_state
+        const UINT control_count = (UINT)gate->control_qubit_list.size();
+        instruction.type = (control_count == 0)   ? DENSE_MATRIX
+                           : (control_count == 1) ? SINGLE_CONTROL_DENSE_MATRIX
+                                                  : MULTI_CONTROL_DENSE_MATRIX;
+        ComplexMatrix matrix;
+        gate->set_matrix(matrix);
+        const CTYPE* matrix_ptr = reinterpret_cast<const CTYPE*>(matrix.data());
+        _matrix_arena.insert(
+            _matrix_arena.end(), matrix_ptr, matrix_ptr + matrix.size());
+    } else if (auto diagonal =
+                   dynamic_cast<const QuantumGateDiagonalMatrix*>(gate)) {
+        instruction.type = diagonal->control_qubit_list.empty()
+                               ? DIAGONAL_MATRIX
+                               : MULTI_CONTROL_DIAGONAL_MATRIX;
+        const CTYPE* diagonal_ptr =
+            reinterpret_cast<const CTYPE*>(diagonal->_diagonal_element.data());
+        _matrix_arena.insert(_matrix_arena.end(), diagonal_ptr,
+            diagonal_ptr + diagonal->_diagonal_element.size());
+    } else if (auto pauli = dynamic_cast<const ClsPauliGate*>(gate)) {
+        instruction.type = PAULI;
+        auto pauli_id_list = pauli->_pauli->get_pauli_id_list();
+        instruction.target_count = (UINT)pauli_id_list.size();
+        for (UINT index : pauli->_pauli->get_index_list()) {
+            _index_arena.push_back(index);
+        }
+        // Pauli ids take the place of the control list
+        _index_arena.insert(
+            _index_arena.end(), pauli_id_list.begin(), pauli_id_list.end());
+    } else if (auto pauli_rotation =
+                   dynamic_cast<const ClsPauliRotationGate*>(gate)) {
+        instruction.type = PAULI_ROTATION;
+        instruction.angle = pauli_rotation->_angle;
+        auto pauli_id_list = pauli_rotation->_pauli->get_pauli_id_list();
+        instruction.target_count = (UINT)pauli_id_list.size();
+        for (UINT index : pauli_rotation->_pauli->get_index_list()) {
+            _index_arena.push_back(index);
+        }
+        _index_arena.insert(
+            _index_arena.end(), pauli_id_list.begin(), pauli_id_list.end());
+    }
+
+    if (instruction.type >= DENSE_MATRIX &&
+        instruction.type <= MULTI_CONTROL_DIAGONAL_MATRIX) {
+        instruction.target_count = (UINT)gate->target_qubit_list.size();
+        instruction.control_count = (UINT)gate->control_qubit_list.size();
+        for (const auto& target : gate->target_qubit_list) {
+            _index_arena.push_back(target.index());
+        }
+        for (const auto& control : gate->control_qubit_list) {
+            _index_arena.push_back(control.index());
+        }
+        for (const auto& control : gate->control_qubit_list) {
+            _index_arena.push_back(control.control_value());
+        }
+    }
+    _instruction_list.push_back(instruction);
+}
+
+UINT CompiledCircuit::get_generic_instruction_count() const {
+    UINT count = 0;
+    for (const Instruction& instruction : _instruction_list) {
+        if (instruction.type == GENERIC_GATE) ++count;
+    }
+    return count;
+}
+
+void CompiledCircuit::update_quantum_state(QuantumStateBase* state) const {
+    if (state->qubit_count != _qubit_count) {
+        throw InvalidQubitCountException(
+            "Error: "
+            "CompiledCircuit::update_quantum_state(QuantumStateBase) : "
+            "invalid qubit count");
+    }
+
+    bool use_kernel = state->is_state_vector() &&
+                      !state->is_single_precision() &&
+                      state->get_device_name() == "cpu";
+#ifdef _USE_MPI
+    use_kernel = use_kernel && state->outer_qc == 0;
+#endif
+    if (!use_kernel) {
+        for (const Instruction& instruction : _instruction_list) {
+            instruction.gate->update_quantum_state(state);
+        }
+        return;
+    }
+
+    CTYPE* state_ptr = state->data_c();
+    const ITYPE dim = state->dim;
+    for (const Instruction& instruction : _instruction_list) {
+        const UINT* target_list = instruction.target_list;
+        const UINT* control_list = instruction.control_list;
+        const UINT* control_value_list =
+            control_list + instruction.control_count;
+        switch (instruction.type) {
+            case ONE_QUBIT:
+                instruction.one_qubit_func(
+                    instruction.qubit_index_0, state_ptr, dim);
+                break;
+            case ONE_QUBIT_ROTATION:
+                instruction.rotation_func(instruction.qubit_index_0,
+                    instruction.angle, state_ptr, dim);
+                break;
+            case TWO_QUBIT:
+                instruction.two_qubit_func(instruction.qubit_index_0,
+                    instruction.qubit_index_1, state_ptr, dim);
+                break;
+            case DENSE_MATRIX:
+                if (instruction.target_count == 1) {
+                    single_qubit_dense_matrix_gate(
+                        target_list[0], instruction.matrix, state_ptr, dim);
+                } else {
+                    multi_qubit_dense_matrix_gate(target_list,
+                        instruction.target_count, instruction.matrix,
+                        state_ptr, dim);
+                }
+                break;
+            case SINGLE_CONTROL_DENSE_MATRIX:
+                if (instruction.target_count == 1) {
+                    single_qubit_control_single_qubit_dense_matrix_gate(
+                        control_list[0], control_value_list[0], target_list[0],
+                        instruction.matrix, state_ptr, dim);
+                } else {
+                    single_qubit_control_multi_qubit_dense_matrix_gate(
+                        control_list[0], control_value_list[0], target_list,
+                        instruction.target_count, instruction.matrix,
+                        state_ptr, dim);
+                }
+                break;
+            case MULTI_CONTROL_DENSE_MATRIX:
+                if (instruction.target_count == 1) {
+                    multi_qubit_control_single_qubit_dense_matrix_gate(
+                        control_list, control_value_list,
+                        instruction.control_count, target_list[0],
+                        instruction.matrix, state_ptr, dim);
+                } else {
+                    multi_qubit_control_multi_qubit_dense_matrix_gate(
+                        control_list, control_value_list,
+                        instruction.control_count, target_list,
+                        instruction.target_count, instruction.matrix,
+                        state_ptr, dim);
+                }
+                break;
+            case DIAGONAL_MATRIX:
+                if (instruction.target_count == 1) {
+                    single_qubit_diagonal_matrix_gate(
+                        target_list[0], instruction.matrix, state_ptr, dim);
+                } else {
+                    multi_qubit_diagonal_matrix_gate(target_list,
+                        instruction.target_count, instruction.matrix,
+                        state_ptr, dim);
+                }
+                break;
+            case MULTI_CONTROL_DIAGONAL_MATRIX:
+                multi_qubit_control_multi_qubit_diagonal_matrix_gate(
+                    control_list, control_value_list,
+                    instruction.control_count, target_list,
+                    instruction.target_count, instruction.matrix, state_ptr,
+                    dim);
+                break;
+            case PAULI:
+                multi_qubit_Pauli_gate_partial_list(target_list, control_list,
+                    instruction.target_count, state_ptr, dim);
+                break;
+            case PAULI_ROTATION:
+                multi_qubit_Pauli_rotation_gate_partial_list(target_list,
+                    control_list, instruction.target_count, instruction.angle,
+                    state_ptr, dim);
+                break;
+            case GENERIC_GATE:
+                instruction.gate->update_quantum_state(state);
+                break;
+        }
+    }
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <vector>
+
+#include "type.hpp"
+
+class QuantumCircuit;
+class QuantumGateBase;
+class QuantumStateBase;
+
+/**
+ * \~japanese-en 量子回路を平坦な命令列に変換したクラス
+ *
+ * 量子回路の各ゲートを、呼び出すcsimのカーネル、作用する量子ビットの添え字、行列要素を
+ * あらかじめ解決した命令に変換して連続した配列に保持する。
+ * 実行時には仮想関数呼び出し、デバイス名の比較、添え字のリストの確保を行わずにカーネルを順に呼び出す。
+ * 名前付きのゲート、行列ゲート、対角行列ゲート、Pauliゲート、Pauli回転ゲート以外のゲート
+ * (ノイズ、測定、パラメトリックゲートなど)は、元のゲートのupdate_quantum_stateを呼び出す命令となる。
+ *
+ * 生成後は変更されない。行列要素は命令列にコピーされるが、上記以外のゲートは元の量子回路のゲートを参照するため、
+ * 元の量子回路が解放されるまでの間のみ有効である。
+ */
+class DllExport CompiledCircuit {
+private:
+    using OneQubitFunc = void (*)(UINT, CTYPE*, ITYPE);
+    using RotationFunc = void (*)(UINT, double, CTYPE*, ITYPE);
+    using TwoQubitFunc = void (*)(UINT, UINT, CTYPE*, ITYPE);
+
+    enum InstructionType {
+        ONE_QUBIT,
+        ONE_QUBIT_ROTATION,
+        TWO_QUBIT,
+        DENSE_MATRIX,
+        SINGLE_CONTROL_DENSE_MATRIX,
+        MULTI_CONTROL_DENSE_MATRIX,
+        DIAGONAL_MATRIX,
+        MULTI_CONTROL_DIAGONAL_MATRIX,
+        PAULI,
+        PAULI_ROTATION,
+        GENERIC_GATE
+    };
+
+    struct Instruction {
+        InstructionType type;
+        UINT target_count;
+        UINT control_count;
+        UINT qubit_index_0;
+        UINT qubit_index_1;
+        double angle;
+        OneQubitFunc one_qubit_func;
+        RotationFunc rotation_func;
+        TwoQubitFunc two_qubit_func;
+        // offsets into the arenas, resolved to the pointers below once the
+        // arenas stop growing
+        ITYPE index_offset;
+        ITYPE matrix_offset;
+        const UINT* target_list;
+        const UINT* control_list; /**< control values follow the indices */
+        const CTYPE* matrix;
+        QuantumGateBase* gate;
+    };
+
+    UINT _qubit_count;
+    std::vector<Instruction> _instruction_list;
+    std::vector<UINT> _index_arena;
+    std::vector<CTYPE> _matrix_arena;
+
+    void add_instruction(QuantumGateBase* gate);
+
+public:
+    /**
+     * \~japanese-en 量子回路を命令列に変換する
+     *
+     * @param circuit 変換する量子回路
+     */
+    explicit CompiledCircuit(const QuantumCircuit* circuit);
+
+    CompiledCircuit(const CompiledCircuit&) = delete;
+    CompiledCircuit& operator=(const CompiledCircuit&) = delete;
+
+    /**
+     * \~japanese-en 量子状態を更新する
+     *
+     * 結果はQuantumCircuit::update_quantum_stateと一致する。
+     * CPU上の倍精度の状態ベクトル以外では、元のゲートを順に適用する。
+     * @param state 更新する量子状態
+     */
+    void update_quantum_state(QuantumStateBase* state) const;
+
+    /**
+     * \~japanese-en 命令の数を取得する
+     *
+     * @return 命令の数
+     */
+    UINT get_instruction_count() const {
+        return (UINT)_instruction_list.size();
+    }
+
+    /**
+     * \~japanese-en 元のゲートのupdate_quantum_stateを呼び出す命令の数を取得する
+     *
+     * @return 元のゲートを呼び出す命令の数
+     */
+    UINT get_generic_instruction_count() const;
+};
@@ -2,12 +2,14 @@
 
 #include <algorithm>
 #include <cassert>
+#include <csim/update_ops_float.hpp>
 #include <functional>
 #include <sstream>
 
 #include "exception.hpp"
 #include "gate_matrix.hpp"
 #include "gate_merge.hpp"
+#include "state.hpp"
 
 bool QuantumGateBase::is_commute(const QuantumGateBase* gate) const {
     for (auto val1 : this->_target_qubit_list) {
@@ -59,6 +61,52 @@ bool QuantumGateBase::is_diagonal() const {
     // return true;
 }
 
+void QuantumGateBase::update_single_precision_state(
+    QuantumStateBase* state) const {
+    if (!state->is_state_vector()) {
+        throw NotImplementedException(
+            "Error: QuantumGateBase::update_single_precision_state("
+            "QuantumStateBase*): single precision density matrix is not "
+            "supported");
+    }
+    std::vector<UINT> target_index = this->get_target_index_list();
+    std::vector<UINT> control_index = this->get_control_index_list();
+    std::vector<UINT> control_value = this->get_control_value_list();
+    ComplexMatrix matrix;
+    this->set_matrix(matrix);
+    // ComplexMatrix is row-major as the csim kernels expect
+    const CTYPE* matrix_ptr = reinterpret_cast<const CTYPE*>(matrix.data());
+    CTYPE_F* state_ptr = reinterpret_cast<CTYPE_F*>(state->data());
+    const UINT target_count = (UINT)target_index.size();
+
+    // diagonal gates are not always flagged as commuting with Z
+    if (control_index.empty() &&
+        (this->is_diagonal() || matrix.isDiagonal(0.))) {
+        std::vector<CTYPE> diagonal(matrix.rows());
+        for (ITYPE i = 0; i < (ITYPE)matrix.rows(); ++i) {
+            diagonal[i] = matrix(i, i);
+        }
+        if (target_count == 1) {
+            float_single_qubit_diagonal_matrix_gate(
+                target_index[0], diagonal.data(), state_ptr, state->dim);
+        } else {
+            float_multi_qubit_diagonal_matrix_gate(target_index.data(),
+                target_count, diagonal.data(), state_ptr, state->dim);
+        }
+    } else if (control_index.empty() && target_count == 1) {
+        float_single_qubit_dense_matrix_gate(
+            target_index[0], matrix_ptr, state_ptr, state->dim);
+    } else if (control_index.empty()) {
+        float_multi_qubit_dense_matrix_gate(target_index.data(), target_count,
+            matrix_ptr, state_ptr, state->dim);
+    } else {
+        float_multi_qubit_control_multi_qubit_dense_matrix_gate(
+            control_index.data(), control_value.data(),
+            (UINT)control_index.size(), target_index.data(), target_count,
+            matrix_ptr, state_ptr, state->dim);
+    }
+}
+
 UINT QuantumGateBase::get_property_value() const {
     return this->_gate_property;
 }
@@ -101,6 +101,14 @@ protected:
     };
     QuantumGateBase& operator=(const QuantumGateBase& rhs) = delete;
 
+    /**
+     * \~japanese-en 単精度の状態ベクトルをゲート行列で更新する
+     *
+     * 専用の単精度関数を持たないゲートは、set_matrixで得た行列を単精度の汎用関数で作用させる。
+     * @param state 更新する単精度の量子状態
+     */
+    void update_single_precision_state(QuantumStateBase* state) const;
+
 public:
     /**
      * \~japanese-en デストラクタ
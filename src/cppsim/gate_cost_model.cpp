@@ -0,0 +1,161 @@
+#include "gate_cost_model.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <csim/update_ops.hpp>
+#include <functional>
+
+#include "exception.hpp"
+#include "gate.hpp"
+#include "gate_matrix.hpp"
+#include "gate_matrix_diagonal.hpp"
+#include "gate_named_one.hpp"
+#include "gate_named_pauli.hpp"
+#include "gate_named_two.hpp"
+#include "utility.hpp"
+
+GateCostModel::GateCostModel(
+    UINT qubit_count, UINT max_target_count, bool calibrate)
+    : _qubit_count(qubit_count),
+      _max_target_count(
+          std::min(max_target_count, std::max(qubit_count, 2U) - 1)),
+      _kernel_time(KERNEL_TYPE_COUNT, std::vector<double>(_max_target_count)) {
+    if (qubit_count < 2 || max_target_count == 0) {
+        throw InvalidQubitCountException(
+            "Error: GateCostModel::GateCostModel(UINT, UINT, bool): "
+            "qubit_count must be at least 2 and max_target_count must be "
+            "positive");
+    }
+    if (calibrate) this->calibrate();
+}
+
+void GateCostModel::calibrate() {
+    const UINT qubit_count = std::min(_qubit_count,
+        std::max(calibration_max_qubit_count, _max_target_count + 1));
+    const ITYPE dim = 1ULL << qubit_count;
+    // kernels on larger states are assumed to be memory-bound, so the ratios
+    // between the kernels are those measured at qubit_count qubits
+    const double scale = (double)(1ULL << (_qubit_count - qubit_count));
+    std::vector<CTYPE> state(dim, 1. / sqrt((double)dim));
+
+    // the target qubits are the lowest ones, and the control is the highest.
+    // only a single control is measured for gates with any number of controls
+    std::vector<UINT> target_list(_max_target_count);
+    std::vector<UINT> Pauli_list(_max_target_count, 1);
+    for (UINT i = 0; i < _max_target_count; ++i) target_list[i] = i;
+    const UINT control = qubit_count - 1;
+
+    auto measure = [&](std::function<void()> kernel) {
+        kernel();
+        Timer timer;
+        UINT repeat = 0;
+        do {
+            kernel();
+            ++repeat;
+        } while (repeat < 3 || timer.elapsed() < 1e-3);
+        return timer.elapsed() / repeat * scale;
+    };
+
+    for (UINT target_count = 1; target_count <= _max_target_count;
+         ++target_count) {
+        const ITYPE matrix_dim = 1ULL << target_count;
+        std::vector<CTYPE> matrix(matrix_dim * matrix_dim, 0.);
+        std::vector<CTYPE> diagonal(matrix_dim, 1.);
+        for (ITYPE i = 0; i < matrix_dim; ++i) {
+            matrix[i * matrix_dim + i] = 1.;
+        }
+        const UINT* targets = target_list.data();
+        CTYPE* state_ptr = state.data();
+
+        _kernel_time[NAMED_KERNEL][target_count - 1] = measure([&]() {
+            if (target_count == 1) {
+                H_gate(targets[0], state_ptr, dim);
+            } else if (target_count == 2) {
+                CNOT_gate(targets[0], targets[1], state_ptr, dim);
+            } else {
+                multi_qubit_Pauli_rotation_gate_partial_list(targets,
+                    Pauli_list.data(), target_count, 0.1, state_ptr, dim);
+            }
+        });
+        _kernel_time[DIAGONAL_KERNEL][target_count - 1] = measure([&]() {
+            if (target_count == 1) {
+                single_qubit_diagonal_matrix_gate(
+                    targets[0], diagonal.data(), state_ptr, dim);
+            } else {
+                multi_qubit_diagonal_matrix_gate(
+                    targets, target_count, diagonal.data(), state_ptr, dim);
+            }
+        });
+        _kernel_time[CONTROLLED_KERNEL][target_count - 1] = measure([&]() {
+            if (target_count == 1) {
+                single_qubit_control_single_qubit_dense_matrix_gate(
+                    control, 1, targets[0], matrix.data(), state_ptr, dim);
+            } else {
+                single_qubit_control_multi_qubit_dense_matrix_gate(control, 1,
+                    targets, target_count, matrix.data(), state_ptr, dim);
+            }
+        });
+        _kernel_time[DENSE_KERNEL][target_count - 1] = measure([&]() {
+            if (target_count == 1) {
+                single_qubit_dense_matrix_gate(
+                    targets[0], matrix.data(), state_ptr, dim);
+            } else {
+                multi_qubit_dense_matrix_gate(
+                    targets, target_count, matrix.data(), state_ptr, dim);
+            }
+        });
+    }
+}
+
+double GateCostModel::get_kernel_time(
+    KernelType type, UINT target_count) const {
+    if (target_count == 0 || target_count > _max_target_count) {
+        throw InvalidQubitCountException(
+            "Error: GateCostModel::get_kernel_time(KernelType, UINT): "
+            "target_count must be between 1 and max_target_count");
+    }
+    return _kernel_time[type][target_count - 1];
+}
+
+void GateCostModel::set_kernel_time(
+    KernelType type, UINT target_count, double time) {
+    if (target_count == 0 || target_count > _max_target_count) {
+        throw InvalidQubitCountException(
+            "Error: GateCostModel::set_kernel_time(KernelType, UINT, double): "
+            "target_count must be between 1 and max_target_count");
+    }
+    _kernel_time[type][target_count - 1] = time;
+}
+
+bool GateCostModel::get_kernel(
+    const QuantumGateBase* gate, KernelType& type, UINT& target_count) const {
+    if (gate->is_parametric()) return false;
+    target_count = (UINT)gate->target_qubit_list.size();
+    if (dynamic_cast<const ClsOneQubitGate*>(gate) != nullptr ||
+        dynamic_cast<const ClsOneQubitRotationGate*>(gate) != nullptr ||
+        dynamic_cast<const ClsTwoQubitGate*>(gate) != nullptr ||
+        dynamic_cast<const ClsPauliGate*>(gate) != nullptr ||
+        dynamic_cast<const ClsPauliRotationGate*>(gate) != nullptr) {
+        type = NAMED_KERNEL;
+    } else if (dynamic_cast<const ClsOneControlOneTargetGate*>(gate) !=
+               nullptr) {
+        type = NAMED_KERNEL;
+        target_count = 2;
+    } else if (dynamic_cast<const QuantumGateDiagonalMatrix*>(gate) !=
+               nullptr) {
+        type = DIAGONAL_KERNEL;
+    } else if (dynamic_cast<const QuantumGateMatrix*>(gate) != nullptr) {
+        type = gate->control_qubit_list.empty() ? DENSE_KERNEL
+                                                : CONTROLLED_KERNEL;
+    } else {
+        return false;
+    }
+    return target_count >= 1 && target_count <= _max_target_count;
+}
+
+double GateCostModel::get_gate_time(const QuantumGateBase* gate) const {
+    KernelType type;
+    UINT target_count;
+    if (!this->get_kernel(gate, type, target_count)) return -1.;
+    return _kernel_time[type][target_count - 1];
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <vector>
+
+#include "type.hpp"
+
+class QuantumGateBase;
+
+/**
+ * \~japanese-en ゲートの実行時間を予測するコストモデル
+ *
+ * csimのカーネルの実行時間を状態ベクトルの大きさごとに測定し、ゲートの実行時間の予測に用いる。
+ * カーネルは名前付きのゲート、対角行列、コントロール付きの行列、密行列の四種類に分け、
+ * それぞれターゲットの量子ビット数ごとの実行時間を持つ。
+ * QuantumCircuitOptimizer::optimize_with_cost_modelで、ゲートを合成するかの判断に用いる。
+ */
+class DllExport GateCostModel {
+public:
+    /**
+     * \~japanese-en カーネルの種類
+     */
+    enum KernelType {
+        NAMED_KERNEL, /**< \~japanese-en 名前付きのゲートやPauliゲートのカーネル */
+        DIAGONAL_KERNEL, /**< \~japanese-en 対角行列のカーネル */
+        CONTROLLED_KERNEL, /**< \~japanese-en コントロール付きの行列のカーネル。コントロールが一つの場合の実行時間を、コントロールの数によらず用いる */
+        DENSE_KERNEL, /**< \~japanese-en 密行列のカーネル */
+        KERNEL_TYPE_COUNT
+    };
+
+private:
+    UINT _qubit_count;
+    UINT _max_target_count;
+    // _kernel_time[type][target_count - 1] in seconds
+    std::vector<std::vector<double>> _kernel_time;
+
+    void calibrate();
+
+public:
+    /**
+     * \~japanese-en 測定に用いる状態ベクトルの量子ビット数の上限
+     */
+    static const UINT calibration_max_qubit_count = 20;
+
+    /**
+     * \~japanese-en コンストラクタ
+     *
+     * 各カーネルを実行して実行時間を測定する。
+     * 測定に用いる状態ベクトルはcalibration_max_qubit_count量子ビットまでとし、
+     * それより大きな状態ではカーネルの実行時間が状態の大きさに比例するとして外挿する。
+     * このため、calibration_max_qubit_countより大きな状態でのカーネル間の実行時間の比は
+     * calibration_max_qubit_count量子ビットでの比に固定され、状態の大きさによる比の変化は反映されない。
+     * CONTROLLED_KERNELはコントロールが一つの場合のみ測定する。
+     * @param qubit_count 予測の対象となる量子状態の量子ビット数
+     * @param max_target_count
+     * 測定するカーネルのターゲットの量子ビット数の上限。qubit_count - 1以下に制限される
+     * @param calibrate falseの場合は測定を行わず、実行時間をset_kernel_timeで与える
+     */
+    explicit GateCostModel(
+        UINT qubit_count, UINT max_target_count = 5, bool calibrate = true);
+
+    /**
+     * \~japanese-en 予測の対象となる量子状態の量子ビット数を取得する
+     *
+     * @return 量子ビット数
+     */
+    UINT get_qubit_count() const { return _qubit_count; }
+
+    /**
+     * \~japanese-en カーネルのターゲットの量子ビット数の上限を取得する
+     *
+     * @return ターゲットの量子ビット数の上限
+     */
+    UINT get_max_target_count() const { return _max_target_count; }
+
+    /**
+     * \~japanese-en カーネルの実行時間を取得する
+     *
+     * @param type カーネルの種類
+     * @param target_count ターゲットの量子ビット数
+     * @return 実行時間 (秒)
+     */
+    double get_kernel_time(KernelType type, UINT target_count) const;
+
+    /**
+     * \~japanese-en カーネルの実行時間を設定する
+     *
+     * @param type カーネルの種類
+     * @param target_count ターゲットの量子ビット数
+     * @param time 実行時間 (秒)
+     */
+    void set_kernel_time(KernelType type, UINT target_count, double time);
+
+    /**
+     * \~japanese-en ゲートが用いるカーネルを判定する
+     *
+     * @param gate ゲート
+     * @param type カーネルの種類
+     * @param target_count カーネルのターゲットの量子ビット数
+     * @return ゲートがモデルに含まれるカーネルで実行されるか。
+     * パラメトリックゲート、ノイズ、測定などではfalseとなる。
+     */
+    bool get_kernel(const QuantumGateBase* gate, KernelType& type,
+        UINT& target_count) const;
+
+    /**
+     * \~japanese-en ゲートの実行時間を予測する
+     *
+     * @param gate ゲート
+     * @return 予測される実行時間 (秒)。モデルに含まれないゲートでは負の値を返す。
+     */
+    double get_gate_time(const QuantumGateBase* gate) const;
+};
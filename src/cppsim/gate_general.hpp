@@ -1,7 +1,14 @@
 #pragma once
 
+#include <csim/stat_ops.hpp>
+#include <csim/update_ops_dm.hpp>
+#include <memory>
+#include <mutex>
+
 #include "gate.hpp"
+#include "gate_matrix_diagonal.hpp"
 #include "gate_merge.hpp"
+#include "gate_named_one.hpp"
 #include "state.hpp"
 #include "utility.hpp"
 /**
@@ -13,6 +20,67 @@
  * ただし、和が1のProbabilistic においてのみ、　Identityなしで求めている
  */
 
+/**
+ * \~japanese-en 密度行列への作用をsuperoperatorとしてキャッシュするゲートの最大量子ビット数
+ */
+const UINT superoperator_max_qubit_count = 3;
+
+/**
+ * \~japanese-en 密度行列への作用を表すsuperoperatorのキャッシュ
+ *
+ * 最初に使われたときに一度だけ計算され、複数のスレッドから同時に使われてもよい。
+ * コピーや代入をすると計算前の状態に戻る。
+ */
+class SuperoperatorCache {
+private:
+    struct Entry {
+        std::once_flag flag;
+        std::vector<UINT> target_list;
+        ComplexMatrix superoperator;
+        bool has_superoperator = false;
+    };
+    std::unique_ptr<Entry> _entry;
+
+public:
+    SuperoperatorCache() : _entry(new Entry()) {}
+    SuperoperatorCache(const SuperoperatorCache&) : _entry(new Entry()) {}
+    SuperoperatorCache& operator=(const SuperoperatorCache&) {
+        _entry.reset(new Entry());
+        return *this;
+    }
+
+    /**
+     * \~japanese-en 密度行列をgateのsuperoperatorで1回の走査で更新する
+     *
+     * @param gate superoperatorを計算するゲート
+     * @param state 更新する密度行列
+     * @return 更新したかどうか
+     */
+    bool update_density_matrix(
+        const QuantumGateBase* gate, QuantumStateBase* state) {
+        Entry& entry = *_entry;
+        std::call_once(entry.flag, [&]() {
+            entry.target_list = gate->get_target_index_list();
+            for (UINT index : gate->get_control_index_list()) {
+                entry.target_list.push_back(index);
+            }
+            std::sort(entry.target_list.begin(), entry.target_list.end());
+            entry.has_superoperator =
+                entry.target_list.size() <= superoperator_max_qubit_count &&
+                gate::get_superoperator(
+                    gate, entry.target_list, entry.superoperator);
+        });
+        if (!entry.has_superoperator || state->get_device_name() != "cpu") {
+            return false;
+        }
+        dm_multi_qubit_superoperator(entry.target_list.data(),
+            (UINT)entry.target_list.size(),
+            (const CTYPE*)entry.superoperator.data(), state->data_c(),
+            state->dim);
+        return true;
+    }
+};
+
 /**
  * \~japanese-en 確率的なユニタリ操作
  */
@@ -24,6 +92,17 @@ protected:
     std::vector<QuantumGateBase*> _gate_list;
     bool is_instrument;
     UINT _classical_register_address;
+    SuperoperatorCache _superoperator_cache;
+
+    /**
+     * \~japanese-en 密度行列をキャッシュしたsuperoperatorで1回の走査で更新する
+     *
+     * @param state 更新する密度行列
+     * @return 更新したかどうか
+     */
+    bool update_density_matrix_by_superoperator(QuantumStateBase* state) {
+        return _superoperator_cache.update_density_matrix(this, state);
+    }
 
 public:
     /**
@@ -126,6 +205,8 @@ public:
                     this->_classical_register_address, (UINT)gate_index);
             }
         } else {
+            if (update_density_matrix_by_superoperator(state)) return;
+
             auto org_state = state->copy();
             auto temp_state = state->copy();
 
@@ -214,6 +295,10 @@ public:
     };
     virtual std::vector<double> get_distribution() { return _distribution; };
     virtual std::vector<QuantumGateBase*> get_gate_list() { return _gate_list; }
+    /**
+     * \~japanese-en 選ばれた添字を古典レジスタに書き込むかどうか
+     */
+    virtual bool is_instrument_gate() const { return is_instrument; }
     virtual void optimize_ProbablisticGate() {
         int n = (int)_gate_list.size();
         std::vector<std::pair<double, int>> itr;
@@ -250,6 +335,17 @@ protected:
     std::vector<QuantumGateBase*> _gate_list;
     bool is_instrument;
     UINT _classical_register_address;
+    SuperoperatorCache _superoperator_cache;
+
+    /**
+     * \~japanese-en 密度行列をキャッシュしたsuperoperatorで1回の走査で更新する
+     *
+     * @param state 更新する密度行列
+     * @return 更新したかどうか
+     */
+    bool update_density_matrix_by_superoperator(QuantumStateBase* state) {
+        return _superoperator_cache.update_density_matrix(this, state);
+    }
 
 public:
     explicit QuantumGate_CPTP(std::vector<QuantumGateBase*> gate_list) {
@@ -292,6 +388,100 @@ public:
         }
     }
 
+protected:
+    /**
+     * \~japanese-en 全てのKraus演算子が同じ1量子ビットに作用する行列ゲートであれば、その行列を取得する
+     *
+     * @param target_index Kraus演算子が作用する量子ビット
+     * @param matrix_list Kraus演算子の行列のリスト
+     * @return 取得できたかどうか
+     */
+    bool get_single_qubit_Kraus_matrix_list(
+        UINT* target_index, std::vector<ComplexMatrix>* matrix_list) const {
+        matrix_list->clear();
+        for (auto gate : _gate_list) {
+            const bool is_matrix_gate =
+                dynamic_cast<const QuantumGateMatrix*>(gate) != NULL ||
+                dynamic_cast<const QuantumGateDiagonalMatrix*>(gate) != NULL ||
+                dynamic_cast<const ClsOneQubitGate*>(gate) != NULL ||
+                dynamic_cast<const ClsOneQubitRotationGate*>(gate) != NULL;
+            if (!is_matrix_gate || !gate->get_control_index_list().empty() ||
+                gate->get_target_index_list().size() != 1) {
+                return false;
+            }
+            if (matrix_list->empty()) {
+                *target_index = gate->get_target_index_list()[0];
+            } else if (gate->get_target_index_list()[0] != *target_index) {
+                return false;
+            }
+            ComplexMatrix matrix;
+            gate->set_matrix(matrix);
+            matrix_list->push_back(matrix);
+        }
+        return !matrix_list->empty();
+    }
+
+    /**
+     * \~japanese-en Kraus演算子が同じ量子ビットへのP0とP1の組、すなわち1量子ビットの測定であるかを判定する
+     *
+     * @param target_index 測定する量子ビット
+     * @return 1量子ビットの測定であるかどうか
+     */
+    bool is_single_qubit_measurement(UINT* target_index) const {
+        if (_gate_list.size() != 2) return false;
+        for (UINT index = 0; index < 2; ++index) {
+            const QuantumGateBase* gate = _gate_list[index];
+            if (dynamic_cast<const ClsOneQubitGate*>(gate) == NULL ||
+                gate->get_name() !=
+                    ((index == 0) ? "Projection-0" : "Projection-1") ||
+                !gate->get_control_index_list().empty()) {
+                return false;
+            }
+        }
+        *target_index = _gate_list[0]->get_target_index_list()[0];
+        return _gate_list[1]->get_target_index_list()[0] == *target_index;
+    }
+
+    /**
+     * \~japanese-en 1量子ビットのKraus演算子を1つ選んで作用させる
+     *
+     * 各演算子が選ばれる確率は対象量子ビットの縮約密度行列から求め、状態のコピーを作らずに選ばれた演算子と規格化を1回の走査で作用させる。
+     * @param r [0,1)の乱数
+     * @param target_index Kraus演算子が作用する量子ビット
+     * @param matrix_list Kraus演算子の行列のリスト
+     * @param state 更新する量子状態
+     * @return 選ばれた演算子の添字。選ばれなかった場合はmatrix_listの長さ
+     */
+    UINT update_by_single_qubit_Kraus_matrix(double r, UINT target_index,
+        const std::vector<ComplexMatrix>& matrix_list,
+        QuantumStateBase* state) const {
+        CTYPE reduced_matrix[4];
+        single_qubit_reduced_density_matrix(
+            target_index, state->data_c(), state->dim, reduced_matrix);
+        ComplexMatrix rho(2, 2);
+        rho << reduced_matrix[0], reduced_matrix[1], reduced_matrix[2],
+            reduced_matrix[3];
+        const double org_norm = rho.trace().real();
+
+        double sum = 0.;
+        for (UINT index = 0; index < matrix_list.size(); ++index) {
+            const ComplexMatrix& kraus = matrix_list[index];
+            const double prob =
+                (kraus * rho * kraus.adjoint()).trace().real() / org_norm;
+            sum += prob;
+            if (r < sum) {
+                const double coef = 1. / sqrt(prob);
+                CTYPE matrix[4] = {coef * kraus(0, 0), coef * kraus(0, 1),
+                    coef * kraus(1, 0), coef * kraus(1, 1)};
+                single_qubit_dense_matrix_gate(
+                    target_index, matrix, state->data_c(), state->dim);
+                return index;
+            }
+        }
+        return (UINT)matrix_list.size();
+    }
+
+public:
     /**
      * \~japanese-en 量子状態を更新する
      *
@@ -301,6 +491,37 @@ public:
         if (state->is_state_vector()) {
             double r = random.uniform();
 
+            UINT target_index;
+            std::vector<ComplexMatrix> matrix_list;
+            const bool is_cpu_state = state->get_device_name() == "cpu" &&
+                                      !state->is_single_precision() &&
+                                      state->outer_qc == 0;
+            if (is_cpu_state && is_single_qubit_measurement(&target_index)) {
+                UINT index = single_qubit_measurement(
+                    target_index, r, state->data_c(), state->dim);
+                if (is_instrument) {
+                    state->set_classical_value(
+                        this->_classical_register_address, index);
+                }
+                return;
+            }
+            if (is_cpu_state && get_single_qubit_Kraus_matrix_list(
+                                    &target_index, &matrix_list)) {
+                UINT index = update_by_single_qubit_Kraus_matrix(
+                    r, target_index, matrix_list, state);
+                if (index == _gate_list.size()) {
+                    std::cerr
+                        << "* Warning : CPTP-map was not trace preserving. "
+                           "Identity-map is applied."
+                        << std::endl;
+                }
+                if (is_instrument) {
+                    state->set_classical_value(
+                        this->_classical_register_address, index);
+                }
+                return;
+            }
+
             double sum = 0.;
             double org_norm = state->get_squared_norm();
 
@@ -330,6 +551,8 @@ public:
                     this->_classical_register_address, index);
             }
         } else {
+            if (update_density_matrix_by_superoperator(state)) return;
+
             auto org_state = state->copy();
             auto temp_state = state->copy();
             for (UINT gate_index = 0; gate_index < _gate_list.size();
@@ -397,6 +620,12 @@ public:
         return pt;
     }
     virtual std::vector<QuantumGateBase*> get_gate_list() { return _gate_list; }
+    /**
+     * \~japanese-en 選ばれた添字を古典レジスタに書き込むかどうか
+     */
+    virtual bool is_instrument_gate() const { return is_instrument; }
+
+    virtual void set_seed(int seed) override { random.set_seed(seed); };
 };
 
 /**
@@ -556,6 +785,8 @@ public:
         return pt;
     }
     virtual std::vector<QuantumGateBase*> get_gate_list() { return _gate_list; }
+
+    virtual void set_seed(int seed) override { random.set_seed(seed); };
 };
 
 /**
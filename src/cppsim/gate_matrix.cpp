@@ -69,6 +69,10 @@ QuantumGateMatrix::QuantumGateMatrix(
 }
 
 void QuantumGateMatrix::update_quantum_state(QuantumStateBase* state) {
+    if (state->is_single_precision()) {
+        this->update_single_precision_state(state);
+        return;
+    }
     // Eigen::Matrix<std::complex<double>, Eigen::Dynamic, Eigen::Dynamic,
     // Eigen::RowMajor> row_matrix(this->_matrix_element); const CTYPE*
     // matrix_ptr = reinterpret_cast<const CTYPE*>(row_matrix.data()); const
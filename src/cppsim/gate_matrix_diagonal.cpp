@@ -68,6 +68,10 @@ QuantumGateDiagonalMatrix::QuantumGateDiagonalMatrix(
 }
 
 void QuantumGateDiagonalMatrix::update_quantum_state(QuantumStateBase* state) {
+    if (state->is_single_precision()) {
+        this->update_single_precision_state(state);
+        return;
+    }
     ITYPE dim = 1ULL << state->qubit_count;
 
     const CTYPE* diagonal_ptr =
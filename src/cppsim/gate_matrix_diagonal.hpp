@@ -12,6 +12,8 @@ private:
     // list of elements of unitary matrix as 1D array with length dim
     ComplexVector _diagonal_element;
 
+    friend class CompiledCircuit;
+
 public:
     /**
      * \~japanese-en コンストラクタ
@@ -75,6 +75,10 @@ void QuantumGateSparseMatrix::update_quantum_state(QuantumStateBase* state) {
         throw NotImplementedException(
             "Control qubit in sparse matrix gate is not supported");
     }
+    if (state->is_single_precision()) {
+        this->update_single_precision_state(state);
+        return;
+    }
 
     std::vector<UINT> target_index;
     std::transform(this->_target_qubit_list.cbegin(),
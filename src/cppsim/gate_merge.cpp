@@ -8,6 +8,12 @@
 
 #include "gate_general.hpp"
 #include "gate_matrix.hpp"
+#include "gate_matrix_diagonal.hpp"
+#include "gate_matrix_sparse.hpp"
+#include "gate_named_npair.hpp"
+#include "gate_named_one.hpp"
+#include "gate_named_pauli.hpp"
+#include "gate_named_two.hpp"
 
 // Create target_gate_set and control_gate_set after merging
 // Any qubit index is classified as 9 cases :  (first_target, first_control,
@@ -464,6 +470,91 @@ QuantumGateMatrix* get_adjoint_gate(const QuantumGateBase* gate) {
         gate->target_qubit_list, &amat, gate->control_qubit_list);
 }
 
+// Superoperator K \otimes conj(K) of the matrix of a gate which is extended
+// to target_index_list. Gates which are not given by a constant matrix are
+// rejected.
+static bool get_matrix_superoperator(const QuantumGateBase* gate,
+    const std::vector<UINT>& target_index_list, ComplexMatrix& superoperator) {
+    const bool is_matrix_gate =
+        dynamic_cast<const QuantumGateMatrix*>(gate) != NULL ||
+        dynamic_cast<const QuantumGateDiagonalMatrix*>(gate) != NULL ||
+        dynamic_cast<const QuantumGateSparseMatrix*>(gate) != NULL ||
+        dynamic_cast<const ClsOneQubitGate*>(gate) != NULL ||
+        dynamic_cast<const ClsOneQubitRotationGate*>(gate) != NULL ||
+        dynamic_cast<const ClsTwoQubitGate*>(gate) != NULL ||
+        dynamic_cast<const ClsOneControlOneTargetGate*>(gate) != NULL ||
+        dynamic_cast<const ClsNpairQubitGate*>(gate) != NULL ||
+        dynamic_cast<const ClsPauliGate*>(gate) != NULL ||
+        dynamic_cast<const ClsPauliRotationGate*>(gate) != NULL;
+    if (!is_matrix_gate || gate->is_parametric()) return false;
+
+    std::vector<TargetQubitInfo> new_target_list;
+    for (UINT index : target_index_list) {
+        new_target_list.push_back(TargetQubitInfo(index));
+    }
+    ComplexMatrix matrix;
+    get_extended_matrix(gate, new_target_list, {}, matrix);
+
+    const ITYPE matrix_dim = matrix.rows();
+    superoperator = ComplexMatrix(matrix_dim * matrix_dim, matrix_dim * matrix_dim);
+    for (ITYPE row = 0; row < matrix_dim; ++row) {
+        for (ITYPE column = 0; column < matrix_dim; ++column) {
+            for (ITYPE row2 = 0; row2 < matrix_dim; ++row2) {
+                for (ITYPE column2 = 0; column2 < matrix_dim; ++column2) {
+                    superoperator(
+                        row * matrix_dim + column, row2 * matrix_dim + column2) =
+                        matrix(row, row2) * std::conj(matrix(column, column2));
+                }
+            }
+        }
+    }
+    return true;
+}
+
+bool get_superoperator(const QuantumGateBase* gate,
+    const std::vector<UINT>& target_index_list, ComplexMatrix& superoperator) {
+    // every qubit of the gate must be in target_index_list
+    std::vector<UINT> gate_index_list = gate->get_target_index_list();
+    for (UINT index : gate->get_control_index_list()) {
+        gate_index_list.push_back(index);
+    }
+    for (UINT index : gate_index_list) {
+        if (std::find(target_index_list.begin(), target_index_list.end(),
+                index) == target_index_list.end()) {
+            return false;
+        }
+    }
+
+    const ITYPE superoperator_dim = 1ULL << (2 * target_index_list.size());
+    std::vector<QuantumGateBase*> kraus_list;
+    std::vector<double> distribution;
+    double identity_probability = 0.;
+    if (auto probabilistic =
+            dynamic_cast<const QuantumGate_Probabilistic*>(gate)) {
+        auto gate_ = const_cast<QuantumGate_Probabilistic*>(probabilistic);
+        kraus_list = gate_->get_gate_list();
+        distribution = gate_->get_distribution();
+        identity_probability = 1. - gate_->get_cumulative_distribution().back();
+    } else if (auto cptp = dynamic_cast<const QuantumGate_CPTP*>(gate)) {
+        kraus_list = const_cast<QuantumGate_CPTP*>(cptp)->get_gate_list();
+        distribution.assign(kraus_list.size(), 1.);
+    } else {
+        return get_matrix_superoperator(gate, target_index_list, superoperator);
+    }
+
+    superoperator = identity_probability *
+                    ComplexMatrix::Identity(superoperator_dim, superoperator_dim);
+    for (UINT index = 0; index < kraus_list.size(); ++index) {
+        ComplexMatrix kraus_superoperator;
+        if (!get_matrix_superoperator(
+                kraus_list[index], target_index_list, kraus_superoperator)) {
+            return false;
+        }
+        superoperator += distribution[index] * kraus_superoperator;
+    }
+    return true;
+}
+
 QuantumGateBase* Probabilistic(
     std::vector<double> distribution, std::vector<QuantumGateBase*> gate_list) {
     return new QuantumGate_Probabilistic(distribution, gate_list);
@@ -143,6 +143,21 @@ DllExport QuantumGateBase* Adaptive(
 DllExport QuantumGateBase* Adaptive(QuantumGateBase* gate,
     std::function<bool(const std::vector<UINT>&, UINT)> func, UINT id);
 
+/**
+ * \~japanese-en ゲートの密度行列への作用を表すsuperoperatorを求める
+ *
+ * 量子ビットtarget_index_list上の密度行列のブロックを、行の添字 row と列の添字
+ * column から row * 2^k + column で並べたベクトルに作用する行列を求める。Kraus演算子
+ * K_i に対しては sum_i K_i[row, row'] conj(K_i[column, column'])
+ * となる。行列で表せるゲート、および行列で表せるゲートからなる確率的なゲートとCPTP-mapに対応する。
+ * @param gate ゲート
+ * @param target_index_list 昇順に並んだ量子ビットのリスト。ゲートが作用する量子ビットを全て含む
+ * @param superoperator superoperatorをセットする変数の参照
+ * @return superoperatorを求められたかどうか
+ */
+DllExport bool get_superoperator(const QuantumGateBase* gate,
+    const std::vector<UINT>& target_index_list, ComplexMatrix& superoperator);
+
 DllExport QuantumGateMatrix* get_transpose_gate(const QuantumGateBase* gate);
 
 DllExport QuantumGateMatrix* get_conjugate_gate(const QuantumGateBase* gate);
@@ -29,6 +29,10 @@ public:
      * @param state 更新する量子状態
      */
     virtual void update_quantum_state(QuantumStateBase* state) override {
+        if (state->is_single_precision()) {
+            this->update_single_precision_state(state);
+            return;
+        }
         if (state->is_state_vector()) {
 #ifdef _USE_GPU
             if (state->get_device_name() == "gpu") {
@@ -3,6 +3,7 @@
 #include <cmath>
 #include <csim/update_ops.hpp>
 #include <csim/update_ops_dm.hpp>
+#include <csim/update_ops_float.hpp>
 
 #include "gate.hpp"
 #include "state.hpp"
@@ -23,14 +24,18 @@ static void Igate_idling_mpi(UINT, CTYPE*, ITYPE, UINT){};
 class ClsOneQubitGate : public QuantumGateBase {
 protected:
     using UpdateFunc = void (*)(UINT, CTYPE*, ITYPE);
+    using UpdateFuncFloat = void (*)(UINT, CTYPE_F*, ITYPE);
     using UpdateFuncGpu = void (*)(UINT, void*, ITYPE, void*, UINT);
     using UpdateFuncMpi = void (*)(UINT, CTYPE*, ITYPE, UINT);
     UpdateFunc _update_func;
     UpdateFunc _update_func_dm;
+    UpdateFuncFloat _update_func_float = nullptr;
     UpdateFuncGpu _update_func_gpu;
     UpdateFuncMpi _update_func_mpi;
     ComplexMatrix _matrix_element;
 
+    friend class CompiledCircuit;
+
 public:
     explicit ClsOneQubitGate(){};
     /**
@@ -39,6 +44,15 @@ public:
      * @param state 更新する量子状態
      */
     virtual void update_quantum_state(QuantumStateBase* state) override {
+        if (state->is_single_precision()) {
+            if (_update_func_float != nullptr && state->is_state_vector()) {
+                _update_func_float(this->_target_qubit_list[0].index(),
+                    reinterpret_cast<CTYPE_F*>(state->data()), state->dim);
+            } else {
+                this->update_single_precision_state(state);
+            }
+            return;
+        }
         if (state->is_state_vector()) {
 #ifdef _USE_GPU
             if (state->get_device_name() == "gpu") {
@@ -95,6 +109,7 @@ public:
     void XGateinit(UINT target_qubit_index) {
         this->_update_func = X_gate;
         this->_update_func_dm = dm_X_gate;
+        this->_update_func_float = float_X_gate;
 #ifdef _USE_GPU
         this->_update_func_gpu = X_gate_host;
 #endif
@@ -112,6 +127,7 @@ public:
     void YGateinit(UINT target_qubit_index) {
         this->_update_func = Y_gate;
         this->_update_func_dm = dm_Y_gate;
+        this->_update_func_float = float_Y_gate;
 #ifdef _USE_GPU
         this->_update_func_gpu = Y_gate_host;
 #endif
@@ -129,6 +145,7 @@ public:
     void ZGateinit(UINT target_qubit_index) {
         this->_update_func = Z_gate;
         this->_update_func_dm = dm_Z_gate;
+        this->_update_func_float = float_Z_gate;
 #ifdef _USE_GPU
         this->_update_func_gpu = Z_gate_host;
 #endif
@@ -146,6 +163,7 @@ public:
     void HGateinit(UINT target_qubit_index) {
         this->_update_func = H_gate;
         this->_update_func_dm = dm_H_gate;
+        this->_update_func_float = float_H_gate;
 #ifdef _USE_GPU
         this->_update_func_gpu = H_gate_host;
 #endif
@@ -352,6 +370,8 @@ protected:
     ComplexMatrix _matrix_element;
     double _angle;
 
+    friend class CompiledCircuit;
+
 public:
     explicit ClsOneQubitRotationGate(){};
     explicit ClsOneQubitRotationGate(double angle) : _angle(angle){};
@@ -361,6 +381,10 @@ public:
      * @param state 更新する量子状態
      */
     virtual void update_quantum_state(QuantumStateBase* state) override {
+        if (state->is_single_precision()) {
+            this->update_single_precision_state(state);
+            return;
+        }
         if (state->is_state_vector()) {
 #ifdef _USE_GPU
             if (state->get_device_name() == "gpu") {
@@ -400,6 +424,12 @@ public:
     virtual void set_matrix(ComplexMatrix& matrix) const override {
         matrix = this->_matrix_element;
     }
+    /**
+     * \~japanese-en 回転角を取得する
+     *
+     * @return 回転角
+     */
+    double get_angle() const { return _angle; }
 
     void RXGateinit(UINT target_qubit_index, double angle) {
         this->_angle = angle;
@@ -2,6 +2,7 @@
 
 #include <csim/update_ops.hpp>
 #include <csim/update_ops_dm.hpp>
+#include <csim/update_ops_float.hpp>
 
 #include "gate.hpp"
 #include "pauli_operator.hpp"
@@ -17,6 +18,8 @@ class ClsPauliGate : public QuantumGateBase {
 protected:
     PauliOperator* _pauli;
 
+    friend class CompiledCircuit;
+
 public:
     /**
      * \~japanese-en コンストラクタ
@@ -53,6 +56,12 @@ public:
     virtual void update_quantum_state(QuantumStateBase* state) override {
         auto target_index_list = _pauli->get_index_list();
         auto pauli_id_list = _pauli->get_pauli_id_list();
+        if (state->is_single_precision() && state->is_state_vector()) {
+            float_multi_qubit_Pauli_gate_partial_list(target_index_list.data(),
+                pauli_id_list.data(), (UINT)target_index_list.size(),
+                reinterpret_cast<CTYPE_F*>(state->data()), state->dim);
+            return;
+        }
         if (state->is_state_vector()) {
 #ifdef _USE_GPU
             if (state->get_device_name() == "gpu") {
@@ -117,6 +126,8 @@ protected:
     double _angle;
     PauliOperator* _pauli;
 
+    friend class CompiledCircuit;
+
 public:
     /**
      * \~japanese-en コンストラクタ
@@ -154,6 +165,13 @@ public:
     virtual void update_quantum_state(QuantumStateBase* state) override {
         auto target_index_list = _pauli->get_index_list();
         auto pauli_id_list = _pauli->get_pauli_id_list();
+        if (state->is_single_precision() && state->is_state_vector()) {
+            float_multi_qubit_Pauli_rotation_gate_partial_list(
+                target_index_list.data(), pauli_id_list.data(),
+                (UINT)target_index_list.size(), _angle,
+                reinterpret_cast<CTYPE_F*>(state->data()), state->dim);
+            return;
+        }
         if (state->is_state_vector()) {
 #ifdef _USE_GPU
             if (state->get_device_name() == "gpu") {
@@ -202,6 +220,20 @@ public:
                  imag_unit * sin(_angle / 2) * matrix;
     }
 
+    /**
+     * \~japanese-en 回転角を取得する
+     *
+     * @return 回転角
+     */
+    double get_angle() const { return _angle; }
+
+    /**
+     * \~japanese-en 回転の軸となるパウリ演算子を取得する
+     *
+     * @return パウリ演算子
+     */
+    const PauliOperator* get_pauli() const { return _pauli; }
+
     /**
      * \~japanese-en ptreeに変換する
      *
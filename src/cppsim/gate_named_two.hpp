@@ -1,6 +1,7 @@
 #pragma once
 
 #include <csim/update_ops.hpp>
+#include <csim/update_ops_float.hpp>
 
 #include "gate.hpp"
 #include "state.hpp"
@@ -12,14 +13,18 @@
 class ClsTwoQubitGate : public QuantumGateBase {
 protected:
     using UpdateFunc = void (*)(UINT, UINT, CTYPE*, ITYPE);
+    using UpdateFuncFloat = void (*)(UINT, UINT, CTYPE_F*, ITYPE);
     using UpdateFuncGpu = void (*)(UINT, UINT, void*, ITYPE, void*, UINT);
     using UpdateFuncMpi = void (*)(UINT, UINT, CTYPE*, ITYPE, UINT);
     UpdateFunc _update_func;
     UpdateFunc _update_func_dm;
+    UpdateFuncFloat _update_func_float = nullptr;
     UpdateFuncGpu _update_func_gpu;
     UpdateFuncMpi _update_func_mpi;
     ComplexMatrix _matrix_element;
 
+    friend class CompiledCircuit;
+
 public:
     explicit ClsTwoQubitGate(){};
     /**
@@ -28,6 +33,16 @@ public:
      * @param state 更新する量子状態
      */
     virtual void update_quantum_state(QuantumStateBase* state) override {
+        if (state->is_single_precision()) {
+            if (_update_func_float != nullptr && state->is_state_vector()) {
+                _update_func_float(this->_target_qubit_list[0].index(),
+                    this->_target_qubit_list[1].index(),
+                    reinterpret_cast<CTYPE_F*>(state->data()), state->dim);
+            } else {
+                this->update_single_precision_state(state);
+            }
+            return;
+        }
         if (state->is_state_vector()) {
 #ifdef _USE_GPU
             if (state->get_device_name() == "gpu") {
@@ -74,6 +89,7 @@ public:
     void SWAPGateinit(UINT target_qubit_index1, UINT target_qubit_index2) {
         this->_update_func = SWAP_gate;
         this->_update_func_dm = dm_SWAP_gate;
+        this->_update_func_float = float_SWAP_gate;
 #ifdef _USE_GPU
         this->_update_func_gpu = SWAP_gate_host;
 #endif
@@ -126,14 +142,18 @@ public:
 class ClsOneControlOneTargetGate : public QuantumGateBase {
 protected:
     using UpdateFunc = void (*)(UINT, UINT, CTYPE*, ITYPE);
+    using UpdateFuncFloat = void (*)(UINT, UINT, CTYPE_F*, ITYPE);
     using UpdateFuncGpu = void (*)(UINT, UINT, void*, ITYPE, void*, UINT);
     using UpdateFuncMpi = void (*)(UINT, UINT, CTYPE*, ITYPE, UINT);
     UpdateFunc _update_func;
     UpdateFunc _update_func_dm;
+    UpdateFuncFloat _update_func_float = nullptr;
     UpdateFuncGpu _update_func_gpu;
     UpdateFuncMpi _update_func_mpi;
     ComplexMatrix _matrix_element;
 
+    friend class CompiledCircuit;
+
 public:
     explicit ClsOneControlOneTargetGate(){};
     /**
@@ -142,6 +162,16 @@ public:
      * @param state 更新する量子状態
      */
     virtual void update_quantum_state(QuantumStateBase* state) override {
+        if (state->is_single_precision()) {
+            if (_update_func_float != nullptr && state->is_state_vector()) {
+                _update_func_float(this->_control_qubit_list[0].index(),
+                    this->_target_qubit_list[0].index(),
+                    reinterpret_cast<CTYPE_F*>(state->data()), state->dim);
+            } else {
+                this->update_single_precision_state(state);
+            }
+            return;
+        }
         if (state->is_state_vector()) {
 #ifdef _USE_GPU
             if (state->get_device_name() == "gpu") {
@@ -188,6 +218,7 @@ public:
     void CNOTGateinit(UINT control_qubit_index, UINT target_qubit_index) {
         this->_update_func = CNOT_gate;
         this->_update_func_dm = dm_CNOT_gate;
+        this->_update_func_float = float_CNOT_gate;
 #ifdef _USE_GPU
         this->_update_func_gpu = CNOT_gate_host;
 #endif
@@ -207,6 +238,7 @@ public:
     void CZGateinit(UINT control_qubit_index, UINT target_qubit_index) {
         this->_update_func = CZ_gate;
         this->_update_func_dm = dm_CZ_gate;
+        this->_update_func_float = float_CZ_gate;
 #ifdef _USE_GPU
         this->_update_func_gpu = CZ_gate_host;
 #endif
@@ -36,6 +36,10 @@ public:
      * @param state 更新する量子状態
      */
     virtual void update_quantum_state(QuantumStateBase* state) override {
+        if (state->is_single_precision()) {
+            this->update_single_precision_state(state);
+            return;
+        }
         std::vector<UINT> target_index;
         std::transform(this->_target_qubit_list.cbegin(),
             this->_target_qubit_list.cend(), std::back_inserter(target_index),
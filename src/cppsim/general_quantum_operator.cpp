@@ -8,6 +8,7 @@
 #include <cstring>
 #include <fstream>
 #include <numeric>
+#include <unordered_map>
 #include <unsupported/Eigen/KroneckerProduct>
 
 #include "exception.hpp"
@@ -21,6 +22,10 @@
 #include <gpusim/update_ops_cuda.h>
 #endif
 
+// Diagonal operators up to this size keep their diagonal for
+// get_expectation_value.
+static const UINT DIAGONAL_CACHE_MAX_QUBIT_COUNT = 22;
+
 GeneralQuantumOperator::GeneralQuantumOperator(const UINT qubit_count)
     : _qubit_count(qubit_count), _is_hermitian(true) {}
 
@@ -113,6 +118,38 @@ CPPCTYPE GeneralQuantumOperator::get_expectation_value(
         return sum;
     }
 
+    if (device == "cpu" && state->is_state_vector() &&
+        !state->is_single_precision()) {
+        // a diagonal operator is compiled into its diagonal
+        if (n_terms > 2 && this->_qubit_count <= DIAGONAL_CACHE_MAX_QUBIT_COUNT) {
+            auto diagonal_cache = this->_get_diagonal_cache();
+            if (diagonal_cache) {
+                return expectation_value_diagonal_operator(
+                    reinterpret_cast<const CTYPE*>(
+                        diagonal_cache->diagonal.data()),
+                    diagonal_cache->diagonal.size(), state->data_c(),
+                    state->dim);
+            }
+        }
+        // terms with the same bit flip mask are evaluated in one pass
+        auto grouping = this->_get_term_grouping();
+        CPPCTYPE sum = 0;
+        std::vector<double> value_list;
+        for (const PauliTermGroup& group : grouping->group_list) {
+            const UINT term_count = (UINT)group.term_index_list.size();
+            value_list.resize(term_count);
+            expectation_value_multi_qubit_Pauli_operator_group_XZ_mask(
+                group.bit_flip_mask, group.phase_flip_mask_list.data(),
+                group.global_phase_90rot_count_list.data(), term_count,
+                state->data_c(), state->dim, value_list.data());
+            for (UINT i = 0; i < term_count; ++i) {
+                sum += _operator_list[group.term_index_list[i]]->get_coef() *
+                       value_list[i];
+            }
+        }
+        return sum;
+    }
+
     double sum_real = 0.;
     double sum_imag = 0.;
     CPPCTYPE tmp(0., 0.);
@@ -133,6 +170,99 @@ CPPCTYPE GeneralQuantumOperator::get_expectation_value(
     return CPPCTYPE(sum_real, sum_imag);
 }
 
+std::shared_ptr<const PauliTermGrouping>
+GeneralQuantumOperator::_get_term_grouping() const {
+    const size_t n_terms = this->_operator_list.size();
+    std::vector<ITYPE> bit_flip_mask_list(n_terms);
+    std::vector<ITYPE> phase_flip_mask_list(n_terms);
+    std::vector<UINT> global_phase_90rot_count_list(n_terms);
+    for (size_t i = 0; i < n_terms; ++i) {
+        _operator_list[i]->get_Pauli_masks(&bit_flip_mask_list[i],
+            &phase_flip_mask_list[i], &global_phase_90rot_count_list[i]);
+    }
+    // the terms may have been changed through get_terms() since the last call
+    auto grouping = std::atomic_load(&_term_grouping);
+    if (grouping && grouping->bit_flip_mask_list == bit_flip_mask_list &&
+        grouping->phase_flip_mask_list == phase_flip_mask_list &&
+        grouping->global_phase_90rot_count_list ==
+            global_phase_90rot_count_list) {
+        return grouping;
+    }
+
+    auto new_grouping = std::make_shared<PauliTermGrouping>();
+    std::unordered_map<ITYPE, size_t> group_index;
+    for (size_t i = 0; i < n_terms; ++i) {
+        auto inserted = group_index.insert(
+            std::make_pair(bit_flip_mask_list[i], group_index.size()));
+        if (inserted.second) {
+            PauliTermGroup group;
+            group.bit_flip_mask = bit_flip_mask_list[i];
+            new_grouping->group_list.push_back(group);
+        }
+        PauliTermGroup& group =
+            new_grouping->group_list[inserted.first->second];
+        group.term_index_list.push_back((UINT)i);
+        group.phase_flip_mask_list.push_back(phase_flip_mask_list[i]);
+        group.global_phase_90rot_count_list.push_back(
+            global_phase_90rot_count_list[i]);
+    }
+    new_grouping->bit_flip_mask_list = std::move(bit_flip_mask_list);
+    new_grouping->phase_flip_mask_list = std::move(phase_flip_mask_list);
+    new_grouping->global_phase_90rot_count_list =
+        std::move(global_phase_90rot_count_list);
+    grouping = new_grouping;
+    std::atomic_store(&_term_grouping, grouping);
+    return grouping;
+}
+
+bool GeneralQuantumOperator::is_diagonal() const {
+    auto grouping = this->_get_term_grouping();
+    return grouping->group_list.empty() ||
+           (grouping->group_list.size() == 1 &&
+               grouping->group_list[0].bit_flip_mask == 0);
+}
+
+std::shared_ptr<const GeneralQuantumOperator::DiagonalCache>
+GeneralQuantumOperator::_get_diagonal_cache() const {
+    auto grouping = this->_get_term_grouping();
+    if (!grouping->group_list.empty() &&
+        (grouping->group_list.size() != 1 ||
+            grouping->group_list[0].bit_flip_mask != 0)) {
+        return nullptr;
+    }
+    std::vector<CPPCTYPE> coef_list;
+    coef_list.reserve(_operator_list.size());
+    for (auto term : _operator_list) coef_list.push_back(term->get_coef());
+    auto diagonal_cache = std::atomic_load(&_diagonal_cache);
+    if (diagonal_cache && diagonal_cache->grouping == grouping &&
+        diagonal_cache->coef_list == coef_list) {
+        return diagonal_cache;
+    }
+
+    auto new_diagonal_cache = std::make_shared<DiagonalCache>();
+    new_diagonal_cache->diagonal.resize(this->get_state_dim());
+    Pauli_operator_Z_mask_diagonal(grouping->phase_flip_mask_list.data(),
+        reinterpret_cast<const CTYPE*>(coef_list.data()),
+        (UINT)coef_list.size(),
+        reinterpret_cast<CTYPE*>(new_diagonal_cache->diagonal.data()),
+        this->get_state_dim());
+    new_diagonal_cache->grouping = grouping;
+    new_diagonal_cache->coef_list = std::move(coef_list);
+    diagonal_cache = new_diagonal_cache;
+    std::atomic_store(&_diagonal_cache, diagonal_cache);
+    return diagonal_cache;
+}
+
+std::vector<CPPCTYPE> GeneralQuantumOperator::get_diagonal() const {
+    auto diagonal_cache = this->_get_diagonal_cache();
+    if (!diagonal_cache) {
+        throw InvalidObservableException(
+            "Error: GeneralQuantumOperator::get_diagonal(): the operator is "
+            "not diagonal");
+    }
+    return diagonal_cache->diagonal;
+}
+
 CPPCTYPE GeneralQuantumOperator::get_expectation_value_single_thread(
     const QuantumStateBase* state) const {
     if (this->_qubit_count > state->qubit_count) {
@@ -329,6 +459,11 @@ void GeneralQuantumOperator::apply_to_state(QuantumStateBase* work_state,
             "same");
     }
 
+    if (this->_apply_to_state_by_group(
+            &state_to_be_multiplied, dst_state, false)) {
+        return;
+    }
+
     dst_state->set_zero_norm_state();
     const auto term_count = this->get_term_count();
     for (UINT i = 0; i < term_count; i++) {
@@ -348,6 +483,10 @@ void GeneralQuantumOperator::apply_to_state(
             "same");
     }
 
+    if (this->_apply_to_state_by_group(state, dst_state, false)) {
+        return;
+    }
+
     dst_state->set_zero_norm_state();
     const auto term_count = this->get_term_count();
     for (UINT i = 0; i < term_count; i++) {
@@ -368,6 +507,10 @@ void GeneralQuantumOperator::apply_to_state_single_thread(
             "same");
     }
 
+    if (this->_apply_to_state_by_group(state, dst_state, true)) {
+        return;
+    }
+
     dst_state->set_zero_norm_state();
     const auto term_count = this->get_term_count();
     for (UINT i = 0; i < term_count; i++) {
@@ -380,6 +523,53 @@ void GeneralQuantumOperator::apply_to_state_single_thread(
     }
 }
 
+bool GeneralQuantumOperator::_apply_to_state_by_group(
+    const QuantumStateBase* state, QuantumStateBase* dst_state,
+    bool single_thread) const {
+    if (!state->is_state_vector() || !dst_state->is_state_vector() ||
+        state->is_single_precision() || dst_state->is_single_precision() ||
+        state->get_device_name() != "cpu" ||
+        dst_state->get_device_name() != "cpu" ||
+        state->data_c() == dst_state->data_c()) {
+        return false;
+    }
+    auto grouping = this->_get_term_grouping();
+    const UINT group_count = (UINT)grouping->group_list.size();
+    std::vector<ITYPE> bit_flip_mask_list;
+    std::vector<UINT> group_begin_list;
+    std::vector<ITYPE> phase_flip_mask_list;
+    std::vector<UINT> global_phase_90rot_count_list;
+    std::vector<CPPCTYPE> coef_list;
+    for (const PauliTermGroup& group : grouping->group_list) {
+        bit_flip_mask_list.push_back(group.bit_flip_mask);
+        group_begin_list.push_back((UINT)phase_flip_mask_list.size());
+        phase_flip_mask_list.insert(phase_flip_mask_list.end(),
+            group.phase_flip_mask_list.begin(),
+            group.phase_flip_mask_list.end());
+        global_phase_90rot_count_list.insert(
+            global_phase_90rot_count_list.end(),
+            group.global_phase_90rot_count_list.begin(),
+            group.global_phase_90rot_count_list.end());
+        for (UINT term_index : group.term_index_list) {
+            coef_list.push_back(_operator_list[term_index]->get_coef());
+        }
+    }
+    group_begin_list.push_back((UINT)phase_flip_mask_list.size());
+    const CTYPE* coef_ptr = reinterpret_cast<const CTYPE*>(coef_list.data());
+    if (single_thread) {
+        multi_qubit_Pauli_operator_sum_XZ_mask_single_thread(
+            bit_flip_mask_list.data(), group_begin_list.data(), group_count,
+            phase_flip_mask_list.data(), global_phase_90rot_count_list.data(),
+            coef_ptr, state->data_c(), dst_state->data_c(), dst_state->dim);
+    } else {
+        multi_qubit_Pauli_operator_sum_XZ_mask(bit_flip_mask_list.data(),
+            group_begin_list.data(), group_count, phase_flip_mask_list.data(),
+            global_phase_90rot_count_list.data(), coef_ptr, state->data_c(),
+            dst_state->data_c(), dst_state->dim);
+    }
+    return true;
+}
+
 void GeneralQuantumOperator::_apply_pauli_to_state(
     std::vector<UINT> pauli_id_list, std::vector<UINT> target_index_list,
     QuantumStateBase* state) const {
@@ -2,6 +2,7 @@
 
 #include <cstdio>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -13,6 +14,38 @@ class SinglePauliOperator;
 class PauliOperator;
 class QuantumStateBase;
 
+/**
+ * \~japanese-en
+ * 同じビット反転マスクを持つ項の組
+ *
+ * 組に含まれる項は状態ベクトルを一度走査するだけでまとめて計算できる。
+ */
+struct PauliTermGroup {
+    //! 組に共通のビット反転マスク
+    ITYPE bit_flip_mask;
+    //! 各項のGeneralQuantumOperatorでの添字
+    std::vector<UINT> term_index_list;
+    //! 各項の位相反転マスク
+    std::vector<ITYPE> phase_flip_mask_list;
+    //! 各項に含まれるYの個数
+    std::vector<UINT> global_phase_90rot_count_list;
+};
+
+/**
+ * \~japanese-en
+ * GeneralQuantumOperatorの項をビット反転マスクで分類した結果
+ */
+struct PauliTermGrouping {
+    //! 分類したときの各項のビット反転マスク
+    std::vector<ITYPE> bit_flip_mask_list;
+    //! 分類したときの各項の位相反転マスク
+    std::vector<ITYPE> phase_flip_mask_list;
+    //! 分類したときの各項に含まれるYの個数
+    std::vector<UINT> global_phase_90rot_count_list;
+    //! 最初に現れた順に並べた組のリスト
+    std::vector<PauliTermGroup> group_list;
+};
+
 class DllExport GeneralQuantumOperator {
 private:
     //! list of multi pauli term
@@ -21,8 +54,36 @@ private:
     UINT _qubit_count;
     bool _is_hermitian;
     Random random;
+    //! grouping of the terms by bit flip mask, rebuilt when the terms change
+    mutable std::shared_ptr<const PauliTermGrouping> _term_grouping;
+    //! diagonal of an operator made of I and Z, and what it was built from
+    struct DiagonalCache {
+        std::shared_ptr<const PauliTermGrouping> grouping;
+        std::vector<CPPCTYPE> coef_list;
+        std::vector<CPPCTYPE> diagonal;
+    };
+    mutable std::shared_ptr<const DiagonalCache> _diagonal_cache;
 
 protected:
+    /**
+     * \~japanese-en
+     * 項をビット反転マスクで分類した結果を返す
+     *
+     * 分類は呼び出しをまたいで保持され、各項のパウリ演算子が変わったときだけ作り直される。
+     * 係数は保持されないので、呼び出し側で各項から取得する。
+     * @return 項の分類
+     */
+    std::shared_ptr<const PauliTermGrouping> _get_term_grouping() const;
+
+    /**
+     * \~japanese-en
+     * 対角な演算子の対角成分を返す
+     *
+     * 対角成分は呼び出しをまたいで保持され、項か係数が変わったときだけ作り直される。
+     * @return 対角成分。対角でない場合はnullptr
+     */
+    std::shared_ptr<const DiagonalCache> _get_diagonal_cache() const;
+
     /**
      * \~japanese-en
      * state にパウリ演算子を作用させる
@@ -43,6 +104,20 @@ protected:
     void _apply_pauli_to_state_single_thread(std::vector<UINT> pauli_id_list,
         std::vector<UINT> target_index_list, QuantumStateBase* state) const;
 
+    /**
+     * \~japanese-en
+     * 項をビット反転マスクの組ごとにまとめて state に作用させ、結果を dst_state
+     * に格納する
+     *
+     * 倍精度のCPUの状態ベクトルのみに対応する。
+     * @param [in] state 作用を受ける状態
+     * @param [out] dst_state 結果を格納する状態
+     * @param [in] single_thread 単一スレッドで計算するか
+     * @return 計算した場合はtrue、対応していない状態の場合はfalse
+     */
+    bool _apply_to_state_by_group(const QuantumStateBase* state,
+        QuantumStateBase* dst_state, bool single_thread) const;
+
 public:
     /**
      * \~japanese-en
@@ -175,6 +250,24 @@ public:
      */
     virtual std::string to_string() const;
 
+    /**
+     * \~japanese-en
+     * すべての項がIとZのみからなる対角な演算子かどうかを判定する
+     *
+     * @return 対角な演算子ならtrue
+     */
+    virtual bool is_diagonal() const;
+
+    /**
+     * \~japanese-en
+     * 対角な演算子の対角成分を返す
+     *
+     * 対角成分は演算子に保持され、期待値の計算でも再利用される。
+     * 項か係数が変わったときだけ計算し直される。
+     * @return 長さ2^qubit_countの対角成分
+     */
+    virtual std::vector<CPPCTYPE> get_diagonal() const;
+
     /**
      * \~japanese-en
      * GeneralQuantumOperatorのある量子状態に対応するエネルギー(期待値)を計算して返す
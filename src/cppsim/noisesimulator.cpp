@@ -5,12 +5,240 @@
 #include "noisesimulator.hpp"
 
 #include <algorithm>
+#include <cfloat>
+#include <cmath>
 #include <numeric>
+#include <unordered_map>
+
+#include <csim/update_ops.hpp>
+#include <csim/utility.hpp>
 
 #include "circuit.hpp"
 #include "gate_factory.hpp"
+#include "gate_matrix.hpp"
+#include "gate_matrix_diagonal.hpp"
 #include "gate_merge.hpp"
+#include "gate_named_one.hpp"
+#include "gate_named_pauli.hpp"
+#include "gate_named_two.hpp"
 #include "state.hpp"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace {
+// Checkpoint memory used by default, 1 GiB.
+const ITYPE DEFAULT_CHECKPOINT_MEMORY_BUDGET = 1ULL << 30;
+
+// Mix the gate chosen at one position into the hash of the chosen prefix
+// (a splitmix64 step). Gates with internal randomness are seeded from the
+// hash of the prefix before them, so their result depends only on the path
+// in the trie and not on which request simulates it first.
+uint64_t mix_gate_pos(uint64_t hash, UINT gate_pos) {
+    uint64_t z = hash + 0x9e3779b97f4a7c15ULL * ((uint64_t)gate_pos + 1);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+// Order of the requests as the dense lists of the chosen gates in descending
+// lexicographic order, which visits the trie over them depth first. An error
+// at an earlier gate, or of a larger branch at the same gate, comes first.
+bool precedes_error_list(const std::vector<std::pair<UINT, UINT>>& l,
+    const std::vector<std::pair<UINT, UINT>>& r) {
+    const size_t count = std::min(l.size(), r.size());
+    for (size_t k = 0; k < count; ++k) {
+        if (l[k].first != r[k].first) return l[k].first < r[k].first;
+        if (l[k].second != r[k].second) return l[k].second > r[k].second;
+    }
+    return l.size() > r.size();
+}
+
+// Number of leading gates for which two requests choose the same gate.
+UINT common_prefix_length(const std::vector<std::pair<UINT, UINT>>& l,
+    const std::vector<std::pair<UINT, UINT>>& r, UINT gate_size) {
+    const size_t count = std::min(l.size(), r.size());
+    size_t k = 0;
+    while (k < count && l[k] == r[k]) ++k;
+    const UINT l_next = (k < l.size()) ? l[k].first : gate_size;
+    const UINT r_next = (k < r.size()) ? r[k].first : gate_size;
+    return std::min(l_next, r_next);
+}
+
+// A sampled pattern: errors simulated on the state and the Pauli frame of
+// the errors in the Clifford suffix.
+typedef std::pair<std::vector<std::pair<UINT, UINT>>, std::pair<ITYPE, ITYPE>>
+    ErrorPattern;
+
+struct ErrorPatternHash {
+    size_t operator()(const ErrorPattern& pattern) const {
+        uint64_t hash = pattern.first.size();
+        for (const auto& error : pattern.first) {
+            hash = mix_gate_pos(hash, error.first);
+            hash = mix_gate_pos(hash, error.second);
+        }
+        hash = mix_gate_pos(hash, (UINT)pattern.second.first);
+        hash = mix_gate_pos(hash, (UINT)(pattern.second.first >> 32));
+        hash = mix_gate_pos(hash, (UINT)pattern.second.second);
+        hash = mix_gate_pos(hash, (UINT)(pattern.second.second >> 32));
+        return (size_t)hash;
+    }
+};
+
+// Pauli frames are only looked for in gates with a few targets.
+const UINT MAX_PAULI_FRAME_TARGET_COUNT = 3;
+
+// Gates of these classes have their matrix in set_matrix. CPTP maps,
+// instruments and adaptive gates do not, and end the Clifford suffix.
+bool has_unitary_gate_class(const QuantumGateBase* gate) {
+    return dynamic_cast<const ClsOneQubitGate*>(gate) != nullptr ||
+           dynamic_cast<const ClsOneQubitRotationGate*>(gate) != nullptr ||
+           dynamic_cast<const ClsTwoQubitGate*>(gate) != nullptr ||
+           dynamic_cast<const ClsOneControlOneTargetGate*>(gate) != nullptr ||
+           dynamic_cast<const ClsPauliGate*>(gate) != nullptr ||
+           dynamic_cast<const ClsPauliRotationGate*>(gate) != nullptr ||
+           dynamic_cast<const QuantumGateMatrix*>(gate) != nullptr ||
+           dynamic_cast<const QuantumGateDiagonalMatrix*>(gate) != nullptr;
+}
+
+// Bit flip and phase flip masks of a gate which is a Pauli operator up to a
+// global phase, such as a branch of a Pauli channel. The matrix of X^x Z^z
+// has the element (-1)^{popcount(j & z)} at (j ^ x, j).
+bool get_Pauli_masks_of_gate(const QuantumGateBase* gate,
+    ITYPE* bit_flip_mask, ITYPE* phase_flip_mask) {
+    if (!has_unitary_gate_class(gate)) return false;
+    if (!gate->get_control_index_list().empty()) return false;
+    const std::vector<UINT> target_index_list = gate->get_target_index_list();
+    if (target_index_list.size() > MAX_PAULI_FRAME_TARGET_COUNT) return false;
+    ComplexMatrix matrix;
+    gate->set_matrix(matrix);
+    const ITYPE dim = matrix.rows();
+    const double tolerance = 1e-10;
+
+    ITYPE local_bit_flip_mask = 0;
+    while (local_bit_flip_mask < dim &&
+           std::abs(matrix(local_bit_flip_mask, 0)) < tolerance) {
+        ++local_bit_flip_mask;
+    }
+    if (local_bit_flip_mask == dim) return false;
+    const CPPCTYPE phase = matrix(local_bit_flip_mask, 0);
+    ITYPE local_phase_flip_mask = 0;
+    for (UINT k = 0; k < target_index_list.size(); ++k) {
+        const ITYPE column = 1ULL << k;
+        if (std::abs(matrix(column ^ local_bit_flip_mask, column) + phase) <
+            tolerance) {
+            local_phase_flip_mask |= column;
+        }
+    }
+    for (ITYPE column = 0; column < dim; ++column) {
+        for (ITYPE row = 0; row < dim; ++row) {
+            CPPCTYPE expected = 0.;
+            if (row == (column ^ local_bit_flip_mask)) {
+                expected = (count_population_parity(
+                               column & local_phase_flip_mask))
+                               ? -phase
+                               : phase;
+            }
+            if (std::abs(matrix(row, column) - expected) > tolerance) {
+                return false;
+            }
+        }
+    }
+
+    *bit_flip_mask = 0;
+    *phase_flip_mask = 0;
+    for (UINT k = 0; k < target_index_list.size(); ++k) {
+        if ((local_bit_flip_mask >> k) & 1) {
+            *bit_flip_mask |= 1ULL << target_index_list[k];
+        }
+        if ((local_phase_flip_mask >> k) & 1) {
+            *phase_flip_mask |= 1ULL << target_index_list[k];
+        }
+    }
+    return true;
+}
+
+// Frames at the end of the circuit of X_j and Z_j placed after a Clifford
+// gate are updated to those placed before it, ignoring signs. Returns false
+// if the gate is not supported.
+bool conjugate_Pauli_frame_image(const QuantumGateBase* gate,
+    std::vector<std::pair<ITYPE, ITYPE>>& x_image,
+    std::vector<std::pair<ITYPE, ITYPE>>& z_image) {
+    auto add_image = [](std::pair<ITYPE, ITYPE>& image,
+                         const std::pair<ITYPE, ITYPE>& other) {
+        image.first ^= other.first;
+        image.second ^= other.second;
+    };
+    const std::string name = gate->get_name();
+    const std::vector<UINT> target = gate->get_target_index_list();
+    const std::vector<UINT> control = gate->get_control_index_list();
+    if (gate->is_Clifford() && control.empty() && target.size() == 1) {
+        const UINT t = target[0];
+        if (name == "H" || name == "sqrtY" || name == "sqrtYdag") {
+            // X <-> Z
+            std::swap(x_image[t], z_image[t]);
+            return true;
+        } else if (name == "S" || name == "Sdag") {
+            // X -> Y, Z -> Z
+            add_image(x_image[t], z_image[t]);
+            return true;
+        } else if (name == "sqrtX" || name == "sqrtXdag") {
+            // X -> X, Z -> Y
+            add_image(z_image[t], x_image[t]);
+            return true;
+        }
+    } else if (gate->is_Clifford() && control.size() == 1 &&
+               target.size() == 1 && gate->get_control_value_list()[0] == 1) {
+        const UINT c = control[0], t = target[0];
+        if (name == "CNOT") {
+            // X_c -> X_c X_t, Z_t -> Z_c Z_t
+            add_image(x_image[c], x_image[t]);
+            add_image(z_image[t], z_image[c]);
+            return true;
+        } else if (name == "CZ") {
+            // X_c -> X_c Z_t, X_t -> Z_c X_t
+            add_image(x_image[c], z_image[t]);
+            add_image(x_image[t], z_image[c]);
+            return true;
+        }
+    } else if (gate->is_Clifford() && control.empty() && target.size() == 2 &&
+               name == "SWAP") {
+        std::swap(x_image[target[0]], x_image[target[1]]);
+        std::swap(z_image[target[0]], z_image[target[1]]);
+        return true;
+    }
+    // Pauli gates commute with the frames up to a sign
+    ITYPE bit_flip_mask, phase_flip_mask;
+    return get_Pauli_masks_of_gate(gate, &bit_flip_mask, &phase_flip_mask);
+}
+
+// Apply X^x Z^z of a Pauli frame in one pass, ignoring the global phase.
+void apply_pauli_frame(
+    ITYPE bit_flip_mask, ITYPE phase_flip_mask, QuantumState* state) {
+    if (bit_flip_mask == 0 && phase_flip_mask == 0) return;
+    std::vector<UINT> target_index_list;
+    std::vector<UINT> pauli_id_list;
+    for (UINT j = 0; j < state->qubit_count; ++j) {
+        const bool x = (bit_flip_mask >> j) & 1;
+        const bool z = (phase_flip_mask >> j) & 1;
+        if (!x && !z) continue;
+        target_index_list.push_back(j);
+        pauli_id_list.push_back(x ? (z ? 2 : 1) : 3);
+    }
+    multi_qubit_Pauli_gate_partial_list(target_index_list.data(),
+        pauli_id_list.data(), (UINT)target_index_list.size(), state->data_c(),
+        state->dim);
+}
+
+// State after the gates before position, kept at a branching point of the
+// trie.
+struct Checkpoint {
+    UINT position;
+    uint64_t hash;
+    QuantumState* state;
+};
+}  // namespace
+
 /**
  * \~japanese-en 回路にノイズを加えてサンプリングするクラス
  */
@@ -26,12 +254,75 @@ NoiseSimulator::NoiseSimulator(
         initial_state = init_state->copy();
     }
     circuit = init_circuit->copy();
+    checkpoint_memory_budget = DEFAULT_CHECKPOINT_MEMORY_BUDGET;
     for (UINT i = 0; i < circuit->gate_list.size(); ++i) {
         auto gate = circuit->gate_list[i];
         if (!gate->is_noise()) continue;
         dynamic_cast<QuantumGate_Probabilistic*>(gate)
             ->optimize_ProbablisticGate();
     }
+    build_pauli_frame_list();
+}
+
+void NoiseSimulator::build_pauli_frame_list() {
+    const UINT gate_size = (UINT)circuit->gate_list.size();
+    const UINT qubit_count = circuit->qubit_count;
+    pauli_frame_list.assign(gate_size, {});
+    pauli_frame_begin = gate_size;
+
+    // x_image[j] and z_image[j] are the frames at the end of the circuit of
+    // X_j and Z_j placed just before the current gate.
+    std::vector<std::pair<ITYPE, ITYPE>> x_image(qubit_count);
+    std::vector<std::pair<ITYPE, ITYPE>> z_image(qubit_count);
+    for (UINT j = 0; j < qubit_count; ++j) {
+        x_image[j] = std::make_pair(1ULL << j, 0ULL);
+        z_image[j] = std::make_pair(0ULL, 1ULL << j);
+    }
+    for (UINT q = gate_size; q > 0; --q) {
+        auto gate = circuit->gate_list[q - 1];
+        if (!gate->is_noise()) {
+            if (!conjugate_Pauli_frame_image(gate, x_image, z_image)) break;
+            pauli_frame_begin = q - 1;
+            continue;
+        }
+        std::vector<QuantumGateBase*> branch_list =
+            dynamic_cast<QuantumGate_Probabilistic*>(gate)->get_gate_list();
+        std::vector<std::pair<ITYPE, ITYPE>> branch_mask_list;
+        for (auto branch : branch_list) {
+            ITYPE bit_flip_mask, phase_flip_mask;
+            if (!get_Pauli_masks_of_gate(
+                    branch, &bit_flip_mask, &phase_flip_mask)) {
+                break;
+            }
+            branch_mask_list.push_back(
+                std::make_pair(bit_flip_mask, phase_flip_mask));
+        }
+        if (branch_mask_list.size() != branch_list.size()) break;
+
+        // the suffix is simulated with the 0-th gate, so a frame is the
+        // difference from it
+        std::vector<std::pair<ITYPE, ITYPE>>& frame_list =
+            pauli_frame_list[q - 1];
+        for (const auto& branch_mask : branch_mask_list) {
+            const ITYPE bit_flip_mask =
+                branch_mask.first ^ branch_mask_list[0].first;
+            const ITYPE phase_flip_mask =
+                branch_mask.second ^ branch_mask_list[0].second;
+            std::pair<ITYPE, ITYPE> frame(0, 0);
+            for (UINT j = 0; j < qubit_count; ++j) {
+                if ((bit_flip_mask >> j) & 1) {
+                    frame.first ^= x_image[j].first;
+                    frame.second ^= x_image[j].second;
+                }
+                if ((phase_flip_mask >> j) & 1) {
+                    frame.first ^= z_image[j].first;
+                    frame.second ^= z_image[j].second;
+                }
+            }
+            frame_list.push_back(frame);
+        }
+        pauli_frame_begin = q - 1;
+    }
 }
 
 NoiseSimulator::~NoiseSimulator() {
@@ -39,6 +330,12 @@ NoiseSimulator::~NoiseSimulator() {
     delete circuit;
 }
 
+void NoiseSimulator::set_seed(UINT seed) { random.set_seed(seed); }
+
+void NoiseSimulator::set_checkpoint_memory_budget(ITYPE byte_count) {
+    checkpoint_memory_budget = byte_count;
+}
+
 NoiseSimulator::Result::Result(
     const std::vector<std::pair<QuantumState*, UINT>>& result_) {
     std::transform(result_.begin(), result_.end(), std::back_inserter(result),
@@ -63,115 +360,353 @@ std::vector<ITYPE> NoiseSimulator::Result::sampling() const {
     return sampling_result;
 }
 
+std::vector<ITYPE> NoiseSimulator::Result::sampling(UINT seed) const {
+    Random seed_generator;
+    seed_generator.set_seed(seed);
+    std::vector<ITYPE> sampling_result;
+    for (auto& p : result) {
+        std::vector<ITYPE> sampling_result_p =
+            p.first->sampling(p.second, (UINT)seed_generator.int32());
+        std::copy(sampling_result_p.begin(), sampling_result_p.end(),
+            std::back_inserter(sampling_result));
+    }
+    return sampling_result;
+}
+
+CPPCTYPE NoiseSimulator::HistogramResult::get_expectation_value() const {
+    CPPCTYPE sum = 0.;
+    UINT count = 0;
+    for (const auto& p : expectation_value_list) {
+        sum += p.first * (double)p.second;
+        count += p.second;
+    }
+    return (count == 0) ? sum : sum / (double)count;
+}
+
+std::vector<UINT> NoiseSimulator::generate_sampling_seed_list(
+    UINT request_count) {
+    Random seed_generator;
+    seed_generator.set_seed((UINT)random.int32());
+    std::vector<UINT> seed_list(request_count);
+    for (UINT i = 0; i < request_count; ++i) {
+        seed_list[i] = (UINT)seed_generator.int32();
+    }
+    return seed_list;
+}
+
 std::vector<ITYPE> NoiseSimulator::execute(const UINT execution_count) {
-    Result* result = execute_and_get_result(execution_count);
-    std::vector<ITYPE> ret = result->sampling();
-    delete result;
+    const std::vector<SamplingRequest> sampling_requests =
+        generate_sampling_request(execution_count);
+    const UINT request_count = (UINT)sampling_requests.size();
+    std::vector<std::vector<ITYPE>> sampling_result_list(request_count);
+    const std::vector<UINT> seed_list =
+        generate_sampling_seed_list(request_count);
+    simulate(sampling_requests,
+        [&](UINT request_index, QuantumState* state, UINT num_of_sampling) {
+            sampling_result_list[request_index] =
+                state->sampling(num_of_sampling, seed_list[request_index]);
+        });
+
+    std::vector<ITYPE> ret;
+    ret.reserve(execution_count);
+    for (const auto& sampling_result : sampling_result_list) {
+        std::copy(sampling_result.begin(), sampling_result.end(),
+            std::back_inserter(ret));
+    }
     return ret;
 }
 
 NoiseSimulator::Result* NoiseSimulator::execute_and_get_result(
     const UINT sample_count) {
-    std::vector<SamplingRequest> sampling_required =
+    const std::vector<SamplingRequest> sampling_requests =
         generate_sampling_request(sample_count);
-    std::vector<std::pair<QuantumState*, UINT>> simulate_result =
-        simulate(sampling_required);
-    Result* result = new Result(simulate_result);
-    for (const std::pair<QuantumState*, UINT>& p : simulate_result) {
-        delete p.first;
+    std::vector<std::pair<QuantumState*, UINT>> simulate_result(
+        sampling_requests.size());
+    simulate(sampling_requests,
+        [&](UINT request_index, QuantumState* state, UINT num_of_sampling) {
+            simulate_result[request_index] =
+                std::make_pair(state->copy(), num_of_sampling);
+        });
+    Result* result = new Result({});
+    result->result = std::move(simulate_result);
+    return result;
+}
+
+NoiseSimulator::HistogramResult NoiseSimulator::execute_and_get_histogram(
+    const UINT sample_count, const Observable* observable) {
+    const std::vector<SamplingRequest> sampling_requests =
+        generate_sampling_request(sample_count);
+    const UINT request_count = (UINT)sampling_requests.size();
+    HistogramResult result;
+    if (observable != NULL) {
+        result.expectation_value_list.resize(request_count);
     }
+    const std::vector<UINT> seed_list =
+        generate_sampling_seed_list(request_count);
+    simulate(sampling_requests,
+        [&](UINT request_index, QuantumState* state, UINT num_of_sampling) {
+            if (observable != NULL) {
+                result.expectation_value_list[request_index] = std::make_pair(
+                    observable->get_expectation_value(state), num_of_sampling);
+            }
+            const std::vector<ITYPE> sampling_result =
+                state->sampling(num_of_sampling, seed_list[request_index]);
+            // counts do not depend on the order of the requests
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+            {
+                for (ITYPE basis : sampling_result) {
+                    ++result.histogram[basis];
+                }
+            }
+        });
     return result;
 }
 
 std::vector<NoiseSimulator::SamplingRequest>
 NoiseSimulator::generate_sampling_request(const UINT sample_count) {
-    std::vector<std::vector<UINT>> selected_gate_pos(
-        sample_count, std::vector<UINT>(circuit->gate_list.size(), 0));
-
     const UINT gate_size = (UINT)circuit->gate_list.size();
-    for (UINT i = 0; i < sample_count; ++i) {
-        for (UINT j = 0; j < gate_size; ++j) {
-            selected_gate_pos[i][j] =
-                randomly_select_which_gate_pos_to_apply(circuit->gate_list[j]);
-        }
-    }
 
-    std::sort(begin(selected_gate_pos), end(selected_gate_pos));
-    std::reverse(begin(selected_gate_pos), end(selected_gate_pos));
+    // cumulative_weight[k] is the sum of -log(probability of the 0-th gate)
+    // over the first k noise gates. The number of noise gates skipped before
+    // the next error follows from one exponential random variable.
+    std::vector<UINT> noise_gate_index_list;
+    std::vector<double> cumulative_weight(1, 0.);
+    for (UINT q = 0; q < gate_size; ++q) {
+        auto gate = circuit->gate_list[q];
+        if (!gate->is_noise()) continue;
+        const double identity_prob =
+            dynamic_cast<QuantumGate_Probabilistic*>(gate)
+                ->get_distribution()[0];
+        noise_gate_index_list.push_back(q);
+        cumulative_weight.push_back(
+            cumulative_weight.back() -
+            std::log(std::max(identity_prob, DBL_MIN)));
+    }
+    const UINT noise_gate_count = (UINT)noise_gate_index_list.size();
 
     // merge sampling requests with same applied gate.
     // we don't have to recalculate same quantum state twice for sampling.
-    std::vector<SamplingRequest> required_sampling_requests;
-    int current_sampling_count = 0;
+    std::unordered_map<ErrorPattern, UINT, ErrorPatternHash> pattern_count;
+    ErrorPattern pattern;
+    std::vector<std::pair<UINT, UINT>>& error_list = pattern.first;
+    std::pair<ITYPE, ITYPE>& frame = pattern.second;
     for (UINT i = 0; i < sample_count; ++i) {
-        current_sampling_count++;
-        if (i + 1 == sample_count ||
-            selected_gate_pos[i] != selected_gate_pos[i + 1]) {
-            // can not merge (i-th) sampling step and (i+1-th) sampling step
-            // together bacause applied gate is different.
-
-            required_sampling_requests.push_back(
-                SamplingRequest(selected_gate_pos[i], current_sampling_count));
-            current_sampling_count = 0;
+        error_list.clear();
+        frame = std::make_pair(0ULL, 0ULL);
+        UINT noise_pos = 0;
+        while (noise_pos < noise_gate_count) {
+            const double threshold = cumulative_weight[noise_pos] -
+                                     std::log(1. - random.uniform());
+            // first noise gate whose cumulative weight exceeds the threshold
+            noise_pos = (UINT)(std::upper_bound(cumulative_weight.begin() +
+                                                    noise_pos + 1,
+                                   cumulative_weight.end(), threshold) -
+                               cumulative_weight.begin());
+            if (noise_pos > noise_gate_count) break;
+            const UINT q = noise_gate_index_list[noise_pos - 1];
+            const UINT chosen_gate =
+                randomly_select_error_gate_pos(circuit->gate_list[q]);
+            if (q >= pauli_frame_begin) {
+                // propagated to the end of the circuit instead of simulated
+                frame.first ^= pauli_frame_list[q][chosen_gate].first;
+                frame.second ^= pauli_frame_list[q][chosen_gate].second;
+            } else {
+                error_list.push_back(std::make_pair(q, chosen_gate));
+            }
         }
+        ++pattern_count[pattern];
     }
 
-    return required_sampling_requests;
-}
-
-std::vector<std::pair<QuantumState*, UINT>> NoiseSimulator::simulate(
-    std::vector<NoiseSimulator::SamplingRequest> sampling_requests) {
-    std::sort(begin(sampling_requests), end(sampling_requests),
+    std::vector<SamplingRequest> required_sampling_requests;
+    required_sampling_requests.reserve(pattern_count.size());
+    for (const auto& p : pattern_count) {
+        required_sampling_requests.push_back(SamplingRequest(p.first.first,
+            p.second, p.first.second.first, p.first.second.second));
+    }
+    // requests which differ only in the frame share the whole path
+    std::sort(begin(required_sampling_requests),
+        end(required_sampling_requests),
         [](const NoiseSimulator::SamplingRequest& l,
             const NoiseSimulator::SamplingRequest& r) {
-            return l.gate_pos > r.gate_pos;
+            if (l.error_list != r.error_list) {
+                return precedes_error_list(l.error_list, r.error_list);
+            }
+            return std::make_pair(l.bit_flip_mask, l.phase_flip_mask) <
+                   std::make_pair(r.bit_flip_mask, r.phase_flip_mask);
         });
+    return required_sampling_requests;
+}
 
-    std::vector<std::pair<QuantumState*, UINT>> simulation_result;
+void NoiseSimulator::simulate(
+    const std::vector<NoiseSimulator::SamplingRequest>& sampling_requests,
+    const std::function<void(UINT, QuantumState*, UINT)>& consumer) {
+    const UINT request_count = (UINT)sampling_requests.size();
+    const UINT gate_size = (UINT)circuit->gate_list.size();
+    const UINT qubit_count = initial_state->qubit_count;
+    const uint64_t root_hash = random.int64();
 
-    QuantumState common_state(initial_state->qubit_count);
-    QuantumState buffer(initial_state->qubit_count);
+    // The sorted requests are the leaves of a trie over the chosen gates in
+    // depth first order. prefix_length_list[i] is the length of the common
+    // prefix of request i - 1 and i, i.e. the depth where the two paths
+    // branch.
+    std::vector<UINT> prefix_length_list(request_count, 0);
+    for (UINT i = 1; i < request_count; ++i) {
+        prefix_length_list[i] =
+            common_prefix_length(sampling_requests[i - 1].error_list,
+                sampling_requests[i].error_list, gate_size);
+    }
+    // next_shallower_list[i] is the first j > i whose branch is shallower
+    // than that of i. Following it from i + 1 enumerates the branching
+    // points on the path of request i which later requests start from.
+    std::vector<UINT> next_shallower_list(request_count, request_count);
+    {
+        std::vector<UINT> pending;
+        for (UINT i = 1; i < request_count; ++i) {
+            while (!pending.empty() &&
+                   prefix_length_list[pending.back()] > prefix_length_list[i]) {
+                next_shallower_list[pending.back()] = i;
+                pending.pop_back();
+            }
+            pending.push_back(i);
+        }
+    }
 
-    common_state.load(initial_state);
-    UINT done_itr = 0;  // for gates i such that i < done_itr, gate i is already
-                        // applied to common_state.
+    UINT thread_count = 1;
+#ifdef _OPENMP
+    thread_count = (UINT)omp_get_max_threads();
+#endif
+    // Requests are split into contiguous chunks, each walked from the root
+    // of the trie by one thread. A single chunk uses the multi-threaded
+    // kernels.
+    const UINT chunk_count =
+        (thread_count == 1) ? std::min(1U, request_count)
+                            : std::min(request_count, thread_count * 4);
+    thread_count = std::max(1U, std::min(thread_count, chunk_count));
+
+    const ITYPE state_bytes = sizeof(CPPCTYPE) * initial_state->dim;
+    const UINT checkpoint_capacity =
+        (UINT)std::min<ITYPE>(gate_size,
+            checkpoint_memory_budget / thread_count / state_bytes);
+
+    // Gates such as CPTP maps have their own random state, so each worker
+    // applies the gates of its own copy of the circuit.
+    std::vector<QuantumCircuit*> worker_circuit_list(thread_count, circuit);
+    std::vector<QuantumState*> workspace_list(thread_count);
+    std::vector<std::vector<QuantumState*>> checkpoint_pool_list(thread_count);
+    for (UINT thread = 0; thread < thread_count; ++thread) {
+        if (thread > 0) worker_circuit_list[thread] = circuit->copy();
+        workspace_list[thread] = new QuantumState(qubit_count);
+    }
 
-    for (UINT i = 0; i < sampling_requests.size(); ++i) {
-        // if gate[done_itr] will always choice 0-th gate to apply to state, we
-        // can apply 0-th gate of gate[done_itr] to common_state.
+    auto simulate_chunk = [&](UINT chunk_begin, UINT chunk_end, UINT thread) {
+        QuantumCircuit* gate_circuit = worker_circuit_list[thread];
+        QuantumState* workspace = workspace_list[thread];
+        std::vector<QuantumState*>& checkpoint_pool =
+            checkpoint_pool_list[thread];
+        std::vector<Checkpoint> checkpoint_stack;
+        std::vector<UINT> branch_list;
 
-        std::vector<UINT> current_gate_pos = sampling_requests[i].gate_pos;
-        while (done_itr < current_gate_pos.size() &&
-               current_gate_pos[done_itr] == 0) {
-            auto gate = circuit->gate_list[done_itr];
-            if (!gate->is_noise()) {
-                gate->update_quantum_state(&common_state);
+        for (UINT i = chunk_begin; i < chunk_end; ++i) {
+            const std::vector<std::pair<UINT, UINT>>& error_list =
+                sampling_requests[i].error_list;
+            const UINT shared_length =
+                (i == chunk_begin) ? 0 : prefix_length_list[i];
+            while (!checkpoint_stack.empty() &&
+                   checkpoint_stack.back().position > shared_length) {
+                checkpoint_pool.push_back(checkpoint_stack.back().state);
+                checkpoint_stack.pop_back();
+            }
+
+            UINT position = 0;
+            uint64_t hash = root_hash;
+            if (checkpoint_stack.empty()) {
+                workspace->load(initial_state);
             } else {
-                dynamic_cast<QuantumGate_Probabilistic*>(gate)
-                    ->get_gate_list()[current_gate_pos[done_itr]]
-                    ->update_quantum_state(&common_state);
+                workspace->load(checkpoint_stack.back().state);
+                position = checkpoint_stack.back().position;
+                hash = checkpoint_stack.back().hash;
+            }
+
+            // branching points of the following requests in this chunk,
+            // from the deepest one
+            branch_list.clear();
+            for (UINT j = i + 1; j < chunk_end; j = next_shallower_list[j]) {
+                if (prefix_length_list[j] <= position) break;
+                branch_list.push_back(prefix_length_list[j]);
             }
-            done_itr++;
+
+            // the shallowest branching points are shared by more requests,
+            // so they are kept first when the budget is exhausted
+            while (!branch_list.empty() &&
+                   checkpoint_stack.size() < checkpoint_capacity) {
+                const UINT branch = branch_list.back();
+                branch_list.pop_back();
+                hash = apply_gates(error_list, workspace, position, branch,
+                    gate_circuit, hash);
+                position = branch;
+                QuantumState* checkpoint_state;
+                if (checkpoint_pool.empty()) {
+                    checkpoint_state = new QuantumState(qubit_count);
+                } else {
+                    checkpoint_state = checkpoint_pool.back();
+                    checkpoint_pool.pop_back();
+                }
+                checkpoint_state->load(workspace);
+                checkpoint_stack.push_back({position, hash, checkpoint_state});
+            }
+            apply_gates(error_list, workspace, position, gate_size,
+                gate_circuit, hash);
+            apply_pauli_frame(sampling_requests[i].bit_flip_mask,
+                sampling_requests[i].phase_flip_mask, workspace);
+            consumer(i, workspace, sampling_requests[i].num_of_sampling);
         }
+        for (const Checkpoint& checkpoint : checkpoint_stack) {
+            checkpoint_pool.push_back(checkpoint.state);
+        }
+    };
 
-        buffer.load(&common_state);
-        apply_gates(current_gate_pos, &buffer, done_itr);
-        simulation_result.emplace_back(
-            buffer.copy(), sampling_requests[i].num_of_sampling);
+    if (chunk_count <= 1) {
+        simulate_chunk(0, request_count, 0);
+    } else {
+        // Each worker owns a workspace and its checkpoints. Kernels called
+        // inside the parallel region run on a single thread.
+        int chunk;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1) num_threads(thread_count)
+#endif
+        for (chunk = 0; chunk < (int)chunk_count; ++chunk) {
+            UINT thread = 0;
+#ifdef _OPENMP
+            thread = (UINT)omp_get_thread_num();
+#endif
+            simulate_chunk((UINT)((ITYPE)request_count * chunk / chunk_count),
+                (UINT)((ITYPE)request_count * (chunk + 1) / chunk_count),
+                thread);
+        }
     }
-    return simulation_result;
-}
 
-UINT NoiseSimulator::randomly_select_which_gate_pos_to_apply(
-    QuantumGateBase* gate) {
-    if (!gate->is_noise()) return 0;
+    for (UINT thread = 0; thread < thread_count; ++thread) {
+        if (thread > 0) delete worker_circuit_list[thread];
+        delete workspace_list[thread];
+        for (QuantumState* checkpoint_state : checkpoint_pool_list[thread]) {
+            delete checkpoint_state;
+        }
+    }
+}
 
+UINT NoiseSimulator::randomly_select_error_gate_pos(QuantumGateBase* gate) {
     std::vector<double> current_cumulative_distribution =
         dynamic_cast<QuantumGate_Probabilistic*>(gate)
             ->get_cumulative_distribution();
-    double tmp = random.uniform();
+    // draw from the distribution restricted to the gates except the 0-th
+    const double identity_prob = current_cumulative_distribution[1];
+    const double error_prob =
+        current_cumulative_distribution.back() - identity_prob;
+    double tmp = identity_prob + random.uniform() * error_prob;
     auto gate_iterator =
-        std::lower_bound(begin(current_cumulative_distribution),
+        std::upper_bound(begin(current_cumulative_distribution) + 1,
             end(current_cumulative_distribution), tmp);
 
     // -1 is applied to gate_pos since gate_iterator is based on
@@ -179,20 +714,33 @@ UINT NoiseSimulator::randomly_select_which_gate_pos_to_apply(
     auto gate_pos =
         std::distance(begin(current_cumulative_distribution), gate_iterator) -
         1;
-    return gate_pos;
-};
+    // rounding can give the end of the distribution
+    return (UINT)std::min<ptrdiff_t>(
+        gate_pos, (ptrdiff_t)current_cumulative_distribution.size() - 2);
+}
 
-void NoiseSimulator::apply_gates(const std::vector<UINT>& chosen_gate,
-    QuantumState* sampling_state, const int StartPos) {
-    const UINT gate_size = (UINT)circuit->gate_list.size();
-    for (UINT q = StartPos; q < gate_size; ++q) {
-        auto gate = circuit->gate_list[q];
+uint64_t NoiseSimulator::apply_gates(
+    const std::vector<std::pair<UINT, UINT>>& error_list,
+    QuantumState* sampling_state, const UINT begin_pos, const UINT end_pos,
+    QuantumCircuit* gate_circuit, uint64_t hash) {
+    auto error_itr = std::lower_bound(
+        error_list.begin(), error_list.end(), std::make_pair(begin_pos, 0U));
+    for (UINT q = begin_pos; q < end_pos; ++q) {
+        UINT chosen_gate = 0;
+        if (error_itr != error_list.end() && error_itr->first == q) {
+            chosen_gate = error_itr->second;
+            ++error_itr;
+        }
+        auto gate = gate_circuit->gate_list[q];
         if (!gate->is_noise()) {
+            gate->set_seed((int)hash);
             gate->update_quantum_state(sampling_state);
         } else {
             dynamic_cast<QuantumGate_Probabilistic*>(gate)
-                ->get_gate_list()[chosen_gate[q]]
+                ->get_gate_list()[chosen_gate]
                 ->update_quantum_state(sampling_state);
         }
+        hash = mix_gate_pos(hash, chosen_gate);
     }
+    return hash;
 }
@@ -5,8 +5,12 @@
 #include "circuit.hpp"
 #include "gate_factory.hpp"
 #include "gate_merge.hpp"
+#include "observable.hpp"
 #include "state.hpp"
 
+#include <functional>
+#include <map>
+
 /**
  * \~japanese-en 回路にDepolarizingNoiseを加えてサンプリングするクラス
  */
@@ -16,6 +20,19 @@ private:
     Random random;
     QuantumCircuit* circuit;
     QuantumStateBase* initial_state;
+    ITYPE checkpoint_memory_budget;
+    /**
+     * \~japanese-en
+     * この位置以降のゲートはすべてPauliフレームで追跡できる。
+     * ノイズゲートはPauliゲートを確率的に選ぶもので、それ以外はCliffordゲートかPauliゲートである。
+     */
+    UINT pauli_frame_begin;
+    /**
+     * \~japanese-en
+     * pauli_frame_begin以降のノイズゲートで各ゲートが選ばれたとき、0番目のゲートとの差を回路の最後まで伝播させたPauliフレーム。
+     * ビット反転と位相反転のマスクの組で、ゲートの位置と選ばれたゲートの番号で引く。
+     */
+    std::vector<std::vector<std::pair<ITYPE, ITYPE>>> pauli_frame_list;
 
     /**
      * \~japanese-en
@@ -25,27 +42,67 @@ private:
     struct SamplingRequest {
         /**
          * \~japanese-en
-         * 1つのゲート内で複数のゲートのうちどれかが選ばれる時、どのゲートを選んでサンプリングすべきかを示す値のvector。
+         * 1つのゲート内で複数のゲートのうちどれかが選ばれる時、0番目以外のゲートが選ばれたゲートの位置と選ばれたゲートの番号の組のvector。
+         * ゲートの位置の昇順に並ぶ。含まれないゲートでは0番目のゲートが選ばれる。
          */
-        std::vector<UINT> gate_pos;
+        std::vector<std::pair<UINT, UINT>> error_list;
         /**
          * \~japanese-en
          *
          * サンプリング回数。
          */
         UINT num_of_sampling;
-        SamplingRequest(
-            std::vector<UINT> init_gate_pos, UINT init_num_of_sampling)
-            : gate_pos(init_gate_pos), num_of_sampling(init_num_of_sampling) {}
+        /**
+         * \~japanese-en
+         *
+         * pauli_frame_begin以降で選ばれたゲートによる、最終状態に適用するPauliフレームのビット反転と位相反転のマスク。
+         */
+        ITYPE bit_flip_mask;
+        ITYPE phase_flip_mask;
+        SamplingRequest(std::vector<std::pair<UINT, UINT>> init_error_list,
+            UINT init_num_of_sampling, ITYPE init_bit_flip_mask = 0,
+            ITYPE init_phase_flip_mask = 0)
+            : error_list(init_error_list),
+              num_of_sampling(init_num_of_sampling),
+              bit_flip_mask(init_bit_flip_mask),
+              phase_flip_mask(init_phase_flip_mask) {}
     };
 
-    void apply_gates(const std::vector<UINT>& chosen_gate,
-        QuantumState* sampling_state, const int StartPos);
+    /**
+     * \~japanese-en
+     *
+     * 回路の末尾のCliffordな区間を求め、その中のノイズゲートの各ゲートについてPauliフレームを計算する。
+     * 回路の最後から逆向きに、各量子ビットのX, Zが最後に何になるかを更新していく。
+     */
+    void build_pauli_frame_list();
+
+    /**
+     * \~japanese-en
+     *
+     * error_listに従ってbegin_pos番目からend_pos番目の手前までのゲートを適用する。
+     * ノイズでないゲートは適用前にそれまでに選ばれたゲートのハッシュをシードとして初期化されるため、
+     * CPTPのように内部で乱数を使うゲートの結果は選ばれたゲートの列だけで決まる。
+     * @param[in] error_list 0番目以外のゲートが選ばれたゲートの位置と番号の組
+     * @param[in] sampling_state 更新する量子状態
+     * @param[in] begin_pos 適用を始めるゲートの位置
+     * @param[in] end_pos 適用を終えるゲートの位置
+     * @param[in] gate_circuit ゲートを取り出す回路。スレッドごとに異なるコピーを用いる。
+     * @param[in] hash begin_pos番目までに選ばれたゲートのハッシュ
+     * @return end_pos番目までに選ばれたゲートのハッシュ
+     */
+    uint64_t apply_gates(const std::vector<std::pair<UINT, UINT>>& error_list,
+        QuantumState* sampling_state, const UINT begin_pos, const UINT end_pos,
+        QuantumCircuit* gate_circuit, uint64_t hash);
 
     /**
      * \~japanese-en
      *
      * サンプリングの回数だけを入力して、実際にどうゲートを適用してサンプリングするかの計画であるSamplingRequestのvectorを生成する関数。
+     *
+     * 各ノイズゲートで0番目のゲートが選ばれる確率の対数の累積和を使い、
+     * 次に0番目以外のゲートが選ばれるノイズゲートまで幾何分布に従って読み飛ばす。
+     * pauli_frame_begin以降で0番目以外のゲートが選ばれた場合は、状態を計算し直す代わりにPauliフレームとして記録する。
+     * 同じゲートの選び方はハッシュで集約され、トライ木を深さ優先で辿る順に並べて返す。
      * @param[in] sample_count 行うサンプリングの回数
      */
     std::vector<SamplingRequest> generate_sampling_request(
@@ -55,19 +112,38 @@ private:
      * \~japanese-en
      *
      * ノイズゲートの場合、ノイズあり/なしで複数個のゲートのうちどれか一つが選ばれる。
-     * どちらを選ぶかを決めて適用するゲートの番号を返す関数。
+     * 0番目以外のゲートが選ばれたという条件の下で、どれを選ぶかを決めて適用するゲートの番号を返す関数。
      * @param[in] gate 入力ゲート
      */
-    UINT randomly_select_which_gate_pos_to_apply(QuantumGateBase* gate);
+    UINT randomly_select_error_gate_pos(QuantumGateBase* gate);
+
+    /**
+     * \~japanese-en
+     *
+     * SamplingRequestの計画通りにシミュレーションを行い、各リクエストの最終状態をconsumerに渡す。
+     *
+     * リクエストを各ゲートで選ばれたゲートの列のトライ木の葉として深さ優先で辿り、
+     * 分岐点の状態をチェックポイントのスタックに保存して共通の接頭辞を一度だけ計算する。
+     * チェックポイントの数はcheckpoint_memory_budgetで制限される。
+     * Pauliフレームは最終状態に一度のビット反転と位相反転として適用される。
+     * リクエストは連続する区間ごとにスレッドへ分配され、各スレッドは自身の状態の上で
+     * シングルスレッドのカーネルで計算する。
+     * 乱数は選ばれたゲートの列から決まるので、結果はスレッド数やメモリ量によらない。
+     * @param[in] sampling_requests generate_sampling_requestで生成したSamplingRequestのvector
+     * @param[in] consumer
+     * リクエストの番号、最終状態、サンプリング回数を受け取る関数。
+     * 異なるリクエストについて複数のスレッドから同時に呼ばれ、状態は呼び出しの後に再利用される。
+     */
+    void simulate(const std::vector<SamplingRequest>& sampling_requests,
+        const std::function<void(UINT, QuantumState*, UINT)>& consumer);
 
     /**
      * \~japanese-en
      *
-     * SamplingRequestの計画通りにシミュレーションを行い、結果をpairの配列で返す。
-     * @param[in] sampling_request_vector SamplingRequestのvector
+     * リクエストごとのサンプリングのシードを生成する。
+     * @param[in] request_count リクエストの数
      */
-    std::vector<std::pair<QuantumState*, UINT>> simulate(
-        std::vector<SamplingRequest> sampling_request_vector);
+    std::vector<UINT> generate_sampling_seed_list(UINT request_count);
 
 public:
     /**
@@ -80,6 +156,39 @@ public:
         Result(const std::vector<std::pair<QuantumState*, UINT>>& result_);
         ~Result();
         std::vector<ITYPE> sampling() const;
+        /**
+         * \~japanese-en
+         *
+         * シードを指定してサンプリングを行う。
+         * @param[in] seed 各状態のサンプリングに使うシードを生成するシード
+         */
+        std::vector<ITYPE> sampling(UINT seed) const;
+    };
+
+    /**
+     * \~japanese-en
+     * 量子状態を保持せずに、サンプリング結果のヒストグラムと期待値だけをまとめた構造体
+     */
+    struct HistogramResult {
+    public:
+        /**
+         * \~japanese-en 測定された基底と回数
+         */
+        std::map<ITYPE, UINT> histogram;
+        /**
+         * \~japanese-en
+         * 異なるノイズのかかり方ごとの最終状態でのオブザーバブルの期待値と、その回数。
+         * オブザーバブルが指定されなかった場合は空。
+         */
+        std::vector<std::pair<CPPCTYPE, UINT>> expectation_value_list;
+
+        /**
+         * \~japanese-en
+         *
+         * 回数で重み付けした期待値の平均を返す。
+         * @return 期待値の平均
+         */
+        CPPCTYPE get_expectation_value() const;
     };
 
     /**
@@ -100,6 +209,23 @@ public:
      */
     virtual ~NoiseSimulator();
 
+    /**
+     * \~japanese-en
+     *
+     * 乱数のシードを設定する。同じシードからは、スレッド数によらず同じ結果が得られる。
+     * @param[in] seed シード値
+     */
+    virtual void set_seed(UINT seed);
+
+    /**
+     * \~japanese-en
+     *
+     * 分岐点の量子状態を保存するチェックポイントに使うメモリ量の上限を設定する。
+     * 全スレッドの合計で、既定値は1GiB。0の場合は各リクエストを初期状態から計算する。
+     * @param[in] byte_count メモリ量の上限(バイト)
+     */
+    virtual void set_checkpoint_memory_budget(ITYPE byte_count);
+
     /**
      * \~japanese-en
      *
@@ -117,4 +243,18 @@ public:
      * 量子状態の列。Resultクラスに入れられる。
      */
     virtual Result* execute_and_get_result(const UINT execution_count);
+
+    /**
+     * \~japanese-en
+     *
+     * サンプリングを行い、結果をヒストグラムとして返す。
+     * 各最終状態はシミュレーションの直後にサンプリングされて破棄されるため、
+     * 保持する量子状態はスレッド数程度で済む。同じシードではexecuteと同じ結果を与える。
+     * @param[in] sample_count 行うsamplingの回数
+     * @param[in] observable
+     * 指定された場合、各最終状態での期待値も計算する。
+     * @return ヒストグラムと期待値
+     */
+    virtual HistogramResult execute_and_get_histogram(
+        const UINT sample_count, const Observable* observable = NULL);
 };
@@ -8,6 +8,7 @@
 
 #include <csim/stat_ops.hpp>
 #include <csim/stat_ops_dm.hpp>
+#include <csim/stat_ops_float.hpp>
 
 #include "exception.hpp"
 #include "gate_factory.hpp"
@@ -129,6 +130,26 @@ void PauliOperator::add_single_Pauli(UINT qubit_index, UINT pauli_type) {
     }
 }
 
+void PauliOperator::get_Pauli_masks(ITYPE* bit_flip_mask,
+    ITYPE* phase_flip_mask, UINT* global_phase_90rot_count) const {
+    // same convention as get_Pauli_masks_partial_list in csim
+    (*bit_flip_mask) = 0;
+    (*phase_flip_mask) = 0;
+    (*global_phase_90rot_count) = 0;
+    for (const SinglePauliOperator& pauli : _pauli_list) {
+        const ITYPE mask = 1ULL << pauli.index();
+        if (pauli.pauli_id() == 1 || pauli.pauli_id() == 2) {
+            (*bit_flip_mask) ^= mask;
+        }
+        if (pauli.pauli_id() == 2 || pauli.pauli_id() == 3) {
+            (*phase_flip_mask) ^= mask;
+        }
+        if (pauli.pauli_id() == 2) {
+            ++(*global_phase_90rot_count);
+        }
+    }
+}
+
 CPPCTYPE PauliOperator::get_expectation_value(
     const QuantumStateBase* state) const {
     if (state->qubit_count < this->get_qubit_count()) {
@@ -140,6 +161,14 @@ CPPCTYPE PauliOperator::get_expectation_value(
             std::to_string(this->get_qubit_count()) +
             " QuantumState: " + std::to_string(state->qubit_count));
     }
+    if (state->is_single_precision() && state->is_state_vector()) {
+        return _coef *
+               float_expectation_value_multi_qubit_Pauli_operator_partial_list(
+                   this->get_index_list().data(),
+                   this->get_pauli_id_list().data(),
+                   (UINT)this->get_index_list().size(),
+                   reinterpret_cast<const CTYPE_F*>(state->data()), state->dim);
+    }
     if (state->is_state_vector()) {
 #ifdef _USE_GPU
         if (state->get_device_name() == "gpu") {
@@ -184,6 +213,15 @@ CPPCTYPE PauliOperator::get_expectation_value(
 
 CPPCTYPE PauliOperator::get_expectation_value_single_thread(
     const QuantumStateBase* state) const {
+    if (state->is_single_precision() && state->is_state_vector()) {
+        // nested in a parallel region, the kernel runs on the calling thread
+        return _coef *
+               float_expectation_value_multi_qubit_Pauli_operator_partial_list(
+                   this->get_index_list().data(),
+                   this->get_pauli_id_list().data(),
+                   (UINT)this->get_index_list().size(),
+                   reinterpret_cast<const CTYPE_F*>(state->data()), state->dim);
+    }
     if (state->is_state_vector()) {
 #ifdef _USE_GPU
         if (state->get_device_name() == "gpu") {
@@ -243,6 +243,18 @@ public:
      */
     virtual boost::dynamic_bitset<> get_z_bits() const { return _z; }
 
+    /**
+     * \~japanese-en
+     * 自身をビット反転マスクと位相反転マスクで表す
+     *
+     * 添字が64以上の量子ビットに作用する場合は使えない。
+     * @param[out] bit_flip_mask XまたはYが作用する量子ビットのマスク
+     * @param[out] phase_flip_mask YまたはZが作用する量子ビットのマスク
+     * @param[out] global_phase_90rot_count Yの個数
+     */
+    virtual void get_Pauli_masks(ITYPE* bit_flip_mask, ITYPE* phase_flip_mask,
+        UINT* global_phase_90rot_count) const;
+
     virtual ~PauliOperator(){};
 
     /**
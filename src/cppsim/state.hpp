@@ -125,6 +125,13 @@ public:
      */
     virtual bool is_state_vector() const { return this->_is_state_vector; }
 
+    /**
+     * \~japanese-en 量子状態が単精度で保持されているかを判定する
+     *
+     * 単精度の量子状態ではdata_c()やdata_cpp()は使えず、data()が<code>std::complex\<float\></code>の配列を返す。
+     */
+    virtual bool is_single_precision() const { return false; }
+
     /**
      * \~japanese-en 量子状態を計算基底の0状態に初期化する
      */
@@ -420,6 +427,18 @@ class QuantumStateCpu : public QuantumStateBase {
 private:
     CPPCTYPE* _state_vector;
     Random random;
+    AllocationPolicy _allocation_policy = get_default_allocation_policy();
+
+    // a copy of source whose pages are first touched by the copy
+    QuantumStateCpu(UINT qubit_count_, AllocationPolicy allocation_policy,
+        const CPPCTYPE* source)
+        : QuantumStateBase(qubit_count_, true),
+          _allocation_policy(allocation_policy) {
+        this->_state_vector =
+            reinterpret_cast<CPPCTYPE*>(allocate_quantum_state_copy_with_policy(
+                reinterpret_cast<const CTYPE*>(source), this->_dim,
+                _allocation_policy));
+    }
 
 public:
     /**
@@ -429,9 +448,31 @@ public:
      */
     explicit QuantumStateCpu(UINT qubit_count_)
         : QuantumStateBase(qubit_count_, true) {
-        this->_state_vector =
-            reinterpret_cast<CPPCTYPE*>(allocate_quantum_state(this->_dim));
-        initialize_quantum_state(this->data_c(), _dim);
+        this->_state_vector = reinterpret_cast<CPPCTYPE*>(
+            allocate_quantum_state_with_policy(this->_dim, _allocation_policy));
+        if (!(_allocation_policy & ALLOCATION_FIRST_TOUCH)) {
+            initialize_quantum_state(this->data_c(), _dim);
+        }
+    }
+
+    /**
+     * \~japanese-en コンストラクタ
+     *
+     * 状態ベクトルのメモリ確保方法を指定する。
+     * 指定しない場合は環境変数 QULACS_ALLOCATION
+     * で決まる既定の方法が使われる。
+     * @param qubit_count_ 量子ビット数
+     * @param allocation_policy メモリ確保方法
+     */
+    explicit QuantumStateCpu(
+        UINT qubit_count_, AllocationPolicy allocation_policy)
+        : QuantumStateBase(qubit_count_, true),
+          _allocation_policy(allocation_policy) {
+        this->_state_vector = reinterpret_cast<CPPCTYPE*>(
+            allocate_quantum_state_with_policy(this->_dim, _allocation_policy));
+        if (!(_allocation_policy & ALLOCATION_FIRST_TOUCH)) {
+            initialize_quantum_state(this->data_c(), _dim);
+        }
     }
 
     /**
@@ -442,15 +483,17 @@ public:
      */
     explicit QuantumStateCpu(UINT qubit_count_, bool use_multi_cpu)
         : QuantumStateBase(qubit_count_, true, (int)use_multi_cpu) {
-        this->_state_vector =
-            reinterpret_cast<CPPCTYPE*>(allocate_quantum_state(this->_dim));
+        this->_state_vector = reinterpret_cast<CPPCTYPE*>(
+            allocate_quantum_state_with_policy(this->_dim, _allocation_policy));
 #ifdef _USE_MPI
         if (this->outer_qc > 0)
             initialize_quantum_state_mpi(this->data_c(), _dim, this->outer_qc);
         else
 #endif
         {
-            initialize_quantum_state(this->data_c(), _dim);
+            if (!(_allocation_policy & ALLOCATION_FIRST_TOUCH)) {
+                initialize_quantum_state(this->data_c(), _dim);
+            }
         }
     }
 
@@ -467,6 +510,15 @@ public:
         release_quantum_state(this->data_c());
     }
 
+    /**
+     * \~japanese-en 状態ベクトルのメモリ確保方法を取得する
+     *
+     * @return メモリ確保方法
+     */
+    AllocationPolicy get_allocation_policy() const {
+        return _allocation_policy;
+    }
+
     /**
      * \~japanese-en 量子状態を計算基底の0状態に初期化する
      */
@@ -675,7 +727,7 @@ public:
         else
             new_state = new QuantumStateCpu(this->_qubit_count, false);
 #else
-        new_state = new QuantumStateCpu(this->_qubit_count);
+        new_state = new QuantumStateCpu(this->_qubit_count, _allocation_policy);
 #endif
         return new_state;
     }
@@ -685,10 +737,18 @@ public:
      * @return 自身のディープコピー
      */
     virtual QuantumStateCpu* copy() const override {
-        QuantumStateCpu* new_state = this->allocate_buffer();
-
-        memcpy(new_state->data_cpp(), _state_vector,
-            (size_t)(sizeof(CPPCTYPE) * _dim));
+        QuantumStateCpu* new_state;
+#ifdef _USE_MPI
+        if (this->outer_qc > 0) {
+            new_state = this->allocate_buffer();
+            memcpy(new_state->data_cpp(), _state_vector,
+                (size_t)(sizeof(CPPCTYPE) * _dim));
+        } else
+#endif
+        {
+            new_state = new QuantumStateCpu(
+                this->_qubit_count, _allocation_policy, _state_vector);
+        }
         for (UINT i = 0; i < _classical_register.size(); ++i) {
             new_state->set_classical_value(i, _classical_register[i]);
         }
@@ -711,7 +771,8 @@ public:
         }
 
         this->_classical_register = _state->classical_register;
-        if (_state->get_device_name() == "gpu") {
+        if (_state->get_device_name() == "gpu" ||
+            _state->is_single_precision()) {
             auto ptr = _state->duplicate_data_cpp();
             memcpy(this->data_cpp(), ptr, (size_t)(sizeof(CPPCTYPE) * _dim));
             free(ptr);
@@ -744,9 +805,8 @@ public:
             } else
 #endif
             {
-                // load cpu to multicpu
-                memcpy(this->data_cpp(), _state->data_cpp(),
-                    (size_t)(sizeof(CPPCTYPE) * _dim));
+                // load cpu to cpu
+                copy_quantum_state(_state->data_c(), this->data_c(), _dim);
             }
         }
     }
@@ -759,15 +819,16 @@ public:
                 "Error: QuantumStateCpu::load(vector<Complex>&): invalid "
                 "length of state");
         }
-        memcpy(
-            this->data_cpp(), _state.data(), (size_t)(sizeof(CPPCTYPE) * _dim));
+        copy_quantum_state(reinterpret_cast<const CTYPE*>(_state.data()),
+            this->data_c(), _dim);
     }
 
     /**
      * \~japanese-en <code>state</code>の量子状態を自身へコピーする。
      */
     virtual void load(const CPPCTYPE* _state) override {
-        memcpy(this->data_cpp(), _state, (size_t)(sizeof(CPPCTYPE) * _dim));
+        copy_quantum_state(
+            reinterpret_cast<const CTYPE*>(_state), this->data_c(), _dim);
     }
 
     /**
@@ -906,23 +967,15 @@ public:
             return this->sampling(sampling_count, seed);
         }
 #endif
-        std::vector<double> stacked_prob;
-        std::vector<ITYPE> result;
-        double sum = 0.;
-        auto ptr = this->data_cpp();
-        stacked_prob.push_back(0.);
-        for (ITYPE i = 0; i < this->dim; ++i) {
-            sum += norm(ptr[i]);
-            stacked_prob.push_back(sum);
-        }
-
-        for (ITYPE count = 0; count < sampling_count; ++count) {
-            double r = random.uniform();
-            auto ite =
-                std::lower_bound(stacked_prob.begin(), stacked_prob.end(), r);
-            auto index = std::distance(stacked_prob.begin(), ite) - 1;
-            result.push_back(index);
+        // the uniforms are drawn in order so that the result only depends
+        // on the seed, and the shots are resolved in parallel
+        std::vector<double> uniform_list(sampling_count);
+        for (UINT count = 0; count < sampling_count; ++count) {
+            uniform_list[count] = random.uniform();
         }
+        std::vector<ITYPE> result(sampling_count);
+        state_sampling(this->data_c(), this->dim, uniform_list.data(),
+            sampling_count, result.data());
         return result;
     }
 
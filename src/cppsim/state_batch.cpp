@@ -0,0 +1,277 @@
+#include "state_batch.hpp"
+
+#include <algorithm>
+
+#include <csim/memory_ops.hpp>
+#include <csim/stat_ops_batch.hpp>
+#include <csim/update_ops_batch.hpp>
+
+#include "circuit.hpp"
+#include "gate.hpp"
+#include "general_quantum_operator.hpp"
+#include "pauli_operator.hpp"
+
+QuantumStateBatch::QuantumStateBatch(UINT qubit_count_, UINT batch_size_)
+    : _qubit_count(qubit_count_),
+      _dim(1ULL << qubit_count_),
+      _batch_size(batch_size_),
+      qubit_count(_qubit_count),
+      dim(_dim),
+      batch_size(_batch_size) {
+    if (batch_size_ == 0) {
+        throw InvalidStateVectorSizeException(
+            "Error: QuantumStateBatch::QuantumStateBatch(UINT, UINT): "
+            "batch_size must be positive");
+    }
+    this->_state_vector = reinterpret_cast<CPPCTYPE*>(
+        allocate_quantum_state(this->_dim * this->_batch_size));
+    batch_initialize_quantum_state(this->data_c(), _dim, _batch_size);
+}
+
+QuantumStateBatch::~QuantumStateBatch() {
+    release_quantum_state(this->data_c());
+}
+
+void QuantumStateBatch::set_zero_state() {
+    batch_initialize_quantum_state(this->data_c(), _dim, _batch_size);
+}
+
+void QuantumStateBatch::set_computational_basis(ITYPE comp_basis) {
+    if (comp_basis >= _dim) {
+        throw MatrixIndexOutOfRangeException(
+            "Error: QuantumStateBatch::set_computational_basis(ITYPE): index "
+            "of computational basis must be smaller than 2^qubit_count");
+    }
+    this->set_zero_state();
+    for (UINT element = 0; element < _batch_size; ++element) {
+        _state_vector[element] = 0.;
+        _state_vector[comp_basis * _batch_size + element] = 1.;
+    }
+}
+
+void QuantumStateBatch::set_Haar_random_state(UINT seed) {
+    QuantumState state(_qubit_count);
+    for (UINT element = 0; element < _batch_size; ++element) {
+        state.set_Haar_random_state(seed + element);
+        this->load(element, &state);
+    }
+}
+
+void QuantumStateBatch::load(UINT element, const QuantumStateBase* state) {
+    if (element >= _batch_size) {
+        throw InvalidStateVectorSizeException(
+            "Error: QuantumStateBatch::load(UINT, const QuantumStateBase*): "
+            "element index must be smaller than batch_size");
+    }
+    if (state->qubit_count != _qubit_count || !state->is_state_vector()) {
+        throw InvalidQubitCountException(
+            "Error: QuantumStateBatch::load(UINT, const QuantumStateBase*): "
+            "invalid qubit count");
+    }
+    CPPCTYPE* data = state->duplicate_data_cpp();
+    for (ITYPE index = 0; index < _dim; ++index) {
+        _state_vector[index * _batch_size + element] = data[index];
+    }
+    free(data);
+}
+
+void QuantumStateBatch::load(const QuantumStateBase* state) {
+    for (UINT element = 0; element < _batch_size; ++element) {
+        this->load(element, state);
+    }
+}
+
+std::vector<CPPCTYPE> QuantumStateBatch::get_vector(UINT element) const {
+    if (element >= _batch_size) {
+        throw InvalidStateVectorSizeException(
+            "Error: QuantumStateBatch::get_vector(UINT): element index must "
+            "be smaller than batch_size");
+    }
+    std::vector<CPPCTYPE> result(_dim);
+    for (ITYPE index = 0; index < _dim; ++index) {
+        result[index] = _state_vector[index * _batch_size + element];
+    }
+    return result;
+}
+
+std::vector<double> QuantumStateBatch::get_squared_norm() const {
+    std::vector<double> result(_batch_size);
+    batch_state_norm_squared(this->data_c(), _dim, _batch_size, result.data());
+    return result;
+}
+
+void QuantumStateBatch::normalize(const std::vector<double>& squared_norm_list) {
+    if (squared_norm_list.size() != _batch_size) {
+        throw InvalidStateVectorSizeException(
+            "Error: QuantumStateBatch::normalize(const std::vector<double>&): "
+            "the size of squared_norm_list must be batch_size");
+    }
+    batch_normalize(
+        squared_norm_list.data(), this->data_c(), _dim, _batch_size);
+}
+
+void QuantumStateBatch::update_quantum_state(const QuantumGateBase* gate) {
+    const std::string name = gate->get_name();
+    if (name == "Probabilistic" || name == "CPTP" || name == "CP" ||
+        name == "Adaptive") {
+        throw NotImplementedException(
+            "Error: QuantumStateBatch::update_quantum_state(const "
+            "QuantumGateBase*): " +
+            name + " gate is not supported");
+    }
+    std::vector<UINT> target_index = gate->get_target_index_list();
+    std::vector<UINT> control_index = gate->get_control_index_list();
+    std::vector<UINT> control_value = gate->get_control_value_list();
+    for (UINT index : target_index) {
+        if (index >= _qubit_count) {
+            throw QubitIndexOutOfRangeException(
+                "Error: QuantumStateBatch::update_quantum_state(const "
+                "QuantumGateBase*): index of qubit is out of range");
+        }
+    }
+    for (UINT index : control_index) {
+        if (index >= _qubit_count) {
+            throw QubitIndexOutOfRangeException(
+                "Error: QuantumStateBatch::update_quantum_state(const "
+                "QuantumGateBase*): index of qubit is out of range");
+        }
+    }
+    ComplexMatrix matrix;
+    gate->set_matrix(matrix);
+    // ComplexMatrix is row-major as the csim kernels expect
+    const CTYPE* matrix_ptr = reinterpret_cast<const CTYPE*>(matrix.data());
+    const UINT target_count = (UINT)target_index.size();
+
+    if (control_index.empty() && matrix.isDiagonal(0.)) {
+        std::vector<CTYPE> diagonal(matrix.rows());
+        for (ITYPE i = 0; i < (ITYPE)matrix.rows(); ++i) {
+            diagonal[i] = matrix(i, i);
+        }
+        batch_multi_qubit_diagonal_matrix_gate(target_index.data(),
+            target_count, diagonal.data(), this->data_c(), _dim, _batch_size);
+    } else if (control_index.empty() && target_count == 1) {
+        batch_single_qubit_dense_matrix_gate(
+            target_index[0], matrix_ptr, this->data_c(), _dim, _batch_size);
+    } else if (target_count == 1) {
+        batch_multi_qubit_control_single_qubit_dense_matrix_gate(
+            control_index.data(), control_value.data(),
+            (UINT)control_index.size(), target_index[0], matrix_ptr,
+            this->data_c(), _dim, _batch_size);
+    } else {
+        batch_multi_qubit_control_multi_qubit_dense_matrix_gate(
+            control_index.data(), control_value.data(),
+            (UINT)control_index.size(), target_index.data(), target_count,
+            matrix_ptr, this->data_c(), _dim, _batch_size);
+    }
+}
+
+void QuantumStateBatch::update_quantum_state(const QuantumCircuit* circuit) {
+    if (circuit->qubit_count != _qubit_count) {
+        throw InvalidQubitCountException(
+            "Error: QuantumStateBatch::update_quantum_state(const "
+            "QuantumCircuit*): invalid qubit count");
+    }
+    for (const QuantumGateBase* gate : circuit->gate_list) {
+        this->update_quantum_state(gate);
+    }
+}
+
+void QuantumStateBatch::apply_RX_gate(
+    UINT target_qubit_index, const std::vector<double>& angle_list) {
+    this->apply_multi_Pauli_rotation_gate(
+        {target_qubit_index}, {1}, angle_list);
+}
+
+void QuantumStateBatch::apply_RY_gate(
+    UINT target_qubit_index, const std::vector<double>& angle_list) {
+    this->apply_multi_Pauli_rotation_gate(
+        {target_qubit_index}, {2}, angle_list);
+}
+
+void QuantumStateBatch::apply_RZ_gate(
+    UINT target_qubit_index, const std::vector<double>& angle_list) {
+    this->apply_multi_Pauli_rotation_gate(
+        {target_qubit_index}, {3}, angle_list);
+}
+
+void QuantumStateBatch::apply_multi_Pauli_rotation_gate(
+    const std::vector<UINT>& target_qubit_index_list,
+    const std::vector<UINT>& pauli_id_list,
+    const std::vector<double>& angle_list) {
+    if (target_qubit_index_list.size() != pauli_id_list.size()) {
+        throw InvalidPauliIdentifierException(
+            "Error: QuantumStateBatch::apply_multi_Pauli_rotation_gate: the "
+            "size of target_qubit_index_list and pauli_id_list must be equal");
+    }
+    if (angle_list.size() != _batch_size) {
+        throw InvalidStateVectorSizeException(
+            "Error: QuantumStateBatch::apply_multi_Pauli_rotation_gate: the "
+            "size of angle_list must be batch_size");
+    }
+    for (UINT index : target_qubit_index_list) {
+        if (index >= _qubit_count) {
+            throw QubitIndexOutOfRangeException(
+                "Error: QuantumStateBatch::apply_multi_Pauli_rotation_gate: "
+                "index of qubit is out of range");
+        }
+    }
+    batch_multi_qubit_Pauli_rotation_gate_partial_list(
+        target_qubit_index_list.data(), pauli_id_list.data(),
+        (UINT)target_qubit_index_list.size(), angle_list.data(),
+        this->data_c(), _dim, _batch_size);
+}
+
+std::vector<CPPCTYPE> QuantumStateBatch::get_expectation_value(
+    const GeneralQuantumOperator* observable) const {
+    if (observable->get_qubit_count() != _qubit_count) {
+        throw InvalidQubitCountException(
+            "Error: QuantumStateBatch::get_expectation_value(const "
+            "GeneralQuantumOperator*): invalid qubit count");
+    }
+    std::vector<CPPCTYPE> result(_batch_size, 0.);
+    std::vector<double> term_value(_batch_size);
+    for (UINT term_index = 0; term_index < observable->get_term_count();
+         ++term_index) {
+        const PauliOperator* term = observable->get_term(term_index);
+        std::vector<UINT> index_list = term->get_index_list();
+        std::vector<UINT> pauli_id_list = term->get_pauli_id_list();
+        batch_expectation_value_multi_qubit_Pauli_operator_partial_list(
+            index_list.data(), pauli_id_list.data(), (UINT)index_list.size(),
+            this->data_c(), _dim, _batch_size, term_value.data());
+        const CPPCTYPE coef = term->get_coef();
+        for (UINT element = 0; element < _batch_size; ++element) {
+            result[element] += coef * term_value[element];
+        }
+    }
+    return result;
+}
+
+std::vector<std::vector<ITYPE>> QuantumStateBatch::sampling(
+    UINT sampling_count) {
+    return this->sampling(sampling_count, random.int32());
+}
+
+std::vector<std::vector<ITYPE>> QuantumStateBatch::sampling(
+    UINT sampling_count, UINT random_seed) {
+    random.set_seed(random_seed);
+    std::vector<std::vector<ITYPE>> result(_batch_size);
+    std::vector<double> stacked_prob(_dim + 1);
+    for (UINT element = 0; element < _batch_size; ++element) {
+        double sum = 0.;
+        stacked_prob[0] = 0.;
+        for (ITYPE index = 0; index < _dim; ++index) {
+            sum += norm(_state_vector[index * _batch_size + element]);
+            stacked_prob[index + 1] = sum;
+        }
+        result[element].reserve(sampling_count);
+        for (UINT count = 0; count < sampling_count; ++count) {
+            double r = random.uniform() * sum;
+            // stacked_prob[index] <= r < stacked_prob[index + 1]
+            auto ite =
+                std::upper_bound(stacked_prob.begin(), stacked_prob.end(), r);
+            ITYPE index = std::distance(stacked_prob.begin(), ite) - 1;
+            result[element].push_back(index < _dim ? index : _dim - 1);
+        }
+    }
+    return result;
+}
@@ -0,0 +1,207 @@
+#pragma once
+
+#include "state.hpp"
+#include "type.hpp"
+#include "utility.hpp"
+
+class QuantumGateBase;
+class QuantumCircuit;
+class GeneralQuantumOperator;
+
+/**
+ * \~japanese-en 同じ量子ビット数の複数の状態ベクトルをまとめて保持するクラス
+ *
+ * 振幅は<code>data_cpp()[basis * batch_size + element]</code>の順に並んでおり、
+ * 同じ基底の振幅がバッチ全体で連続する。
+ * 同じ量子回路を多数の小さな量子状態に作用させる場合に、
+ * 一回のゲート適用ですべての状態を更新するため、
+ * スレッドの起動やゲートごとの処理の負荷が状態の数で割られ、
+ * 最内ループがバッチ方向にベクトル化される。
+ */
+class DllExport QuantumStateBatch {
+private:
+    CPPCTYPE* _state_vector;
+    UINT _qubit_count;
+    ITYPE _dim;
+    UINT _batch_size;
+    Random random;
+
+public:
+    const UINT& qubit_count; /**< \~japanese-en 量子ビット数 */
+    const ITYPE& dim;        /**< \~japanese-en 各状態ベクトルの次元 */
+    const UINT& batch_size;  /**< \~japanese-en 状態の数 */
+
+    /**
+     * \~japanese-en コンストラクタ
+     *
+     * すべての状態は計算基底の0状態に初期化される。
+     * @param qubit_count_ 量子ビット数
+     * @param batch_size_ 状態の数
+     */
+    QuantumStateBatch(UINT qubit_count_, UINT batch_size_);
+
+    /**
+     * \~japanese-en デストラクタ
+     */
+    virtual ~QuantumStateBatch();
+
+    QuantumStateBatch(const QuantumStateBatch&) = delete;
+    QuantumStateBatch& operator=(const QuantumStateBatch&) = delete;
+
+    /**
+     * \~japanese-en すべての状態を計算基底の0状態に初期化する
+     */
+    void set_zero_state();
+
+    /**
+     * \~japanese-en すべての状態を<code>comp_basis</code>の基底状態に初期化する
+     *
+     * @param comp_basis 初期化する基底を表す整数
+     */
+    void set_computational_basis(ITYPE comp_basis);
+
+    /**
+     * \~japanese-en 各状態をHaar randomにサンプリングされた量子状態に初期化する
+     *
+     * <code>element</code>番目の状態はシード<code>seed +
+     * element</code>で初期化したQuantumStateと一致する。
+     * @param seed 乱数のシード
+     */
+    void set_Haar_random_state(UINT seed);
+
+    /**
+     * \~japanese-en <code>element</code>番目の状態に量子状態をコピーする
+     *
+     * @param element 状態の添え字
+     * @param state コピー元の量子状態
+     */
+    void load(UINT element, const QuantumStateBase* state);
+
+    /**
+     * \~japanese-en すべての状態に量子状態をコピーする
+     *
+     * @param state コピー元の量子状態
+     */
+    void load(const QuantumStateBase* state);
+
+    /**
+     * \~japanese-en <code>element</code>番目の状態ベクトルを取得する
+     *
+     * @param element 状態の添え字
+     * @return 状態ベクトル
+     */
+    std::vector<CPPCTYPE> get_vector(UINT element) const;
+
+    /**
+     * \~japanese-en 各状態のノルムの二乗を計算する
+     *
+     * @return ノルムの二乗のリスト
+     */
+    std::vector<double> get_squared_norm() const;
+
+    /**
+     * \~japanese-en 各状態を正規化する
+     *
+     * @param squared_norm_list 各状態の規格化因子のリスト
+     */
+    void normalize(const std::vector<double>& squared_norm_list);
+
+    /**
+     * \~japanese-en すべての状態に量子ゲートを作用させる
+     *
+     * ゲート行列は一度だけ作られ、バッチ全体に適用される。
+     * 測定やCPTP-mapのような非ユニタリなゲートには対応していない。
+     * @param gate 作用させるゲート
+     */
+    void update_quantum_state(const QuantumGateBase* gate);
+
+    /**
+     * \~japanese-en すべての状態に量子回路を作用させる
+     *
+     * @param circuit 作用させる量子回路
+     */
+    void update_quantum_state(const QuantumCircuit* circuit);
+
+    /**
+     * \~japanese-en 状態ごとに異なる角度のX回転ゲートを作用させる
+     *
+     * <code>element</code>番目の状態には<code>gate::RX(target_qubit_index,
+     * angle_list[element])</code>が作用する。
+     * @param target_qubit_index ターゲットの量子ビットの添え字
+     * @param angle_list 各状態の回転角
+     */
+    void apply_RX_gate(
+        UINT target_qubit_index, const std::vector<double>& angle_list);
+
+    /**
+     * \~japanese-en 状態ごとに異なる角度のY回転ゲートを作用させる
+     *
+     * @param target_qubit_index ターゲットの量子ビットの添え字
+     * @param angle_list 各状態の回転角
+     */
+    void apply_RY_gate(
+        UINT target_qubit_index, const std::vector<double>& angle_list);
+
+    /**
+     * \~japanese-en 状態ごとに異なる角度のZ回転ゲートを作用させる
+     *
+     * @param target_qubit_index ターゲットの量子ビットの添え字
+     * @param angle_list 各状態の回転角
+     */
+    void apply_RZ_gate(
+        UINT target_qubit_index, const std::vector<double>& angle_list);
+
+    /**
+     * \~japanese-en 状態ごとに異なる角度のPauli回転ゲートを作用させる
+     *
+     * @param target_qubit_index_list ターゲットの量子ビットの添え字のリスト
+     * @param pauli_id_list
+     * Pauli演算子の種類のリスト。(I,X,Y,Z)が(0,1,2,3)に対応する。
+     * @param angle_list 各状態の回転角
+     */
+    void apply_multi_Pauli_rotation_gate(
+        const std::vector<UINT>& target_qubit_index_list,
+        const std::vector<UINT>& pauli_id_list,
+        const std::vector<double>& angle_list);
+
+    /**
+     * \~japanese-en 各状態でのオブザーバブルの期待値を計算する
+     *
+     * @param observable オブザーバブル
+     * @return 期待値のリスト
+     */
+    std::vector<CPPCTYPE> get_expectation_value(
+        const GeneralQuantumOperator* observable) const;
+
+    /**
+     * \~japanese-en 各状態から計算基底で測定した結果をサンプリングする
+     *
+     * @param sampling_count 状態ごとのサンプリング回数
+     * @return 状態ごとのサンプルのリスト
+     */
+    std::vector<std::vector<ITYPE>> sampling(UINT sampling_count);
+
+    /**
+     * \~japanese-en 各状態から計算基底で測定した結果をサンプリングする
+     *
+     * @param sampling_count 状態ごとのサンプリング回数
+     * @param random_seed 乱数のシード
+     * @return 状態ごとのサンプルのリスト
+     */
+    std::vector<std::vector<ITYPE>> sampling(
+        UINT sampling_count, UINT random_seed);
+
+    /**
+     * \~japanese-en 振幅の配列のポインタを取得する
+     *
+     * @return 振幅の配列のポインタ
+     */
+    CPPCTYPE* data_cpp() const { return _state_vector; }
+
+    /**
+     * \~japanese-en 振幅の配列のポインタをcsimの型で取得する
+     *
+     * @return 振幅の配列のポインタ
+     */
+    CTYPE* data_c() const { return reinterpret_cast<CTYPE*>(_state_vector); }
+};
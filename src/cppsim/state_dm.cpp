@@ -5,6 +5,8 @@
 #include <csim/stat_ops_dm.hpp>
 #include <iostream>
 
+#include "state_float.hpp"
+
 namespace state {
 DensityMatrixCpu* tensor_product(
     const DensityMatrixCpu* state_left, const DensityMatrixCpu* state_right) {
@@ -100,6 +102,18 @@ DllExport QuantumStateBase* from_ptree(const boost::property_tree::ptree& pt) {
         }
         qs->load(state_vector);
         return qs;
+    } else if (name == "QuantumStateFloat") {
+        UINT qubit_count = pt.get<UINT>("qubit_count");
+        std::vector<UINT> classical_register =
+            ptree::uint_array_from_ptree(pt.get_child("classical_register"));
+        std::vector<CPPCTYPE> state_vector =
+            ptree::complex_array_from_ptree(pt.get_child("state_vector"));
+        QuantumStateFloat* qs = new QuantumStateFloat(qubit_count);
+        for (UINT i = 0; i < classical_register.size(); i++) {
+            qs->set_classical_value(i, classical_register[i]);
+        }
+        qs->load(state_vector);
+        return qs;
     } else if (name == "DensityMatrix") {
         UINT qubit_count = pt.get<UINT>("qubit_count");
         std::vector<UINT> classical_register =
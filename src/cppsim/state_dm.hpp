@@ -28,6 +28,25 @@ public:
      * \~japanese-en デストラクタ
      */
     virtual ~DensityMatrixCpu() { dm_release_quantum_state(this->data_c()); }
+
+    /**
+     * \~japanese-en 密度行列の更新をvec(rho)上の状態ベクトルのカーネルで行うかを設定する
+     *
+     * プロセス全体の設定で、すべての密度行列に適用される。既定では無効。
+     * @param enabled 有効にするか
+     */
+    static void set_vectorized_execution(bool enabled) {
+        dm_set_vectorized_execution(enabled);
+    }
+
+    /**
+     * \~japanese-en 密度行列の更新をvec(rho)上の状態ベクトルのカーネルで行うかを取得する
+     *
+     * @return 有効かどうか
+     */
+    static bool is_vectorized_execution() {
+        return dm_is_vectorized_execution();
+    }
     /**
      * \~japanese-en 量子状態を計算基底の0状態に初期化する
      */
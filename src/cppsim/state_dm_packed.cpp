@@ -0,0 +1,289 @@
+#include "state_dm_packed.hpp"
+
+#include <algorithm>
+
+#include <csim/stat_ops_dm_packed.hpp>
+#include <csim/update_ops_dm_packed.hpp>
+
+#include "circuit.hpp"
+#include "gate.hpp"
+#include "gate_general.hpp"
+#include "gate_merge.hpp"
+#include "general_quantum_operator.hpp"
+#include "pauli_operator.hpp"
+#include "state_dm.hpp"
+
+DensityMatrixPacked::DensityMatrixPacked(UINT qubit_count_)
+    : _qubit_count(qubit_count_),
+      _dim(1ULL << qubit_count_),
+      qubit_count(_qubit_count),
+      dim(_dim) {
+    this->_density_matrix = packed_dm_allocate_quantum_state(this->_dim);
+    packed_dm_initialize_quantum_state(this->_density_matrix, _dim);
+}
+
+DensityMatrixPacked::~DensityMatrixPacked() {
+    packed_dm_release_quantum_state(this->_density_matrix);
+}
+
+void DensityMatrixPacked::set_zero_state() {
+    packed_dm_initialize_quantum_state(this->_density_matrix, _dim);
+}
+
+void DensityMatrixPacked::set_computational_basis(ITYPE comp_basis) {
+    if (comp_basis >= _dim) {
+        throw MatrixIndexOutOfRangeException(
+            "Error: DensityMatrixPacked::set_computational_basis(ITYPE): "
+            "index of computational basis must be smaller than "
+            "2^qubit_count");
+    }
+    this->set_zero_state();
+    _density_matrix[0] = 0.;
+    _density_matrix[comp_basis * _dim + comp_basis] = 1.;
+}
+
+void DensityMatrixPacked::set_Haar_random_state(UINT seed) {
+    QuantumState pure_state(_qubit_count);
+    pure_state.set_Haar_random_state(seed);
+    packed_dm_initialize_with_pure_state(
+        this->_density_matrix, pure_state.data_c(), _dim);
+}
+
+void DensityMatrixPacked::load(const QuantumStateBase* state) {
+    if (state->qubit_count != _qubit_count) {
+        throw InvalidQubitCountException(
+            "Error: DensityMatrixPacked::load(const QuantumStateBase*): "
+            "invalid qubit count");
+    }
+    if (state->outer_qc > 0) {
+        throw NotImplementedException(
+            "Error: DensityMatrixPacked::load(const QuantumStateBase*) "
+            "using multi-cpu is not implemented");
+    }
+    if (state->is_state_vector()) {
+        CTYPE* ptr = state->duplicate_data_c();
+        packed_dm_initialize_with_pure_state(this->_density_matrix, ptr, _dim);
+        free(ptr);
+    } else {
+        packed_dm_initialize_with_density_matrix(
+            this->_density_matrix, state->data_c(), _dim);
+    }
+}
+
+DensityMatrixPacked* DensityMatrixPacked::copy() const {
+    DensityMatrixPacked* new_state = new DensityMatrixPacked(_qubit_count);
+    memcpy(new_state->data(), _density_matrix,
+        (size_t)(sizeof(double) * _dim * _dim));
+    return new_state;
+}
+
+DensityMatrixCpu* DensityMatrixPacked::to_density_matrix() const {
+    DensityMatrixCpu* new_state = new DensityMatrixCpu(_qubit_count);
+    packed_dm_copy_to_density_matrix(
+        this->_density_matrix, new_state->data_c(), _dim);
+    return new_state;
+}
+
+CPPCTYPE DensityMatrixPacked::get_element(ITYPE row, ITYPE col) const {
+    if (row >= _dim || col >= _dim) {
+        throw MatrixIndexOutOfRangeException(
+            "Error: DensityMatrixPacked::get_element(ITYPE, ITYPE): index "
+            "must be smaller than dim");
+    }
+    return packed_dm_get_element(this->_density_matrix, _dim, row, col);
+}
+
+double DensityMatrixPacked::get_squared_norm() const {
+    return packed_dm_state_norm_squared(this->_density_matrix, _dim);
+}
+
+void DensityMatrixPacked::normalize(double squared_norm) {
+    packed_dm_normalize(squared_norm, this->_density_matrix, _dim);
+}
+
+double DensityMatrixPacked::get_zero_probability(
+    UINT target_qubit_index) const {
+    if (target_qubit_index >= _qubit_count) {
+        throw QubitIndexOutOfRangeException(
+            "Error: DensityMatrixPacked::get_zero_probability(UINT): index "
+            "of target qubit must be smaller than qubit_count");
+    }
+    UINT measured_value = 0;
+    return packed_dm_marginal_prob(&target_qubit_index, &measured_value, 1,
+        this->_density_matrix, _dim);
+}
+
+double DensityMatrixPacked::get_marginal_probability(
+    const std::vector<UINT>& measured_values) const {
+    if (measured_values.size() != _qubit_count) {
+        throw InvalidQubitCountException(
+            "Error: "
+            "DensityMatrixPacked::get_marginal_probability(vector<UINT>): "
+            "the length of measured_values must be equal to qubit_count");
+    }
+    std::vector<UINT> target_index;
+    std::vector<UINT> target_value;
+    for (UINT i = 0; i < measured_values.size(); ++i) {
+        UINT measured_value = measured_values[i];
+        if (measured_value == 0 || measured_value == 1) {
+            target_index.push_back(i);
+            target_value.push_back(measured_value);
+        }
+    }
+    return packed_dm_marginal_prob(target_index.data(), target_value.data(),
+        (UINT)target_index.size(), this->_density_matrix, _dim);
+}
+
+double DensityMatrixPacked::get_entropy() const {
+    return packed_dm_measurement_distribution_entropy(
+        this->_density_matrix, _dim);
+}
+
+void DensityMatrixPacked::update_quantum_state(const QuantumGateBase* gate) {
+    const std::string name = gate->get_name();
+    if (name == "CP" || name == "Adaptive") {
+        throw NotImplementedException(
+            "Error: DensityMatrixPacked::update_quantum_state(const "
+            "QuantumGateBase*): " +
+            name + " gate is not supported");
+    }
+    std::vector<UINT> target_index = gate->get_target_index_list();
+    std::vector<UINT> control_index = gate->get_control_index_list();
+    std::vector<UINT> qubit_list = target_index;
+    qubit_list.insert(
+        qubit_list.end(), control_index.begin(), control_index.end());
+    for (UINT index : qubit_list) {
+        if (index >= _qubit_count) {
+            throw QubitIndexOutOfRangeException(
+                "Error: DensityMatrixPacked::update_quantum_state(const "
+                "QuantumGateBase*): index of qubit is out of range");
+        }
+    }
+    std::sort(qubit_list.begin(), qubit_list.end());
+
+    if (name == "Probabilistic" || name == "CPTP") {
+        ComplexMatrix superoperator;
+        if (qubit_list.size() > superoperator_max_qubit_count ||
+            !gate::get_superoperator(gate, qubit_list, superoperator)) {
+            throw NotImplementedException(
+                "Error: DensityMatrixPacked::update_quantum_state(const "
+                "QuantumGateBase*): " +
+                name +
+                " gate must consist of matrix gates on at most " +
+                std::to_string(superoperator_max_qubit_count) + " qubits");
+        }
+        packed_dm_multi_qubit_superoperator(qubit_list.data(),
+            (UINT)qubit_list.size(),
+            reinterpret_cast<const CTYPE*>(superoperator.data()),
+            this->_density_matrix, _dim);
+        return;
+    }
+
+    // ComplexMatrix is row-major as the csim kernels expect. Controls are
+    // absorbed into a matrix on all the qubits of the gate.
+    ComplexMatrix matrix;
+    if (control_index.empty()) {
+        gate->set_matrix(matrix);
+    } else {
+        std::vector<TargetQubitInfo> new_target_list;
+        for (UINT index : qubit_list) {
+            new_target_list.push_back(TargetQubitInfo(index));
+        }
+        gate::get_extended_matrix(gate, new_target_list, {}, matrix);
+        target_index = qubit_list;
+    }
+    if (target_index.size() == 1) {
+        packed_dm_single_qubit_dense_matrix_gate(target_index[0],
+            reinterpret_cast<const CTYPE*>(matrix.data()),
+            this->_density_matrix, _dim);
+        return;
+    }
+    packed_dm_multi_qubit_dense_matrix_gate(target_index.data(),
+        (UINT)target_index.size(),
+        reinterpret_cast<const CTYPE*>(matrix.data()), this->_density_matrix,
+        _dim);
+}
+
+void DensityMatrixPacked::update_quantum_state(const QuantumCircuit* circuit) {
+    if (circuit->qubit_count != _qubit_count) {
+        throw InvalidQubitCountException(
+            "Error: DensityMatrixPacked::update_quantum_state(const "
+            "QuantumCircuit*): invalid qubit count");
+    }
+    for (const QuantumGateBase* gate : circuit->gate_list) {
+        this->update_quantum_state(gate);
+    }
+}
+
+CPPCTYPE DensityMatrixPacked::get_expectation_value(
+    const GeneralQuantumOperator* observable) const {
+    if (observable->get_qubit_count() != _qubit_count) {
+        throw InvalidQubitCountException(
+            "Error: DensityMatrixPacked::get_expectation_value(const "
+            "GeneralQuantumOperator*): invalid qubit count");
+    }
+    CPPCTYPE result = 0.;
+    for (UINT term_index = 0; term_index < observable->get_term_count();
+         ++term_index) {
+        const PauliOperator* term = observable->get_term(term_index);
+        std::vector<UINT> index_list = term->get_index_list();
+        std::vector<UINT> pauli_id_list = term->get_pauli_id_list();
+        result +=
+            term->get_coef() *
+            packed_dm_expectation_value_multi_qubit_Pauli_operator_partial_list(
+                index_list.data(), pauli_id_list.data(),
+                (UINT)index_list.size(), this->_density_matrix, _dim);
+    }
+    return result;
+}
+
+std::vector<ITYPE> DensityMatrixPacked::sampling(UINT sampling_count) {
+    return this->sampling(sampling_count, random.int32());
+}
+
+std::vector<ITYPE> DensityMatrixPacked::sampling(
+    UINT sampling_count, UINT random_seed) {
+    random.set_seed(random_seed);
+    // the probabilities are the diagonal, which is stored in place
+    std::vector<double> stacked_prob(_dim + 1);
+    double sum = 0.;
+    stacked_prob[0] = 0.;
+    for (ITYPE index = 0; index < _dim; ++index) {
+        sum += _density_matrix[index * _dim + index];
+        stacked_prob[index + 1] = sum;
+    }
+    std::vector<ITYPE> result;
+    result.reserve(sampling_count);
+    for (UINT count = 0; count < sampling_count; ++count) {
+        double r = random.uniform() * sum;
+        // stacked_prob[index] <= r < stacked_prob[index + 1]
+        auto ite =
+            std::upper_bound(stacked_prob.begin(), stacked_prob.end(), r);
+        ITYPE index = std::distance(stacked_prob.begin(), ite) - 1;
+        result.push_back(index < _dim ? index : _dim - 1);
+    }
+    return result;
+}
+
+namespace state {
+DensityMatrixPacked* partial_trace(
+    const DensityMatrixPacked* state, std::vector<UINT> target_traceout) {
+    if (state->qubit_count <= target_traceout.size()) {
+        throw InvalidQubitCountException(
+            "Error: partial_trace(const DensityMatrixPacked*, "
+            "std::vector<UINT>): invalid qubit count");
+    }
+    for (UINT index : target_traceout) {
+        if (index >= state->qubit_count) {
+            throw QubitIndexOutOfRangeException(
+                "Error: partial_trace(const DensityMatrixPacked*, "
+                "std::vector<UINT>): index of qubit is out of range");
+        }
+    }
+    UINT qubit_count = state->qubit_count - (UINT)target_traceout.size();
+    DensityMatrixPacked* qs = new DensityMatrixPacked(qubit_count);
+    packed_dm_state_partial_trace(target_traceout.data(),
+        (UINT)target_traceout.size(), state->data(), qs->data(), state->dim);
+    return qs;
+}
+}  // namespace state
@@ -0,0 +1,202 @@
+#pragma once
+
+#include "state.hpp"
+#include "type.hpp"
+#include "utility.hpp"
+
+class QuantumGateBase;
+class QuantumCircuit;
+class GeneralQuantumOperator;
+class DensityMatrixCpu;
+
+/**
+ * \~japanese-en エルミート性を用いて半分のメモリで密度行列を保持するクラス
+ *
+ * 密度行列 rho は実数の配列<code>data()</code>に、
+ * i <= j に対して<code>data()[i * dim + j]</code>に Re rho[i][j] を、
+ * i < j に対して<code>data()[j * dim + i]</code>に Im rho[i][j] を格納する。
+ * DensityMatrixCpuの半分のメモリで同じ量子ビット数を扱え、
+ * ゲートの作用はブロックの上三角のみを更新するためメモリの読み書きも半分になる。
+ */
+class DllExport DensityMatrixPacked {
+private:
+    double* _density_matrix;
+    UINT _qubit_count;
+    ITYPE _dim;
+    Random random;
+
+public:
+    const UINT& qubit_count; /**< \~japanese-en 量子ビット数 */
+    const ITYPE& dim;        /**< \~japanese-en 密度行列の次元 */
+
+    /**
+     * \~japanese-en コンストラクタ
+     *
+     * 密度行列は計算基底の0状態に初期化される。
+     * @param qubit_count_ 量子ビット数
+     */
+    explicit DensityMatrixPacked(UINT qubit_count_);
+
+    /**
+     * \~japanese-en デストラクタ
+     */
+    virtual ~DensityMatrixPacked();
+
+    DensityMatrixPacked(const DensityMatrixPacked&) = delete;
+    DensityMatrixPacked& operator=(const DensityMatrixPacked&) = delete;
+
+    /**
+     * \~japanese-en 量子状態を計算基底の0状態に初期化する
+     */
+    void set_zero_state();
+
+    /**
+     * \~japanese-en 量子状態を<code>comp_basis</code>の基底状態に初期化する
+     *
+     * @param comp_basis 初期化する基底を表す整数
+     */
+    void set_computational_basis(ITYPE comp_basis);
+
+    /**
+     * \~japanese-en 量子状態をシードを用いてHaar
+     * randomにサンプリングされた純粋状態に初期化する
+     *
+     * @param seed 乱数のシード
+     */
+    void set_Haar_random_state(UINT seed);
+
+    /**
+     * \~japanese-en <code>state</code>の量子状態を自身へコピーする
+     *
+     * 状態ベクトルは純粋状態の密度行列として読み込まれる。
+     * @param state コピー元の量子状態
+     */
+    void load(const QuantumStateBase* state);
+
+    /**
+     * \~japanese-en 自身の状態のディープコピーを生成する
+     *
+     * @return 自身のディープコピー
+     */
+    DensityMatrixPacked* copy() const;
+
+    /**
+     * \~japanese-en 密度行列を通常の密度行列として取得する
+     *
+     * @return 生成された密度行列
+     */
+    DensityMatrixCpu* to_density_matrix() const;
+
+    /**
+     * \~japanese-en 密度行列の要素を取得する
+     *
+     * @param row 行の添え字
+     * @param col 列の添え字
+     * @return rho[row][col]
+     */
+    CPPCTYPE get_element(ITYPE row, ITYPE col) const;
+
+    /**
+     * \~japanese-en 密度行列のトレースを計算する
+     *
+     * @return トレース
+     */
+    double get_squared_norm() const;
+
+    /**
+     * \~japanese-en 量子状態を正規化する
+     *
+     * @param squared_norm 自身のトレース
+     */
+    void normalize(double squared_norm);
+
+    /**
+     * \~japanese-en
+     * <code>target_qubit_index</code>の添え字の量子ビットを測定した時、0が観測される確率を計算する。
+     *
+     * @param target_qubit_index
+     * @return 0が観測される確率
+     */
+    double get_zero_probability(UINT target_qubit_index) const;
+
+    /**
+     * \~japanese-en 複数の量子ビットを測定した時の周辺確率を計算する
+     *
+     * @param measured_values
+     * 量子ビット数と同じ長さの0,1,2の配列。0,1はその値が観測され、2は測定をしないことを表す。
+     * @return 計算された周辺確率
+     */
+    double get_marginal_probability(
+        const std::vector<UINT>& measured_values) const;
+
+    /**
+     * \~japanese-en
+     * 計算基底で測定した時得られる確率分布のエントロピーを計算する。
+     *
+     * @return エントロピー
+     */
+    double get_entropy() const;
+
+    /**
+     * \~japanese-en 量子ゲートを作用させる
+     *
+     * ユニタリなゲートと行列で表せるゲートは M rho M^dagger
+     * として作用する。確率的なゲートとCPTP-mapは
+     * superoperatorとして作用する。InstrumentはDensityMatrixCpuと同様に
+     * classical registerに書き込まない。CP-mapとAdaptiveには対応していない。
+     * @param gate 作用させるゲート
+     */
+    void update_quantum_state(const QuantumGateBase* gate);
+
+    /**
+     * \~japanese-en 量子回路を作用させる
+     *
+     * @param circuit 作用させる量子回路
+     */
+    void update_quantum_state(const QuantumCircuit* circuit);
+
+    /**
+     * \~japanese-en オブザーバブルの期待値を計算する
+     *
+     * @param observable オブザーバブル
+     * @return 期待値
+     */
+    CPPCTYPE get_expectation_value(
+        const GeneralQuantumOperator* observable) const;
+
+    /**
+     * \~japanese-en 量子状態を測定した際の計算基底のサンプリングを行う
+     *
+     * @param sampling_count サンプリングを行う回数
+     * @return サンプルされた値のリスト
+     */
+    std::vector<ITYPE> sampling(UINT sampling_count);
+
+    /**
+     * \~japanese-en 量子状態を測定した際の計算基底のサンプリングを行う
+     *
+     * @param sampling_count サンプリングを行う回数
+     * @param random_seed 乱数のシード
+     * @return サンプルされた値のリスト
+     */
+    std::vector<ITYPE> sampling(UINT sampling_count, UINT random_seed);
+
+    /**
+     * \~japanese-en 密度行列を格納した実数の配列のポインタを取得する
+     *
+     * @return 実数の配列のポインタ
+     */
+    double* data() const { return _density_matrix; }
+};
+
+namespace state {
+/**
+ * \~japanese-en 指定した量子ビットについて部分トレースをとる
+ *
+ * @param state 密度行列
+ * @param target_traceout トレースアウトする量子ビットのリスト
+ * @return 部分トレースをとった密度行列
+ */
+DllExport DensityMatrixPacked* partial_trace(
+    const DensityMatrixPacked* state, std::vector<UINT> target_traceout);
+}  // namespace state
@@ -0,0 +1,14 @@
+#include "state_float.hpp"
+
+namespace state {
+CPPCTYPE inner_product(
+    const QuantumStateFloat* state_bra, const QuantumStateFloat* state_ket) {
+    if (state_bra->qubit_count != state_ket->qubit_count) {
+        throw InvalidQubitCountException(
+            "Error: inner_product(const QuantumStateFloat*, const "
+            "QuantumStateFloat*): invalid qubit count");
+    }
+    return float_state_inner_product(
+        state_bra->data_float(), state_ket->data_float(), state_bra->dim);
+}
+}  // namespace state
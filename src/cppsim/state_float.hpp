@@ -0,0 +1,438 @@
+#pragma once
+
+#include <csim/memory_ops_float.hpp>
+#include <csim/stat_ops_float.hpp>
+#include <csim/update_ops_float.hpp>
+
+#include "state.hpp"
+
+/**
+ * \~japanese-en 単精度の状態ベクトルを保持する量子状態のクラス
+ *
+ * 振幅を<code>std::complex\<float\></code>で保持するため、QuantumStateCpuの半分のメモリで動作し、
+ * メモリ帯域に律速されるゲート適用が高速になる。ノルムや期待値などの統計量は倍精度で積算される。
+ * data_c()やdata_cpp()は使えないため、倍精度の配列が必要な場合はduplicate_data_cpp()を用いる。
+ */
+class QuantumStateFloatCpu : public QuantumStateBase {
+private:
+    CTYPE_F* _state_vector;
+    Random random;
+
+public:
+    /**
+     * \~japanese-en コンストラクタ
+     *
+     * @param qubit_count_ 量子ビット数
+     */
+    explicit QuantumStateFloatCpu(UINT qubit_count_)
+        : QuantumStateBase(qubit_count_, true) {
+        this->_state_vector = float_allocate_quantum_state(this->_dim);
+        float_initialize_quantum_state(this->_state_vector, _dim);
+    }
+    /**
+     * \~japanese-en デストラクタ
+     */
+    virtual ~QuantumStateFloatCpu() {
+        float_release_quantum_state(this->_state_vector);
+    }
+
+    virtual bool is_single_precision() const override { return true; }
+
+    /**
+     * \~japanese-en 量子状態を計算基底の0状態に初期化する
+     */
+    virtual void set_zero_state() override {
+        float_initialize_quantum_state(this->_state_vector, _dim);
+    }
+
+    /**
+     * \~japanese-en 量子状態をノルム0の状態にする
+     */
+    virtual void set_zero_norm_state() override {
+        set_zero_state();
+        _state_vector[0] = 0;
+    }
+
+    /**
+     * \~japanese-en 量子状態を<code>comp_basis</code>の基底状態に初期化する
+     *
+     * @param comp_basis 初期化する基底を表す整数
+     */
+    virtual void set_computational_basis(ITYPE comp_basis) override {
+        if (comp_basis >= (ITYPE)(1ULL << this->qubit_count)) {
+            throw MatrixIndexOutOfRangeException(
+                "Error: QuantumStateFloatCpu::set_computational_basis(ITYPE): "
+                "index of computational basis must be smaller than "
+                "2^qubit_count");
+        }
+        set_zero_state();
+        _state_vector[0] = 0.f;
+        _state_vector[comp_basis] = 1.f;
+    }
+    /**
+     * \~japanese-en 量子状態をHaar
+     * randomにサンプリングされた量子状態に初期化する
+     */
+    virtual void set_Haar_random_state() override {
+        this->set_Haar_random_state(random.int32());
+    }
+    /**
+     * \~japanese-en 量子状態をシードを用いてHaar
+     * randomにサンプリングされた量子状態に初期化する
+     *
+     * 同じシードを用いたQuantumStateCpuの状態を単精度に丸めたものと一致する。
+     */
+    virtual void set_Haar_random_state(UINT seed) override {
+        float_initialize_Haar_random_state_with_seed(
+            this->_state_vector, _dim, seed);
+    }
+    /**
+     * \~japanese-en
+     * <code>target_qubit_index</code>の添え字の量子ビットを測定した時、0が観測される確率を計算する。
+     *
+     * 量子状態は変更しない。
+     * @param target_qubit_index
+     * @return double
+     */
+    virtual double get_zero_probability(
+        UINT target_qubit_index) const override {
+        if (target_qubit_index >= this->qubit_count) {
+            throw QubitIndexOutOfRangeException(
+                "Error: QuantumStateFloatCpu::get_zero_probability(UINT): "
+                "index of target qubit must be smaller than qubit_count");
+        }
+        return float_M0_prob(target_qubit_index, this->_state_vector, _dim);
+    }
+    /**
+     * \~japanese-en 複数の量子ビットを測定した時の周辺確率を計算する
+     *
+     * @param measured_values
+     * 量子ビット数と同じ長さの0,1,2の配列。0,1はその値が観測され、2は測定をしないことを表す。
+     * @return 計算された周辺確率
+     */
+    virtual double get_marginal_probability(
+        std::vector<UINT> measured_values) const override {
+        if (measured_values.size() != this->qubit_count) {
+            throw InvalidQubitCountException(
+                "Error: "
+                "QuantumStateFloatCpu::get_marginal_probability(vector<UINT>)"
+                ": the length of measured_values must be equal to "
+                "qubit_count");
+        }
+
+        std::vector<UINT> target_index;
+        std::vector<UINT> target_value;
+        for (UINT i = 0; i < measured_values.size(); ++i) {
+            UINT measured_value = measured_values[i];
+            if (measured_value == 0 || measured_value == 1) {
+                target_index.push_back(i);
+                target_value.push_back(measured_value);
+            }
+        }
+        return float_marginal_prob(target_index.data(), target_value.data(),
+            (UINT)target_index.size(), this->_state_vector, _dim);
+    }
+    /**
+     * \~japanese-en
+     * 計算基底で測定した時得られる確率分布のエントロピーを計算する。
+     *
+     * @return エントロピー
+     */
+    virtual double get_entropy() const override {
+        return float_measurement_distribution_entropy(
+            this->_state_vector, _dim);
+    }
+
+    /**
+     * \~japanese-en 量子状態のノルムを計算する
+     *
+     * 量子状態のノルムは非ユニタリなゲートを作用した時に小さくなる。
+     * @return ノルム
+     */
+    virtual double get_squared_norm() const override {
+        return float_state_norm_squared(this->_state_vector, _dim);
+    }
+
+    /**
+     * \~japanese-en 量子状態のノルムを計算する
+     *
+     * 量子状態のノルムは非ユニタリなゲートを作用した時に小さくなる。
+     * @return ノルム
+     */
+    virtual double get_squared_norm_single_thread() const override {
+        double norm = 0.;
+        for (ITYPE i = 0; i < _dim; ++i) {
+            norm += std::norm(std::complex<double>(_state_vector[i]));
+        }
+        return norm;
+    }
+
+    /**
+     * \~japanese-en 量子状態を正規化する
+     *
+     * @param norm 自身のノルム
+     */
+    virtual void normalize(double squared_norm) override {
+        float_normalize(squared_norm, this->_state_vector, _dim);
+    }
+
+    /**
+     * \~japanese-en 量子状態を正規化する
+     *
+     * @param norm 自身のノルム
+     */
+    virtual void normalize_single_thread(double squared_norm) override {
+        const float normalize_factor = (float)(1. / sqrt(squared_norm));
+        for (ITYPE i = 0; i < _dim; ++i) {
+            _state_vector[i] *= normalize_factor;
+        }
+    }
+
+    /**
+     * \~japanese-en バッファとして同じサイズの量子状態を作成する。
+     *
+     * @return 生成された量子状態
+     */
+    virtual QuantumStateFloatCpu* allocate_buffer() const override {
+        return new QuantumStateFloatCpu(this->_qubit_count);
+    }
+    /**
+     * \~japanese-en 自身の状態のディープコピーを生成する
+     *
+     * @return 自身のディープコピー
+     */
+    virtual QuantumStateFloatCpu* copy() const override {
+        QuantumStateFloatCpu* new_state = this->allocate_buffer();
+        memcpy(new_state->data(), _state_vector,
+            (size_t)(sizeof(CTYPE_F) * _dim));
+        for (UINT i = 0; i < _classical_register.size(); ++i) {
+            new_state->set_classical_value(i, _classical_register[i]);
+        }
+        return new_state;
+    }
+    /**
+     * \~japanese-en <code>state</code>の量子状態を自身へコピーする。
+     *
+     * 倍精度の量子状態は単精度に丸めてコピーされる。
+     */
+    virtual void load(const QuantumStateBase* _state) override {
+        if (_state->qubit_count != this->qubit_count) {
+            throw InvalidQubitCountException(
+                "Error: QuantumStateFloatCpu::load(const QuantumStateBase*): "
+                "invalid qubit count");
+        }
+        if (!_state->is_state_vector()) {
+            throw InoperatableQuantumStateTypeException(
+                "Error: QuantumStateFloatCpu::load(const QuantumStateBase*): "
+                "cannot load DensityMatrix to StateVector");
+        }
+        if (_state->outer_qc > 0) {
+            throw NotImplementedException(
+                "Error: QuantumStateFloatCpu::load(const QuantumStateBase*) "
+                "using multi-cpu is not implemented");
+        }
+
+        this->_classical_register = _state->classical_register;
+        if (_state->is_single_precision()) {
+            memcpy(this->_state_vector, _state->data(),
+                (size_t)(sizeof(CTYPE_F) * _dim));
+        } else if (_state->get_device_name() == "gpu") {
+            auto ptr = _state->duplicate_data_c();
+            float_state_from_double(ptr, this->_state_vector, _dim);
+            free(ptr);
+        } else {
+            float_state_from_double(_state->data_c(), this->_state_vector, _dim);
+        }
+    }
+    /**
+     * \~japanese-en <code>state</code>の量子状態を自身へコピーする。
+     */
+    virtual void load(const std::vector<CPPCTYPE>& _state) override {
+        if (_state.size() != _dim) {
+            throw InvalidStateVectorSizeException(
+                "Error: QuantumStateFloatCpu::load(vector<Complex>&): invalid "
+                "length of state");
+        }
+        this->load(_state.data());
+    }
+
+    /**
+     * \~japanese-en <code>state</code>の量子状態を自身へコピーする。
+     */
+    virtual void load(const CPPCTYPE* _state) override {
+        float_state_from_double(
+            reinterpret_cast<const CTYPE*>(_state), this->_state_vector, _dim);
+    }
+
+    /**
+     * \~japanese-en
+     * 量子状態が配置されているメモリを保持するデバイス名を取得する。
+     */
+    virtual const std::string get_device_name() const override { return "cpu"; }
+
+    /**
+     * \~japanese-en 量子状態のポインタを<code>std::complex\<float\></code>の配列のvoid*型として返す
+     */
+    virtual void* data() const override {
+        return reinterpret_cast<void*>(this->_state_vector);
+    }
+    /**
+     * \~japanese-en 量子状態を単精度の複素数の配列として取得する
+     *
+     * @return 複素ベクトルのポインタ
+     */
+    CTYPE_F* data_float() const { return this->_state_vector; }
+    /**
+     * \~japanese-en 単精度の量子状態では使えない。duplicate_data_cpp()を用いる。
+     */
+    virtual CPPCTYPE* data_cpp() const override {
+        throw NotImplementedException(
+            "Error: QuantumStateFloatCpu::data_cpp(): single precision state "
+            "has no double precision buffer, use duplicate_data_cpp()");
+    }
+    /**
+     * \~japanese-en 単精度の量子状態では使えない。duplicate_data_c()を用いる。
+     */
+    virtual CTYPE* data_c() const override {
+        throw NotImplementedException(
+            "Error: QuantumStateFloatCpu::data_c(): single precision state "
+            "has no double precision buffer, use duplicate_data_c()");
+    }
+
+    /**
+     * \~japanese-en 量子状態を倍精度に変換した配列を生成する
+     */
+    virtual CTYPE* duplicate_data_c() const override {
+        CTYPE* new_data = (CTYPE*)malloc(sizeof(CTYPE) * _dim);
+        float_state_to_double(this->_state_vector, new_data, _dim);
+        return new_data;
+    }
+
+    /**
+     * \~japanese-en 量子状態を倍精度に変換した配列を生成する
+     */
+    virtual CPPCTYPE* duplicate_data_cpp() const override {
+        return reinterpret_cast<CPPCTYPE*>(this->duplicate_data_c());
+    }
+
+    /**
+     * \~japanese-en 量子状態を足しこむ
+     */
+    virtual void add_state(const QuantumStateBase* state) override {
+        this->add_state_with_coef(1., state);
+    }
+
+    /**
+     * \~japanese-en 量子状態を足しこむ
+     */
+    virtual void add_state_with_coef(
+        CPPCTYPE coef, const QuantumStateBase* state) override {
+        if (!state->is_single_precision() || !state->is_state_vector()) {
+            throw InoperatableQuantumStateTypeException(
+                "Error: QuantumStateFloatCpu::add_state_with_coef(CPPCTYPE, "
+                "const QuantumStateBase*): only single precision state "
+                "vector can be added");
+        }
+        float_state_add_with_coef(coef,
+            reinterpret_cast<const CTYPE_F*>(state->data()),
+            this->_state_vector, this->dim);
+    }
+
+    /**
+     * \~japanese-en 量子状態を足しこむ
+     */
+    virtual void add_state_with_coef_single_thread(
+        CPPCTYPE coef, const QuantumStateBase* state) override {
+        if (!state->is_single_precision() || !state->is_state_vector()) {
+            throw InoperatableQuantumStateTypeException(
+                "Error: "
+                "QuantumStateFloatCpu::add_state_with_coef_single_thread("
+                "CPPCTYPE, const QuantumStateBase*): only single precision "
+                "state vector can be added");
+        }
+        const CTYPE_F coef_f(coef);
+        const CTYPE_F* state_added =
+            reinterpret_cast<const CTYPE_F*>(state->data());
+        for (ITYPE i = 0; i < _dim; ++i) {
+            _state_vector[i] += coef_f * state_added[i];
+        }
+    }
+
+    /**
+     * \~japanese-en 複素数をかける
+     */
+    virtual void multiply_coef(CPPCTYPE coef) override {
+        float_state_multiply(coef, this->_state_vector, this->dim);
+    }
+
+    virtual void multiply_elementwise_function(
+        const std::function<CPPCTYPE(ITYPE)>& func) override {
+        for (ITYPE idx = 0; idx < dim; ++idx) {
+            _state_vector[idx] *= CTYPE_F(func(idx));
+        }
+    }
+
+    /**
+     * \~japanese-en 量子状態を測定した際の計算基底のサンプリングを行う
+     *
+     * 累積確率は倍精度で計算し、ノルムが1からずれていても全体の和で正規化して扱う。
+     * @param[in] sampling_count サンプリングを行う回数
+     * @return サンプルされた値のリスト
+     */
+    virtual std::vector<ITYPE> sampling(UINT sampling_count) override {
+        // the uniforms are drawn in order so that the result only depends
+        // on the seed, and the shots are resolved in parallel
+        std::vector<double> uniform_list(sampling_count);
+        for (UINT count = 0; count < sampling_count; ++count) {
+            uniform_list[count] = random.uniform();
+        }
+        std::vector<ITYPE> result(sampling_count);
+        float_state_sampling(_state_vector, this->dim, uniform_list.data(),
+            sampling_count, result.data());
+        return result;
+    }
+
+    virtual std::vector<ITYPE> sampling(
+        UINT sampling_count, UINT random_seed) override {
+        random.set_seed(random_seed);
+        return this->sampling(sampling_count);
+    }
+
+    virtual std::string to_string() const override {
+        std::stringstream os;
+        ComplexVector eigen_state(this->dim);
+        for (ITYPE i = 0; i < this->dim; ++i) {
+            eigen_state[i] = CPPCTYPE(_state_vector[i]);
+        }
+        os << " *** Quantum State (single precision) ***" << std::endl;
+        os << " * Qubit Count : " << this->qubit_count << std::endl;
+        os << " * Dimension   : " << this->dim << std::endl;
+        os << " * State vector : \n" << eigen_state << std::endl;
+        return os.str();
+    }
+
+    virtual boost::property_tree::ptree to_ptree() const override {
+        boost::property_tree::ptree pt;
+        pt.put("name", "QuantumStateFloat");
+        pt.put("qubit_count", _qubit_count);
+        pt.put_child(
+            "classical_register", ptree::to_ptree(_classical_register));
+        pt.put_child("state_vector", ptree::to_ptree(std::vector<CPPCTYPE>(
+                                         _state_vector, _state_vector + _dim)));
+        return pt;
+    }
+};
+
+using QuantumStateFloat = QuantumStateFloatCpu;
+
+namespace state {
+/**
+ * \~japanese-en 単精度の量子状態間の内積を倍精度で計算する
+ *
+ * @param[in] state_bra 内積のブラ側の量子状態
+ * @param[in] state_ket 内積のケット側の量子状態
+ * @return 内積の値
+ */
+CPPCTYPE DllExport inner_product(
+    const QuantumStateFloat* state_bra, const QuantumStateFloat* state_ket);
+}  // namespace state
@@ -2,21 +2,150 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "utility.hpp"
 #ifdef _OPENMP
 #include <omp.h>
 #endif
 
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
 #ifdef _MSC_VER
-#define aligned_free _aligned_free;
-#define aligned_malloc _aligned_malloc;
+#include <malloc.h>
 #endif
 
-// memory allocation
-CTYPE* allocate_quantum_state(ITYPE dim) {
-    CTYPE* state = (CTYPE*)malloc((size_t)(sizeof(CTYPE) * dim));
-    // CTYPE* state = (CTYPE*)_aligned_malloc((size_t)(sizeof(CTYPE)*dim), 32);
+static const size_t CACHE_LINE_SIZE = 64;
+static const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+static AllocationPolicy parse_allocation_policy(const char* text) {
+    UINT policy = ALLOCATION_MALLOC;
+    const char* cursor = text;
+    while (*cursor != '\0') {
+        const char* end = strchr(cursor, ',');
+        const size_t length =
+            (end == NULL) ? strlen(cursor) : (size_t)(end - cursor);
+        if (length == 7 && strncmp(cursor, "aligned", length) == 0) {
+            policy |= ALLOCATION_ALIGNED;
+        } else if (length == 8 && strncmp(cursor, "hugepage", length) == 0) {
+            policy |= ALLOCATION_HUGE_PAGE;
+        } else if (length == 11 && strncmp(cursor, "first_touch", length) == 0) {
+            policy |= ALLOCATION_FIRST_TOUCH;
+        }
+        // "malloc" and unknown words add no flag
+        if (end == NULL) break;
+        cursor = end + 1;
+    }
+    return static_cast<AllocationPolicy>(policy);
+}
+
+static AllocationPolicy& default_allocation_policy() {
+    static AllocationPolicy policy = []() {
+        if (const char* tmp = getenv("QULACS_ALLOCATION")) {
+            return parse_allocation_policy(tmp);
+        }
+        return ALLOCATION_ALIGNED | ALLOCATION_FIRST_TOUCH;
+    }();
+    return policy;
+}
+
+AllocationPolicy get_default_allocation_policy() {
+    return default_allocation_policy();
+}
+
+void set_default_allocation_policy(AllocationPolicy policy) {
+    default_allocation_policy() = policy;
+}
+
+// Each buffer starts with a header in the prefix just before the state, so
+// that release_quantum_state knows how to free it without a global registry.
+// The prefix is one cache line, or one huge page so that the state stays
+// aligned to huge pages.
+enum StateMemoryKind : UINT {
+    STATE_MEMORY_MALLOC,
+    STATE_MEMORY_ALIGNED,
+    STATE_MEMORY_MAPPED,
+};
+
+struct StateMemoryHeader {
+    void* base;
+    size_t size;
+    StateMemoryKind kind;
+};
+
+static StateMemoryHeader* get_state_memory_header(CTYPE* state) {
+    return reinterpret_cast<StateMemoryHeader*>(
+        reinterpret_cast<char*>(state) - CACHE_LINE_SIZE);
+}
+
+static CTYPE* place_state_memory_header(
+    void* base, size_t size, size_t prefix_size, StateMemoryKind kind) {
+    if (base == NULL) return NULL;
+    CTYPE* state =
+        reinterpret_cast<CTYPE*>(reinterpret_cast<char*>(base) + prefix_size);
+    StateMemoryHeader* header = get_state_memory_header(state);
+    header->base = base;
+    header->size = size;
+    header->kind = kind;
+    return state;
+}
+
+static void* aligned_allocate(size_t size, size_t alignment) {
+#ifdef _MSC_VER
+    return _aligned_malloc(size, alignment);
+#else
+    void* ptr = NULL;
+    if (posix_memalign(&ptr, alignment, size) != 0) return NULL;
+    return ptr;
+#endif
+}
+
+static CTYPE* huge_page_allocate(size_t size) {
+    // round up to whole huge pages
+    size = (size + 2 * HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+#if defined(__linux__) && defined(MAP_HUGETLB)
+    // explicit huge pages are used only when the administrator reserved them
+    void* mapped = mmap(NULL, size, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (mapped != MAP_FAILED) {
+        return place_state_memory_header(
+            mapped, size, HUGE_PAGE_SIZE, STATE_MEMORY_MAPPED);
+    }
+#endif
+    void* ptr = aligned_allocate(size, HUGE_PAGE_SIZE);
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    // otherwise ask for transparent huge pages, except for the prefix
+    if (ptr != NULL) {
+        madvise((char*)ptr + HUGE_PAGE_SIZE, size - HUGE_PAGE_SIZE,
+            MADV_HUGEPAGE);
+    }
+#endif
+    return place_state_memory_header(
+        ptr, size, HUGE_PAGE_SIZE, STATE_MEMORY_ALIGNED);
+}
+
+static CTYPE* allocate_state_memory(ITYPE dim, AllocationPolicy policy) {
+    const size_t size = (size_t)(sizeof(CTYPE) * dim);
+    CTYPE* state;
+    if (policy & ALLOCATION_HUGE_PAGE) {
+        state = huge_page_allocate(size);
+    } else if (policy & ALLOCATION_ALIGNED) {
+        state = place_state_memory_header(
+            aligned_allocate(size + CACHE_LINE_SIZE, CACHE_LINE_SIZE),
+            size + CACHE_LINE_SIZE, CACHE_LINE_SIZE, STATE_MEMORY_ALIGNED);
+    } else {
+#ifdef _MSC_VER
+        // buffers are always released with _aligned_free on Windows
+        state = place_state_memory_header(
+            aligned_allocate(size + CACHE_LINE_SIZE, sizeof(CTYPE)),
+            size + CACHE_LINE_SIZE, CACHE_LINE_SIZE, STATE_MEMORY_ALIGNED);
+#else
+        state = place_state_memory_header(malloc(size + CACHE_LINE_SIZE),
+            size + CACHE_LINE_SIZE, CACHE_LINE_SIZE, STATE_MEMORY_MALLOC);
+#endif
+    }
 
     if (!state) {
         fprintf(stderr, "Out of memory\n");
@@ -26,7 +155,77 @@ CTYPE* allocate_quantum_state(ITYPE dim) {
     return state;
 }
 
+// Each thread writes the block it will update in the kernels, so that the
+// OS places the pages on the NUMA node of that thread. The state is set to
+// |0> in the same pass.
+static void first_touch_quantum_state(CTYPE* state, ITYPE dim) {
+    ITYPE index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
+#pragma omp parallel for schedule(static)
+#endif
+    for (index = 0; index < dim; ++index) {
+        state[index] = 0;
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    state[0] = 1.0;
+}
+
+// memory allocation
+CTYPE* allocate_quantum_state(ITYPE dim) {
+    return allocate_quantum_state_with_policy(
+        dim, get_default_allocation_policy());
+}
+
+CTYPE* allocate_quantum_state_with_policy(ITYPE dim, AllocationPolicy policy) {
+    CTYPE* state = allocate_state_memory(dim, policy);
+    if (policy & ALLOCATION_FIRST_TOUCH) {
+        first_touch_quantum_state(state, dim);
+    }
+    return state;
+}
+
+CTYPE* allocate_quantum_state_copy_with_policy(
+    const CTYPE* source, ITYPE dim, AllocationPolicy policy) {
+    CTYPE* state = allocate_state_memory(dim, policy);
+    if (policy & ALLOCATION_FIRST_TOUCH) {
+        copy_quantum_state(source, state, dim);
+    } else {
+        memcpy(state, source, (size_t)(sizeof(CTYPE) * dim));
+    }
+    return state;
+}
+
+// The pages are read and written with the static schedule of the kernels,
+// which keeps them on the NUMA node placed by the first touch.
+void copy_quantum_state(const CTYPE* source, CTYPE* state, ITYPE dim) {
+    ITYPE index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
+#pragma omp parallel for schedule(static)
+#endif
+    for (index = 0; index < dim; ++index) {
+        state[index] = source[index];
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
 void release_quantum_state(CTYPE* state) {
-    free(state);
-    //_aligned_free(state);
+    if (state == NULL) return;
+    const StateMemoryHeader header = *get_state_memory_header(state);
+#if defined(__linux__) && defined(MAP_HUGETLB)
+    if (header.kind == STATE_MEMORY_MAPPED) {
+        munmap(header.base, header.size);
+        return;
+    }
+#endif
+#ifdef _MSC_VER
+    _aligned_free(header.base);
+#else
+    free(header.base);
+#endif
 }
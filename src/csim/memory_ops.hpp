@@ -9,14 +9,75 @@
 #include "type.hpp"
 
 /**
- * allocate quantum state in memory
+ * Flags which select how a state vector is allocated. They can be combined
+ * with operator|.
  *
+ * The default policy is ALLOCATION_ALIGNED | ALLOCATION_FIRST_TOUCH. It can
+ * be overridden with the environment variable QULACS_ALLOCATION, a comma
+ * separated list of "malloc", "aligned", "hugepage" and "first_touch", or
+ * with set_default_allocation_policy.
+ */
+enum AllocationPolicy : UINT {
+    //! plain malloc
+    ALLOCATION_MALLOC = 0,
+    //! 64-byte (cache line) aligned buffer
+    ALLOCATION_ALIGNED = 1,
+    //! 2 MiB aligned buffer backed by huge pages when the OS provides them
+    ALLOCATION_HUGE_PAGE = 2,
+    //! touch the pages in parallel with the static schedule of the kernels
+    ALLOCATION_FIRST_TOUCH = 4,
+};
+
+inline AllocationPolicy operator|(AllocationPolicy a, AllocationPolicy b) {
+    return static_cast<AllocationPolicy>(
+        static_cast<UINT>(a) | static_cast<UINT>(b));
+}
+
+/**
  * allocate quantum state in memory
+ *
+ * allocate quantum state in memory with the default allocation policy
  * @param[in] dim dimension, i.e. size of vector
  * @return pointer to allocated vector
  */
 DllExport CTYPE* allocate_quantum_state(ITYPE dim);
 
+/**
+ * allocate quantum state in memory with the given policy
+ *
+ * The buffer must be released with release_quantum_state.
+ * When ALLOCATION_FIRST_TOUCH is set, the buffer is initialized to |0> by
+ * the first touch, so initialize_quantum_state is not needed.
+ * @param[in] dim dimension, i.e. size of vector
+ * @param[in] policy allocation policy
+ * @return pointer to allocated vector
+ */
+DllExport CTYPE* allocate_quantum_state_with_policy(
+    ITYPE dim, AllocationPolicy policy);
+
+/**
+ * allocate a copy of a quantum state with the given policy
+ *
+ * When ALLOCATION_FIRST_TOUCH is set, the first touch of the buffer is the
+ * parallel copy of source.
+ * @param[in] source quantum state to be copied
+ * @param[in] dim dimension, i.e. size of vector
+ * @param[in] policy allocation policy
+ * @return pointer to allocated vector
+ */
+DllExport CTYPE* allocate_quantum_state_copy_with_policy(
+    const CTYPE* source, ITYPE dim, AllocationPolicy policy);
+
+/**
+ * copy quantum state in parallel
+ *
+ * The threads access the same blocks as in the kernels.
+ * @param[in] source quantum state to be copied
+ * @param[out] state destination
+ * @param[in] dim dimension, i.e. size of vector
+ */
+DllExport void copy_quantum_state(const CTYPE* source, CTYPE* state, ITYPE dim);
+
 /**
  * release allocated quantum state
  *
@@ -24,3 +85,15 @@ DllExport CTYPE* allocate_quantum_state(ITYPE dim);
  * @param[in] psi quantum state
  */
 DllExport void release_quantum_state(CTYPE* state);
+
+/**
+ * Policy used by allocate_quantum_state.
+ */
+DllExport AllocationPolicy get_default_allocation_policy();
+
+/**
+ * Change the policy used by allocate_quantum_state.
+ *
+ * This must not be called while other threads allocate states.
+ */
+DllExport void set_default_allocation_policy(AllocationPolicy policy);
@@ -0,0 +1,140 @@
+#include "memory_ops_float.hpp"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "utility.hpp"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// defined in init_ops_random.cpp
+unsigned long xor_shift(unsigned long* state);
+double random_normal(unsigned long* state);
+
+CTYPE_F* float_allocate_quantum_state(ITYPE dim) {
+    CTYPE_F* state = (CTYPE_F*)malloc((size_t)(sizeof(CTYPE_F) * dim));
+    if (!state) {
+        fprintf(stderr, "Out of memory\n");
+        fflush(stderr);
+        exit(1);
+    }
+    return state;
+}
+
+void float_initialize_quantum_state(CTYPE_F* state, ITYPE dim) {
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 15);
+#pragma omp parallel for
+#endif
+    for (ITYPE index = 0; index < dim; ++index) {
+        state[index] = 0;
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    state[0] = 1.0f;
+}
+
+void float_initialize_Haar_random_state_with_seed(
+    CTYPE_F* state, ITYPE dim, UINT seed) {
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+    const UINT thread_count = omp_get_max_threads();
+#else
+    const UINT thread_count = 1;
+#endif
+    const int ignore_first = 40;
+    const ITYPE block_size = dim / thread_count;
+    const ITYPE residual = dim % thread_count;
+
+    unsigned long* random_state_list =
+        (unsigned long*)malloc(sizeof(unsigned long) * 4 * thread_count);
+    srand(seed);
+    for (UINT i = 0; i < 4 * thread_count; ++i) {
+        random_state_list[i] = rand();
+    }
+
+    // the norm is accumulated in double precision
+    double* norm_list = (double*)malloc(sizeof(double) * thread_count);
+    for (UINT i = 0; i < thread_count; ++i) {
+        norm_list[i] = 0;
+    }
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+#ifdef _OPENMP
+        UINT thread_id = omp_get_thread_num();
+#else
+        UINT thread_id = 0;
+#endif
+        unsigned long* my_random_state = random_state_list + 4 * thread_id;
+        ITYPE start_index = block_size * thread_id +
+                            (residual > thread_id ? thread_id : residual);
+        ITYPE end_index =
+            block_size * (thread_id + 1) +
+            (residual > (thread_id + 1) ? (thread_id + 1) : residual);
+        ITYPE index;
+
+        // ignore first randoms
+        for (int i = 0; i < ignore_first; ++i) xor_shift(my_random_state);
+
+        for (index = start_index; index < end_index; ++index) {
+            double r1, r2;
+            r1 = random_normal(my_random_state);
+            r2 = random_normal(my_random_state);
+            state[index] = CTYPE_F((float)r1, (float)r2);
+            norm_list[thread_id] += r1 * r1 + r2 * r2;
+        }
+    }
+
+    double normalizer = 0.;
+    for (UINT i = 0; i < thread_count; ++i) {
+        normalizer += norm_list[i];
+    }
+    const float scale = (float)(1. / sqrt(normalizer));
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (ITYPE index = 0; index < dim; ++index) {
+        state[index] *= scale;
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    free(random_state_list);
+    free(norm_list);
+}
+
+void float_release_quantum_state(CTYPE_F* state) { free(state); }
+
+void float_state_from_double(
+    const CTYPE* state_src, CTYPE_F* state_dst, ITYPE dim) {
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 15);
+#pragma omp parallel for
+#endif
+    for (ITYPE index = 0; index < dim; ++index) {
+        state_dst[index] = CTYPE_F(state_src[index]);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+void float_state_to_double(
+    const CTYPE_F* state_src, CTYPE* state_dst, ITYPE dim) {
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 15);
+#pragma omp parallel for
+#endif
+    for (ITYPE index = 0; index < dim; ++index) {
+        state_dst[index] = CTYPE(state_src[index]);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
@@ -0,0 +1,64 @@
+/**
+ * @file memory_ops_float.hpp
+ * @brief Definition and basic functions for single precision state vector
+ */
+
+#pragma once
+
+#include "type.hpp"
+
+/**
+ * allocate single precision quantum state in memory
+ *
+ * @param[in] dim dimension, i.e. size of vector
+ * @return pointer to allocated vector
+ */
+DllExport CTYPE_F* float_allocate_quantum_state(ITYPE dim);
+
+/**
+ * intiialize single precision quantum state to zero state
+ *
+ * @param[out] state pointer of quantum state
+ * @param[in] dim dimension
+ */
+DllExport void float_initialize_quantum_state(CTYPE_F* state, ITYPE dim);
+
+/**
+ * initialize single precision quantum state to Haar random state
+ *
+ * The random numbers are the same as initialize_Haar_random_state_with_seed,
+ * so that the result is the single precision copy of the double precision
+ * state made with the same seed.
+ * @param[out] state pointer of quantum state
+ * @param[in] dim dimension
+ * @param[in] seed random seed
+ */
+DllExport void float_initialize_Haar_random_state_with_seed(
+    CTYPE_F* state, ITYPE dim, UINT seed);
+
+/**
+ * release allocated single precision quantum state
+ *
+ * @param[in] state quantum state
+ */
+DllExport void float_release_quantum_state(CTYPE_F* state);
+
+/**
+ * convert double precision quantum state to single precision
+ *
+ * @param[in] state_src double precision quantum state
+ * @param[out] state_dst single precision quantum state
+ * @param[in] dim dimension
+ */
+DllExport void float_state_from_double(
+    const CTYPE* state_src, CTYPE_F* state_dst, ITYPE dim);
+
+/**
+ * convert single precision quantum state to double precision
+ *
+ * @param[in] state_src single precision quantum state
+ * @param[out] state_dst double precision quantum state
+ * @param[in] dim dimension
+ */
+DllExport void float_state_to_double(
+    const CTYPE_F* state_src, CTYPE* state_dst, ITYPE dim);
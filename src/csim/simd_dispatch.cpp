@@ -0,0 +1,298 @@
+#include "simd_dispatch.hpp"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "update_ops.hpp"
+
+#ifdef _USE_SIMD
+#ifdef _MSC_VER
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+#endif
+
+#ifdef _USE_SVE
+#if defined(__linux__)
+#include <sys/auxv.h>
+#endif
+#ifndef HWCAP_SVE
+#define HWCAP_SVE (1 << 22)
+#endif
+#endif
+
+double expectation_value_X_Pauli_operator(
+    UINT target_qubit_index, const CTYPE* state, ITYPE dim);
+double expectation_value_Y_Pauli_operator(
+    UINT target_qubit_index, const CTYPE* state, ITYPE dim);
+double expectation_value_Z_Pauli_operator(
+    UINT target_qubit_index, const CTYPE* state, ITYPE dim);
+double expectation_value_multi_qubit_Pauli_operator_XZ_mask(ITYPE bit_flip_mask,
+    ITYPE phase_flip_mask, UINT global_phase_90rot_count,
+    UINT pivot_qubit_index, const CTYPE* state, ITYPE dim);
+double expectation_value_multi_qubit_Pauli_operator_Z_mask(
+    ITYPE phase_flip_mask, const CTYPE* state, ITYPE dim);
+
+#ifdef _USE_SVE
+double expectation_value_X_Pauli_operator_sve(
+    UINT target_qubit_index, const CTYPE* state, ITYPE dim);
+double expectation_value_Y_Pauli_operator_sve(
+    UINT target_qubit_index, const CTYPE* state, ITYPE dim);
+double expectation_value_Z_Pauli_operator_sve(
+    UINT target_qubit_index, const CTYPE* state, ITYPE dim);
+double expectation_value_multi_qubit_Pauli_operator_XZ_mask_sve(
+    ITYPE bit_flip_mask, ITYPE phase_flip_mask, UINT global_phase_90rot_count,
+    UINT pivot_qubit_index, const CTYPE* state, ITYPE dim);
+double expectation_value_multi_qubit_Pauli_operator_Z_mask_sve(
+    ITYPE phase_flip_mask, const CTYPE* state, ITYPE dim);
+
+// The SVE reductions need at least one full register of amplitudes.
+static double expectation_value_X_Pauli_operator_sve_guarded(
+    UINT target_qubit_index, const CTYPE* state, ITYPE dim) {
+    if (dim > svcntd() / 2)
+        return expectation_value_X_Pauli_operator_sve(
+            target_qubit_index, state, dim);
+    return expectation_value_X_Pauli_operator(target_qubit_index, state, dim);
+}
+static double expectation_value_Y_Pauli_operator_sve_guarded(
+    UINT target_qubit_index, const CTYPE* state, ITYPE dim) {
+    if (dim > svcntd() / 2)
+        return expectation_value_Y_Pauli_operator_sve(
+            target_qubit_index, state, dim);
+    return expectation_value_Y_Pauli_operator(target_qubit_index, state, dim);
+}
+static double expectation_value_Z_Pauli_operator_sve_guarded(
+    UINT target_qubit_index, const CTYPE* state, ITYPE dim) {
+    if (dim >= svcntd() / 2)
+        return expectation_value_Z_Pauli_operator_sve(
+            target_qubit_index, state, dim);
+    return expectation_value_Z_Pauli_operator(target_qubit_index, state, dim);
+}
+static double expectation_value_multi_qubit_Pauli_operator_XZ_mask_sve_guarded(
+    ITYPE bit_flip_mask, ITYPE phase_flip_mask, UINT global_phase_90rot_count,
+    UINT pivot_qubit_index, const CTYPE* state, ITYPE dim) {
+    if (dim > svcntd() / 2)
+        return expectation_value_multi_qubit_Pauli_operator_XZ_mask_sve(
+            bit_flip_mask, phase_flip_mask, global_phase_90rot_count,
+            pivot_qubit_index, state, dim);
+    return expectation_value_multi_qubit_Pauli_operator_XZ_mask(bit_flip_mask,
+        phase_flip_mask, global_phase_90rot_count, pivot_qubit_index, state,
+        dim);
+}
+static double expectation_value_multi_qubit_Pauli_operator_Z_mask_sve_guarded(
+    ITYPE phase_flip_mask, const CTYPE* state, ITYPE dim) {
+    if (dim > svcntd() / 2)
+        return expectation_value_multi_qubit_Pauli_operator_Z_mask_sve(
+            phase_flip_mask, state, dim);
+    return expectation_value_multi_qubit_Pauli_operator_Z_mask(
+        phase_flip_mask, state, dim);
+}
+#endif
+
+SIMDutil::SIMDutil() {
+    detected_variant = detect_variant();
+    active_variant = detected_variant;
+
+    if (const char* tmp = std::getenv("QULACS_SIMD")) {
+        SIMDVariant requested = active_variant;
+        if (strcmp(tmp, "scalar") == 0 || strcmp(tmp, "none") == 0) {
+            requested = SIMD_VARIANT_SCALAR;
+        } else if (strcmp(tmp, "avx2") == 0) {
+            requested = SIMD_VARIANT_AVX2;
+        } else if (strcmp(tmp, "avx512") == 0) {
+            requested = SIMD_VARIANT_AVX512;
+        } else if (strcmp(tmp, "sve") == 0) {
+            requested = SIMD_VARIANT_SVE;
+        }
+        // unsupported requests fall back to the detected variant
+        if (is_supported(requested)) active_variant = requested;
+    }
+
+    fill_kernel_table(active_variant, &kernel_table);
+}
+
+SIMDVariant SIMDutil::detect_variant() {
+#ifdef _USE_SIMD
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    const int max_leaf = info[0];
+    if (max_leaf >= 7) {
+        __cpuid(info, 1);
+        const bool has_fma = (info[2] >> 12) & 1;
+        const bool has_osxsave = (info[2] >> 27) & 1;
+        const bool has_avx = (info[2] >> 28) & 1;
+        __cpuidex(info, 7, 0);
+        const bool has_avx2 = (info[1] >> 5) & 1;
+        const bool has_avx512f = (info[1] >> 16) & 1;
+        // the OS must save YMM (and ZMM, opmask) registers on context switch
+        const bool has_ymm_state =
+            has_osxsave && (_xgetbv(0) & 0x6) == 0x6;
+        const bool has_zmm_state =
+            has_osxsave && (_xgetbv(0) & 0xe6) == 0xe6;
+        if (has_fma && has_avx && has_avx2 && has_ymm_state) {
+            if (has_avx512f && has_zmm_state) return SIMD_VARIANT_AVX512;
+            return SIMD_VARIANT_AVX2;
+        }
+    }
+#else
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        if (__builtin_cpu_supports("avx512f")) return SIMD_VARIANT_AVX512;
+        return SIMD_VARIANT_AVX2;
+    }
+#endif
+#endif
+
+#ifdef _USE_SVE
+#if defined(__linux__)
+    if (getauxval(AT_HWCAP) & HWCAP_SVE) return SIMD_VARIANT_SVE;
+#else
+    return SIMD_VARIANT_SVE;
+#endif
+#endif
+
+    return SIMD_VARIANT_SCALAR;
+}
+
+void SIMDutil::fill_kernel_table(SIMDVariant variant, KernelTable* table) {
+#if !defined(_USE_SIMD) && !defined(_USE_SVE)
+    (void)variant;
+#endif
+    table->X_gate = X_gate_parallel_unroll;
+    table->Y_gate = Y_gate_parallel_unroll;
+    table->Z_gate = Z_gate_parallel_unroll;
+    table->H_gate = H_gate_parallel_unroll;
+    table->CNOT_gate = CNOT_gate_parallel_unroll;
+    table->CZ_gate = CZ_gate_parallel_unroll;
+    table->SWAP_gate = SWAP_gate_parallel_unroll;
+    table->single_qubit_dense_matrix_gate =
+        single_qubit_dense_matrix_gate_parallel;
+    table->single_qubit_diagonal_matrix_gate =
+        single_qubit_diagonal_matrix_gate_parallel_unroll;
+    table->single_qubit_phase_gate = single_qubit_phase_gate_parallel_unroll;
+    table->single_qubit_control_single_qubit_dense_matrix_gate =
+        single_qubit_control_single_qubit_dense_matrix_gate_unroll;
+    table->multi_qubit_control_single_qubit_dense_matrix_gate =
+        multi_qubit_control_single_qubit_dense_matrix_gate_unroll;
+    table->double_qubit_dense_matrix_gate =
+        double_qubit_dense_matrix_gate_nosimd;
+    table->multi_qubit_dense_matrix_gate =
+        multi_qubit_dense_matrix_gate_parallel;
+    table->expectation_value_X_Pauli_operator =
+        expectation_value_X_Pauli_operator;
+    table->expectation_value_Y_Pauli_operator =
+        expectation_value_Y_Pauli_operator;
+    table->expectation_value_Z_Pauli_operator =
+        expectation_value_Z_Pauli_operator;
+    table->expectation_value_multi_qubit_Pauli_operator_XZ_mask =
+        expectation_value_multi_qubit_Pauli_operator_XZ_mask;
+    table->expectation_value_multi_qubit_Pauli_operator_Z_mask =
+        expectation_value_multi_qubit_Pauli_operator_Z_mask;
+
+#ifdef _USE_SIMD
+    if (variant == SIMD_VARIANT_AVX2 || variant == SIMD_VARIANT_AVX512) {
+        table->X_gate = X_gate_parallel_simd;
+        table->Y_gate = Y_gate_parallel_simd;
+        table->Z_gate = Z_gate_parallel_simd;
+        table->H_gate = H_gate_parallel_simd;
+        table->CNOT_gate = CNOT_gate_parallel_simd;
+        table->CZ_gate = CZ_gate_parallel_simd;
+        table->SWAP_gate = SWAP_gate_parallel_simd;
+        table->single_qubit_dense_matrix_gate =
+            single_qubit_dense_matrix_gate_parallel_simd;
+        table->single_qubit_diagonal_matrix_gate =
+            single_qubit_diagonal_matrix_gate_parallel_simd;
+        table->single_qubit_phase_gate = single_qubit_phase_gate_parallel_simd;
+        table->single_qubit_control_single_qubit_dense_matrix_gate =
+            single_qubit_control_single_qubit_dense_matrix_gate_simd;
+        table->multi_qubit_control_single_qubit_dense_matrix_gate =
+            multi_qubit_control_single_qubit_dense_matrix_gate_simd;
+        table->double_qubit_dense_matrix_gate =
+            double_qubit_dense_matrix_gate_simd;
+    }
+    // kernels without a 512-bit version keep the AVX2 one
+    if (variant == SIMD_VARIANT_AVX512) {
+        table->single_qubit_dense_matrix_gate =
+            single_qubit_dense_matrix_gate_parallel_avx512;
+        table->single_qubit_diagonal_matrix_gate =
+            single_qubit_diagonal_matrix_gate_parallel_avx512;
+        table->single_qubit_phase_gate =
+            single_qubit_phase_gate_parallel_avx512;
+        table->double_qubit_dense_matrix_gate =
+            double_qubit_dense_matrix_gate_avx512;
+        table->multi_qubit_dense_matrix_gate =
+            multi_qubit_dense_matrix_gate_parallel_avx512;
+    }
+#endif
+
+#ifdef _USE_SVE
+    if (variant == SIMD_VARIANT_SVE) {
+        table->X_gate = X_gate_parallel_sve;
+        table->Y_gate = Y_gate_parallel_sve;
+        table->Z_gate = Z_gate_parallel_sve;
+        table->H_gate = H_gate_parallel_sve;
+        table->CNOT_gate = CNOT_gate_parallel_sve;
+        table->CZ_gate = CZ_gate_parallel_sve;
+        table->SWAP_gate = SWAP_gate_parallel_sve;
+        table->single_qubit_dense_matrix_gate =
+            single_qubit_dense_matrix_gate_parallel_sve;
+        table->single_qubit_diagonal_matrix_gate =
+            single_qubit_diagonal_matrix_gate_parallel_sve;
+        table->single_qubit_control_single_qubit_dense_matrix_gate =
+            single_qubit_control_single_qubit_dense_matrix_gate_sve512;
+        table->double_qubit_dense_matrix_gate =
+            double_qubit_dense_matrix_gate_sve;
+        table->expectation_value_X_Pauli_operator =
+            expectation_value_X_Pauli_operator_sve_guarded;
+        table->expectation_value_Y_Pauli_operator =
+            expectation_value_Y_Pauli_operator_sve_guarded;
+        table->expectation_value_Z_Pauli_operator =
+            expectation_value_Z_Pauli_operator_sve_guarded;
+        table->expectation_value_multi_qubit_Pauli_operator_XZ_mask =
+            expectation_value_multi_qubit_Pauli_operator_XZ_mask_sve_guarded;
+        table->expectation_value_multi_qubit_Pauli_operator_Z_mask =
+            expectation_value_multi_qubit_Pauli_operator_Z_mask_sve_guarded;
+    }
+#endif
+}
+
+bool SIMDutil::is_supported(SIMDVariant variant) const {
+    if (variant == SIMD_VARIANT_SCALAR) return true;
+    if (variant == SIMD_VARIANT_AVX2 &&
+        detected_variant == SIMD_VARIANT_AVX512)
+        return true;
+    return variant == detected_variant;
+}
+
+bool SIMDutil::set_variant(SIMDVariant variant) {
+    if (!is_supported(variant)) return false;
+    active_variant = variant;
+    fill_kernel_table(active_variant, &kernel_table);
+    return true;
+}
+
+const char* SIMDutil::get_variant_name(SIMDVariant variant) {
+    switch (variant) {
+        case SIMD_VARIANT_AVX2:
+            return "avx2";
+        case SIMD_VARIANT_AVX512:
+            return "avx512";
+        case SIMD_VARIANT_SVE:
+            return "sve";
+        default:
+            return "scalar";
+    }
+}
+
+const char* get_simd_variant_name() {
+    return SIMDutil::get_variant_name(SIMDutil::get_inst().get_variant());
+}
+
+namespace {
+// Fill the table when the library is loaded rather than on the first kernel
+// call.
+struct SIMDutilLoader {
+    SIMDutilLoader() { SIMDutil::get_inst(); }
+} simd_util_loader;
+}  // namespace
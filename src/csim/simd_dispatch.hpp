@@ -0,0 +1,135 @@
+/**
+ * @file simd_dispatch.hpp
+ * @brief runtime selection of SIMD kernels
+ *
+ * Kernels which have several implementations (unrolled, AVX2, AVX-512,
+ * SVE, ...) are
+ * called through a table of function pointers. The table is filled once when
+ * the library is loaded, according to the instruction sets reported by the
+ * CPU. The choice can be overridden with the environment variable
+ * QULACS_SIMD=scalar|avx2|avx512|sve, or with SIMDutil::set_variant.
+ */
+
+#pragma once
+
+#include "type.hpp"
+
+/**
+ * Instruction-set variant of the kernels
+ */
+enum SIMDVariant {
+    SIMD_VARIANT_SCALAR = 0,
+    SIMD_VARIANT_AVX2 = 1,
+    SIMD_VARIANT_SVE = 2,
+    SIMD_VARIANT_AVX512 = 3,
+};
+
+/**
+ * Function pointers of the kernels declared in update_ops.hpp and
+ * stat_ops.hpp which have instruction-set specific implementations.
+ * Each entry has the same signature as the public function of the same name.
+ */
+struct KernelTable {
+    void (*X_gate)(UINT target_qubit_index, CTYPE* state, ITYPE dim);
+    void (*Y_gate)(UINT target_qubit_index, CTYPE* state, ITYPE dim);
+    void (*Z_gate)(UINT target_qubit_index, CTYPE* state, ITYPE dim);
+    void (*H_gate)(UINT target_qubit_index, CTYPE* state, ITYPE dim);
+    void (*CNOT_gate)(UINT control_qubit_index, UINT target_qubit_index,
+        CTYPE* state, ITYPE dim);
+    void (*CZ_gate)(UINT control_qubit_index, UINT target_qubit_index,
+        CTYPE* state, ITYPE dim);
+    void (*SWAP_gate)(UINT target_qubit_index_0, UINT target_qubit_index_1,
+        CTYPE* state, ITYPE dim);
+    void (*single_qubit_dense_matrix_gate)(UINT target_qubit_index,
+        const CTYPE matrix[4], CTYPE* state, ITYPE dim);
+    void (*single_qubit_diagonal_matrix_gate)(UINT target_qubit_index,
+        const CTYPE diagonal_matrix[2], CTYPE* state, ITYPE dim);
+    void (*single_qubit_phase_gate)(
+        UINT target_qubit_index, CTYPE phase, CTYPE* state, ITYPE dim);
+    void (*single_qubit_control_single_qubit_dense_matrix_gate)(
+        UINT control_qubit_index, UINT control_value, UINT target_qubit_index,
+        const CTYPE matrix[4], CTYPE* state, ITYPE dim);
+    void (*multi_qubit_control_single_qubit_dense_matrix_gate)(
+        const UINT* control_qubit_index_list, const UINT* control_value_list,
+        UINT control_qubit_index_count, UINT target_qubit_index,
+        const CTYPE matrix[4], CTYPE* state, ITYPE dim);
+    void (*double_qubit_dense_matrix_gate)(UINT target_qubit_index1,
+        UINT target_qubit_index2, const CTYPE matrix[16], CTYPE* state,
+        ITYPE dim);
+    void (*multi_qubit_dense_matrix_gate)(const UINT* target_qubit_index_list,
+        UINT target_qubit_index_count, const CTYPE* matrix, CTYPE* state,
+        ITYPE dim);
+
+    double (*expectation_value_X_Pauli_operator)(
+        UINT target_qubit_index, const CTYPE* state, ITYPE dim);
+    double (*expectation_value_Y_Pauli_operator)(
+        UINT target_qubit_index, const CTYPE* state, ITYPE dim);
+    double (*expectation_value_Z_Pauli_operator)(
+        UINT target_qubit_index, const CTYPE* state, ITYPE dim);
+    double (*expectation_value_multi_qubit_Pauli_operator_XZ_mask)(
+        ITYPE bit_flip_mask, ITYPE phase_flip_mask,
+        UINT global_phase_90rot_count, UINT pivot_qubit_index,
+        const CTYPE* state, ITYPE dim);
+    double (*expectation_value_multi_qubit_Pauli_operator_Z_mask)(
+        ITYPE phase_flip_mask, const CTYPE* state, ITYPE dim);
+};
+
+/**
+ * SIMD kernel dispatch utility
+ */
+class SIMDutil {
+private:
+    SIMDVariant detected_variant = SIMD_VARIANT_SCALAR;
+    SIMDVariant active_variant = SIMD_VARIANT_SCALAR;
+    KernelTable kernel_table;
+
+    SIMDutil();
+    ~SIMDutil() = default;
+
+    static SIMDVariant detect_variant();
+    static void fill_kernel_table(SIMDVariant variant, KernelTable* table);
+
+public:
+    SIMDutil(const SIMDutil&) = delete;
+    SIMDutil& operator=(const SIMDutil&) = delete;
+    SIMDutil(SIMDutil&&) = delete;
+    SIMDutil& operator=(SIMDutil&&) = delete;
+
+    static SIMDutil& get_inst() {
+        static SIMDutil instance;
+        return instance;
+    }
+
+    const KernelTable& get_kernel_table() const { return kernel_table; }
+
+    /**
+     * Variant used by the kernel table now.
+     */
+    SIMDVariant get_variant() const { return active_variant; }
+
+    /**
+     * Best variant which is both compiled in and supported by this CPU.
+     */
+    SIMDVariant get_detected_variant() const { return detected_variant; }
+
+    /**
+     * Whether the variant can run on this CPU. AVX-512 machines also
+     * support the AVX2 variant.
+     */
+    bool is_supported(SIMDVariant variant) const;
+
+    /**
+     * Switch the kernel table to the given variant.
+     *
+     * Returns false and keeps the current table when the variant is not
+     * supported. This must not be called while other threads run kernels.
+     */
+    bool set_variant(SIMDVariant variant);
+
+    static const char* get_variant_name(SIMDVariant variant);
+};
+
+/**
+ * Name of the active SIMD variant ("scalar", "avx2", "avx512" or "sve").
+ */
+DllExport const char* get_simd_variant_name();
@@ -25,10 +25,28 @@ DllExport double M0_prob(
     UINT target_qubit_index, const CTYPE* state, ITYPE dim);
 DllExport double M1_prob(
     UINT target_qubit_index, const CTYPE* state, ITYPE dim);
+/**
+ * Reduced density matrix of one qubit, rho_{ab} = sum_{i} state[i with a]
+ * conj(state[i with b]), in a single pass.
+ *
+ * reduced_matrix is row-major and its trace is the squared norm of state.
+ */
+DllExport void single_qubit_reduced_density_matrix(UINT target_qubit_index,
+    const CTYPE* state, ITYPE dim, CTYPE reduced_matrix[4]);
 DllExport double marginal_prob(const UINT* sorted_target_qubit_index_list,
     const UINT* measured_value_list, UINT target_qubit_index_count,
     const CTYPE* state, ITYPE dim);
 
+/**
+ * Sample basis indices with the probability |state[index]|^2 / norm.
+ *
+ * result[i] is the basis index selected by uniform_list[i], a value in
+ * [0, 1): the smallest index whose cumulative probability exceeds it. The
+ * result does not depend on the number of threads.
+ */
+DllExport void state_sampling(const CTYPE* state, ITYPE dim,
+    const double* uniform_list, UINT sampling_count, ITYPE* result);
+
 DllExport double expectation_value_single_qubit_Pauli_operator(
     UINT target_qubit_index, UINT Pauli_operator_type, const CTYPE* state,
     ITYPE dim);
@@ -39,6 +57,37 @@ DllExport double expectation_value_multi_qubit_Pauli_operator_partial_list(
     const UINT* target_qubit_index_list, const UINT* Pauli_operator_type_list,
     UINT target_qubit_index_count, const CTYPE* state, ITYPE dim);
 
+/**
+ * Expectation values of the Pauli operators which share bit_flip_mask.
+ *
+ * result[term] is the expectation value of the Pauli operator given by
+ * bit_flip_mask, phase_flip_mask_list[term] and
+ * global_phase_90rot_count_list[term] (see get_Pauli_masks_partial_list).
+ * All terms are evaluated in a single pass over the state. The order of the
+ * summation depends on the number of threads, so results computed with a
+ * different number of threads may differ by rounding errors.
+ */
+DllExport void expectation_value_multi_qubit_Pauli_operator_group_XZ_mask(
+    ITYPE bit_flip_mask, const ITYPE* phase_flip_mask_list,
+    const UINT* global_phase_90rot_count_list, UINT term_count,
+    const CTYPE* state, ITYPE dim, double* result);
+
+/**
+ * Diagonal of a linear combination of Pauli operators made of I and Z.
+ *
+ * diagonal[basis] = sum_term coef_list[term]
+ * (-1)^{popcount(basis & phase_flip_mask_list[term])} for basis < dim.
+ */
+DllExport void Pauli_operator_Z_mask_diagonal(const ITYPE* phase_flip_mask_list,
+    const CTYPE* coef_list, UINT term_count, CTYPE* diagonal, ITYPE dim);
+/**
+ * Expectation value of a diagonal operator, sum_basis |state[basis]|^2
+ * diagonal[basis % diagonal_dim]. diagonal_dim must be a power of two not
+ * larger than dim, i.e., the operator acts on the lowest qubits.
+ */
+DllExport CTYPE expectation_value_diagonal_operator(const CTYPE* diagonal,
+    ITYPE diagonal_dim, const CTYPE* state, ITYPE dim);
+
 DllExport CTYPE transition_amplitude_multi_qubit_Pauli_operator_whole_list(
     const UINT* Pauli_operator_type_list, UINT qubit_count,
     const CTYPE* state_bra, const CTYPE* state_ket, ITYPE dim);
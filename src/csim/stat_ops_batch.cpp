@@ -0,0 +1,142 @@
+#include "stat_ops_batch.hpp"
+
+#include <stdlib.h>
+
+#include "constant.hpp"
+#include "utility.hpp"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Each thread accumulates into its own row of partial sums, and the rows are
+// added in the order of the thread number so that the result does not depend
+// on the scheduling.
+static void batch_reduce_partial_sum(const double* partial_sum_list,
+    UINT thread_count, UINT batch_size, double* result_list) {
+    for (UINT element = 0; element < batch_size; ++element) {
+        result_list[element] = 0.;
+    }
+    for (UINT thread = 0; thread < thread_count; ++thread) {
+        const double* partial_sum = partial_sum_list + thread * batch_size;
+        for (UINT element = 0; element < batch_size; ++element) {
+            result_list[element] += partial_sum[element];
+        }
+    }
+}
+
+void batch_state_norm_squared(
+    const CTYPE* state, ITYPE dim, UINT batch_size, double* norm_list) {
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim * batch_size, 15);
+    const UINT thread_count = omp_get_max_threads();
+#else
+    const UINT thread_count = 1;
+#endif
+    double* partial_sum_list =
+        (double*)calloc((size_t)thread_count * batch_size, sizeof(double));
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+#ifdef _OPENMP
+        double* partial_sum =
+            partial_sum_list + batch_size * omp_get_thread_num();
+#pragma omp for
+#else
+        double* partial_sum = partial_sum_list;
+#endif
+        for (ITYPE state_index = 0; state_index < dim; ++state_index) {
+            const CTYPE* amplitude = state + state_index * batch_size;
+            for (UINT element = 0; element < batch_size; ++element) {
+                const double re = amplitude[element].real();
+                const double im = amplitude[element].imag();
+                partial_sum[element] += re * re + im * im;
+            }
+        }
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    batch_reduce_partial_sum(
+        partial_sum_list, thread_count, batch_size, norm_list);
+    free(partial_sum_list);
+}
+
+void batch_expectation_value_multi_qubit_Pauli_operator_partial_list(
+    const UINT* target_qubit_index_list, const UINT* Pauli_operator_type_list,
+    UINT target_qubit_index_count, const CTYPE* state, ITYPE dim,
+    UINT batch_size, double* expectation_list) {
+    ITYPE bit_flip_mask = 0;
+    ITYPE phase_flip_mask = 0;
+    UINT global_phase_90rot_count = 0;
+    UINT pivot_qubit_index = 0;
+    get_Pauli_masks_partial_list(target_qubit_index_list,
+        Pauli_operator_type_list, target_qubit_index_count, &bit_flip_mask,
+        &phase_flip_mask, &global_phase_90rot_count, &pivot_qubit_index);
+
+    // with X or Y, amplitudes are visited in pairs of basis_0 and basis_1
+    const ITYPE loop_dim = (bit_flip_mask == 0) ? dim : dim / 2;
+    const ITYPE pivot_mask = 1ULL << pivot_qubit_index;
+
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim * batch_size, 10);
+    const UINT thread_count = omp_get_max_threads();
+#else
+    const UINT thread_count = 1;
+#endif
+    double* partial_sum_list =
+        (double*)calloc((size_t)thread_count * batch_size, sizeof(double));
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+#ifdef _OPENMP
+        double* partial_sum =
+            partial_sum_list + batch_size * omp_get_thread_num();
+#pragma omp for
+#else
+        double* partial_sum = partial_sum_list;
+#endif
+        for (ITYPE state_index = 0; state_index < loop_dim; ++state_index) {
+            if (bit_flip_mask == 0) {
+                const int bit_parity =
+                    count_population(state_index & phase_flip_mask) % 2;
+                const double sign = 1 - 2 * bit_parity;
+                const CTYPE* amplitude = state + state_index * batch_size;
+                for (UINT element = 0; element < batch_size; ++element) {
+                    const double re = amplitude[element].real();
+                    const double im = amplitude[element].imag();
+                    partial_sum[element] += sign * (re * re + im * im);
+                }
+            } else {
+                const ITYPE basis_0 = insert_zero_to_basis_index(
+                    state_index, pivot_mask, pivot_qubit_index);
+                const ITYPE basis_1 = basis_0 ^ bit_flip_mask;
+                const UINT sign_0 =
+                    count_population(basis_0 & phase_flip_mask) % 2;
+                const CTYPE phase =
+                    2. * PHASE_90ROT[(global_phase_90rot_count + sign_0 * 2) %
+                                     4];
+                const CTYPE* amplitude_0 = state + basis_0 * batch_size;
+                const CTYPE* amplitude_1 = state + basis_1 * batch_size;
+                // real part of amplitude_0 * conj(amplitude_1) * phase
+                for (UINT element = 0; element < batch_size; ++element) {
+                    const double re_0 = amplitude_0[element].real();
+                    const double im_0 = amplitude_0[element].imag();
+                    const double re_1 = amplitude_1[element].real();
+                    const double im_1 = amplitude_1[element].imag();
+                    const double prod_re = re_0 * re_1 + im_0 * im_1;
+                    const double prod_im = im_0 * re_1 - re_0 * im_1;
+                    partial_sum[element] +=
+                        prod_re * phase.real() - prod_im * phase.imag();
+                }
+            }
+        }
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    batch_reduce_partial_sum(
+        partial_sum_list, thread_count, batch_size, expectation_list);
+    free(partial_sum_list);
+}
@@ -0,0 +1,16 @@
+/*
+ Statistics of batches of state vectors. See update_ops_batch.hpp for the
+ memory layout. Each function writes batch_size values to its output list.
+ */
+
+#pragma once
+
+#include "type.hpp"
+
+DllExport void batch_state_norm_squared(
+    const CTYPE* state, ITYPE dim, UINT batch_size, double* norm_list);
+
+DllExport void batch_expectation_value_multi_qubit_Pauli_operator_partial_list(
+    const UINT* target_qubit_index_list, const UINT* Pauli_operator_type_list,
+    UINT target_qubit_index_count, const CTYPE* state, ITYPE dim,
+    UINT batch_size, double* expectation_list);
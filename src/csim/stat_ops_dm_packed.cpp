@@ -0,0 +1,154 @@
+#include "stat_ops_dm_packed.hpp"
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "constant.hpp"
+#include "update_ops_dm_packed.hpp"
+#include "utility.hpp"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// calculate norm
+double packed_dm_state_norm_squared(const double* state, ITYPE dim) {
+    ITYPE index;
+    double norm = 0;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel for reduction(+ : norm)
+#endif
+    for (index = 0; index < dim; ++index) {
+        norm += state[index * dim + index];
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    return norm;
+}
+
+// calculate entropy of probability distribution of Z-basis measurements
+double packed_dm_measurement_distribution_entropy(
+    const double* state, ITYPE dim) {
+    ITYPE index;
+    double ent = 0;
+    const double eps = 1e-15;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel for reduction(+ : ent)
+#endif
+    for (index = 0; index < dim; ++index) {
+        double prob = state[index * dim + index];
+        if (prob > eps) {
+            ent += -1.0 * prob * log(prob);
+        }
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    return ent;
+}
+
+double packed_dm_marginal_prob(const UINT* sorted_target_qubit_index_list,
+    const UINT* measured_value_list, UINT target_qubit_index_count,
+    const double* state, ITYPE dim) {
+    ITYPE loop_dim = dim >> target_qubit_index_count;
+    ITYPE state_index;
+    double sum = 0.;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel for reduction(+ : sum)
+#endif
+    for (state_index = 0; state_index < loop_dim; ++state_index) {
+        ITYPE basis = state_index;
+        for (UINT cursor = 0; cursor < target_qubit_index_count; cursor++) {
+            UINT insert_index = sorted_target_qubit_index_list[cursor];
+            ITYPE mask = 1ULL << insert_index;
+            basis = insert_zero_to_basis_index(basis, mask, insert_index);
+            basis ^= mask * measured_value_list[cursor];
+        }
+        sum += state[basis * dim + basis];
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    return sum;
+}
+
+double packed_dm_expectation_value_multi_qubit_Pauli_operator_partial_list(
+    const UINT* target_qubit_index_list, const UINT* Pauli_operator_type_list,
+    UINT target_qubit_index_count, const double* state, ITYPE dim) {
+    ITYPE bit_flip_mask = 0;
+    ITYPE phase_flip_mask = 0;
+    UINT global_phase_90rot_count = 0;
+    UINT pivot_qubit_index = 0;
+    get_Pauli_masks_partial_list(target_qubit_index_list,
+        Pauli_operator_type_list, target_qubit_index_count, &bit_flip_mask,
+        &phase_flip_mask, &global_phase_90rot_count, &pivot_qubit_index);
+
+    // Tr(rho P) = i^{#Y} sum_s (-1)^{|s & phase_flip_mask|} rho[s][s ^ bit]
+    ITYPE state_index;
+    double sum_real = 0.;
+    double sum_imag = 0.;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel for reduction(+ : sum_real, sum_imag)
+#endif
+    for (state_index = 0; state_index < dim; ++state_index) {
+        const CTYPE value = packed_dm_get_element(
+            state, dim, state_index, state_index ^ bit_flip_mask);
+        const double sign =
+            1. - 2. * count_population_parity(state_index & phase_flip_mask);
+        sum_real += sign * _creal(value);
+        sum_imag += sign * _cimag(value);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    return _creal(PHASE_90ROT[global_phase_90rot_count % 4] *
+                  CTYPE(sum_real, sum_imag));
+}
+
+void packed_dm_state_partial_trace(const UINT* target, UINT target_count,
+    const double* state_src, double* state_dst, ITYPE dim) {
+    const ITYPE dst_dim = dim >> target_count;
+    const ITYPE trace_dim = 1ULL << target_count;
+    const ITYPE* matrix_mask_list =
+        create_matrix_mask_list(target, target_count);
+    const UINT* sorted_insert_index_list =
+        create_sorted_ui_list(target, target_count);
+
+    ITYPE index_y;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (index_y = 0; index_y < dst_dim; ++index_y) {
+        ITYPE basis_0_y = index_y;
+        for (UINT cursor = 0; cursor < target_count; cursor++) {
+            UINT insert_index = sorted_insert_index_list[cursor];
+            basis_0_y = insert_zero_to_basis_index(
+                basis_0_y, 1ULL << insert_index, insert_index);
+        }
+        for (ITYPE index_x = index_y; index_x < dst_dim; ++index_x) {
+            ITYPE basis_0_x = index_x;
+            for (UINT cursor = 0; cursor < target_count; cursor++) {
+                UINT insert_index = sorted_insert_index_list[cursor];
+                basis_0_x = insert_zero_to_basis_index(
+                    basis_0_x, 1ULL << insert_index, insert_index);
+            }
+            CTYPE sum = 0;
+            for (ITYPE t = 0; t < trace_dim; ++t) {
+                sum += packed_dm_get_element(state_src, dim,
+                    basis_0_y ^ matrix_mask_list[t],
+                    basis_0_x ^ matrix_mask_list[t]);
+            }
+            packed_dm_set_element(state_dst, dst_dim, index_y, index_x, sum);
+        }
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    free((UINT*)sorted_insert_index_list);
+    free((ITYPE*)matrix_mask_list);
+}
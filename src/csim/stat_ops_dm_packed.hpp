@@ -0,0 +1,26 @@
+/*
+ Statistics of Hermitian-packed density matrices. See update_ops_dm_packed.hpp
+ for the memory layout.
+ */
+
+#pragma once
+
+#include "type.hpp"
+
+DllExport double packed_dm_state_norm_squared(const double* state, ITYPE dim);
+DllExport double packed_dm_measurement_distribution_entropy(
+    const double* state, ITYPE dim);
+DllExport double packed_dm_marginal_prob(
+    const UINT* sorted_target_qubit_index_list, const UINT* measured_value_list,
+    UINT target_qubit_index_count, const double* state, ITYPE dim);
+
+DllExport double packed_dm_expectation_value_multi_qubit_Pauli_operator_partial_list(
+    const UINT* target_qubit_index_list, const UINT* Pauli_operator_type_list,
+    UINT target_qubit_index_count, const double* state, ITYPE dim);
+
+/**
+ * Trace out the target qubits. state_dst is a Hermitian-packed density matrix
+ * of dimension dim >> target_count.
+ */
+DllExport void packed_dm_state_partial_trace(const UINT* target,
+    UINT target_count, const double* state_src, double* state_dst, ITYPE dim);
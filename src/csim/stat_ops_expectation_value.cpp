@@ -4,6 +4,7 @@
 #include <string.h>
 
 #include "MPIutil.hpp"
+#include "simd_dispatch.hpp"
 #include "stat_ops.hpp"
 #include "utility.hpp"
 
@@ -291,46 +292,19 @@ double expectation_value_Z_Pauli_operator_sve(
 // calculate expectation value for single-qubit pauli operator
 double expectation_value_single_qubit_Pauli_operator(UINT target_qubit_index,
     UINT Pauli_operator_type, const CTYPE* state, ITYPE dim) {
-#ifdef _USE_SVE
-    // # of complex128 numbers in an SVE register
-    ITYPE VL = svcntd() / 2;
-#endif
+    const KernelTable& kernels = SIMDutil::get_inst().get_kernel_table();
 
     if (Pauli_operator_type == 0) {
         return state_norm_squared(state, dim);
     } else if (Pauli_operator_type == 1) {
-#ifdef _USE_SVE
-        if (dim > VL) {
-            return expectation_value_X_Pauli_operator_sve(
-                target_qubit_index, state, dim);
-        } else
-#endif
-        {
-            return expectation_value_X_Pauli_operator(
-                target_qubit_index, state, dim);
-        }
+        return kernels.expectation_value_X_Pauli_operator(
+            target_qubit_index, state, dim);
     } else if (Pauli_operator_type == 2) {
-#ifdef _USE_SVE
-        if (dim > VL) {
-            return expectation_value_Y_Pauli_operator_sve(
-                target_qubit_index, state, dim);
-        } else
-#endif
-        {
-            return expectation_value_Y_Pauli_operator(
-                target_qubit_index, state, dim);
-        }
+        return kernels.expectation_value_Y_Pauli_operator(
+            target_qubit_index, state, dim);
     } else if (Pauli_operator_type == 3) {
-#ifdef _USE_SVE
-        if (dim >= VL) {
-            return expectation_value_Z_Pauli_operator_sve(
-                target_qubit_index, state, dim);
-        } else
-#endif
-        {
-            return expectation_value_Z_Pauli_operator(
-                target_qubit_index, state, dim);
-        }
+        return kernels.expectation_value_Z_Pauli_operator(
+            target_qubit_index, state, dim);
     } else {
         fprintf(
             stderr, "invalid expectation value of pauli operator is called");
@@ -547,35 +521,15 @@ double expectation_value_multi_qubit_Pauli_operator_partial_list(
 #ifdef _OPENMP
     OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
 #endif
-#ifdef _USE_SVE
-    // # of complex128 numbers in an SVE register
-    ITYPE VL = svcntd() / 2;
-#endif
+    const KernelTable& kernels = SIMDutil::get_inst().get_kernel_table();
 
     if (bit_flip_mask == 0) {
-#ifdef _USE_SVE
-        if (dim > VL) {
-            result = expectation_value_multi_qubit_Pauli_operator_Z_mask_sve(
-                phase_flip_mask, state, dim);
-        } else
-#endif
-        {
-            result = expectation_value_multi_qubit_Pauli_operator_Z_mask(
-                phase_flip_mask, state, dim);
-        }
+        result = kernels.expectation_value_multi_qubit_Pauli_operator_Z_mask(
+            phase_flip_mask, state, dim);
     } else {
-#ifdef _USE_SVE
-        if (dim > VL) {
-            result = expectation_value_multi_qubit_Pauli_operator_XZ_mask_sve(
-                bit_flip_mask, phase_flip_mask, global_phase_90rot_count,
-                pivot_qubit_index, state, dim);
-        } else
-#endif
-        {
-            result = expectation_value_multi_qubit_Pauli_operator_XZ_mask(
-                bit_flip_mask, phase_flip_mask, global_phase_90rot_count,
-                pivot_qubit_index, state, dim);
-        }
+        result = kernels.expectation_value_multi_qubit_Pauli_operator_XZ_mask(
+            bit_flip_mask, phase_flip_mask, global_phase_90rot_count,
+            pivot_qubit_index, state, dim);
     }
 #ifdef _OPENMP
     OMPutil::get_inst().reset_qulacs_num_threads();
@@ -598,35 +552,15 @@ double expectation_value_multi_qubit_Pauli_operator_whole_list(
 #ifdef _OPENMP
     OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
 #endif
-#ifdef _USE_SVE
-    // # of complex128 numbers in an SVE register
-    ITYPE VL = svcntd() / 2;
-#endif
+    const KernelTable& kernels = SIMDutil::get_inst().get_kernel_table();
 
     if (bit_flip_mask == 0) {
-#ifdef _USE_SVE
-        if (dim > VL) {
-            result = expectation_value_multi_qubit_Pauli_operator_Z_mask_sve(
-                phase_flip_mask, state, dim);
-        } else
-#endif
-        {
-            result = expectation_value_multi_qubit_Pauli_operator_Z_mask(
-                phase_flip_mask, state, dim);
-        }
+        result = kernels.expectation_value_multi_qubit_Pauli_operator_Z_mask(
+            phase_flip_mask, state, dim);
     } else {
-#ifdef _USE_SVE
-        if (dim > VL) {
-            result = expectation_value_multi_qubit_Pauli_operator_XZ_mask_sve(
-                bit_flip_mask, phase_flip_mask, global_phase_90rot_count,
-                pivot_qubit_index, state, dim);
-        } else
-#endif
-        {
-            result = expectation_value_multi_qubit_Pauli_operator_XZ_mask(
-                bit_flip_mask, phase_flip_mask, global_phase_90rot_count,
-                pivot_qubit_index, state, dim);
-        }
+        result = kernels.expectation_value_multi_qubit_Pauli_operator_XZ_mask(
+            bit_flip_mask, phase_flip_mask, global_phase_90rot_count,
+            pivot_qubit_index, state, dim);
     }
 #ifdef _OPENMP
     OMPutil::get_inst().reset_qulacs_num_threads();
@@ -659,35 +593,15 @@ double expectation_value_multi_qubit_Pauli_operator_partial_list_single_thread(
     OMPutil::get_inst().set_qulacs_num_threads(1, 1);  // set num_thread=1
 #endif
 
-#ifdef _USE_SVE
-    // # of complex128 numbers in an SVE register
-    ITYPE VL = svcntd() / 2;
-#endif
+    const KernelTable& kernels = SIMDutil::get_inst().get_kernel_table();
 
     if (bit_flip_mask == 0) {
-#ifdef _USE_SVE
-        if (dim > VL) {
-            result = expectation_value_multi_qubit_Pauli_operator_Z_mask_sve(
-                phase_flip_mask, state, dim);
-        } else
-#endif
-        {
-            result = expectation_value_multi_qubit_Pauli_operator_Z_mask(
-                phase_flip_mask, state, dim);
-        }
+        result = kernels.expectation_value_multi_qubit_Pauli_operator_Z_mask(
+            phase_flip_mask, state, dim);
     } else {
-#ifdef _USE_SVE
-        if (dim > VL) {
-            result = expectation_value_multi_qubit_Pauli_operator_XZ_mask_sve(
-                bit_flip_mask, phase_flip_mask, global_phase_90rot_count,
-                pivot_qubit_index, state, dim);
-        } else
-#endif
-        {
-            result = expectation_value_multi_qubit_Pauli_operator_XZ_mask(
-                bit_flip_mask, phase_flip_mask, global_phase_90rot_count,
-                pivot_qubit_index, state, dim);
-        }
+        result = kernels.expectation_value_multi_qubit_Pauli_operator_XZ_mask(
+            bit_flip_mask, phase_flip_mask, global_phase_90rot_count,
+            pivot_qubit_index, state, dim);
     }
 #ifdef _OPENMP
     OMPutil::get_inst().reset_qulacs_num_threads();
@@ -824,3 +738,176 @@ double expectation_value_multi_qubit_Pauli_operator_Z_mask_mpi(
     return sum;
 }
 #endif
+
+// Expectation values of several Pauli operators with a common bit flip mask.
+// Each pair of amplitudes is read once: state[basis_0] * conj(state[basis_1])
+// is computed per pair and added to every term with the sign given by the
+// parity of basis_0 & phase_flip_mask_list[term]. Each thread accumulates
+// into its own buffer, so that threads do not share cache lines, and copies
+// it once into its row of partial sums, which are added in the order of the
+// thread number.
+void expectation_value_multi_qubit_Pauli_operator_group_XZ_mask(
+    ITYPE bit_flip_mask, const ITYPE* phase_flip_mask_list,
+    const UINT* global_phase_90rot_count_list, UINT term_count,
+    const CTYPE* state, ITYPE dim, double* result) {
+    if (term_count == 0) return;
+    UINT pivot_qubit_index = 0;
+    while (bit_flip_mask != 0 && !((bit_flip_mask >> pivot_qubit_index) & 1)) {
+        ++pivot_qubit_index;
+    }
+    const ITYPE pivot_mask = 1ULL << pivot_qubit_index;
+    const ITYPE loop_dim = (bit_flip_mask == 0) ? dim : dim / 2;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+    const UINT thread_count = omp_get_max_threads();
+#else
+    const UINT thread_count = 1;
+#endif
+    // real parts followed by imaginary parts of
+    // sum_{basis_0} sign * state[basis_0] * conj(state[basis_1])
+    const UINT row_size = 2 * term_count;
+    double* partial_sum_list =
+        (double*)calloc((size_t)thread_count * row_size, sizeof(double));
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+#ifdef _OPENMP
+        double* partial_row =
+            partial_sum_list + row_size * omp_get_thread_num();
+#else
+        double* partial_row = partial_sum_list;
+#endif
+        double* partial_re = (double*)calloc(row_size, sizeof(double));
+        double* partial_im = partial_re + term_count;
+        ITYPE state_index;
+        if (bit_flip_mask == 0) {
+#ifdef _OPENMP
+#pragma omp for
+#endif
+            for (state_index = 0; state_index < loop_dim; ++state_index) {
+                const double re = _creal(state[state_index]);
+                const double im = _cimag(state[state_index]);
+                const double prob = re * re + im * im;
+                for (UINT term = 0; term < term_count; ++term) {
+                    const double sign =
+                        1. - 2. * count_population_parity(
+                                      state_index & phase_flip_mask_list[term]);
+                    partial_re[term] += sign * prob;
+                }
+            }
+        } else {
+#ifdef _OPENMP
+#pragma omp for
+#endif
+            for (state_index = 0; state_index < loop_dim; ++state_index) {
+                const ITYPE basis_0 = insert_zero_to_basis_index(
+                    state_index, pivot_mask, pivot_qubit_index);
+                const ITYPE basis_1 = basis_0 ^ bit_flip_mask;
+                const double re_0 = _creal(state[basis_0]);
+                const double im_0 = _cimag(state[basis_0]);
+                const double re_1 = _creal(state[basis_1]);
+                const double im_1 = _cimag(state[basis_1]);
+                const double re = re_0 * re_1 + im_0 * im_1;
+                const double im = im_0 * re_1 - re_0 * im_1;
+                for (UINT term = 0; term < term_count; ++term) {
+                    const double sign =
+                        1. - 2. * count_population_parity(
+                                      basis_0 & phase_flip_mask_list[term]);
+                    partial_re[term] += sign * re;
+                    partial_im[term] += sign * im;
+                }
+            }
+        }
+        memcpy(partial_row, partial_re, sizeof(double) * row_size);
+        free(partial_re);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    for (UINT term = 0; term < term_count; ++term) {
+        double re = 0.;
+        double im = 0.;
+        for (UINT thread = 0; thread < thread_count; ++thread) {
+            re += partial_sum_list[thread * row_size + term];
+            im += partial_sum_list[thread * row_size + term_count + term];
+        }
+        if (bit_flip_mask == 0) {
+            result[term] = re;
+            continue;
+        }
+        // real part of 2 * i^{global_phase_90rot_count} * (re + i im)
+        switch (global_phase_90rot_count_list[term] % 4) {
+            case 0:
+                result[term] = 2. * re;
+                break;
+            case 1:
+                result[term] = -2. * im;
+                break;
+            case 2:
+                result[term] = -2. * re;
+                break;
+            default:
+                result[term] = 2. * im;
+                break;
+        }
+    }
+    free(partial_sum_list);
+}
+
+void Pauli_operator_Z_mask_diagonal(const ITYPE* phase_flip_mask_list,
+    const CTYPE* coef_list, UINT term_count, CTYPE* diagonal, ITYPE dim) {
+    // diagonal[basis] = sum_term coef * (-1)^{popcount(basis & mask)} is the
+    // Walsh-Hadamard transform of the coefficients placed at their masks
+    ITYPE index;
+    for (index = 0; index < dim; ++index) diagonal[index] = 0.;
+    for (UINT term = 0; term < term_count; ++term) {
+        diagonal[phase_flip_mask_list[term] & (dim - 1)] += coef_list[term];
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
+#endif
+    for (ITYPE half = 1; half < dim; half <<= 1) {
+        const ITYPE mask_low = half - 1;
+        const ITYPE mask_high = ~mask_low;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (index = 0; index < dim / 2; ++index) {
+            const ITYPE basis_0 = (index & mask_low) + ((index & mask_high) << 1);
+            const ITYPE basis_1 = basis_0 + half;
+            const double re_0 = _creal(diagonal[basis_0]);
+            const double im_0 = _cimag(diagonal[basis_0]);
+            const double re_1 = _creal(diagonal[basis_1]);
+            const double im_1 = _cimag(diagonal[basis_1]);
+            diagonal[basis_0] = CTYPE(re_0 + re_1, im_0 + im_1);
+            diagonal[basis_1] = CTYPE(re_0 - re_1, im_0 - im_1);
+        }
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+CTYPE expectation_value_diagonal_operator(const CTYPE* diagonal,
+    ITYPE diagonal_dim, const CTYPE* state, ITYPE dim) {
+    const ITYPE diagonal_mask = diagonal_dim - 1;
+    double sum_re = 0.;
+    double sum_im = 0.;
+    ITYPE state_index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel for reduction(+ : sum_re, sum_im)
+#endif
+    for (state_index = 0; state_index < dim; ++state_index) {
+        const double re = _creal(state[state_index]);
+        const double im = _cimag(state[state_index]);
+        const double prob = re * re + im * im;
+        sum_re += prob * _creal(diagonal[state_index & diagonal_mask]);
+        sum_im += prob * _cimag(diagonal[state_index & diagonal_mask]);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    return CTYPE(sum_re, sum_im);
+}
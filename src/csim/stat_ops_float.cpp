@@ -0,0 +1,190 @@
+#include "stat_ops_float.hpp"
+
+#include <math.h>
+
+#include "constant.hpp"
+#include "utility.hpp"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// squared absolute value of an amplitude in double precision
+inline static double float_norm(const CTYPE_F& value) {
+    const double re = value.real();
+    const double im = value.imag();
+    return re * re + im * im;
+}
+
+double float_state_norm_squared(const CTYPE_F* state, ITYPE dim) {
+    ITYPE index;
+    double norm = 0;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 15);
+#pragma omp parallel for reduction(+ : norm)
+#endif
+    for (index = 0; index < dim; ++index) {
+        norm += float_norm(state[index]);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    return norm;
+}
+
+double float_measurement_distribution_entropy(const CTYPE_F* state, ITYPE dim) {
+    ITYPE index;
+    double ent = 0;
+    const double eps = 1e-15;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel for reduction(+ : ent)
+#endif
+    for (index = 0; index < dim; ++index) {
+        double prob = float_norm(state[index]);
+        prob = (prob > eps) ? prob : eps;
+        ent += -1.0 * prob * log(prob);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    return ent;
+}
+
+CTYPE float_state_inner_product(
+    const CTYPE_F* bra, const CTYPE_F* ket, ITYPE dim) {
+    double real_sum = 0.;
+    double imag_sum = 0.;
+    ITYPE index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 15);
+#pragma omp parallel for reduction(+ : real_sum, imag_sum)
+#endif
+    for (index = 0; index < dim; ++index) {
+        const double bra_re = bra[index].real(), bra_im = bra[index].imag();
+        const double ket_re = ket[index].real(), ket_im = ket[index].imag();
+        real_sum += bra_re * ket_re + bra_im * ket_im;
+        imag_sum += bra_re * ket_im - bra_im * ket_re;
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    return CTYPE(real_sum, imag_sum);
+}
+
+double float_M0_prob(UINT target_qubit_index, const CTYPE_F* state, ITYPE dim) {
+    const ITYPE loop_dim = dim / 2;
+    const ITYPE mask = 1ULL << target_qubit_index;
+    ITYPE state_index;
+    double sum = 0.;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel for reduction(+ : sum)
+#endif
+    for (state_index = 0; state_index < loop_dim; ++state_index) {
+        ITYPE basis_0 =
+            insert_zero_to_basis_index(state_index, mask, target_qubit_index);
+        sum += float_norm(state[basis_0]);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    return sum;
+}
+
+double float_marginal_prob(const UINT* sorted_target_qubit_index_list,
+    const UINT* measured_value_list, UINT target_qubit_index_count,
+    const CTYPE_F* state, ITYPE dim) {
+    ITYPE loop_dim = dim >> target_qubit_index_count;
+    ITYPE state_index;
+    double sum = 0.;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel for reduction(+ : sum)
+#endif
+    for (state_index = 0; state_index < loop_dim; ++state_index) {
+        ITYPE basis = state_index;
+        for (UINT cursor = 0; cursor < target_qubit_index_count; cursor++) {
+            UINT insert_index = sorted_target_qubit_index_list[cursor];
+            ITYPE mask = 1ULL << insert_index;
+            basis = insert_zero_to_basis_index(basis, mask, insert_index);
+            basis ^= mask * measured_value_list[cursor];
+        }
+        sum += float_norm(state[basis]);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    return sum;
+}
+
+static double float_expectation_value_multi_qubit_Pauli_operator_XZ_mask(
+    ITYPE bit_flip_mask, ITYPE phase_flip_mask, UINT global_phase_90rot_count,
+    UINT pivot_qubit_index, const CTYPE_F* state, ITYPE dim) {
+    const ITYPE loop_dim = dim / 2;
+    const ITYPE pivot_mask = 1ULL << pivot_qubit_index;
+    ITYPE state_index;
+    double sum = 0.;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+ : sum)
+#endif
+    for (state_index = 0; state_index < loop_dim; ++state_index) {
+        ITYPE basis_0 = insert_zero_to_basis_index(
+            state_index, pivot_mask, pivot_qubit_index);
+        ITYPE basis_1 = basis_0 ^ bit_flip_mask;
+        UINT sign_0 = count_population(basis_0 & phase_flip_mask) % 2;
+
+        // real part of state[basis_0] * conj(state[basis_1]) * i^rot * 2
+        const double re_0 = state[basis_0].real(), im_0 = state[basis_0].imag();
+        const double re_1 = state[basis_1].real(), im_1 = state[basis_1].imag();
+        const double prod_re = re_0 * re_1 + im_0 * im_1;
+        const double prod_im = im_0 * re_1 - re_0 * im_1;
+        const CTYPE phase =
+            PHASE_90ROT[(global_phase_90rot_count + sign_0 * 2) % 4];
+        sum += 2.0 * (prod_re * phase.real() - prod_im * phase.imag());
+    }
+    return sum;
+}
+
+static double float_expectation_value_multi_qubit_Pauli_operator_Z_mask(
+    ITYPE phase_flip_mask, const CTYPE_F* state, ITYPE dim) {
+    const ITYPE loop_dim = dim;
+    ITYPE state_index;
+    double sum = 0.;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+ : sum)
+#endif
+    for (state_index = 0; state_index < loop_dim; ++state_index) {
+        int bit_parity = count_population(state_index & phase_flip_mask) % 2;
+        int sign = 1 - 2 * bit_parity;
+        sum += float_norm(state[state_index]) * sign;
+    }
+    return sum;
+}
+
+double float_expectation_value_multi_qubit_Pauli_operator_partial_list(
+    const UINT* target_qubit_index_list, const UINT* Pauli_operator_type_list,
+    UINT target_qubit_index_count, const CTYPE_F* state, ITYPE dim) {
+    ITYPE bit_flip_mask = 0;
+    ITYPE phase_flip_mask = 0;
+    UINT global_phase_90rot_count = 0;
+    UINT pivot_qubit_index = 0;
+    get_Pauli_masks_partial_list(target_qubit_index_list,
+        Pauli_operator_type_list, target_qubit_index_count, &bit_flip_mask,
+        &phase_flip_mask, &global_phase_90rot_count, &pivot_qubit_index);
+    double result;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#endif
+    if (bit_flip_mask == 0) {
+        result = float_expectation_value_multi_qubit_Pauli_operator_Z_mask(
+            phase_flip_mask, state, dim);
+    } else {
+        result = float_expectation_value_multi_qubit_Pauli_operator_XZ_mask(
+            bit_flip_mask, phase_flip_mask, global_phase_90rot_count,
+            pivot_qubit_index, state, dim);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    return result;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "type.hpp"
+
+// All the statistics of single precision states are accumulated in double
+// precision.
+DllExport double float_state_norm_squared(const CTYPE_F* state, ITYPE dim);
+DllExport double float_measurement_distribution_entropy(
+    const CTYPE_F* state, ITYPE dim);
+DllExport CTYPE float_state_inner_product(
+    const CTYPE_F* bra, const CTYPE_F* ket, ITYPE dim);
+
+DllExport double float_M0_prob(
+    UINT target_qubit_index, const CTYPE_F* state, ITYPE dim);
+DllExport double float_marginal_prob(const UINT* sorted_target_qubit_index_list,
+    const UINT* measured_value_list, UINT target_qubit_index_count,
+    const CTYPE_F* state, ITYPE dim);
+
+/**
+ * Sample basis indices with the probability |state[index]|^2 / norm.
+ *
+ * The same as state_sampling. The probabilities are normalized by their sum,
+ * so a state whose norm is slightly off from 1 is sampled in range.
+ */
+DllExport void float_state_sampling(const CTYPE_F* state, ITYPE dim,
+    const double* uniform_list, UINT sampling_count, ITYPE* result);
+
+DllExport double float_expectation_value_multi_qubit_Pauli_operator_partial_list(
+    const UINT* target_qubit_index_list, const UINT* Pauli_operator_type_list,
+    UINT target_qubit_index_count, const CTYPE_F* state, ITYPE dim);
@@ -50,6 +50,40 @@ double M1_prob(UINT target_qubit_index, const CTYPE* state, ITYPE dim) {
     return sum;
 }
 
+// calculate the reduced density matrix of target qubit
+void single_qubit_reduced_density_matrix(UINT target_qubit_index,
+    const CTYPE* state, ITYPE dim, CTYPE reduced_matrix[4]) {
+    const ITYPE loop_dim = dim / 2;
+    const ITYPE mask = 1ULL << target_qubit_index;
+    ITYPE state_index;
+    double sum_00 = 0., sum_11 = 0., sum_01_real = 0., sum_01_imag = 0.;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel for reduction(+ : sum_00, sum_11, sum_01_real, sum_01_imag)
+#endif
+    for (state_index = 0; state_index < loop_dim; ++state_index) {
+        ITYPE basis_0 =
+            insert_zero_to_basis_index(state_index, mask, target_qubit_index);
+        ITYPE basis_1 = basis_0 ^ mask;
+        const double re0 = _creal(state[basis_0]);
+        const double im0 = _cimag(state[basis_0]);
+        const double re1 = _creal(state[basis_1]);
+        const double im1 = _cimag(state[basis_1]);
+        sum_00 += re0 * re0 + im0 * im0;
+        sum_11 += re1 * re1 + im1 * im1;
+        // state[basis_0] * conj(state[basis_1])
+        sum_01_real += re0 * re1 + im0 * im1;
+        sum_01_imag += im0 * re1 - re0 * im1;
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    reduced_matrix[0] = sum_00;
+    reduced_matrix[1] = sum_01_real + 1.i * sum_01_imag;
+    reduced_matrix[2] = sum_01_real - 1.i * sum_01_imag;
+    reduced_matrix[3] = sum_11;
+}
+
 // calculate merginal probability with which we obtain the set of values
 // measured_value_list at sorted_target_qubit_index_list warning:
 // sorted_target_qubit_index_list must be sorted.
@@ -0,0 +1,218 @@
+#include <stdlib.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "stat_ops.hpp"
+#include "stat_ops_float.hpp"
+#include "utility.hpp"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Number of amplitudes summed into one entry of the block prefix sum. Only
+// dim / SAMPLING_BLOCK_DIM partial sums are kept instead of a prefix sum of
+// the whole distribution.
+static const ITYPE SAMPLING_BLOCK_DIM = 1ULL << 12;
+
+// squared absolute value of an amplitude in double precision
+inline static double sampling_prob(const CTYPE& value) {
+    const double re = _creal(value);
+    const double im = _cimag(value);
+    return re * re + im * im;
+}
+
+inline static double sampling_prob(const CTYPE_F& value) {
+    const double re = value.real();
+    const double im = value.imag();
+    return re * re + im * im;
+}
+
+// Resolve the shots which fall into one block. shot_list holds pairs of
+// (scaled uniform value, shot index) and is sorted here, so the amplitudes
+// of the block are read once in order.
+template <typename StateType>
+static void sampling_resolve_block(const StateType* state, ITYPE block_begin,
+    ITYPE block_dim, double block_offset,
+    std::vector<std::pair<double, UINT>>& shot_list, ITYPE* result) {
+    std::sort(shot_list.begin(), shot_list.end());
+    double cumulative = block_offset;
+    ITYPE index = block_begin;
+    const ITYPE block_end = block_begin + block_dim;
+    ITYPE last_nonzero_index = block_begin;
+    for (auto& shot : shot_list) {
+        // advance while the shot lies beyond the amplitude at index
+        while (index < block_end) {
+            const double prob = sampling_prob(state[index]);
+            if (prob > 0) {
+                last_nonzero_index = index;
+                if (shot.first < cumulative + prob) break;
+            }
+            cumulative += prob;
+            ++index;
+        }
+        // rounding differences with the block sum are given to the last
+        // amplitude with non-zero probability
+        result[shot.second] = (index < block_end) ? index : last_nonzero_index;
+    }
+}
+
+// The cumulative probabilities are accumulated in double precision for both
+// state types.
+template <typename StateType>
+static void state_sampling_impl(const StateType* state, ITYPE dim,
+    const double* uniform_list, UINT sampling_count, ITYPE* result) {
+    const ITYPE block_dim =
+        (dim < SAMPLING_BLOCK_DIM) ? dim : SAMPLING_BLOCK_DIM;
+    const ITYPE block_count = dim / block_dim;
+
+    // block_prefix[block] is the probability of the blocks before block
+    double* block_prefix = (double*)malloc(sizeof(double) * (block_count + 1));
+    ITYPE block;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
+#pragma omp parallel for
+#endif
+    for (block = 0; block < block_count; ++block) {
+        const StateType* block_state = state + block * block_dim;
+        double sum = 0.;
+        for (ITYPE index = 0; index < block_dim; ++index) {
+            sum += sampling_prob(block_state[index]);
+        }
+        block_prefix[block + 1] = sum;
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    block_prefix[0] = 0.;
+    ITYPE last_nonzero_block = 0;
+    for (block = 0; block < block_count; ++block) {
+        if (block_prefix[block + 1] > 0) last_nonzero_block = block;
+        block_prefix[block + 1] += block_prefix[block];
+    }
+    const double total = block_prefix[block_count];
+
+    // find the block of each shot
+    ITYPE* shot_block = (ITYPE*)malloc(sizeof(ITYPE) * sampling_count);
+    UINT shot;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(sampling_count, 13);
+#pragma omp parallel for
+#endif
+    for (shot = 0; shot < sampling_count; ++shot) {
+        const double r = uniform_list[shot] * total;
+        ITYPE found =
+            (ITYPE)(std::upper_bound(
+                        block_prefix, block_prefix + block_count + 1, r) -
+                    block_prefix) -
+            1;
+        shot_block[shot] = std::min(found, last_nonzero_block);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+
+    // counting sort of the shots by block
+    ITYPE* block_begin = (ITYPE*)calloc(block_count + 1, sizeof(ITYPE));
+    for (shot = 0; shot < sampling_count; ++shot) {
+        ++block_begin[shot_block[shot] + 1];
+    }
+    for (block = 0; block < block_count; ++block) {
+        block_begin[block + 1] += block_begin[block];
+    }
+    UINT* sorted_shot = (UINT*)malloc(sizeof(UINT) * sampling_count);
+    {
+        ITYPE* cursor = (ITYPE*)malloc(sizeof(ITYPE) * block_count);
+        for (block = 0; block < block_count; ++block) {
+            cursor[block] = block_begin[block];
+        }
+        for (shot = 0; shot < sampling_count; ++shot) {
+            sorted_shot[cursor[shot_block[shot]]++] = shot;
+        }
+        free(cursor);
+    }
+    free(shot_block);
+
+    // resolve the shots of each block in one streaming pass
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
+#pragma omp parallel
+#endif
+    {
+        std::vector<std::pair<double, UINT>> shot_list;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 16)
+#endif
+        for (block = 0; block < block_count; ++block) {
+            const ITYPE shot_count = block_begin[block + 1] - block_begin[block];
+            if (shot_count == 0 || shot_count > block_dim) continue;
+            shot_list.clear();
+            for (ITYPE pos = block_begin[block]; pos < block_begin[block + 1];
+                 ++pos) {
+                const UINT block_shot = sorted_shot[pos];
+                shot_list.push_back(std::make_pair(
+                    uniform_list[block_shot] * total, block_shot));
+            }
+            sampling_resolve_block(state, block * block_dim, block_dim,
+                block_prefix[block], shot_list, result);
+        }
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+
+    // Blocks with more shots than amplitudes, e.g. a peaked distribution,
+    // keep a cumulative sum of the block and split their shots over threads.
+    double* block_cumulative = NULL;
+    for (block = 0; block < block_count; ++block) {
+        const ITYPE shot_count = block_begin[block + 1] - block_begin[block];
+        if (shot_count <= block_dim) continue;
+        if (block_cumulative == NULL) {
+            block_cumulative = (double*)malloc(sizeof(double) * block_dim);
+        }
+        const StateType* block_state = state + block * block_dim;
+        double cumulative = block_prefix[block];
+        ITYPE last_nonzero_index = 0;
+        for (ITYPE index = 0; index < block_dim; ++index) {
+            const double prob = sampling_prob(block_state[index]);
+            if (prob > 0) last_nonzero_index = index;
+            cumulative += prob;
+            block_cumulative[index] = cumulative;
+        }
+        ITYPE pos;
+#ifdef _OPENMP
+        OMPutil::get_inst().set_qulacs_num_threads(shot_count, 13);
+#pragma omp parallel for
+#endif
+        for (pos = block_begin[block]; pos < block_begin[block + 1]; ++pos) {
+            const UINT block_shot = sorted_shot[pos];
+            const double r = uniform_list[block_shot] * total;
+            const ITYPE found =
+                (ITYPE)(std::upper_bound(block_cumulative,
+                            block_cumulative + block_dim, r) -
+                        block_cumulative);
+            result[block_shot] =
+                block * block_dim +
+                ((found < block_dim) ? found : last_nonzero_index);
+        }
+#ifdef _OPENMP
+        OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    }
+    free(block_cumulative);
+
+    free(sorted_shot);
+    free(block_begin);
+    free(block_prefix);
+}
+
+void state_sampling(const CTYPE* state, ITYPE dim, const double* uniform_list,
+    UINT sampling_count, ITYPE* result) {
+    state_sampling_impl(state, dim, uniform_list, sampling_count, result);
+}
+
+void float_state_sampling(const CTYPE_F* state, ITYPE dim,
+    const double* uniform_list, UINT sampling_count, ITYPE* result) {
+    state_sampling_impl(state, dim, uniform_list, sampling_count, result);
+}
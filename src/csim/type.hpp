@@ -16,6 +16,8 @@ using UINT = unsigned int;
 
 //! complex value
 using CTYPE = std::complex<double>;
+//! single precision complex value for QuantumStateFloat
+using CTYPE_F = std::complex<float>;
 using namespace std::complex_literals;
 inline static double _cabs(CTYPE val) { return std::abs(val); }
 inline static double _creal(CTYPE val) { return std::real(val); }
@@ -30,14 +32,22 @@ using ITYPE = unsigned long long;
 #endif
 
 //! check AVX2 support
-#ifdef _MSC_VER
-// MSVC
-// In MSVC, flag __AVX2__ is not automatically set by default
-#else
-// GCC remove simd flag when AVX2 is not supported
-#ifndef __AVX2__
+// AVX2 kernels are compiled regardless of the flags of the build host and
+// are selected at runtime by SIMDutil (see simd_dispatch.hpp), so only drop
+// the simd flag on non-x86 targets.
+#if !defined(__x86_64__) && !defined(__i386__) && !defined(_M_X64) && \
+    !defined(_M_IX86)
 #undef _USE_SIMD
 #endif
+
+//! mark a function to be compiled for AVX2 / AVX-512 even if the whole
+//! library is not
+#if defined(_USE_SIMD) && !defined(_MSC_VER)
+#define QULACS_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define QULACS_TARGET_AVX512 __attribute__((target("avx512f")))
+#else
+#define QULACS_TARGET_AVX2
+#define QULACS_TARGET_AVX512
 #endif
 
 //! define export command
@@ -488,6 +488,35 @@ void P1_gate_parallel(UINT target_qubit_index, CTYPE* state, ITYPE dim);
 DllExport void P1_gate_mpi(
     UINT target_qubit_index, CTYPE* state, ITYPE dim, UINT inner_qc);
 
+/**
+ * \~english
+ * Measure a qubit and collapse the quantum state.
+ *
+ * The outcome is 0 if random_value is smaller than the probability of 0
+ * relative to the squared norm of the state, and 1 otherwise. The amplitudes
+ * of the other outcome are set to zero and the rest is rescaled so that the
+ * squared norm is kept. The probabilities are computed in one pass over the
+ * state and the collapse is done in a second pass.
+ * @param[in] target_qubit_index index of the qubit
+ * @param[in] random_value uniform random value in [0, 1)
+ * @param[in,out] state quantum state
+ * @param[in] dim dimension
+ * @return measured value
+ *
+ * \~japanese-en
+ * 量子ビットを測定して状態を射影
+ *
+ * 状態のノルムに対する0の確率がrandom_valueより大きければ0、そうでなければ1を測定値とする。
+ * 他方の測定値の振幅を0にし、ノルムが保たれるように残りを規格化する。確率は状態の1回の走査で求め、射影は2回目の走査で行う。
+ * @param[in] target_qubit_index 作用する量子ビットのインデックス
+ * @param[in] random_value [0,1)の一様乱数
+ * @param[in,out] state 量子状態
+ * @param[in] dim 次元
+ * @return 測定値
+ */
+DllExport UINT single_qubit_measurement(
+    UINT target_qubit_index, double random_value, CTYPE* state, ITYPE dim);
+
 /**
  * \~english
  * Normalize the quantum state.
@@ -727,6 +756,8 @@ void single_qubit_dense_matrix_gate_parallel_simd(
     UINT target_qubit_index, const CTYPE matrix[4], CTYPE* state, ITYPE dim);
 void single_qubit_dense_matrix_gate_parallel_sve(
     UINT target_qubit_index, const CTYPE matrix[4], CTYPE* state, ITYPE dim);
+void single_qubit_dense_matrix_gate_parallel_avx512(
+    UINT target_qubit_index, const CTYPE matrix[4], CTYPE* state, ITYPE dim);
 DllExport void single_qubit_dense_matrix_gate_mpi(UINT target_qubit_index,
     const CTYPE matrix[4], CTYPE* state, ITYPE dim, UINT inner_qc);
 
@@ -763,6 +794,8 @@ void single_qubit_diagonal_matrix_gate_parallel_simd(UINT target_qubit_index,
     const CTYPE diagonal_matrix[2], CTYPE* state, ITYPE dim);
 void single_qubit_diagonal_matrix_gate_parallel_sve(UINT target_qubit_index,
     const CTYPE diagonal_matrix[2], CTYPE* state, ITYPE dim);
+void single_qubit_diagonal_matrix_gate_parallel_avx512(UINT target_qubit_index,
+    const CTYPE diagonal_matrix[2], CTYPE* state, ITYPE dim);
 DllExport void single_qubit_diagonal_matrix_gate_mpi(UINT target_qubit_index,
     const CTYPE diagonal_matrix[2], CTYPE* state, ITYPE dim, UINT inner_qc);
 
@@ -796,6 +829,8 @@ void single_qubit_phase_gate_parallel_unroll(
     UINT target_qubit_index, CTYPE phase, CTYPE* state, ITYPE dim);
 void single_qubit_phase_gate_parallel_simd(
     UINT target_qubit_index, CTYPE phase, CTYPE* state, ITYPE dim);
+void single_qubit_phase_gate_parallel_avx512(
+    UINT target_qubit_index, CTYPE phase, CTYPE* state, ITYPE dim);
 DllExport void single_qubit_phase_gate_mpi(UINT target_qubit_index, CTYPE phase,
     CTYPE* state, ITYPE dim, UINT inner_qc);
 
@@ -1007,6 +1042,54 @@ DllExport void multi_qubit_Pauli_gate_partial_list(
 // TODO: multi_qubit_Pauli_gate_partial_list is not implemented for multi-cpu
 // yet
 
+/**
+ * \~english
+ * Apply a linear combination of Pauli operators to the quantum state.
+ *
+ * dst_state = sum_term coef_list[term] P_term state, where the terms are
+ * sorted into groups sharing a bit flip mask. The terms of the group g are
+ * group_begin_list[g], ..., group_begin_list[g + 1] - 1 and their bit flip
+ * mask is bit_flip_mask_list[g]. Each output amplitude is written once, so no
+ * work state is required. state and dst_state must not overlap.
+ *
+ * @param[in] bit_flip_mask_list bit flip mask of each group
+ * @param[in] group_begin_list first term of each group, followed by the
+ * number of terms
+ * @param[in] group_count the number of groups
+ * @param[in] phase_flip_mask_list phase flip mask of each term
+ * @param[in] global_phase_90rot_count_list the number of Y of each term
+ * @param[in] coef_list coefficient of each term
+ * @param[in] state quantum state
+ * @param[out] dst_state result
+ * @param[in] dim dimension
+ *
+ * \~japanese-en
+ * パウリ演算子の線形結合を量子状態に作用させる
+ *
+ * ビット反転マスクが共通の項を組にまとめて与え、結果をdst_stateに書き込む。
+ * 各要素は一度だけ書き込まれるため、作業用の状態は必要ない。
+ *
+ * @param[in] bit_flip_mask_list 各組のビット反転マスク
+ * @param[in] group_begin_list 各組の最初の項の添え字と、最後に項の数
+ * @param[in] group_count 組の数
+ * @param[in] phase_flip_mask_list 各項の位相反転マスク
+ * @param[in] global_phase_90rot_count_list 各項のYの個数
+ * @param[in] coef_list 各項の係数
+ * @param[in] state 量子状態
+ * @param[out] dst_state 結果を格納する状態
+ * @param[in] dim 次元
+ */
+DllExport void multi_qubit_Pauli_operator_sum_XZ_mask(
+    const ITYPE* bit_flip_mask_list, const UINT* group_begin_list,
+    UINT group_count, const ITYPE* phase_flip_mask_list,
+    const UINT* global_phase_90rot_count_list, const CTYPE* coef_list,
+    const CTYPE* state, CTYPE* dst_state, ITYPE dim);
+DllExport void multi_qubit_Pauli_operator_sum_XZ_mask_single_thread(
+    const ITYPE* bit_flip_mask_list, const UINT* group_begin_list,
+    UINT group_count, const ITYPE* phase_flip_mask_list,
+    const UINT* global_phase_90rot_count_list, const CTYPE* coef_list,
+    const CTYPE* state, CTYPE* dst_state, ITYPE dim);
+
 /**
  * \~english
  * Apply multi-qubit Pauli operator to the quantum state with a partial list.
@@ -1275,6 +1358,8 @@ void double_qubit_dense_matrix_gate_simd(UINT target_qubit_index1,
     UINT target_qubit_index2, const CTYPE matrix[16], CTYPE* state, ITYPE dim);
 void double_qubit_dense_matrix_gate_sve(UINT target_qubit_index1,
     UINT target_qubit_index2, const CTYPE matrix[16], CTYPE* state, ITYPE dim);
+void double_qubit_dense_matrix_gate_avx512(UINT target_qubit_index1,
+    UINT target_qubit_index2, const CTYPE matrix[16], CTYPE* state, ITYPE dim);
 DllExport void double_qubit_dense_matrix_gate_mpi(UINT target_qubit_index1,
     UINT target_qubit_index2, const CTYPE matrix[16], CTYPE* state, ITYPE dim,
     UINT inner_qc);
@@ -1326,6 +1411,9 @@ DllExport void multi_qubit_dense_matrix_gate(
 void multi_qubit_dense_matrix_gate_parallel(const UINT* target_qubit_index_list,
     UINT target_qubit_index_count, const CTYPE* matrix, CTYPE* state,
     ITYPE dim);
+void multi_qubit_dense_matrix_gate_parallel_avx512(
+    const UINT* target_qubit_index_list, UINT target_qubit_index_count,
+    const CTYPE* matrix, CTYPE* state, ITYPE dim);
 DllExport void multi_qubit_dense_matrix_gate_mpi(
     const UINT* target_qubit_index_list, UINT target_qubit_index_count,
     const CTYPE* matrix, CTYPE* state, ITYPE dim, UINT inner_qc);
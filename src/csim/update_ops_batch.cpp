@@ -0,0 +1,353 @@
+#include "update_ops_batch.hpp"
+
+#include <math.h>
+#include <stdlib.h>
+
+#include "constant.hpp"
+#include "utility.hpp"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Written out so that the loops over the batch elements are vectorized; the
+// multiplication operator of std::complex checks NaN and infinity.
+inline static CTYPE batch_mul(const CTYPE& a, const CTYPE& b) {
+    return CTYPE(a.real() * b.real() - a.imag() * b.imag(),
+        a.real() * b.imag() + a.imag() * b.real());
+}
+
+void batch_initialize_quantum_state(CTYPE* state, ITYPE dim, UINT batch_size) {
+    const ITYPE total_dim = dim * batch_size;
+    ITYPE index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(total_dim, 15);
+#pragma omp parallel for
+#endif
+    for (index = 0; index < total_dim; ++index) {
+        state[index] = 0;
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    for (UINT element = 0; element < batch_size; ++element) {
+        state[element] = 1.0;
+    }
+}
+
+void batch_normalize(const double* squared_norm_list, CTYPE* state, ITYPE dim,
+    UINT batch_size) {
+    double* normalize_factor = (double*)malloc(sizeof(double) * batch_size);
+    for (UINT element = 0; element < batch_size; ++element) {
+        normalize_factor[element] = 1.0 / sqrt(squared_norm_list[element]);
+    }
+    ITYPE state_index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim * batch_size, 13);
+#pragma omp parallel for
+#endif
+    for (state_index = 0; state_index < dim; ++state_index) {
+        CTYPE* amplitude = state + state_index * batch_size;
+        for (UINT element = 0; element < batch_size; ++element) {
+            amplitude[element] *= normalize_factor[element];
+        }
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    free(normalize_factor);
+}
+
+// Apply a 2x2 matrix to the pair of amplitude rows. X-like matrices, such as
+// the target part of CNOT, only swap the rows.
+inline static void batch_update_amplitude_pair(CTYPE* amplitude_0,
+    CTYPE* amplitude_1, const CTYPE matrix[4], bool is_swap, UINT batch_size) {
+    if (is_swap) {
+        for (UINT element = 0; element < batch_size; ++element) {
+            const CTYPE v0 = amplitude_0[element];
+            amplitude_0[element] = amplitude_1[element];
+            amplitude_1[element] = v0;
+        }
+        return;
+    }
+    const CTYPE m00 = matrix[0], m01 = matrix[1];
+    const CTYPE m10 = matrix[2], m11 = matrix[3];
+    for (UINT element = 0; element < batch_size; ++element) {
+        const CTYPE v0 = amplitude_0[element];
+        const CTYPE v1 = amplitude_1[element];
+        amplitude_0[element] = batch_mul(m00, v0) + batch_mul(m01, v1);
+        amplitude_1[element] = batch_mul(m10, v0) + batch_mul(m11, v1);
+    }
+}
+
+inline static bool batch_is_swap_matrix(const CTYPE matrix[4]) {
+    return matrix[0] == 0. && matrix[1] == 1. && matrix[2] == 1. &&
+           matrix[3] == 0.;
+}
+
+void batch_single_qubit_dense_matrix_gate(UINT target_qubit_index,
+    const CTYPE matrix[4], CTYPE* state, ITYPE dim, UINT batch_size) {
+    const ITYPE loop_dim = dim / 2;
+    const ITYPE mask = (1ULL << target_qubit_index);
+    const bool is_swap = batch_is_swap_matrix(matrix);
+    ITYPE state_index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim * batch_size, 13);
+#pragma omp parallel for
+#endif
+    for (state_index = 0; state_index < loop_dim; ++state_index) {
+        ITYPE basis_0 =
+            insert_zero_to_basis_index(state_index, mask, target_qubit_index);
+        ITYPE basis_1 = basis_0 ^ mask;
+        batch_update_amplitude_pair(state + basis_0 * batch_size,
+            state + basis_1 * batch_size, matrix, is_swap, batch_size);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+void batch_multi_qubit_control_single_qubit_dense_matrix_gate(
+    const UINT* control_qubit_index_list, const UINT* control_value_list,
+    UINT control_qubit_index_count, UINT target_qubit_index,
+    const CTYPE matrix[4], CTYPE* state, ITYPE dim, UINT batch_size) {
+    const UINT insert_index_count = control_qubit_index_count + 1;
+    UINT* sorted_insert_index_list = create_sorted_ui_list_value(
+        control_qubit_index_list, control_qubit_index_count,
+        target_qubit_index);
+    const ITYPE control_mask = create_control_mask(control_qubit_index_list,
+        control_value_list, control_qubit_index_count);
+    const ITYPE target_mask = 1ULL << target_qubit_index;
+    const ITYPE loop_dim = dim >> insert_index_count;
+    const bool is_swap = batch_is_swap_matrix(matrix);
+    ITYPE state_index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim * batch_size, 13);
+#pragma omp parallel for
+#endif
+    for (state_index = 0; state_index < loop_dim; ++state_index) {
+        ITYPE basis_0 = state_index;
+        for (UINT cursor = 0; cursor < insert_index_count; cursor++) {
+            UINT insert_index = sorted_insert_index_list[cursor];
+            basis_0 = insert_zero_to_basis_index(
+                basis_0, 1ULL << insert_index, insert_index);
+        }
+        basis_0 ^= control_mask;
+        ITYPE basis_1 = basis_0 ^ target_mask;
+        batch_update_amplitude_pair(state + basis_0 * batch_size,
+            state + basis_1 * batch_size, matrix, is_swap, batch_size);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    free(sorted_insert_index_list);
+}
+
+void batch_multi_qubit_diagonal_matrix_gate(const UINT* target_qubit_index_list,
+    UINT target_qubit_index_count, const CTYPE* diagonal_element, CTYPE* state,
+    ITYPE dim, UINT batch_size) {
+    ITYPE state_index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim * batch_size, 13);
+#pragma omp parallel for
+#endif
+    for (state_index = 0; state_index < dim; ++state_index) {
+        // index of the diagonal element
+        ITYPE matrix_index = 0;
+        for (UINT cursor = 0; cursor < target_qubit_index_count; ++cursor) {
+            matrix_index |=
+                ((state_index >> target_qubit_index_list[cursor]) & 1ULL)
+                << cursor;
+        }
+        const CTYPE coef = diagonal_element[matrix_index];
+        CTYPE* amplitude = state + state_index * batch_size;
+        for (UINT element = 0; element < batch_size; ++element) {
+            amplitude[element] = batch_mul(coef, amplitude[element]);
+        }
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+void batch_multi_qubit_control_multi_qubit_dense_matrix_gate(
+    const UINT* control_qubit_index_list, const UINT* control_value_list,
+    UINT control_qubit_index_count, const UINT* target_qubit_index_list,
+    UINT target_qubit_index_count, const CTYPE* matrix, CTYPE* state,
+    ITYPE dim, UINT batch_size) {
+    // matrix dim, mask, buffer
+    const ITYPE matrix_dim = 1ULL << target_qubit_index_count;
+    ITYPE* matrix_mask_list = create_matrix_mask_list(
+        target_qubit_index_list, target_qubit_index_count);
+
+    // insert index
+    const UINT insert_index_count =
+        target_qubit_index_count + control_qubit_index_count;
+    UINT* sorted_insert_index_list = create_sorted_ui_list_list(
+        target_qubit_index_list, target_qubit_index_count,
+        control_qubit_index_list, control_qubit_index_count);
+
+    // control mask
+    const ITYPE control_mask = create_control_mask(control_qubit_index_list,
+        control_value_list, control_qubit_index_count);
+
+    // loop varaibles
+    const ITYPE loop_dim = dim >> insert_index_count;
+    const ITYPE buffer_dim = matrix_dim * batch_size;
+
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim * batch_size, 13);
+    const UINT thread_count = omp_get_max_threads();
+#else
+    const UINT thread_count = 1;
+#endif
+    CTYPE* buffer_list =
+        (CTYPE*)malloc((size_t)(sizeof(CTYPE) * buffer_dim * thread_count));
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+#ifdef _OPENMP
+        CTYPE* buffer = buffer_list + buffer_dim * omp_get_thread_num();
+#pragma omp for
+#else
+        CTYPE* buffer = buffer_list;
+#endif
+        for (ITYPE state_index = 0; state_index < loop_dim; ++state_index) {
+            // create base index
+            ITYPE basis_0 = state_index;
+            for (UINT cursor = 0; cursor < insert_index_count; cursor++) {
+                UINT insert_index = sorted_insert_index_list[cursor];
+                basis_0 = insert_zero_to_basis_index(
+                    basis_0, 1ULL << insert_index, insert_index);
+            }
+
+            // flip control masks
+            basis_0 ^= control_mask;
+
+            // compute matrix mul
+            for (ITYPE y = 0; y < matrix_dim; ++y) {
+                CTYPE* out = buffer + y * batch_size;
+                for (UINT element = 0; element < batch_size; ++element) {
+                    out[element] = 0;
+                }
+                for (ITYPE x = 0; x < matrix_dim; ++x) {
+                    const CTYPE coef = matrix[y * matrix_dim + x];
+                    const CTYPE* in =
+                        state + (basis_0 ^ matrix_mask_list[x]) * batch_size;
+                    for (UINT element = 0; element < batch_size; ++element) {
+                        out[element] += batch_mul(coef, in[element]);
+                    }
+                }
+            }
+
+            // set result
+            for (ITYPE y = 0; y < matrix_dim; ++y) {
+                CTYPE* amplitude =
+                    state + (basis_0 ^ matrix_mask_list[y]) * batch_size;
+                const CTYPE* out = buffer + y * batch_size;
+                for (UINT element = 0; element < batch_size; ++element) {
+                    amplitude[element] = out[element];
+                }
+            }
+        }
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    free(buffer_list);
+    free(sorted_insert_index_list);
+    free(matrix_mask_list);
+}
+
+static void batch_multi_qubit_Pauli_rotation_gate_XZ_mask(ITYPE bit_flip_mask,
+    ITYPE phase_flip_mask, UINT global_phase_90rot_count,
+    UINT pivot_qubit_index, const double* cos_list, const double* sin_list,
+    CTYPE* state, ITYPE dim, UINT batch_size) {
+    const ITYPE loop_dim = dim / 2;
+    const ITYPE mask = (1ULL << pivot_qubit_index);
+    ITYPE state_index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim * batch_size, 13);
+#pragma omp parallel for
+#endif
+    for (state_index = 0; state_index < loop_dim; ++state_index) {
+        ITYPE basis_0 =
+            insert_zero_to_basis_index(state_index, mask, pivot_qubit_index);
+        ITYPE basis_1 = basis_0 ^ bit_flip_mask;
+        int bit_parity_0 = count_population(basis_0 & phase_flip_mask) % 2;
+        int bit_parity_1 = count_population(basis_1 & phase_flip_mask) % 2;
+        // i * (phase of P) for each direction
+        const CTYPE coef_0 =
+            1.i *
+            PHASE_M90ROT[(global_phase_90rot_count + bit_parity_0 * 2) % 4];
+        const CTYPE coef_1 =
+            1.i *
+            PHASE_M90ROT[(global_phase_90rot_count + bit_parity_1 * 2) % 4];
+        CTYPE* amplitude_0 = state + basis_0 * batch_size;
+        CTYPE* amplitude_1 = state + basis_1 * batch_size;
+        for (UINT element = 0; element < batch_size; ++element) {
+            const CTYPE v0 = amplitude_0[element];
+            const CTYPE v1 = amplitude_1[element];
+            amplitude_0[element] = cos_list[element] * v0 +
+                                   sin_list[element] * batch_mul(coef_0, v1);
+            amplitude_1[element] = cos_list[element] * v1 +
+                                   sin_list[element] * batch_mul(coef_1, v0);
+        }
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+static void batch_multi_qubit_Pauli_rotation_gate_Z_mask(ITYPE phase_flip_mask,
+    const double* cos_list, const double* sin_list, CTYPE* state, ITYPE dim,
+    UINT batch_size) {
+    ITYPE state_index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim * batch_size, 13);
+#pragma omp parallel for
+#endif
+    for (state_index = 0; state_index < dim; ++state_index) {
+        int bit_parity = count_population(state_index & phase_flip_mask) % 2;
+        const double sign = 1 - 2 * bit_parity;
+        CTYPE* amplitude = state + state_index * batch_size;
+        for (UINT element = 0; element < batch_size; ++element) {
+            amplitude[element] = batch_mul(
+                CTYPE(cos_list[element], sign * sin_list[element]),
+                amplitude[element]);
+        }
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+void batch_multi_qubit_Pauli_rotation_gate_partial_list(
+    const UINT* target_qubit_index_list, const UINT* Pauli_operator_type_list,
+    UINT target_qubit_index_count, const double* angle_list, CTYPE* state,
+    ITYPE dim, UINT batch_size) {
+    ITYPE bit_flip_mask = 0;
+    ITYPE phase_flip_mask = 0;
+    UINT global_phase_90rot_count = 0;
+    UINT pivot_qubit_index = 0;
+    get_Pauli_masks_partial_list(target_qubit_index_list,
+        Pauli_operator_type_list, target_qubit_index_count, &bit_flip_mask,
+        &phase_flip_mask, &global_phase_90rot_count, &pivot_qubit_index);
+
+    double* cos_list = (double*)malloc(sizeof(double) * batch_size * 2);
+    double* sin_list = cos_list + batch_size;
+    for (UINT element = 0; element < batch_size; ++element) {
+        cos_list[element] = cos(angle_list[element] / 2);
+        sin_list[element] = sin(angle_list[element] / 2);
+    }
+    if (bit_flip_mask == 0) {
+        batch_multi_qubit_Pauli_rotation_gate_Z_mask(
+            phase_flip_mask, cos_list, sin_list, state, dim, batch_size);
+    } else {
+        batch_multi_qubit_Pauli_rotation_gate_XZ_mask(bit_flip_mask,
+            phase_flip_mask, global_phase_90rot_count, pivot_qubit_index,
+            cos_list, sin_list, state, dim, batch_size);
+    }
+    free(cos_list);
+}
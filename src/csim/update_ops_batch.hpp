@@ -0,0 +1,41 @@
+/*
+ Update functions for batches of state vectors.
+
+ A batch of batch_size state vectors of dimension dim is stored as one array
+ of dim * batch_size amplitudes, in which the amplitudes of the same basis
+ are contiguous: state[basis * batch_size + element]. A gate sweeps the
+ array once and the innermost loop runs over the batch elements.
+ */
+
+#pragma once
+
+#include "type.hpp"
+
+DllExport void batch_initialize_quantum_state(
+    CTYPE* state, ITYPE dim, UINT batch_size);
+DllExport void batch_normalize(const double* squared_norm_list, CTYPE* state,
+    ITYPE dim, UINT batch_size);
+
+DllExport void batch_single_qubit_dense_matrix_gate(UINT target_qubit_index,
+    const CTYPE matrix[4], CTYPE* state, ITYPE dim, UINT batch_size);
+DllExport void batch_multi_qubit_control_single_qubit_dense_matrix_gate(
+    const UINT* control_qubit_index_list, const UINT* control_value_list,
+    UINT control_qubit_index_count, UINT target_qubit_index,
+    const CTYPE matrix[4], CTYPE* state, ITYPE dim, UINT batch_size);
+DllExport void batch_multi_qubit_diagonal_matrix_gate(
+    const UINT* target_qubit_index_list, UINT target_qubit_index_count,
+    const CTYPE* diagonal_element, CTYPE* state, ITYPE dim, UINT batch_size);
+DllExport void batch_multi_qubit_control_multi_qubit_dense_matrix_gate(
+    const UINT* control_qubit_index_list, const UINT* control_value_list,
+    UINT control_qubit_index_count, const UINT* target_qubit_index_list,
+    UINT target_qubit_index_count, const CTYPE* matrix, CTYPE* state,
+    ITYPE dim, UINT batch_size);
+
+/**
+ * Pauli rotation exp(i angle_list[b] / 2 P) with a different angle for each
+ * batch element b.
+ */
+DllExport void batch_multi_qubit_Pauli_rotation_gate_partial_list(
+    const UINT* target_qubit_index_list, const UINT* Pauli_operator_type_list,
+    UINT target_qubit_index_count, const double* angle_list, CTYPE* state,
+    ITYPE dim, UINT batch_size);
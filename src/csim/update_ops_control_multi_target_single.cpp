@@ -5,6 +5,7 @@
 
 #include "MPIutil.hpp"
 #include "constant.hpp"
+#include "simd_dispatch.hpp"
 #include "update_ops.hpp"
 #include "utility.hpp"
 #ifdef _OPENMP
@@ -47,15 +48,11 @@ void multi_qubit_control_single_qubit_dense_matrix_gate(
     OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
 #endif
 
-#ifdef _USE_SIMD
-    multi_qubit_control_single_qubit_dense_matrix_gate_simd(
-        control_qubit_index_list, control_value_list, control_qubit_index_count,
-        target_qubit_index, matrix, state, dim);
-#else
-    multi_qubit_control_single_qubit_dense_matrix_gate_unroll(
-        control_qubit_index_list, control_value_list, control_qubit_index_count,
-        target_qubit_index, matrix, state, dim);
-#endif
+    SIMDutil::get_inst()
+        .get_kernel_table()
+        .multi_qubit_control_single_qubit_dense_matrix_gate(
+            control_qubit_index_list, control_value_list,
+            control_qubit_index_count, target_qubit_index, matrix, state, dim);
 
 #ifdef _OPENMP
     OMPutil::get_inst().reset_qulacs_num_threads();
@@ -150,6 +147,7 @@ void multi_qubit_control_single_qubit_dense_matrix_gate_unroll(
 }
 
 #ifdef _USE_SIMD
+QULACS_TARGET_AVX2
 void multi_qubit_control_single_qubit_dense_matrix_gate_simd(
     const UINT* control_qubit_index_list, const UINT* control_value_list,
     UINT control_qubit_index_count, UINT target_qubit_index,
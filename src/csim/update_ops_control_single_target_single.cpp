@@ -6,6 +6,7 @@
 
 #include "MPIutil.hpp"
 #include "constant.hpp"
+#include "simd_dispatch.hpp"
 #include "update_ops.hpp"
 #include "utility.hpp"
 #ifdef _OPENMP
@@ -27,19 +28,11 @@ void single_qubit_control_single_qubit_dense_matrix_gate(
     OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
 #endif
 
-#ifdef _USE_SIMD
-    single_qubit_control_single_qubit_dense_matrix_gate_simd(
-        control_qubit_index, control_value, target_qubit_index, matrix, state,
-        dim);
-#elif defined(_USE_SVE)
-    single_qubit_control_single_qubit_dense_matrix_gate_sve512(
-        control_qubit_index, control_value, target_qubit_index, matrix, state,
-        dim);
-#else
-    single_qubit_control_single_qubit_dense_matrix_gate_unroll(
-        control_qubit_index, control_value, target_qubit_index, matrix, state,
-        dim);
-#endif
+    SIMDutil::get_inst()
+        .get_kernel_table()
+        .single_qubit_control_single_qubit_dense_matrix_gate(
+            control_qubit_index, control_value, target_qubit_index, matrix,
+            state, dim);
 
 #ifdef _OPENMP
     OMPutil::get_inst().reset_qulacs_num_threads();
@@ -120,6 +113,7 @@ void single_qubit_control_single_qubit_dense_matrix_gate_unroll(
 }
 
 #ifdef _USE_SIMD
+QULACS_TARGET_AVX2
 void single_qubit_control_single_qubit_dense_matrix_gate_simd(
     UINT control_qubit_index, UINT control_value, UINT target_qubit_index,
     const CTYPE matrix[4], CTYPE* state, ITYPE dim) {
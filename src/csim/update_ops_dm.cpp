@@ -32,6 +32,11 @@ void dm_normalize(double squared_norm, CTYPE* state, ITYPE dim) {
 
 void dm_single_qubit_dense_matrix_gate(
     UINT target_qubit_index, const CTYPE matrix[4], CTYPE* state, ITYPE dim) {
+    if (dm_is_vectorized_execution()) {
+        dm_vectorized_single_qubit_dense_matrix_gate(target_qubit_index, matrix,
+            state, dim);
+        return;
+    }
     // target mask
     const ITYPE target_mask = 1ULL << target_qubit_index;
 
@@ -105,6 +110,13 @@ void dm_multi_qubit_control_single_qubit_dense_matrix_gate(
     const UINT* control_qubit_index_list, const UINT* control_value_list,
     UINT control_qubit_index_count, UINT target_qubit_index,
     const CTYPE matrix[4], CTYPE* state, ITYPE dim) {
+    if (dm_is_vectorized_execution()) {
+        dm_vectorized_multi_qubit_control_multi_qubit_dense_matrix_gate(
+            control_qubit_index_list, control_value_list,
+            control_qubit_index_count, &target_qubit_index, 1, matrix, state,
+            dim);
+        return;
+    }
     // insert index list
     const UINT insert_index_list_count = control_qubit_index_count + 1;
     UINT* insert_index_list =
@@ -342,6 +354,11 @@ buffer[y];
 void dm_multi_qubit_dense_matrix_gate(const UINT* target_qubit_index_list,
     UINT target_qubit_index_count, const CTYPE* matrix, CTYPE* state,
     ITYPE dim) {
+    if (dm_is_vectorized_execution()) {
+        dm_vectorized_multi_qubit_dense_matrix_gate(target_qubit_index_list,
+            target_qubit_index_count, matrix, state, dim);
+        return;
+    }
     // matrix dim, mask, buffer
     const ITYPE matrix_dim = 1ULL << target_qubit_index_count;
     const ITYPE* matrix_mask_list = create_matrix_mask_list(
@@ -497,11 +514,114 @@ void dm_multi_qubit_dense_matrix_gate(const UINT* target_qubit_index_list,
     free((ITYPE*)matrix_mask_list);
 }
 
+void dm_multi_qubit_superoperator(const UINT* target_qubit_index_list,
+    UINT target_qubit_index_count, const CTYPE* superoperator, CTYPE* state,
+    ITYPE dim) {
+    if (dm_is_vectorized_execution()) {
+        dm_vectorized_multi_qubit_superoperator(target_qubit_index_list,
+            target_qubit_index_count, superoperator, state, dim);
+        return;
+    }
+    // matrix dim, mask
+    const ITYPE matrix_dim = 1ULL << target_qubit_index_count;
+    const ITYPE superoperator_dim = matrix_dim * matrix_dim;
+    const ITYPE* matrix_mask_list = create_matrix_mask_list(
+        target_qubit_index_list, target_qubit_index_count);
+
+    // insert index
+    const UINT* sorted_insert_index_list = create_sorted_ui_list(
+        target_qubit_index_list, target_qubit_index_count);
+
+    // loop variables
+    const ITYPE loop_dim = dim >> target_qubit_index_count;
+    ITYPE state_index_y;
+
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 0);
+#pragma omp parallel
+#endif
+    {
+        // local block of rho before and after the update
+        CTYPE* buffer =
+            (CTYPE*)malloc((size_t)(sizeof(CTYPE) * superoperator_dim * 2));
+        CTYPE* local_state = buffer + superoperator_dim;
+#ifdef _OPENMP
+#pragma omp for
+#endif
+        for (state_index_y = 0; state_index_y < loop_dim; ++state_index_y) {
+            // create base index
+            ITYPE basis_0_y = state_index_y;
+            for (UINT cursor = 0; cursor < target_qubit_index_count; cursor++) {
+                UINT insert_index = sorted_insert_index_list[cursor];
+                basis_0_y = insert_zero_to_basis_index(
+                    basis_0_y, 1ULL << insert_index, insert_index);
+            }
+
+            for (ITYPE state_index_x = 0; state_index_x < loop_dim;
+                 ++state_index_x) {
+                // create base index
+                ITYPE basis_0_x = state_index_x;
+                for (UINT cursor = 0; cursor < target_qubit_index_count;
+                     cursor++) {
+                    UINT insert_index = sorted_insert_index_list[cursor];
+                    basis_0_x = insert_zero_to_basis_index(
+                        basis_0_x, 1ULL << insert_index, insert_index);
+                }
+
+                // gather the local block
+                for (ITYPE y = 0; y < matrix_dim; ++y) {
+                    const ITYPE dm_index_y = basis_0_y ^ matrix_mask_list[y];
+                    for (ITYPE x = 0; x < matrix_dim; ++x) {
+                        const ITYPE dm_index_x =
+                            basis_0_x ^ matrix_mask_list[x];
+                        local_state[y * matrix_dim + x] =
+                            state[dm_index_y * dim + dm_index_x];
+                    }
+                }
+
+                // compute matrix-vector multiply
+                for (ITYPE y = 0; y < superoperator_dim; ++y) {
+                    CTYPE sum = 0;
+                    const CTYPE* row = superoperator + y * superoperator_dim;
+                    for (ITYPE x = 0; x < superoperator_dim; ++x) {
+                        sum += row[x] * local_state[x];
+                    }
+                    buffer[y] = sum;
+                }
+
+                // set result
+                for (ITYPE y = 0; y < matrix_dim; ++y) {
+                    const ITYPE dm_index_y = basis_0_y ^ matrix_mask_list[y];
+                    for (ITYPE x = 0; x < matrix_dim; ++x) {
+                        const ITYPE dm_index_x =
+                            basis_0_x ^ matrix_mask_list[x];
+                        state[dm_index_y * dim + dm_index_x] =
+                            buffer[y * matrix_dim + x];
+                    }
+                }
+            }
+        }
+        free(buffer);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    free((UINT*)sorted_insert_index_list);
+    free((ITYPE*)matrix_mask_list);
+}
+
 void dm_multi_qubit_control_multi_qubit_dense_matrix_gate(
     const UINT* control_qubit_index_list, const UINT* control_value_list,
     UINT control_qubit_index_count, const UINT* target_qubit_index_list,
     UINT target_qubit_index_count, const CTYPE* matrix, CTYPE* state,
     ITYPE dim) {
+    if (dm_is_vectorized_execution()) {
+        dm_vectorized_multi_qubit_control_multi_qubit_dense_matrix_gate(
+            control_qubit_index_list, control_value_list,
+            control_qubit_index_count, target_qubit_index_list,
+            target_qubit_index_count, matrix, state, dim);
+        return;
+    }
     // matrix dim, mask, buffer
     const ITYPE matrix_dim = 1ULL << target_qubit_index_count;
     ITYPE* matrix_mask_list = create_matrix_mask_list(
@@ -744,6 +864,11 @@ void dm_P1_gate(UINT target_qubit_index, CTYPE* state, ITYPE dim) {
 }
 void dm_CNOT_gate(UINT control_qubit_index, UINT target_qubit_index,
     CTYPE* state, ITYPE dim) {
+    if (dm_is_vectorized_execution()) {
+        dm_vectorized_CNOT_gate(control_qubit_index, target_qubit_index, state,
+            dim);
+        return;
+    }
     UINT control_index_list[1];
     UINT control_value_list[1];
     control_index_list[0] = control_qubit_index;
@@ -753,6 +878,11 @@ void dm_CNOT_gate(UINT control_qubit_index, UINT target_qubit_index,
 }
 void dm_CZ_gate(UINT control_qubit_index, UINT target_qubit_index, CTYPE* state,
     ITYPE dim) {
+    if (dm_is_vectorized_execution()) {
+        dm_vectorized_CZ_gate(control_qubit_index, target_qubit_index, state,
+            dim);
+        return;
+    }
     UINT control_index_list[1];
     UINT control_value_list[1];
     control_index_list[0] = control_qubit_index;
@@ -762,6 +892,11 @@ void dm_CZ_gate(UINT control_qubit_index, UINT target_qubit_index, CTYPE* state,
 }
 void dm_SWAP_gate(UINT target_qubit_index_0, UINT target_qubit_index_1,
     CTYPE* state, ITYPE dim) {
+    if (dm_is_vectorized_execution()) {
+        dm_vectorized_SWAP_gate(target_qubit_index_0, target_qubit_index_1,
+            state, dim);
+        return;
+    }
     CTYPE matrix[16] = {};
     matrix[0 * 4 + 0] = 1;
     matrix[1 * 4 + 2] = 1;
@@ -812,6 +947,12 @@ void dm_RZ_gate(
 void dm_multi_qubit_Pauli_gate_partial_list(const UINT* target_qubit_index_list,
     const UINT* Pauli_operator_type_list, UINT target_qubit_index_count,
     CTYPE* state, ITYPE dim) {
+    if (dm_is_vectorized_execution()) {
+        dm_vectorized_multi_qubit_Pauli_gate_partial_list(
+            target_qubit_index_list, Pauli_operator_type_list,
+            target_qubit_index_count, state, dim);
+        return;
+    }
     // TODO faster impl
     const ITYPE matrix_dim = 1ULL << target_qubit_index_count;
     CTYPE* matrix = (CTYPE*)malloc(sizeof(CTYPE) * matrix_dim * matrix_dim);
@@ -833,6 +974,12 @@ void dm_multi_qubit_Pauli_gate_partial_list(const UINT* target_qubit_index_list,
 void dm_multi_qubit_Pauli_rotation_gate_partial_list(
     const UINT* target_qubit_index_list, const UINT* Pauli_operator_type_list,
     UINT target_qubit_index_count, double angle, CTYPE* state, ITYPE dim) {
+    if (dm_is_vectorized_execution()) {
+        dm_vectorized_multi_qubit_Pauli_rotation_gate_partial_list(
+            target_qubit_index_list, Pauli_operator_type_list,
+            target_qubit_index_count, angle, state, dim);
+        return;
+    }
     // TODO faster impl
     const ITYPE matrix_dim = 1ULL << target_qubit_index_count;
     CTYPE* matrix = (CTYPE*)malloc(sizeof(CTYPE) * matrix_dim * matrix_dim);
@@ -18,6 +18,51 @@
 #include <omp.h>
 #endif
 
+/**
+ * Vectorized execution of density matrices.
+ *
+ * The row-major density matrix rho[row * dim + col] of n qubits is the
+ * 2n-qubit state vector vec(rho), in which qubit i of the column is qubit i
+ * and qubit i of the row is qubit n + i. M rho M^dagger is then M on the
+ * qubits [n, 2n) and conj(M) on the qubits [0, n), and the gates below are
+ * applied through the state-vector kernels of update_ops.hpp, including
+ * their SIMD paths. The row and column parts of gates on at most
+ * DM_VECTORIZED_FUSION_MAX_QUBIT_COUNT qubits are fused into one kernel call.
+ *
+ * The vectorized execution is opt-in and process-wide: it is enabled with
+ * dm_set_vectorized_execution(true), and the loops of the dm_* kernels are
+ * used otherwise.
+ */
+#define DM_VECTORIZED_FUSION_MAX_QUBIT_COUNT 2
+DllExport void dm_set_vectorized_execution(bool enabled);
+DllExport bool dm_is_vectorized_execution();
+
+DllExport void dm_vectorized_single_qubit_dense_matrix_gate(
+    UINT target_qubit_index, const CTYPE matrix[4], CTYPE* state, ITYPE dim);
+DllExport void dm_vectorized_multi_qubit_dense_matrix_gate(
+    const UINT* target_qubit_index_list, UINT target_qubit_index_count,
+    const CTYPE* matrix, CTYPE* state, ITYPE dim);
+DllExport void dm_vectorized_multi_qubit_control_multi_qubit_dense_matrix_gate(
+    const UINT* control_qubit_index_list, const UINT* control_value_list,
+    UINT control_qubit_index_count, const UINT* target_qubit_index_list,
+    UINT target_qubit_index_count, const CTYPE* matrix, CTYPE* state,
+    ITYPE dim);
+DllExport void dm_vectorized_multi_qubit_superoperator(
+    const UINT* target_qubit_index_list, UINT target_qubit_index_count,
+    const CTYPE* superoperator, CTYPE* state, ITYPE dim);
+DllExport void dm_vectorized_CNOT_gate(
+    UINT control_qubit_index, UINT target_qubit_index, CTYPE* state, ITYPE dim);
+DllExport void dm_vectorized_CZ_gate(
+    UINT control_qubit_index, UINT target_qubit_index, CTYPE* state, ITYPE dim);
+DllExport void dm_vectorized_SWAP_gate(UINT target_qubit_index_0,
+    UINT target_qubit_index_1, CTYPE* state, ITYPE dim);
+DllExport void dm_vectorized_multi_qubit_Pauli_gate_partial_list(
+    const UINT* target_qubit_index_list, const UINT* Pauli_operator_type_list,
+    UINT target_qubit_index_count, CTYPE* state, ITYPE dim);
+DllExport void dm_vectorized_multi_qubit_Pauli_rotation_gate_partial_list(
+    const UINT* target_qubit_index_list, const UINT* Pauli_operator_type_list,
+    UINT target_qubit_index_count, double angle, CTYPE* state, ITYPE dim);
+
 DllExport void dm_normalize(double squared_norm, CTYPE* state, ITYPE dim);
 DllExport void dm_single_qubit_dense_matrix_gate(
     UINT target_qubit_index, const CTYPE matrix[4], CTYPE* state, ITYPE dim);
@@ -34,6 +79,19 @@ DllExport void dm_multi_qubit_control_multi_qubit_dense_matrix_gate(
     UINT target_qubit_index_count, const CTYPE* matrix, CTYPE* state,
     ITYPE dim);
 
+/**
+ * Apply a superoperator on target qubits, rho -> S(rho), in one pass.
+ *
+ * superoperator is a row-major matrix of dimension 4^k for k target qubits.
+ * Its row and column index is row * 2^k + column of the local block of rho,
+ * where the j-th bit of row and column corresponds to
+ * target_qubit_index_list[j]. For Kraus operators K_i, the element is
+ * sum_i K_i[row, row'] conj(K_i[column, column']).
+ */
+DllExport void dm_multi_qubit_superoperator(
+    const UINT* target_qubit_index_list, UINT target_qubit_index_count,
+    const CTYPE* superoperator, CTYPE* state, ITYPE dim);
+
 DllExport void dm_X_gate(UINT target_qubit_index, CTYPE* state, ITYPE dim);
 DllExport void dm_Y_gate(UINT target_qubit_index, CTYPE* state, ITYPE dim);
 DllExport void dm_Z_gate(UINT target_qubit_index, CTYPE* state, ITYPE dim);
@@ -0,0 +1,382 @@
+#include "update_ops_dm_packed.hpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "constant.hpp"
+#include "utility.hpp"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Number of outer indices in one side of a tile of block pairs. Both
+// state[i * dim + j] and its mirrored element state[j * dim + i] are read for
+// each element, so the block pairs are visited tile by tile to reuse the
+// cache lines of the mirrored triangle.
+static const ITYPE PACKED_DM_TILE_DIM = 16;
+
+// Written out since the multiplication operator of std::complex checks NaN and
+// infinity, which dominates the small matrix products below.
+inline static CTYPE packed_dm_mul(const CTYPE& a, const CTYPE& b) {
+    return CTYPE(a.real() * b.real() - a.imag() * b.imag(),
+        a.real() * b.imag() + a.imag() * b.real());
+}
+inline static CTYPE packed_dm_mul_conj(const CTYPE& a, const CTYPE& b) {
+    return CTYPE(a.real() * b.real() + a.imag() * b.imag(),
+        a.imag() * b.real() - a.real() * b.imag());
+}
+
+// Gather each block pair (y, x) with y <= x of the target qubits, pass it to
+// update and scatter the block returned by it. update(local_state, buffer)
+// receives the row-major 2^k x 2^k block and a buffer of the same size, and
+// returns a pointer to the updated block.
+template <typename Update>
+static void packed_dm_update_block_pairs(const UINT* target_qubit_index_list,
+    UINT target_qubit_index_count, double* state, ITYPE dim, Update update) {
+    // matrix dim, mask
+    const ITYPE matrix_dim = 1ULL << target_qubit_index_count;
+    const ITYPE block_dim = matrix_dim * matrix_dim;
+    const ITYPE* matrix_mask_list = create_matrix_mask_list(
+        target_qubit_index_list, target_qubit_index_count);
+
+    // insert index
+    const UINT* sorted_insert_index_list = create_sorted_ui_list(
+        target_qubit_index_list, target_qubit_index_count);
+
+    // loop variables
+    const ITYPE loop_dim = dim >> target_qubit_index_count;
+    const ITYPE tile_dim =
+        (loop_dim < PACKED_DM_TILE_DIM) ? loop_dim : PACKED_DM_TILE_DIM;
+    const ITYPE tile_count = loop_dim / tile_dim;
+    ITYPE tile_y;
+
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 0);
+#pragma omp parallel
+#endif
+    {
+        CTYPE* local_state =
+            (CTYPE*)malloc((size_t)(sizeof(CTYPE) * block_dim * 2));
+        CTYPE* buffer = local_state + block_dim;
+        // the tiles of a row become shorter towards the end
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+        for (tile_y = 0; tile_y < tile_count; ++tile_y) {
+            for (ITYPE tile_x = tile_y; tile_x < tile_count; ++tile_x) {
+                for (ITYPE state_index_y = tile_y * tile_dim;
+                     state_index_y < (tile_y + 1) * tile_dim; ++state_index_y) {
+                    // create base index
+                    ITYPE basis_0_y = state_index_y;
+                    for (UINT cursor = 0; cursor < target_qubit_index_count;
+                         cursor++) {
+                        UINT insert_index = sorted_insert_index_list[cursor];
+                        basis_0_y = insert_zero_to_basis_index(
+                            basis_0_y, 1ULL << insert_index, insert_index);
+                    }
+
+                    const ITYPE x_begin =
+                        (tile_x == tile_y) ? state_index_y : tile_x * tile_dim;
+                    for (ITYPE state_index_x = x_begin;
+                         state_index_x < (tile_x + 1) * tile_dim;
+                         ++state_index_x) {
+                        // create base index
+                        ITYPE basis_0_x = state_index_x;
+                        for (UINT cursor = 0; cursor < target_qubit_index_count;
+                             cursor++) {
+                            UINT insert_index =
+                                sorted_insert_index_list[cursor];
+                            basis_0_x = insert_zero_to_basis_index(
+                                basis_0_x, 1ULL << insert_index, insert_index);
+                        }
+
+                        // gather the local block
+                        for (ITYPE y = 0; y < matrix_dim; ++y) {
+                            const ITYPE dm_index_y =
+                                basis_0_y ^ matrix_mask_list[y];
+                            for (ITYPE x = 0; x < matrix_dim; ++x) {
+                                const ITYPE dm_index_x =
+                                    basis_0_x ^ matrix_mask_list[x];
+                                local_state[y * matrix_dim + x] =
+                                    packed_dm_get_element(
+                                        state, dim, dm_index_y, dm_index_x);
+                            }
+                        }
+
+                        const CTYPE* updated = update(local_state, buffer);
+
+                        // set result. In a diagonal block pair, the element
+                        // below the diagonal is the conjugate of the one
+                        // above it and is not written twice.
+                        const bool is_diagonal_block =
+                            (state_index_y == state_index_x);
+                        for (ITYPE y = 0; y < matrix_dim; ++y) {
+                            const ITYPE dm_index_y =
+                                basis_0_y ^ matrix_mask_list[y];
+                            for (ITYPE x = 0; x < matrix_dim; ++x) {
+                                const ITYPE dm_index_x =
+                                    basis_0_x ^ matrix_mask_list[x];
+                                if (is_diagonal_block &&
+                                    dm_index_y > dm_index_x)
+                                    continue;
+                                packed_dm_set_element(state, dim, dm_index_y,
+                                    dm_index_x, updated[y * matrix_dim + x]);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        free(local_state);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    free((UINT*)sorted_insert_index_list);
+    free((ITYPE*)matrix_mask_list);
+}
+
+double* packed_dm_allocate_quantum_state(ITYPE dim) {
+    double* state = (double*)malloc((size_t)(sizeof(double) * dim * dim));
+    if (!state) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    return state;
+}
+
+void packed_dm_release_quantum_state(double* state) { free(state); }
+
+void packed_dm_initialize_quantum_state(double* state, ITYPE dim) {
+    ITYPE index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel for
+#endif
+    for (index = 0; index < dim; ++index) {
+        memset(state + index * dim, 0, (size_t)(sizeof(double) * dim));
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    state[0] = 1.0;
+}
+
+void packed_dm_initialize_with_pure_state(
+    double* state, const CTYPE* pure_state, ITYPE dim) {
+    ITYPE index_y;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (index_y = 0; index_y < dim; ++index_y) {
+        for (ITYPE index_x = index_y; index_x < dim; ++index_x) {
+            packed_dm_set_element(state, dim, index_y, index_x,
+                pure_state[index_y] * conj(pure_state[index_x]));
+        }
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+void packed_dm_initialize_with_density_matrix(
+    double* state, const CTYPE* density_matrix, ITYPE dim) {
+    ITYPE index_y;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+    for (index_y = 0; index_y < dim; ++index_y) {
+        for (ITYPE index_x = index_y; index_x < dim; ++index_x) {
+            packed_dm_set_element(state, dim, index_y, index_x,
+                density_matrix[index_y * dim + index_x]);
+        }
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+void packed_dm_copy_to_density_matrix(
+    const double* state, CTYPE* density_matrix, ITYPE dim) {
+    ITYPE index_y;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel for
+#endif
+    for (index_y = 0; index_y < dim; ++index_y) {
+        for (ITYPE index_x = 0; index_x < dim; ++index_x) {
+            density_matrix[index_y * dim + index_x] =
+                packed_dm_get_element(state, dim, index_y, index_x);
+        }
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+void packed_dm_normalize(double squared_norm, double* state, ITYPE dim) {
+    packed_dm_state_multiply(1. / squared_norm, state, dim);
+}
+
+void packed_dm_state_add_with_coef(
+    double coef, const double* state_added, double* state, ITYPE dim) {
+    // both halves are linear in rho for a real coefficient
+    const ITYPE loop_dim = dim * dim;
+    ITYPE index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel for
+#endif
+    for (index = 0; index < loop_dim; ++index) {
+        state[index] += coef * state_added[index];
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+void packed_dm_state_multiply(double coef, double* state, ITYPE dim) {
+    const ITYPE loop_dim = dim * dim;
+    ITYPE index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel for
+#endif
+    for (index = 0; index < loop_dim; ++index) {
+        state[index] *= coef;
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+void packed_dm_single_qubit_dense_matrix_gate(
+    UINT target_qubit_index, const CTYPE matrix[4], double* state, ITYPE dim) {
+    // the block pairs of packed_dm_update_block_pairs for one target qubit,
+    // with the 2x2 products written out
+    const ITYPE mask = 1ULL << target_qubit_index;
+    const ITYPE loop_dim = dim / 2;
+    const ITYPE tile_dim =
+        (loop_dim < PACKED_DM_TILE_DIM) ? loop_dim : PACKED_DM_TILE_DIM;
+    const ITYPE tile_count = loop_dim / tile_dim;
+    ITYPE tile_y;
+
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 0);
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (tile_y = 0; tile_y < tile_count; ++tile_y) {
+        for (ITYPE tile_x = tile_y; tile_x < tile_count; ++tile_x) {
+            for (ITYPE state_index_y = tile_y * tile_dim;
+                 state_index_y < (tile_y + 1) * tile_dim; ++state_index_y) {
+                const ITYPE basis_0_y = insert_zero_to_basis_index(
+                    state_index_y, mask, target_qubit_index);
+                const ITYPE basis_1_y = basis_0_y ^ mask;
+                const ITYPE x_begin =
+                    (tile_x == tile_y) ? state_index_y : tile_x * tile_dim;
+                for (ITYPE state_index_x = x_begin;
+                     state_index_x < (tile_x + 1) * tile_dim;
+                     ++state_index_x) {
+                    const ITYPE basis_0_x = insert_zero_to_basis_index(
+                        state_index_x, mask, target_qubit_index);
+                    const ITYPE basis_1_x = basis_0_x ^ mask;
+
+                    const CTYPE rho_00 = packed_dm_get_element(
+                        state, dim, basis_0_y, basis_0_x);
+                    const CTYPE rho_01 = packed_dm_get_element(
+                        state, dim, basis_0_y, basis_1_x);
+                    const CTYPE rho_10 = packed_dm_get_element(
+                        state, dim, basis_1_y, basis_0_x);
+                    const CTYPE rho_11 = packed_dm_get_element(
+                        state, dim, basis_1_y, basis_1_x);
+
+                    // M rho
+                    const CTYPE temp_00 = packed_dm_mul(matrix[0], rho_00) +
+                                          packed_dm_mul(matrix[1], rho_10);
+                    const CTYPE temp_01 = packed_dm_mul(matrix[0], rho_01) +
+                                          packed_dm_mul(matrix[1], rho_11);
+                    const CTYPE temp_10 = packed_dm_mul(matrix[2], rho_00) +
+                                          packed_dm_mul(matrix[3], rho_10);
+                    const CTYPE temp_11 = packed_dm_mul(matrix[2], rho_01) +
+                                          packed_dm_mul(matrix[3], rho_11);
+
+                    // (M rho) M^dagger
+                    packed_dm_set_element(state, dim, basis_0_y, basis_0_x,
+                        packed_dm_mul_conj(temp_00, matrix[0]) +
+                            packed_dm_mul_conj(temp_01, matrix[1]));
+                    packed_dm_set_element(state, dim, basis_0_y, basis_1_x,
+                        packed_dm_mul_conj(temp_00, matrix[2]) +
+                            packed_dm_mul_conj(temp_01, matrix[3]));
+                    // rho_10 of a diagonal block pair is conj(rho_01)
+                    if (state_index_y != state_index_x) {
+                        packed_dm_set_element(state, dim, basis_1_y, basis_0_x,
+                            packed_dm_mul_conj(temp_10, matrix[0]) +
+                                packed_dm_mul_conj(temp_11, matrix[1]));
+                    }
+                    packed_dm_set_element(state, dim, basis_1_y, basis_1_x,
+                        packed_dm_mul_conj(temp_10, matrix[2]) +
+                            packed_dm_mul_conj(temp_11, matrix[3]));
+                }
+            }
+        }
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+void packed_dm_multi_qubit_dense_matrix_gate(
+    const UINT* target_qubit_index_list, UINT target_qubit_index_count,
+    const CTYPE* matrix, double* state, ITYPE dim) {
+    const ITYPE matrix_dim = 1ULL << target_qubit_index_count;
+    packed_dm_update_block_pairs(target_qubit_index_list,
+        target_qubit_index_count, state, dim,
+        [&](CTYPE* local_state, CTYPE* buffer) -> const CTYPE* {
+            // buffer = M rho
+            for (ITYPE y = 0; y < matrix_dim; ++y) {
+                for (ITYPE x = 0; x < matrix_dim; ++x) {
+                    CTYPE sum = 0;
+                    for (ITYPE k = 0; k < matrix_dim; ++k) {
+                        sum += packed_dm_mul(matrix[y * matrix_dim + k],
+                            local_state[k * matrix_dim + x]);
+                    }
+                    buffer[y * matrix_dim + x] = sum;
+                }
+            }
+            // rho = buffer M^dagger
+            for (ITYPE y = 0; y < matrix_dim; ++y) {
+                for (ITYPE x = 0; x < matrix_dim; ++x) {
+                    CTYPE sum = 0;
+                    for (ITYPE k = 0; k < matrix_dim; ++k) {
+                        sum += packed_dm_mul_conj(buffer[y * matrix_dim + k],
+                            matrix[x * matrix_dim + k]);
+                    }
+                    local_state[y * matrix_dim + x] = sum;
+                }
+            }
+            return local_state;
+        });
+}
+
+void packed_dm_multi_qubit_superoperator(const UINT* target_qubit_index_list,
+    UINT target_qubit_index_count, const CTYPE* superoperator, double* state,
+    ITYPE dim) {
+    const ITYPE matrix_dim = 1ULL << target_qubit_index_count;
+    const ITYPE superoperator_dim = matrix_dim * matrix_dim;
+    packed_dm_update_block_pairs(target_qubit_index_list,
+        target_qubit_index_count, state, dim,
+        [&](CTYPE* local_state, CTYPE* buffer) -> const CTYPE* {
+            for (ITYPE y = 0; y < superoperator_dim; ++y) {
+                CTYPE sum = 0;
+                const CTYPE* row = superoperator + y * superoperator_dim;
+                for (ITYPE x = 0; x < superoperator_dim; ++x) {
+                    sum += packed_dm_mul(row[x], local_state[x]);
+                }
+                buffer[y] = sum;
+            }
+            return buffer;
+        });
+}
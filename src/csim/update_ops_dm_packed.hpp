@@ -0,0 +1,86 @@
+/*
+ Update functions for Hermitian-packed density matrices.
+
+ A density matrix rho of dimension dim is Hermitian, so it is stored as one
+ real array of dim * dim doubles instead of dim * dim complex numbers:
+   state[i * dim + j] = Re rho[i][j]  (i <= j)
+   state[j * dim + i] = Im rho[i][j]  (i < j)
+ The diagonal and the real parts of the upper triangle are kept in place and
+ the imaginary parts of the upper triangle are kept in the mirrored lower
+ triangle. Gate kernels update the block pairs (y, x) with y <= x only, and
+ the lower blocks follow from Hermiticity, so memory and traffic are half of
+ the update_ops_dm kernels.
+ */
+
+#pragma once
+
+#include "type.hpp"
+
+/**
+ * Read rho[row][col] from a Hermitian-packed density matrix.
+ */
+inline static CTYPE packed_dm_get_element(
+    const double* state, ITYPE dim, ITYPE row, ITYPE col) {
+    if (row < col) {
+        return CTYPE(state[row * dim + col], state[col * dim + row]);
+    } else if (row > col) {
+        return CTYPE(state[col * dim + row], -state[row * dim + col]);
+    }
+    return CTYPE(state[row * dim + row], 0.);
+}
+
+/**
+ * Write rho[row][col], and therefore rho[col][row] = conj(value), to a
+ * Hermitian-packed density matrix. The imaginary part of a diagonal element
+ * is dropped.
+ */
+inline static void packed_dm_set_element(
+    double* state, ITYPE dim, ITYPE row, ITYPE col, CTYPE value) {
+    if (row < col) {
+        state[row * dim + col] = _creal(value);
+        state[col * dim + row] = _cimag(value);
+    } else if (row > col) {
+        state[col * dim + row] = _creal(value);
+        state[row * dim + col] = -_cimag(value);
+    } else {
+        state[row * dim + row] = _creal(value);
+    }
+}
+
+DllExport double* packed_dm_allocate_quantum_state(ITYPE dim);
+DllExport void packed_dm_release_quantum_state(double* state);
+DllExport void packed_dm_initialize_quantum_state(double* state, ITYPE dim);
+DllExport void packed_dm_initialize_with_pure_state(
+    double* state, const CTYPE* pure_state, ITYPE dim);
+DllExport void packed_dm_initialize_with_density_matrix(
+    double* state, const CTYPE* density_matrix, ITYPE dim);
+DllExport void packed_dm_copy_to_density_matrix(
+    const double* state, CTYPE* density_matrix, ITYPE dim);
+
+DllExport void packed_dm_normalize(double squared_norm, double* state, ITYPE dim);
+DllExport void packed_dm_state_add_with_coef(
+    double coef, const double* state_added, double* state, ITYPE dim);
+DllExport void packed_dm_state_multiply(double coef, double* state, ITYPE dim);
+
+/**
+ * rho -> M rho M^dagger for a 2 x 2 row-major matrix M on the target qubit.
+ */
+DllExport void packed_dm_single_qubit_dense_matrix_gate(
+    UINT target_qubit_index, const CTYPE matrix[4], double* state, ITYPE dim);
+
+/**
+ * rho -> M rho M^dagger for a 2^k x 2^k row-major matrix M on the target
+ * qubits. Controls are handled by the caller through an extended matrix.
+ */
+DllExport void packed_dm_multi_qubit_dense_matrix_gate(
+    const UINT* target_qubit_index_list, UINT target_qubit_index_count,
+    const CTYPE* matrix, double* state, ITYPE dim);
+
+/**
+ * Apply a Hermiticity-preserving superoperator, such as a Kraus channel, on
+ * the target qubits. The superoperator uses the index convention of
+ * dm_multi_qubit_superoperator.
+ */
+DllExport void packed_dm_multi_qubit_superoperator(
+    const UINT* target_qubit_index_list, UINT target_qubit_index_count,
+    const CTYPE* superoperator, double* state, ITYPE dim);
@@ -0,0 +1,216 @@
+#include <stdlib.h>
+
+#include <atomic>
+#include <vector>
+
+#include "update_ops.hpp"
+#include "update_ops_dm.hpp"
+#include "utility.hpp"
+
+static std::atomic<bool> dm_vectorized_execution(false);
+
+void dm_set_vectorized_execution(bool enabled) {
+    dm_vectorized_execution = enabled;
+}
+
+bool dm_is_vectorized_execution() { return dm_vectorized_execution; }
+
+// number of qubits n of a density matrix of dimension dim = 2^n
+static UINT dm_vectorized_qubit_count(ITYPE dim) {
+    UINT qubit_count = 0;
+    while ((1ULL << qubit_count) < dim) ++qubit_count;
+    return qubit_count;
+}
+
+// qubits of the columns followed by the qubits of the rows of vec(rho), so
+// that the local index of a superoperator is row * 2^k + column
+static UINT* dm_vectorized_create_index_list(
+    const UINT* qubit_index_list, UINT qubit_index_count, UINT qubit_count) {
+    UINT* index_list = (UINT*)malloc(sizeof(UINT) * qubit_index_count * 2);
+    for (UINT i = 0; i < qubit_index_count; ++i) {
+        index_list[i] = qubit_index_list[i];
+        index_list[qubit_index_count + i] = qubit_index_list[i] + qubit_count;
+    }
+    return index_list;
+}
+
+// number of Pauli-Y, which gives conj(P) = (-1)^{#Y} P
+static UINT dm_vectorized_Pauli_Y_count(
+    const UINT* Pauli_operator_type_list, UINT target_qubit_index_count) {
+    UINT count = 0;
+    for (UINT i = 0; i < target_qubit_index_count; ++i) {
+        if (Pauli_operator_type_list[i] == 2) ++count;
+    }
+    return count;
+}
+
+void dm_vectorized_single_qubit_dense_matrix_gate(
+    UINT target_qubit_index, const CTYPE matrix[4], CTYPE* state, ITYPE dim) {
+    dm_vectorized_multi_qubit_dense_matrix_gate(
+        &target_qubit_index, 1, matrix, state, dim);
+}
+
+void dm_vectorized_multi_qubit_dense_matrix_gate(
+    const UINT* target_qubit_index_list, UINT target_qubit_index_count,
+    const CTYPE* matrix, CTYPE* state, ITYPE dim) {
+    const UINT qubit_count = dm_vectorized_qubit_count(dim);
+    const ITYPE matrix_dim = 1ULL << target_qubit_index_count;
+    UINT* index_list = dm_vectorized_create_index_list(
+        target_qubit_index_list, target_qubit_index_count, qubit_count);
+
+    if (target_qubit_index_count <= DM_VECTORIZED_FUSION_MAX_QUBIT_COUNT) {
+        // one sweep with M (x) conj(M) on the row and column qubits
+        const ITYPE superoperator_dim = matrix_dim * matrix_dim;
+        CTYPE* superoperator = (CTYPE*)malloc(
+            sizeof(CTYPE) * superoperator_dim * superoperator_dim);
+        for (ITYPE row = 0; row < matrix_dim; ++row) {
+            for (ITYPE col = 0; col < matrix_dim; ++col) {
+                for (ITYPE row_src = 0; row_src < matrix_dim; ++row_src) {
+                    for (ITYPE col_src = 0; col_src < matrix_dim; ++col_src) {
+                        superoperator[(row * matrix_dim + col) *
+                                          superoperator_dim +
+                                      row_src * matrix_dim + col_src] =
+                            matrix[row * matrix_dim + row_src] *
+                            conj(matrix[col * matrix_dim + col_src]);
+                    }
+                }
+            }
+        }
+        multi_qubit_dense_matrix_gate(index_list, target_qubit_index_count * 2,
+            superoperator, state, dim * dim);
+        free(superoperator);
+    } else {
+        CTYPE* conj_matrix =
+            (CTYPE*)malloc(sizeof(CTYPE) * matrix_dim * matrix_dim);
+        for (ITYPE i = 0; i < matrix_dim * matrix_dim; ++i) {
+            conj_matrix[i] = conj(matrix[i]);
+        }
+        multi_qubit_dense_matrix_gate(index_list + target_qubit_index_count,
+            target_qubit_index_count, matrix, state, dim * dim);
+        multi_qubit_dense_matrix_gate(index_list, target_qubit_index_count,
+            conj_matrix, state, dim * dim);
+        free(conj_matrix);
+    }
+    free(index_list);
+}
+
+void dm_vectorized_multi_qubit_control_multi_qubit_dense_matrix_gate(
+    const UINT* control_qubit_index_list, const UINT* control_value_list,
+    UINT control_qubit_index_count, const UINT* target_qubit_index_list,
+    UINT target_qubit_index_count, const CTYPE* matrix, CTYPE* state,
+    ITYPE dim) {
+    // C_U (x) conj(C_U) = (C_U (x) I)(I (x) conj(C_U)), so the controlled
+    // gate is applied on the rows and its conjugate on the columns in turn
+    const UINT qubit_count = dm_vectorized_qubit_count(dim);
+    const ITYPE matrix_dim = 1ULL << target_qubit_index_count;
+    UINT* control_list = dm_vectorized_create_index_list(
+        control_qubit_index_list, control_qubit_index_count, qubit_count);
+    UINT* target_list = dm_vectorized_create_index_list(
+        target_qubit_index_list, target_qubit_index_count, qubit_count);
+    CTYPE* conj_matrix =
+        (CTYPE*)malloc(sizeof(CTYPE) * matrix_dim * matrix_dim);
+    for (ITYPE i = 0; i < matrix_dim * matrix_dim; ++i) {
+        conj_matrix[i] = conj(matrix[i]);
+    }
+
+    if (target_qubit_index_count == 1) {
+        multi_qubit_control_single_qubit_dense_matrix_gate(
+            control_list + control_qubit_index_count, control_value_list,
+            control_qubit_index_count, target_list[1], matrix, state,
+            dim * dim);
+        multi_qubit_control_single_qubit_dense_matrix_gate(control_list,
+            control_value_list, control_qubit_index_count, target_list[0],
+            conj_matrix, state, dim * dim);
+    } else {
+        multi_qubit_control_multi_qubit_dense_matrix_gate(
+            control_list + control_qubit_index_count, control_value_list,
+            control_qubit_index_count, target_list + target_qubit_index_count,
+            target_qubit_index_count, matrix, state, dim * dim);
+        multi_qubit_control_multi_qubit_dense_matrix_gate(control_list,
+            control_value_list, control_qubit_index_count, target_list,
+            target_qubit_index_count, conj_matrix, state, dim * dim);
+    }
+    free(conj_matrix);
+    free(target_list);
+    free(control_list);
+}
+
+void dm_vectorized_multi_qubit_superoperator(
+    const UINT* target_qubit_index_list, UINT target_qubit_index_count,
+    const CTYPE* superoperator, CTYPE* state, ITYPE dim) {
+    const UINT qubit_count = dm_vectorized_qubit_count(dim);
+    UINT* index_list = dm_vectorized_create_index_list(
+        target_qubit_index_list, target_qubit_index_count, qubit_count);
+    multi_qubit_dense_matrix_gate(index_list, target_qubit_index_count * 2,
+        superoperator, state, dim * dim);
+    free(index_list);
+}
+
+void dm_vectorized_CNOT_gate(UINT control_qubit_index, UINT target_qubit_index,
+    CTYPE* state, ITYPE dim) {
+    const UINT qubit_count = dm_vectorized_qubit_count(dim);
+    CNOT_gate(control_qubit_index + qubit_count,
+        target_qubit_index + qubit_count, state, dim * dim);
+    CNOT_gate(control_qubit_index, target_qubit_index, state, dim * dim);
+}
+
+void dm_vectorized_CZ_gate(UINT control_qubit_index, UINT target_qubit_index,
+    CTYPE* state, ITYPE dim) {
+    const UINT qubit_count = dm_vectorized_qubit_count(dim);
+    CZ_gate(control_qubit_index + qubit_count, target_qubit_index + qubit_count,
+        state, dim * dim);
+    CZ_gate(control_qubit_index, target_qubit_index, state, dim * dim);
+}
+
+void dm_vectorized_SWAP_gate(UINT target_qubit_index_0,
+    UINT target_qubit_index_1, CTYPE* state, ITYPE dim) {
+    const UINT qubit_count = dm_vectorized_qubit_count(dim);
+    SWAP_gate(target_qubit_index_0 + qubit_count,
+        target_qubit_index_1 + qubit_count, state, dim * dim);
+    SWAP_gate(target_qubit_index_0, target_qubit_index_1, state, dim * dim);
+}
+
+void dm_vectorized_multi_qubit_Pauli_gate_partial_list(
+    const UINT* target_qubit_index_list, const UINT* Pauli_operator_type_list,
+    UINT target_qubit_index_count, CTYPE* state, ITYPE dim) {
+    // P rho P^dagger = (-1)^{#Y} (P (x) P) vec(rho), applied in one sweep
+    const UINT qubit_count = dm_vectorized_qubit_count(dim);
+    std::vector<UINT> index_list(target_qubit_index_count * 2);
+    std::vector<UINT> Pauli_list(target_qubit_index_count * 2);
+    for (UINT i = 0; i < target_qubit_index_count; ++i) {
+        index_list[i] = target_qubit_index_list[i];
+        index_list[target_qubit_index_count + i] =
+            target_qubit_index_list[i] + qubit_count;
+        Pauli_list[i] = Pauli_operator_type_list[i];
+        Pauli_list[target_qubit_index_count + i] = Pauli_operator_type_list[i];
+    }
+    multi_qubit_Pauli_gate_partial_list(index_list.data(), Pauli_list.data(),
+        target_qubit_index_count * 2, state, dim * dim);
+    if (dm_vectorized_Pauli_Y_count(
+            Pauli_operator_type_list, target_qubit_index_count) %
+        2) {
+        state_multiply(-1., state, dim * dim);
+    }
+}
+
+void dm_vectorized_multi_qubit_Pauli_rotation_gate_partial_list(
+    const UINT* target_qubit_index_list, const UINT* Pauli_operator_type_list,
+    UINT target_qubit_index_count, double angle, CTYPE* state, ITYPE dim) {
+    // conj(exp(i angle/2 P)) = exp(-i angle/2 (-1)^{#Y} P)
+    const UINT qubit_count = dm_vectorized_qubit_count(dim);
+    UINT* index_list = dm_vectorized_create_index_list(
+        target_qubit_index_list, target_qubit_index_count, qubit_count);
+    const double column_angle =
+        (dm_vectorized_Pauli_Y_count(
+             Pauli_operator_type_list, target_qubit_index_count) %
+            2)
+            ? angle
+            : -angle;
+    multi_qubit_Pauli_rotation_gate_partial_list(
+        index_list + target_qubit_index_count, Pauli_operator_type_list,
+        target_qubit_index_count, angle, state, dim * dim);
+    multi_qubit_Pauli_rotation_gate_partial_list(index_list,
+        Pauli_operator_type_list, target_qubit_index_count, column_angle,
+        state, dim * dim);
+    free(index_list);
+}
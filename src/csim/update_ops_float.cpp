@@ -0,0 +1,585 @@
+#include "update_ops_float.hpp"
+
+#include <stdlib.h>
+
+#include "constant.hpp"
+#include "utility.hpp"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// The multiplication operator of std::complex checks NaN and infinity and
+// calls a library routine unless -ffast-math is given, which is much slower
+// than the memory access of the kernels.
+inline static CTYPE_F float_mul(const CTYPE_F& a, const CTYPE_F& b) {
+    return CTYPE_F(a.real() * b.real() - a.imag() * b.imag(),
+        a.real() * b.imag() + a.imag() * b.real());
+}
+
+void float_X_gate(UINT target_qubit_index, CTYPE_F* state, ITYPE dim) {
+    const ITYPE loop_dim = dim / 2;
+    const ITYPE mask = (1ULL << target_qubit_index);
+    ITYPE state_index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
+#pragma omp parallel for
+#endif
+    for (state_index = 0; state_index < loop_dim; ++state_index) {
+        ITYPE basis_0 =
+            insert_zero_to_basis_index(state_index, mask, target_qubit_index);
+        ITYPE basis_1 = basis_0 ^ mask;
+        CTYPE_F temp = state[basis_0];
+        state[basis_0] = state[basis_1];
+        state[basis_1] = temp;
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+void float_Y_gate(UINT target_qubit_index, CTYPE_F* state, ITYPE dim) {
+    const ITYPE loop_dim = dim / 2;
+    const ITYPE mask = (1ULL << target_qubit_index);
+    const CTYPE_F imag(0.f, 1.f);
+    ITYPE state_index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
+#pragma omp parallel for
+#endif
+    for (state_index = 0; state_index < loop_dim; ++state_index) {
+        ITYPE basis_0 =
+            insert_zero_to_basis_index(state_index, mask, target_qubit_index);
+        ITYPE basis_1 = basis_0 ^ mask;
+        CTYPE_F temp = state[basis_0];
+        state[basis_0] = float_mul(-imag, state[basis_1]);
+        state[basis_1] = float_mul(imag, temp);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+void float_Z_gate(UINT target_qubit_index, CTYPE_F* state, ITYPE dim) {
+    const ITYPE loop_dim = dim / 2;
+    const ITYPE mask = (1ULL << target_qubit_index);
+    ITYPE state_index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
+#pragma omp parallel for
+#endif
+    for (state_index = 0; state_index < loop_dim; ++state_index) {
+        ITYPE basis_1 =
+            insert_zero_to_basis_index(state_index, mask, target_qubit_index) ^
+            mask;
+        state[basis_1] *= -1.f;
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+void float_H_gate(UINT target_qubit_index, CTYPE_F* state, ITYPE dim) {
+    const ITYPE loop_dim = dim / 2;
+    const ITYPE mask = (1ULL << target_qubit_index);
+    const float sqrt2inv = (float)(1. / SQRT2);
+    ITYPE state_index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
+#pragma omp parallel for
+#endif
+    for (state_index = 0; state_index < loop_dim; ++state_index) {
+        ITYPE basis_0 =
+            insert_zero_to_basis_index(state_index, mask, target_qubit_index);
+        ITYPE basis_1 = basis_0 ^ mask;
+        CTYPE_F temp_0 = state[basis_0];
+        CTYPE_F temp_1 = state[basis_1];
+        state[basis_0] = (temp_0 + temp_1) * sqrt2inv;
+        state[basis_1] = (temp_0 - temp_1) * sqrt2inv;
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+void float_CNOT_gate(UINT control_qubit_index, UINT target_qubit_index,
+    CTYPE_F* state, ITYPE dim) {
+    const ITYPE loop_dim = dim / 4;
+    const ITYPE target_mask = 1ULL << target_qubit_index;
+    const ITYPE control_mask = 1ULL << control_qubit_index;
+    const UINT min_qubit_index =
+        get_min_ui(control_qubit_index, target_qubit_index);
+    const UINT max_qubit_index =
+        get_max_ui(control_qubit_index, target_qubit_index);
+    const ITYPE min_qubit_mask = 1ULL << min_qubit_index;
+    const ITYPE max_qubit_mask = 1ULL << max_qubit_index;
+    ITYPE state_index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
+#pragma omp parallel for
+#endif
+    for (state_index = 0; state_index < loop_dim; ++state_index) {
+        ITYPE basis_0 = insert_zero_to_basis_index(
+            insert_zero_to_basis_index(
+                state_index, min_qubit_mask, min_qubit_index),
+            max_qubit_mask, max_qubit_index);
+        ITYPE basis_10 = basis_0 ^ control_mask;
+        ITYPE basis_11 = basis_10 ^ target_mask;
+        CTYPE_F temp = state[basis_10];
+        state[basis_10] = state[basis_11];
+        state[basis_11] = temp;
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+void float_CZ_gate(UINT control_qubit_index, UINT target_qubit_index,
+    CTYPE_F* state, ITYPE dim) {
+    const ITYPE loop_dim = dim / 4;
+    const UINT min_qubit_index =
+        get_min_ui(control_qubit_index, target_qubit_index);
+    const UINT max_qubit_index =
+        get_max_ui(control_qubit_index, target_qubit_index);
+    const ITYPE min_qubit_mask = 1ULL << min_qubit_index;
+    const ITYPE max_qubit_mask = 1ULL << max_qubit_index;
+    const ITYPE mask = min_qubit_mask | max_qubit_mask;
+    ITYPE state_index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
+#pragma omp parallel for
+#endif
+    for (state_index = 0; state_index < loop_dim; ++state_index) {
+        ITYPE basis_11 = insert_zero_to_basis_index(
+                             insert_zero_to_basis_index(
+                                 state_index, min_qubit_mask, min_qubit_index),
+                             max_qubit_mask, max_qubit_index) ^
+                         mask;
+        state[basis_11] *= -1.f;
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+void float_SWAP_gate(UINT target_qubit_index_0, UINT target_qubit_index_1,
+    CTYPE_F* state, ITYPE dim) {
+    const ITYPE loop_dim = dim / 4;
+    const UINT min_qubit_index =
+        get_min_ui(target_qubit_index_0, target_qubit_index_1);
+    const UINT max_qubit_index =
+        get_max_ui(target_qubit_index_0, target_qubit_index_1);
+    const ITYPE min_qubit_mask = 1ULL << min_qubit_index;
+    const ITYPE max_qubit_mask = 1ULL << max_qubit_index;
+    ITYPE state_index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
+#pragma omp parallel for
+#endif
+    for (state_index = 0; state_index < loop_dim; ++state_index) {
+        ITYPE basis_0 = insert_zero_to_basis_index(
+            insert_zero_to_basis_index(
+                state_index, min_qubit_mask, min_qubit_index),
+            max_qubit_mask, max_qubit_index);
+        ITYPE basis_01 = basis_0 ^ min_qubit_mask;
+        ITYPE basis_10 = basis_0 ^ max_qubit_mask;
+        CTYPE_F temp = state[basis_01];
+        state[basis_01] = state[basis_10];
+        state[basis_10] = temp;
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+void float_normalize(double squared_norm, CTYPE_F* state, ITYPE dim) {
+    const float normalize_factor = (float)(1. / sqrt(squared_norm));
+    ITYPE state_index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
+#pragma omp parallel for
+#endif
+    for (state_index = 0; state_index < dim; ++state_index) {
+        state[state_index] *= normalize_factor;
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+void float_single_qubit_dense_matrix_gate(
+    UINT target_qubit_index, const CTYPE matrix[4], CTYPE_F* state, ITYPE dim) {
+    const ITYPE loop_dim = dim / 2;
+    const ITYPE mask = (1ULL << target_qubit_index);
+    const CTYPE_F m00(matrix[0]), m01(matrix[1]), m10(matrix[2]),
+        m11(matrix[3]);
+    ITYPE state_index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
+#pragma omp parallel for
+#endif
+    for (state_index = 0; state_index < loop_dim; ++state_index) {
+        ITYPE basis_0 =
+            insert_zero_to_basis_index(state_index, mask, target_qubit_index);
+        ITYPE basis_1 = basis_0 ^ mask;
+        CTYPE_F cval_0 = state[basis_0];
+        CTYPE_F cval_1 = state[basis_1];
+        state[basis_0] = float_mul(m00, cval_0) + float_mul(m01, cval_1);
+        state[basis_1] = float_mul(m10, cval_0) + float_mul(m11, cval_1);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+void float_single_qubit_diagonal_matrix_gate(UINT target_qubit_index,
+    const CTYPE diagonal_matrix[2], CTYPE_F* state, ITYPE dim) {
+    const CTYPE_F diagonal[2] = {
+        CTYPE_F(diagonal_matrix[0]), CTYPE_F(diagonal_matrix[1])};
+    ITYPE state_index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
+#pragma omp parallel for
+#endif
+    for (state_index = 0; state_index < dim; ++state_index) {
+        state[state_index] = float_mul(
+            state[state_index], diagonal[(state_index >> target_qubit_index) & 1]);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+void float_double_qubit_dense_matrix_gate(UINT target_qubit_index1,
+    UINT target_qubit_index2, const CTYPE matrix[16], CTYPE_F* state,
+    ITYPE dim) {
+    CTYPE_F mat[16];
+    for (UINT i = 0; i < 16; ++i) mat[i] = CTYPE_F(matrix[i]);
+
+    const UINT min_qubit_index =
+        get_min_ui(target_qubit_index1, target_qubit_index2);
+    const UINT max_qubit_index =
+        get_max_ui(target_qubit_index1, target_qubit_index2);
+    const ITYPE min_qubit_mask = 1ULL << min_qubit_index;
+    const ITYPE max_qubit_mask = 1ULL << (max_qubit_index - 1);
+    const ITYPE low_mask = min_qubit_mask - 1;
+    const ITYPE mid_mask = (max_qubit_mask - 1) ^ low_mask;
+    const ITYPE high_mask = ~(max_qubit_mask - 1);
+
+    const ITYPE target_mask1 = 1ULL << target_qubit_index1;
+    const ITYPE target_mask2 = 1ULL << target_qubit_index2;
+
+    const ITYPE loop_dim = dim / 4;
+    ITYPE state_index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
+#pragma omp parallel for
+#endif
+    for (state_index = 0; state_index < loop_dim; ++state_index) {
+        const ITYPE basis_0 = (state_index & low_mask) +
+                              ((state_index & mid_mask) << 1) +
+                              ((state_index & high_mask) << 2);
+        const ITYPE basis[4] = {basis_0, basis_0 + target_mask1,
+            basis_0 + target_mask2, basis_0 + target_mask1 + target_mask2};
+        const CTYPE_F v[4] = {
+            state[basis[0]], state[basis[1]], state[basis[2]], state[basis[3]]};
+        for (UINT y = 0; y < 4; ++y) {
+            state[basis[y]] =
+                float_mul(mat[y * 4 + 0], v[0]) + float_mul(mat[y * 4 + 1], v[1]) +
+                float_mul(mat[y * 4 + 2], v[2]) + float_mul(mat[y * 4 + 3], v[3]);
+        }
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+void float_multi_qubit_dense_matrix_gate(const UINT* target_qubit_index_list,
+    UINT target_qubit_index_count, const CTYPE* matrix, CTYPE_F* state,
+    ITYPE dim) {
+    if (target_qubit_index_count == 2) {
+        float_double_qubit_dense_matrix_gate(target_qubit_index_list[0],
+            target_qubit_index_list[1], matrix, state, dim);
+        return;
+    }
+    float_multi_qubit_control_multi_qubit_dense_matrix_gate(NULL, NULL, 0,
+        target_qubit_index_list, target_qubit_index_count, matrix, state, dim);
+}
+
+void float_multi_qubit_control_multi_qubit_dense_matrix_gate(
+    const UINT* control_qubit_index_list, const UINT* control_value_list,
+    UINT control_qubit_index_count, const UINT* target_qubit_index_list,
+    UINT target_qubit_index_count, const CTYPE* matrix, CTYPE_F* state,
+    ITYPE dim) {
+    // matrix dim, mask, rounded matrix
+    const ITYPE matrix_dim = 1ULL << target_qubit_index_count;
+    ITYPE* matrix_mask_list = create_matrix_mask_list(
+        target_qubit_index_list, target_qubit_index_count);
+    CTYPE_F* matrix_f =
+        (CTYPE_F*)malloc((size_t)(sizeof(CTYPE_F) * matrix_dim * matrix_dim));
+    for (ITYPE i = 0; i < matrix_dim * matrix_dim; ++i) {
+        matrix_f[i] = CTYPE_F(matrix[i]);
+    }
+
+    // insert index
+    const UINT insert_index_count =
+        target_qubit_index_count + control_qubit_index_count;
+    UINT* sorted_insert_index_list = create_sorted_ui_list_list(
+        target_qubit_index_list, target_qubit_index_count,
+        control_qubit_index_list, control_qubit_index_count);
+
+    // control mask
+    const ITYPE control_mask = create_control_mask(control_qubit_index_list,
+        control_value_list, control_qubit_index_count);
+
+    // loop varaibles
+    const ITYPE loop_dim = dim >> insert_index_count;
+
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
+    const UINT thread_count = omp_get_max_threads();
+#else
+    const UINT thread_count = 1;
+#endif
+    CTYPE_F* buffer_list = (CTYPE_F*)malloc(
+        (size_t)(sizeof(CTYPE_F) * matrix_dim * thread_count));
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+#ifdef _OPENMP
+        CTYPE_F* buffer = buffer_list + matrix_dim * omp_get_thread_num();
+#pragma omp for
+#else
+        CTYPE_F* buffer = buffer_list;
+#endif
+        for (ITYPE state_index = 0; state_index < loop_dim; ++state_index) {
+            // create base index
+            ITYPE basis_0 = state_index;
+            for (UINT cursor = 0; cursor < insert_index_count; cursor++) {
+                UINT insert_index = sorted_insert_index_list[cursor];
+                basis_0 = insert_zero_to_basis_index(
+                    basis_0, 1ULL << insert_index, insert_index);
+            }
+
+            // flip control masks
+            basis_0 ^= control_mask;
+
+            // compute matrix mul
+            for (ITYPE y = 0; y < matrix_dim; ++y) {
+                buffer[y] = 0;
+                for (ITYPE x = 0; x < matrix_dim; ++x) {
+                    buffer[y] += float_mul(matrix_f[y * matrix_dim + x],
+                        state[basis_0 ^ matrix_mask_list[x]]);
+                }
+            }
+
+            // set result
+            for (ITYPE y = 0; y < matrix_dim; ++y) {
+                state[basis_0 ^ matrix_mask_list[y]] = buffer[y];
+            }
+        }
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    free(buffer_list);
+    free(sorted_insert_index_list);
+    free(matrix_f);
+    free(matrix_mask_list);
+}
+
+void float_multi_qubit_diagonal_matrix_gate(const UINT* target_qubit_index_list,
+    UINT target_qubit_index_count, const CTYPE* diagonal_element,
+    CTYPE_F* state, ITYPE dim) {
+    const ITYPE matrix_dim = 1ULL << target_qubit_index_count;
+    CTYPE_F* diagonal_f = (CTYPE_F*)malloc((size_t)(sizeof(CTYPE_F) * matrix_dim));
+    for (ITYPE i = 0; i < matrix_dim; ++i) {
+        diagonal_f[i] = CTYPE_F(diagonal_element[i]);
+    }
+    ITYPE state_index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
+#pragma omp parallel for
+#endif
+    for (state_index = 0; state_index < dim; ++state_index) {
+        // the index of the diagonal element is the bits on the targets
+        ITYPE matrix_index = 0;
+        for (UINT i = 0; i < target_qubit_index_count; ++i) {
+            matrix_index |= ((state_index >> target_qubit_index_list[i]) & 1)
+                            << i;
+        }
+        state[state_index] =
+            float_mul(state[state_index], diagonal_f[matrix_index]);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    free(diagonal_f);
+}
+
+static void float_multi_qubit_Pauli_gate_XZ_mask(ITYPE bit_flip_mask,
+    ITYPE phase_flip_mask, UINT global_phase_90rot_count,
+    UINT pivot_qubit_index, CTYPE_F* state, ITYPE dim) {
+    const ITYPE loop_dim = dim / 2;
+    const ITYPE mask = (1ULL << pivot_qubit_index);
+    ITYPE state_index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 14);
+#pragma omp parallel for
+#endif
+    for (state_index = 0; state_index < loop_dim; ++state_index) {
+        ITYPE basis_0 =
+            insert_zero_to_basis_index(state_index, mask, pivot_qubit_index);
+        ITYPE basis_1 = basis_0 ^ bit_flip_mask;
+        UINT sign_0 = count_population(basis_0 & phase_flip_mask) % 2;
+        UINT sign_1 = count_population(basis_1 & phase_flip_mask) % 2;
+        CTYPE_F cval_0 = state[basis_0];
+        CTYPE_F cval_1 = state[basis_1];
+        state[basis_0] = float_mul(cval_1,
+            CTYPE_F(PHASE_M90ROT[(global_phase_90rot_count + sign_0 * 2) % 4]));
+        state[basis_1] = float_mul(cval_0,
+            CTYPE_F(PHASE_M90ROT[(global_phase_90rot_count + sign_1 * 2) % 4]));
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+static void float_multi_qubit_Pauli_rotation_gate_XZ_mask(ITYPE bit_flip_mask,
+    ITYPE phase_flip_mask, UINT global_phase_90rot_count,
+    UINT pivot_qubit_index, double angle, CTYPE_F* state, ITYPE dim) {
+    const ITYPE loop_dim = dim / 2;
+    const ITYPE mask = (1ULL << pivot_qubit_index);
+    const float cosval = (float)cos(angle / 2);
+    const CTYPE_F isinval(0.f, (float)sin(angle / 2));
+    ITYPE state_index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 14);
+#pragma omp parallel for
+#endif
+    for (state_index = 0; state_index < loop_dim; ++state_index) {
+        ITYPE basis_0 =
+            insert_zero_to_basis_index(state_index, mask, pivot_qubit_index);
+        ITYPE basis_1 = basis_0 ^ bit_flip_mask;
+        int bit_parity_0 = count_population(basis_0 & phase_flip_mask) % 2;
+        int bit_parity_1 = count_population(basis_1 & phase_flip_mask) % 2;
+        CTYPE_F cval_0 = state[basis_0];
+        CTYPE_F cval_1 = state[basis_1];
+        state[basis_0] =
+            cosval * cval_0 +
+            float_mul(float_mul(isinval, cval_1),
+                CTYPE_F(PHASE_M90ROT[(global_phase_90rot_count +
+                                         bit_parity_0 * 2) %
+                                     4]));
+        state[basis_1] =
+            cosval * cval_1 +
+            float_mul(float_mul(isinval, cval_0),
+                CTYPE_F(PHASE_M90ROT[(global_phase_90rot_count +
+                                         bit_parity_1 * 2) %
+                                     4]));
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+static void float_multi_qubit_Pauli_rotation_gate_Z_mask(
+    ITYPE phase_flip_mask, double angle, CTYPE_F* state, ITYPE dim) {
+    const CTYPE_F phase[2] = {CTYPE_F((float)cos(angle / 2),
+                                  (float)sin(angle / 2)),
+        CTYPE_F((float)cos(angle / 2), -(float)sin(angle / 2))};
+    ITYPE state_index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 14);
+#pragma omp parallel for
+#endif
+    for (state_index = 0; state_index < dim; ++state_index) {
+        int bit_parity = count_population(state_index & phase_flip_mask) % 2;
+        state[state_index] = float_mul(state[state_index], phase[bit_parity]);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+void float_multi_qubit_Pauli_gate_partial_list(
+    const UINT* target_qubit_index_list, const UINT* Pauli_operator_type_list,
+    UINT target_qubit_index_count, CTYPE_F* state, ITYPE dim) {
+    ITYPE bit_flip_mask = 0;
+    ITYPE phase_flip_mask = 0;
+    UINT global_phase_90rot_count = 0;
+    UINT pivot_qubit_index = 0;
+    get_Pauli_masks_partial_list(target_qubit_index_list,
+        Pauli_operator_type_list, target_qubit_index_count, &bit_flip_mask,
+        &phase_flip_mask, &global_phase_90rot_count, &pivot_qubit_index);
+    if (bit_flip_mask == 0) {
+        ITYPE state_index;
+#ifdef _OPENMP
+        OMPutil::get_inst().set_qulacs_num_threads(dim, 14);
+#pragma omp parallel for
+#endif
+        for (state_index = 0; state_index < dim; ++state_index) {
+            if (count_population(state_index & phase_flip_mask) % 2 == 1) {
+                state[state_index] *= -1.f;
+            }
+        }
+#ifdef _OPENMP
+        OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    } else {
+        float_multi_qubit_Pauli_gate_XZ_mask(bit_flip_mask, phase_flip_mask,
+            global_phase_90rot_count, pivot_qubit_index, state, dim);
+    }
+}
+
+void float_multi_qubit_Pauli_rotation_gate_partial_list(
+    const UINT* target_qubit_index_list, const UINT* Pauli_operator_type_list,
+    UINT target_qubit_index_count, double angle, CTYPE_F* state, ITYPE dim) {
+    ITYPE bit_flip_mask = 0;
+    ITYPE phase_flip_mask = 0;
+    UINT global_phase_90rot_count = 0;
+    UINT pivot_qubit_index = 0;
+    get_Pauli_masks_partial_list(target_qubit_index_list,
+        Pauli_operator_type_list, target_qubit_index_count, &bit_flip_mask,
+        &phase_flip_mask, &global_phase_90rot_count, &pivot_qubit_index);
+    if (bit_flip_mask == 0) {
+        float_multi_qubit_Pauli_rotation_gate_Z_mask(
+            phase_flip_mask, angle, state, dim);
+    } else {
+        float_multi_qubit_Pauli_rotation_gate_XZ_mask(bit_flip_mask,
+            phase_flip_mask, global_phase_90rot_count, pivot_qubit_index,
+            angle, state, dim);
+    }
+}
+
+void float_state_add_with_coef(
+    CTYPE coef, const CTYPE_F* state_added, CTYPE_F* state, ITYPE dim) {
+    const CTYPE_F coef_f(coef);
+    ITYPE index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 15);
+#pragma omp parallel for
+#endif
+    for (index = 0; index < dim; ++index) {
+        state[index] += float_mul(coef_f, state_added[index]);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+void float_state_multiply(CTYPE coef, CTYPE_F* state, ITYPE dim) {
+    const CTYPE_F coef_f(coef);
+    ITYPE index;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 15);
+#pragma omp parallel for
+#endif
+    for (index = 0; index < dim; ++index) {
+        state[index] = float_mul(state[index], coef_f);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
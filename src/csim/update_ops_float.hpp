@@ -0,0 +1,54 @@
+/*
+ Update functions for single precision state vectors.
+
+ The order of arguments follows update_ops.hpp. Gate matrices are given in
+ double precision and rounded once per call, and amplitudes are stored and
+ updated in single precision.
+ */
+
+#pragma once
+
+#include "type.hpp"
+
+DllExport void float_X_gate(UINT target_qubit_index, CTYPE_F* state, ITYPE dim);
+DllExport void float_Y_gate(UINT target_qubit_index, CTYPE_F* state, ITYPE dim);
+DllExport void float_Z_gate(UINT target_qubit_index, CTYPE_F* state, ITYPE dim);
+DllExport void float_H_gate(UINT target_qubit_index, CTYPE_F* state, ITYPE dim);
+DllExport void float_CNOT_gate(UINT control_qubit_index,
+    UINT target_qubit_index, CTYPE_F* state, ITYPE dim);
+DllExport void float_CZ_gate(UINT control_qubit_index, UINT target_qubit_index,
+    CTYPE_F* state, ITYPE dim);
+DllExport void float_SWAP_gate(UINT target_qubit_index_0,
+    UINT target_qubit_index_1, CTYPE_F* state, ITYPE dim);
+
+DllExport void float_normalize(double squared_norm, CTYPE_F* state, ITYPE dim);
+
+DllExport void float_single_qubit_dense_matrix_gate(
+    UINT target_qubit_index, const CTYPE matrix[4], CTYPE_F* state, ITYPE dim);
+DllExport void float_single_qubit_diagonal_matrix_gate(UINT target_qubit_index,
+    const CTYPE diagonal_matrix[2], CTYPE_F* state, ITYPE dim);
+DllExport void float_double_qubit_dense_matrix_gate(UINT target_qubit_index1,
+    UINT target_qubit_index2, const CTYPE matrix[16], CTYPE_F* state,
+    ITYPE dim);
+DllExport void float_multi_qubit_dense_matrix_gate(
+    const UINT* target_qubit_index_list, UINT target_qubit_index_count,
+    const CTYPE* matrix, CTYPE_F* state, ITYPE dim);
+DllExport void float_multi_qubit_control_multi_qubit_dense_matrix_gate(
+    const UINT* control_qubit_index_list, const UINT* control_value_list,
+    UINT control_qubit_index_count, const UINT* target_qubit_index_list,
+    UINT target_qubit_index_count, const CTYPE* matrix, CTYPE_F* state,
+    ITYPE dim);
+DllExport void float_multi_qubit_diagonal_matrix_gate(
+    const UINT* target_qubit_index_list, UINT target_qubit_index_count,
+    const CTYPE* diagonal_element, CTYPE_F* state, ITYPE dim);
+
+DllExport void float_multi_qubit_Pauli_gate_partial_list(
+    const UINT* target_qubit_index_list, const UINT* Pauli_operator_type_list,
+    UINT target_qubit_index_count, CTYPE_F* state, ITYPE dim);
+DllExport void float_multi_qubit_Pauli_rotation_gate_partial_list(
+    const UINT* target_qubit_index_list, const UINT* Pauli_operator_type_list,
+    UINT target_qubit_index_count, double angle, CTYPE_F* state, ITYPE dim);
+
+DllExport void float_state_add_with_coef(
+    CTYPE coef, const CTYPE_F* state_added, CTYPE_F* state, ITYPE dim);
+DllExport void float_state_multiply(CTYPE coef, CTYPE_F* state, ITYPE dim);
@@ -6,6 +6,7 @@
 
 #include "constant.hpp"
 #include "cppsim/exception.hpp"
+#include "simd_dispatch.hpp"
 #include "update_ops.hpp"
 #include "utility.hpp"
 
@@ -22,10 +23,13 @@
 #endif
 
 #ifdef _USE_SIMD
+QULACS_TARGET_AVX2
 void double_qubit_dense_matrix_gate_simd_high(UINT target_qubit_index1,
     UINT target_qubit_index2, const CTYPE mat[16], CTYPE* vec, ITYPE dim);
+QULACS_TARGET_AVX2
 void double_qubit_dense_matrix_gate_simd_middle(UINT target_qubit_index1,
     UINT target_qubit_index2, const CTYPE mat[16], CTYPE* vec, ITYPE dim);
+QULACS_TARGET_AVX2
 void double_qubit_dense_matrix_gate_simd_low(UINT target_qubit_index1,
     UINT target_qubit_index2, const CTYPE mat[16], CTYPE* vec, ITYPE dim);
 #endif
@@ -45,16 +49,8 @@ void double_qubit_dense_matrix_gate_c(UINT target_qubit_index1,
     OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
 #endif
 
-#ifdef _USE_SIMD
-    double_qubit_dense_matrix_gate_simd(
-        target_qubit_index1, target_qubit_index2, matrix, state, dim);
-#elif defined(_USE_SVE)
-    double_qubit_dense_matrix_gate_sve(
-        target_qubit_index1, target_qubit_index2, matrix, state, dim);
-#else
-    double_qubit_dense_matrix_gate_nosimd(
+    SIMDutil::get_inst().get_kernel_table().double_qubit_dense_matrix_gate(
         target_qubit_index1, target_qubit_index2, matrix, state, dim);
-#endif
 
 #ifdef _OPENMP
     OMPutil::get_inst().reset_qulacs_num_threads();
@@ -113,6 +109,7 @@ void double_qubit_dense_matrix_gate_nosimd(UINT target_qubit_index1,
 }
 
 #ifdef _USE_SIMD
+QULACS_TARGET_AVX2
 void double_qubit_dense_matrix_gate_simd_high(UINT target_qubit_index1,
     UINT target_qubit_index2, const CTYPE mat[16], CTYPE* vec, ITYPE dim) {
     assert(target_qubit_index1 >= 2);
@@ -417,6 +414,7 @@ void double_qubit_dense_matrix_gate_simd_high(UINT target_qubit_index1,
     }
 }
 
+QULACS_TARGET_AVX2
 void double_qubit_dense_matrix_gate_simd_low(UINT target_qubit_index1,
     UINT target_qubit_index2, const CTYPE mat[16], CTYPE* vec, ITYPE dim) {
     assert(target_qubit_index1 < 2);
@@ -760,6 +758,7 @@ __inline void _complex_element_swap(double* vec, UINT i1, UINT i2) {
     vec[i2 << 1 | 1] = temp;
 }
 
+QULACS_TARGET_AVX2
 void double_qubit_dense_matrix_gate_simd_middle(UINT target_qubit_index1,
     UINT target_qubit_index2, const CTYPE _mat[16], CTYPE* vec, ITYPE dim) {
     double mat[32];
@@ -975,6 +974,77 @@ void double_qubit_dense_matrix_gate_simd(UINT target_qubit_index1,
             target_qubit_index1, target_qubit_index2, mat, vec, dim);
     }
 }
+
+QULACS_TARGET_AVX512
+void double_qubit_dense_matrix_gate_avx512(UINT target_qubit_index1,
+    UINT target_qubit_index2, const CTYPE matrix[16], CTYPE* state,
+    ITYPE dim) {
+    assert(target_qubit_index1 != target_qubit_index2);
+    if (target_qubit_index1 < 2 || target_qubit_index2 < 2) {
+        // a register would mix amplitudes of different basis groups
+        double_qubit_dense_matrix_gate_simd(
+            target_qubit_index1, target_qubit_index2, matrix, state, dim);
+        return;
+    }
+    const UINT min_qubit_index =
+        get_min_ui(target_qubit_index1, target_qubit_index2);
+    const UINT max_qubit_index =
+        get_max_ui(target_qubit_index1, target_qubit_index2);
+    const ITYPE min_qubit_mask = 1ULL << min_qubit_index;
+    const ITYPE max_qubit_mask = 1ULL << (max_qubit_index - 1);
+    const ITYPE low_mask = min_qubit_mask - 1;
+    const ITYPE mid_mask = (max_qubit_mask - 1) ^ low_mask;
+    const ITYPE high_mask = ~(max_qubit_mask - 1);
+
+    const ITYPE target_mask1 = 1ULL << target_qubit_index1;
+    const ITYPE target_mask2 = 1ULL << target_qubit_index2;
+
+    const __m512d one = _mm512_set1_pd(1.0);
+    __m512d mr[16], mi[16];
+    for (UINT i = 0; i < 16; ++i) {
+        mr[i] = _mm512_set1_pd(_creal(matrix[i]));
+        mi[i] = _mm512_set1_pd(_cimag(matrix[i]));
+    }
+
+    // loop variables
+    const ITYPE loop_dim = dim / 4;
+    ITYPE state_index;
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (state_index = 0; state_index < loop_dim; state_index += 4) {
+        // create index
+        ITYPE basis_0 = (state_index & low_mask) +
+                        ((state_index & mid_mask) << 1) +
+                        ((state_index & high_mask) << 2);
+
+        // gather index
+        double* ptr[4];
+        ptr[0] = (double*)(state + basis_0);
+        ptr[1] = (double*)(state + basis_0 + target_mask1);
+        ptr[2] = (double*)(state + basis_0 + target_mask2);
+        ptr[3] = (double*)(state + basis_0 + target_mask1 + target_mask2);
+
+        // fetch values
+        __m512d data[4], swap[4];
+        for (UINT i = 0; i < 4; ++i) {
+            data[i] = _mm512_loadu_pd(ptr[i]);
+            swap[i] = _mm512_shuffle_pd(data[i], data[i], 0x55);
+        }
+
+        // set values
+        for (UINT y = 0; y < 4; ++y) {
+            __m512d real = _mm512_mul_pd(mr[y * 4], data[0]);
+            __m512d imag = _mm512_mul_pd(mi[y * 4], swap[0]);
+            for (UINT x = 1; x < 4; ++x) {
+                real = _mm512_fmadd_pd(mr[y * 4 + x], data[x], real);
+                imag = _mm512_fmadd_pd(mi[y * 4 + x], swap[x], imag);
+            }
+            _mm512_storeu_pd(ptr[y], _mm512_fmaddsub_pd(real, one, imag));
+        }
+    }
+}
 #endif
 
 #ifdef _USE_SVE
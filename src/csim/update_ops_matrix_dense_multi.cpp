@@ -10,6 +10,7 @@
 
 #include "constant.hpp"
 #include "cppsim/exception.hpp"
+#include "simd_dispatch.hpp"
 #include "update_ops.hpp"
 #include "utility.hpp"
 #ifdef _OPENMP
@@ -39,8 +40,9 @@ void multi_qubit_dense_matrix_gate(const UINT* target_qubit_index_list,
 #ifdef _OPENMP
         OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
 #endif
-        multi_qubit_dense_matrix_gate_parallel(target_qubit_index_list,
-            target_qubit_index_count, matrix, state, dim);
+        SIMDutil::get_inst().get_kernel_table().multi_qubit_dense_matrix_gate(
+            target_qubit_index_list, target_qubit_index_count, matrix, state,
+            dim);
 #ifdef _OPENMP
         OMPutil::get_inst().reset_qulacs_num_threads();
 #endif
@@ -127,6 +129,102 @@ void multi_qubit_dense_matrix_gate_parallel(const UINT* target_qubit_index_list,
     free((ITYPE*)matrix_mask_list);
 }
 
+#ifdef _USE_SIMD
+QULACS_TARGET_AVX512
+void multi_qubit_dense_matrix_gate_parallel_avx512(
+    const UINT* target_qubit_index_list, UINT target_qubit_index_count,
+    const CTYPE* matrix, CTYPE* state, ITYPE dim) {
+    UINT sort_array[64];
+    ITYPE mask_array[64];
+    create_shift_mask_list_from_list_buf(target_qubit_index_list,
+        target_qubit_index_count, sort_array, mask_array);
+    if (sort_array[0] < 2) {
+        // a register would mix amplitudes of different basis groups
+        multi_qubit_dense_matrix_gate_parallel(target_qubit_index_list,
+            target_qubit_index_count, matrix, state, dim);
+        return;
+    }
+
+    // matrix dim, mask, buffer
+    const ITYPE matrix_dim = 1ULL << target_qubit_index_count;
+    const ITYPE* matrix_mask_list = create_matrix_mask_list(
+        target_qubit_index_list, target_qubit_index_count);
+    // loop variables
+    const ITYPE loop_dim = dim >> target_qubit_index_count;
+
+    // real and imaginary parts of the matrix are broadcast separately
+    double* matrix_real =
+        (double*)malloc((size_t)(sizeof(double) * matrix_dim * matrix_dim));
+    double* matrix_imag =
+        (double*)malloc((size_t)(sizeof(double) * matrix_dim * matrix_dim));
+    for (ITYPE i = 0; i < matrix_dim * matrix_dim; ++i) {
+        matrix_real[i] = _creal(matrix[i]);
+        matrix_imag[i] = _cimag(matrix[i]);
+    }
+
+#ifdef _OPENMP
+    const UINT thread_count = omp_get_max_threads();
+#else
+    const UINT thread_count = 1;
+#endif
+    // each thread keeps four amplitudes per column and their (im, re) swap
+    const ITYPE buffer_size = matrix_dim * 16;
+    double* buffer_list = (double*)malloc(
+        (size_t)(sizeof(double) * buffer_size * thread_count));
+
+    const __m512d one = _mm512_set1_pd(1.0);
+    ITYPE state_index;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (state_index = 0; state_index < loop_dim; state_index += 4) {
+#ifdef _OPENMP
+        UINT thread_id = omp_get_thread_num();
+#else
+        UINT thread_id = 0;
+#endif
+        double* data_buffer = buffer_list + thread_id * buffer_size;
+        double* swap_buffer = data_buffer + matrix_dim * 8;
+
+        // create base index
+        ITYPE basis_0 = state_index;
+        for (UINT cursor = 0; cursor < target_qubit_index_count; ++cursor) {
+            basis_0 = (basis_0 & mask_array[cursor]) +
+                      ((basis_0 & (~mask_array[cursor])) << 1);
+        }
+
+        // fetch values
+        for (ITYPE x = 0; x < matrix_dim; ++x) {
+            __m512d data = _mm512_loadu_pd(
+                (double*)(state + (basis_0 ^ matrix_mask_list[x])));
+            _mm512_storeu_pd(data_buffer + x * 8, data);
+            _mm512_storeu_pd(
+                swap_buffer + x * 8, _mm512_shuffle_pd(data, data, 0x55));
+        }
+
+        // compute matrix-vector multiply and set result
+        for (ITYPE y = 0; y < matrix_dim; ++y) {
+            const double* row_real = matrix_real + y * matrix_dim;
+            const double* row_imag = matrix_imag + y * matrix_dim;
+            __m512d real = _mm512_setzero_pd();
+            __m512d imag = _mm512_setzero_pd();
+            for (ITYPE x = 0; x < matrix_dim; ++x) {
+                real = _mm512_fmadd_pd(_mm512_set1_pd(row_real[x]),
+                    _mm512_loadu_pd(data_buffer + x * 8), real);
+                imag = _mm512_fmadd_pd(_mm512_set1_pd(row_imag[x]),
+                    _mm512_loadu_pd(swap_buffer + x * 8), imag);
+            }
+            _mm512_storeu_pd((double*)(state + (basis_0 ^ matrix_mask_list[y])),
+                _mm512_fmaddsub_pd(real, one, imag));
+        }
+    }
+    free(buffer_list);
+    free(matrix_real);
+    free(matrix_imag);
+    free((ITYPE*)matrix_mask_list);
+}
+#endif
+
 #ifdef _USE_MPI
 void multi_qubit_dense_matrix_gate_mpi(const UINT* target_qubit_index_list,
     UINT target_qubit_index_count, const CTYPE* matrix, CTYPE* state, ITYPE dim,
@@ -6,6 +6,7 @@
 
 #include "MPIutil.hpp"
 #include "constant.hpp"
+#include "simd_dispatch.hpp"
 #include "update_ops.hpp"
 #include "utility.hpp"
 #ifdef _OPENMP
@@ -25,16 +26,8 @@ void single_qubit_dense_matrix_gate(
     OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
 #endif
 
-#ifdef _USE_SIMD
-    single_qubit_dense_matrix_gate_parallel_simd(
-        target_qubit_index, matrix, state, dim);
-#elif defined(_USE_SVE)
-    single_qubit_dense_matrix_gate_parallel_sve(
-        target_qubit_index, matrix, state, dim);
-#else
-    single_qubit_dense_matrix_gate_parallel(
+    SIMDutil::get_inst().get_kernel_table().single_qubit_dense_matrix_gate(
         target_qubit_index, matrix, state, dim);
-#endif
 
 #ifdef _OPENMP
     OMPutil::get_inst().reset_qulacs_num_threads();
@@ -115,6 +108,7 @@ void single_qubit_dense_matrix_gate_parallel_unroll(
 }
 
 #ifdef _USE_SIMD
+QULACS_TARGET_AVX2
 void single_qubit_dense_matrix_gate_parallel_simd(
     UINT target_qubit_index, const CTYPE matrix[4], CTYPE *state, ITYPE dim) {
     const ITYPE loop_dim = dim / 2;
@@ -211,6 +205,62 @@ void single_qubit_dense_matrix_gate_parallel_simd(
         }
     }
 }
+
+// Amplitudes are stored as (re, im) pairs, so a 512-bit register holds four
+// of them. A complex matrix element m acts on a register v as
+// re(m) * v -/+ im(m) * swap(v), where swap exchanges re and im.
+QULACS_TARGET_AVX512
+void single_qubit_dense_matrix_gate_parallel_avx512(
+    UINT target_qubit_index, const CTYPE matrix[4], CTYPE *state, ITYPE dim) {
+    if (target_qubit_index < 2) {
+        // a register would mix amplitudes of both branches
+        single_qubit_dense_matrix_gate_parallel_simd(
+            target_qubit_index, matrix, state, dim);
+        return;
+    }
+    const ITYPE loop_dim = dim / 2;
+    const ITYPE mask = (1ULL << target_qubit_index);
+    const ITYPE mask_low = mask - 1;
+    const ITYPE mask_high = ~mask_low;
+
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d m00r = _mm512_set1_pd(_creal(matrix[0]));
+    const __m512d m00i = _mm512_set1_pd(_cimag(matrix[0]));
+    const __m512d m01r = _mm512_set1_pd(_creal(matrix[1]));
+    const __m512d m01i = _mm512_set1_pd(_cimag(matrix[1]));
+    const __m512d m10r = _mm512_set1_pd(_creal(matrix[2]));
+    const __m512d m10i = _mm512_set1_pd(_cimag(matrix[2]));
+    const __m512d m11r = _mm512_set1_pd(_creal(matrix[3]));
+    const __m512d m11i = _mm512_set1_pd(_cimag(matrix[3]));
+
+    ITYPE state_index = 0;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (state_index = 0; state_index < loop_dim; state_index += 4) {
+        ITYPE basis_0 =
+            (state_index & mask_low) + ((state_index & mask_high) << 1);
+        ITYPE basis_1 = basis_0 + mask;
+        double *ptr0 = (double *)(state + basis_0);
+        double *ptr1 = (double *)(state + basis_1);
+        __m512d data0 = _mm512_loadu_pd(ptr0);
+        __m512d data1 = _mm512_loadu_pd(ptr1);
+        __m512d swap0 = _mm512_shuffle_pd(data0, data0, 0x55);
+        __m512d swap1 = _mm512_shuffle_pd(data1, data1, 0x55);
+
+        __m512d real0 =
+            _mm512_fmadd_pd(m01r, data1, _mm512_mul_pd(m00r, data0));
+        __m512d imag0 =
+            _mm512_fmadd_pd(m01i, swap1, _mm512_mul_pd(m00i, swap0));
+        __m512d real1 =
+            _mm512_fmadd_pd(m11r, data1, _mm512_mul_pd(m10r, data0));
+        __m512d imag1 =
+            _mm512_fmadd_pd(m11i, swap1, _mm512_mul_pd(m10i, swap0));
+
+        _mm512_storeu_pd(ptr0, _mm512_fmaddsub_pd(real0, one, imag0));
+        _mm512_storeu_pd(ptr1, _mm512_fmaddsub_pd(real1, one, imag1));
+    }
+}
 #endif
 
 #ifdef _USE_SVE
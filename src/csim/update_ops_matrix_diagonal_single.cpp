@@ -6,6 +6,7 @@
 
 #include "MPIutil.hpp"
 #include "constant.hpp"
+#include "simd_dispatch.hpp"
 #include "update_ops.hpp"
 #include "utility.hpp"
 #ifdef _OPENMP
@@ -25,16 +26,8 @@ void single_qubit_diagonal_matrix_gate(UINT target_qubit_index,
     OMPutil::get_inst().set_qulacs_num_threads(dim, 12);
 #endif
 
-#ifdef _USE_SIMD
-    single_qubit_diagonal_matrix_gate_parallel_simd(
-        target_qubit_index, diagonal_matrix, state, dim);
-#elif defined(_USE_SVE)
-    single_qubit_diagonal_matrix_gate_parallel_sve(
-        target_qubit_index, diagonal_matrix, state, dim);
-#else
-    single_qubit_diagonal_matrix_gate_parallel_unroll(
+    SIMDutil::get_inst().get_kernel_table().single_qubit_diagonal_matrix_gate(
         target_qubit_index, diagonal_matrix, state, dim);
-#endif
 
 #ifdef _OPENMP
     OMPutil::get_inst().reset_qulacs_num_threads();
@@ -68,6 +61,7 @@ void single_qubit_diagonal_matrix_gate_parallel_unroll(UINT target_qubit_index,
 }
 
 #ifdef _USE_SIMD
+QULACS_TARGET_AVX2
 void single_qubit_diagonal_matrix_gate_parallel_simd(UINT target_qubit_index,
     const CTYPE diagonal_matrix[2], CTYPE *state, ITYPE dim) {
     // loop variables
@@ -122,6 +116,69 @@ void single_qubit_diagonal_matrix_gate_parallel_simd(UINT target_qubit_index,
         }
     }
 }
+
+QULACS_TARGET_AVX512
+void single_qubit_diagonal_matrix_gate_parallel_avx512(UINT target_qubit_index,
+    const CTYPE diagonal_matrix[2], CTYPE *state, ITYPE dim) {
+    if (dim < 4) {
+        single_qubit_diagonal_matrix_gate_parallel_unroll(
+            target_qubit_index, diagonal_matrix, state, dim);
+        return;
+    }
+    // a register holds four amplitudes; the coefficient of each lane is
+    // chosen by the target bit of its index
+    const double r0 = _creal(diagonal_matrix[0]);
+    const double i0 = _cimag(diagonal_matrix[0]);
+    const double r1 = _creal(diagonal_matrix[1]);
+    const double i1 = _cimag(diagonal_matrix[1]);
+    ITYPE state_index;
+    if (target_qubit_index < 2) {
+        __m512d mr, mi;
+        if (target_qubit_index == 0) {
+            mr = _mm512_set_pd(r1, r1, r0, r0, r1, r1, r0, r0);
+            mi = _mm512_set_pd(i1, i1, i0, i0, i1, i1, i0, i0);
+        } else {
+            mr = _mm512_set_pd(r1, r1, r1, r1, r0, r0, r0, r0);
+            mi = _mm512_set_pd(i1, i1, i1, i1, i0, i0, i0, i0);
+        }
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (state_index = 0; state_index < dim; state_index += 4) {
+            double *ptr = (double *)(state + state_index);
+            __m512d data = _mm512_loadu_pd(ptr);
+            __m512d swap = _mm512_shuffle_pd(data, data, 0x55);
+            data = _mm512_fmaddsub_pd(data, mr, _mm512_mul_pd(swap, mi));
+            _mm512_storeu_pd(ptr, data);
+        }
+    } else {
+        const ITYPE loop_dim = dim / 2;
+        const ITYPE mask = 1ULL << target_qubit_index;
+        const ITYPE mask_low = mask - 1;
+        const ITYPE mask_high = ~mask_low;
+        const __m512d mr0 = _mm512_set1_pd(r0);
+        const __m512d mi0 = _mm512_set1_pd(i0);
+        const __m512d mr1 = _mm512_set1_pd(r1);
+        const __m512d mi1 = _mm512_set1_pd(i1);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+        for (state_index = 0; state_index < loop_dim; state_index += 4) {
+            ITYPE basis_0 =
+                (state_index & mask_low) + ((state_index & mask_high) << 1);
+            double *ptr0 = (double *)(state + basis_0);
+            double *ptr1 = (double *)(state + basis_0 + mask);
+            __m512d data0 = _mm512_loadu_pd(ptr0);
+            __m512d data1 = _mm512_loadu_pd(ptr1);
+            __m512d swap0 = _mm512_shuffle_pd(data0, data0, 0x55);
+            __m512d swap1 = _mm512_shuffle_pd(data1, data1, 0x55);
+            _mm512_storeu_pd(ptr0,
+                _mm512_fmaddsub_pd(data0, mr0, _mm512_mul_pd(swap0, mi0)));
+            _mm512_storeu_pd(ptr1,
+                _mm512_fmaddsub_pd(data1, mr1, _mm512_mul_pd(swap1, mi1)));
+        }
+    }
+}
 #endif
 
 #ifdef _USE_SVE
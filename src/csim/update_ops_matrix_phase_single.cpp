@@ -1,5 +1,6 @@
 
 #include "MPIutil.hpp"
+#include "simd_dispatch.hpp"
 #include "update_ops.hpp"
 #include "utility.hpp"
 
@@ -17,13 +18,8 @@ void single_qubit_phase_gate(
     OMPutil::get_inst().set_qulacs_num_threads(dim, 12);
 #endif
 
-#ifdef _USE_SIMD
-    single_qubit_phase_gate_parallel_simd(
-        target_qubit_index, phase, state, dim);
-#else
-    single_qubit_phase_gate_parallel_unroll(
+    SIMDutil::get_inst().get_kernel_table().single_qubit_phase_gate(
         target_qubit_index, phase, state, dim);
-#endif
 
 #ifdef _OPENMP
     OMPutil::get_inst().reset_qulacs_num_threads();
@@ -62,6 +58,7 @@ void single_qubit_phase_gate_parallel_unroll(
 }
 
 #ifdef _USE_SIMD
+QULACS_TARGET_AVX2
 void single_qubit_phase_gate_parallel_simd(
     UINT target_qubit_index, CTYPE phase, CTYPE* state, ITYPE dim) {
     // target tmask
@@ -100,6 +97,38 @@ void single_qubit_phase_gate_parallel_simd(
         }
     }
 }
+
+QULACS_TARGET_AVX512
+void single_qubit_phase_gate_parallel_avx512(
+    UINT target_qubit_index, CTYPE phase, CTYPE* state, ITYPE dim) {
+    if (target_qubit_index < 2) {
+        // both branches share a register
+        const CTYPE diagonal_matrix[2] = {1.0, phase};
+        single_qubit_diagonal_matrix_gate_parallel_avx512(
+            target_qubit_index, diagonal_matrix, state, dim);
+        return;
+    }
+    // only the half with the target bit set is touched
+    const ITYPE mask = 1ULL << target_qubit_index;
+    const ITYPE low_mask = mask - 1;
+    const ITYPE high_mask = ~low_mask;
+    const ITYPE loop_dim = dim / 2;
+    const __m512d mr = _mm512_set1_pd(_creal(phase));
+    const __m512d mi = _mm512_set1_pd(_cimag(phase));
+    ITYPE state_index;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (state_index = 0; state_index < loop_dim; state_index += 4) {
+        ITYPE basis =
+            (state_index & low_mask) + ((state_index & high_mask) << 1) + mask;
+        double* ptr = (double*)(state + basis);
+        __m512d data = _mm512_loadu_pd(ptr);
+        __m512d swap = _mm512_shuffle_pd(data, data, 0x55);
+        _mm512_storeu_pd(
+            ptr, _mm512_fmaddsub_pd(data, mr, _mm512_mul_pd(swap, mi)));
+    }
+}
 #endif
 
 #ifdef _USE_MPI
@@ -4,6 +4,7 @@
 
 #include "MPIutil.hpp"
 #include "constant.hpp"
+#include "simd_dispatch.hpp"
 #include "update_ops.hpp"
 #include "utility.hpp"
 #ifdef _OPENMP
@@ -24,15 +25,8 @@ void CNOT_gate(UINT control_qubit_index, UINT target_qubit_index, CTYPE* state,
     OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
 #endif
 
-#ifdef _USE_SIMD
-    CNOT_gate_parallel_simd(
-        control_qubit_index, target_qubit_index, state, dim);
-#elif defined(_USE_SVE)
-    CNOT_gate_parallel_sve(control_qubit_index, target_qubit_index, state, dim);
-#else
-    CNOT_gate_parallel_unroll(
+    SIMDutil::get_inst().get_kernel_table().CNOT_gate(
         control_qubit_index, target_qubit_index, state, dim);
-#endif
 
 #ifdef _OPENMP
     OMPutil::get_inst().reset_qulacs_num_threads();
@@ -104,6 +98,7 @@ void CNOT_gate_parallel_unroll(UINT control_qubit_index,
 }
 
 #ifdef _USE_SIMD
+QULACS_TARGET_AVX2
 void CNOT_gate_parallel_simd(UINT control_qubit_index, UINT target_qubit_index,
     CTYPE* state, ITYPE dim) {
     const ITYPE loop_dim = dim / 4;
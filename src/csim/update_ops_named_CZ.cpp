@@ -1,5 +1,6 @@
 
 #include "MPIutil.hpp"
+#include "simd_dispatch.hpp"
 #include "update_ops.hpp"
 #include "utility.hpp"
 
@@ -17,14 +18,8 @@ void CZ_gate(UINT control_qubit_index, UINT target_qubit_index, CTYPE* state,
     OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
 #endif
 
-#ifdef _USE_SIMD
-    CZ_gate_parallel_simd(control_qubit_index, target_qubit_index, state, dim);
-#elif defined(_USE_SVE)
-    CZ_gate_parallel_sve(control_qubit_index, target_qubit_index, state, dim);
-#else
-    CZ_gate_parallel_unroll(
+    SIMDutil::get_inst().get_kernel_table().CZ_gate(
         control_qubit_index, target_qubit_index, state, dim);
-#endif
 
 #ifdef _OPENMP
     OMPutil::get_inst().reset_qulacs_num_threads();
@@ -75,6 +70,7 @@ void CZ_gate_parallel_unroll(UINT control_qubit_index, UINT target_qubit_index,
 }
 
 #ifdef _USE_SIMD
+QULACS_TARGET_AVX2
 void CZ_gate_parallel_simd(UINT control_qubit_index, UINT target_qubit_index,
     CTYPE* state, ITYPE dim) {
     const ITYPE loop_dim = dim / 4;
@@ -1,5 +1,6 @@
 
 #include "MPIutil.hpp"
+#include "simd_dispatch.hpp"
 #include "update_ops.hpp"
 #include "utility.hpp"
 
@@ -16,13 +17,8 @@ void H_gate(UINT target_qubit_index, CTYPE *state, ITYPE dim) {
     OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
 #endif
 
-#ifdef _USE_SIMD
-    H_gate_parallel_simd(target_qubit_index, state, dim);
-#elif defined(_USE_SVE)
-    H_gate_parallel_sve(target_qubit_index, state, dim);
-#else
-    H_gate_parallel_unroll(target_qubit_index, state, dim);
-#endif
+    SIMDutil::get_inst().get_kernel_table().H_gate(
+        target_qubit_index, state, dim);
 
 #ifdef _OPENMP
     OMPutil::get_inst().reset_qulacs_num_threads();
@@ -68,6 +64,7 @@ void H_gate_parallel_unroll(UINT target_qubit_index, CTYPE *state, ITYPE dim) {
 }
 
 #ifdef _USE_SIMD
+QULACS_TARGET_AVX2
 void H_gate_parallel_simd(UINT target_qubit_index, CTYPE *state, ITYPE dim) {
     const ITYPE loop_dim = dim / 2;
     const ITYPE mask = (1ULL << target_qubit_index);
@@ -3,6 +3,7 @@
 
 #include "MPIutil.hpp"
 #include "constant.hpp"
+#include "simd_dispatch.hpp"
 #include "update_ops.hpp"
 #include "utility.hpp"
 #ifdef _OPENMP
@@ -23,16 +24,8 @@ void SWAP_gate(UINT target_qubit_index_0, UINT target_qubit_index_1,
     OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
 #endif
 
-#ifdef _USE_SIMD
-    SWAP_gate_parallel_simd(
-        target_qubit_index_0, target_qubit_index_1, state, dim);
-#elif defined(_USE_SVE)
-    SWAP_gate_parallel_sve(
+    SIMDutil::get_inst().get_kernel_table().SWAP_gate(
         target_qubit_index_0, target_qubit_index_1, state, dim);
-#else
-    SWAP_gate_parallel_unroll(
-        target_qubit_index_0, target_qubit_index_1, state, dim);
-#endif
 
 #ifdef _OPENMP
     OMPutil::get_inst().reset_qulacs_num_threads();
@@ -92,6 +85,7 @@ void SWAP_gate_parallel_unroll(UINT target_qubit_index_0,
 }
 
 #ifdef _USE_SIMD
+QULACS_TARGET_AVX2
 void SWAP_gate_parallel_simd(UINT target_qubit_index_0,
     UINT target_qubit_index_1, CTYPE* state, ITYPE dim) {
     const ITYPE loop_dim = dim / 4;
@@ -3,6 +3,7 @@
 
 #include "MPIutil.hpp"
 #include "constant.hpp"
+#include "simd_dispatch.hpp"
 #include "update_ops.hpp"
 #include "utility.hpp"
 #ifdef _OPENMP
@@ -22,13 +23,8 @@ void X_gate(UINT target_qubit_index, CTYPE* state, ITYPE dim) {
     OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
 #endif
 
-#ifdef _USE_SIMD
-    X_gate_parallel_simd(target_qubit_index, state, dim);
-#elif defined(_USE_SVE)
-    X_gate_parallel_sve(target_qubit_index, state, dim);
-#else
-    X_gate_parallel_unroll(target_qubit_index, state, dim);
-#endif
+    SIMDutil::get_inst().get_kernel_table().X_gate(
+        target_qubit_index, state, dim);
 
 #ifdef _OPENMP
     OMPutil::get_inst().reset_qulacs_num_threads();
@@ -66,6 +62,7 @@ void X_gate_parallel_unroll(UINT target_qubit_index, CTYPE* state, ITYPE dim) {
 }
 
 #ifdef _USE_SIMD
+QULACS_TARGET_AVX2
 void X_gate_parallel_simd(UINT target_qubit_index, CTYPE* state, ITYPE dim) {
     const ITYPE loop_dim = dim / 2;
     const ITYPE mask = (1ULL << target_qubit_index);
@@ -1,6 +1,7 @@
 
 #include "MPIutil.hpp"
 #include "constant.hpp"
+#include "simd_dispatch.hpp"
 #include "update_ops.hpp"
 #include "utility.hpp"
 #ifdef _OPENMP
@@ -20,13 +21,8 @@ void Z_gate(UINT target_qubit_index, CTYPE* state, ITYPE dim) {
     OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
 #endif
 
-#ifdef _USE_SIMD
-    Z_gate_parallel_simd(target_qubit_index, state, dim);
-#elif defined(_USE_SVE)
-    Z_gate_parallel_sve(target_qubit_index, state, dim);
-#else
-    Z_gate_parallel_unroll(target_qubit_index, state, dim);
-#endif
+    SIMDutil::get_inst().get_kernel_table().Z_gate(
+        target_qubit_index, state, dim);
 
 #ifdef _OPENMP
     OMPutil::get_inst().reset_qulacs_num_threads();
@@ -60,6 +56,7 @@ void Z_gate_parallel_unroll(UINT target_qubit_index, CTYPE* state, ITYPE dim) {
 }
 
 #ifdef _USE_SIMD
+QULACS_TARGET_AVX2
 void Z_gate_parallel_simd(UINT target_qubit_index, CTYPE* state, ITYPE dim) {
     const ITYPE loop_dim = dim / 2;
     const ITYPE mask = (1ULL << target_qubit_index);
@@ -1,4 +1,6 @@
 
+#include <math.h>
+
 #include "MPIutil.hpp"
 #include "update_ops.hpp"
 #include "utility.hpp"
@@ -69,6 +71,54 @@ void P1_gate_parallel(UINT target_qubit_index, CTYPE* state, ITYPE dim) {
     }
 }
 
+UINT single_qubit_measurement(
+    UINT target_qubit_index, double random_value, CTYPE* state, ITYPE dim) {
+    const ITYPE loop_dim = dim / 2;
+    const ITYPE mask = (1ULL << target_qubit_index);
+    const ITYPE low_mask = mask - 1;
+    const ITYPE high_mask = ~low_mask;
+
+    ITYPE state_index;
+    double prob_0 = 0., prob_1 = 0.;
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 10);
+#pragma omp parallel for reduction(+ : prob_0, prob_1)
+#endif
+    for (state_index = 0; state_index < loop_dim; ++state_index) {
+        ITYPE basis_0 =
+            (state_index & low_mask) + ((state_index & high_mask) << 1);
+        ITYPE basis_1 = basis_0 + mask;
+        prob_0 += _creal(state[basis_0]) * _creal(state[basis_0]) +
+                  _cimag(state[basis_0]) * _cimag(state[basis_0]);
+        prob_1 += _creal(state[basis_1]) * _creal(state[basis_1]) +
+                  _cimag(state[basis_1]) * _cimag(state[basis_1]);
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+
+    const double squared_norm = prob_0 + prob_1;
+    const UINT outcome = (random_value < prob_0 / squared_norm) ? 0 : 1;
+    const double coef =
+        sqrt(squared_norm / ((outcome == 0) ? prob_0 : prob_1));
+    const ITYPE keep_offset = (outcome == 0) ? 0 : mask;
+
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 13);
+#pragma omp parallel for
+#endif
+    for (state_index = 0; state_index < loop_dim; ++state_index) {
+        ITYPE basis_0 =
+            (state_index & low_mask) + ((state_index & high_mask) << 1);
+        state[basis_0 + keep_offset] *= coef;
+        state[basis_0 + (mask - keep_offset)] = 0;
+    }
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+    return outcome;
+}
+
 #ifdef _USE_MPI
 void P0_gate_mpi(
     UINT target_qubit_index, CTYPE* state, ITYPE dim, UINT inner_qc) {
@@ -456,3 +456,154 @@ void multi_qubit_Pauli_rotation_gate_whole_list_single_thread(
             state, dim);
     }
 }
+
+// Output amplitudes are computed in blocks of this size, so that the block of
+// dst_state and the coefficient sums of a group stay in cache.
+static const UINT PAULI_SUM_BLOCK_QUBIT_COUNT = 10;
+
+static void multi_qubit_Pauli_operator_sum_XZ_mask_impl(
+    const ITYPE* bit_flip_mask_list, const UINT* group_begin_list,
+    UINT group_count, const ITYPE* phase_flip_mask_list,
+    const UINT* global_phase_90rot_count_list, const CTYPE* coef_list,
+    const CTYPE* state, CTYPE* dst_state, ITYPE dim) {
+    // (P state)[basis] = (-i)^{global_phase_90rot_count}
+    // (-1)^{popcount(basis & phase_flip_mask)} state[basis ^ bit_flip_mask],
+    // so the constant phase is folded into the coefficient
+    const UINT term_count = group_begin_list[group_count];
+    double* coef_re = (double*)malloc(sizeof(double) * term_count);
+    double* coef_im = (double*)malloc(sizeof(double) * term_count);
+    for (UINT term = 0; term < term_count; ++term) {
+        const CTYPE coef =
+            coef_list[term] *
+            PHASE_M90ROT[global_phase_90rot_count_list[term] % 4];
+        coef_re[term] = _creal(coef);
+        coef_im[term] = _cimag(coef);
+    }
+
+    UINT block_qubit_count = PAULI_SUM_BLOCK_QUBIT_COUNT;
+    while ((1ULL << block_qubit_count) > dim) --block_qubit_count;
+    const ITYPE block_dim = 1ULL << block_qubit_count;
+    const ITYPE block_mask = block_dim - 1;
+    const ITYPE block_count = dim / block_dim;
+    ITYPE block;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+        // factor[offset] = sum_term coef * (-1)^{popcount(basis &
+        // phase_flip_mask)} of the current group and block
+        double* factor_re = (double*)malloc(sizeof(double) * block_dim);
+        double* factor_im = (double*)malloc(sizeof(double) * block_dim);
+#ifdef _OPENMP
+#pragma omp for
+#endif
+        for (block = 0; block < block_count; ++block) {
+            const ITYPE block_begin = block * block_dim;
+            double* dst = (double*)(dst_state + block_begin);
+            for (ITYPE index = 0; index < 2 * block_dim; ++index) {
+                dst[index] = 0.;
+            }
+            for (UINT group = 0; group < group_count; ++group) {
+                for (ITYPE offset = 0; offset < block_dim; ++offset) {
+                    factor_re[offset] = 0.;
+                    factor_im[offset] = 0.;
+                }
+                const UINT term_begin = group_begin_list[group];
+                const UINT term_end = group_begin_list[group + 1];
+                const bool use_transform =
+                    (term_end - term_begin) > block_qubit_count;
+                for (UINT term = term_begin; term < term_end; ++term) {
+                    // the sign of the bits above the block is common
+                    const ITYPE phase_flip_mask = phase_flip_mask_list[term];
+                    const double sign =
+                        1. - 2. * count_population_parity(
+                                      block_begin & phase_flip_mask);
+                    const double re = sign * coef_re[term];
+                    const double im = sign * coef_im[term];
+                    const ITYPE low_mask = phase_flip_mask & block_mask;
+                    if (use_transform) {
+                        factor_re[low_mask] += re;
+                        factor_im[low_mask] += im;
+                        continue;
+                    }
+                    for (ITYPE offset = 0; offset < block_dim; ++offset) {
+                        const double offset_sign =
+                            1. -
+                            2. * count_population_parity(offset & low_mask);
+                        factor_re[offset] += offset_sign * re;
+                        factor_im[offset] += offset_sign * im;
+                    }
+                }
+                if (use_transform) {
+                    // Walsh-Hadamard transform of the coefficients gathered
+                    // by the phase flip mask within the block
+                    for (ITYPE half = 1; half < block_dim; half <<= 1) {
+                        for (ITYPE begin = 0; begin < block_dim;
+                             begin += 2 * half) {
+                            for (ITYPE offset = begin; offset < begin + half;
+                                 ++offset) {
+                                const double re_0 = factor_re[offset];
+                                const double im_0 = factor_im[offset];
+                                const double re_1 = factor_re[offset + half];
+                                const double im_1 = factor_im[offset + half];
+                                factor_re[offset] = re_0 + re_1;
+                                factor_im[offset] = im_0 + im_1;
+                                factor_re[offset + half] = re_0 - re_1;
+                                factor_im[offset + half] = im_0 - im_1;
+                            }
+                        }
+                    }
+                }
+                const CTYPE* src =
+                    state + (block_begin ^ (bit_flip_mask_list[group] &
+                                               ~block_mask));
+                const ITYPE low_bit_flip_mask =
+                    bit_flip_mask_list[group] & block_mask;
+                for (ITYPE offset = 0; offset < block_dim; ++offset) {
+                    const double re = _creal(src[offset ^ low_bit_flip_mask]);
+                    const double im = _cimag(src[offset ^ low_bit_flip_mask]);
+                    dst[2 * offset] += factor_re[offset] * re -
+                                       factor_im[offset] * im;
+                    dst[2 * offset + 1] += factor_re[offset] * im +
+                                           factor_im[offset] * re;
+                }
+            }
+        }
+        free(factor_re);
+        free(factor_im);
+    }
+    free(coef_im);
+    free(coef_re);
+}
+
+void multi_qubit_Pauli_operator_sum_XZ_mask(const ITYPE* bit_flip_mask_list,
+    const UINT* group_begin_list, UINT group_count,
+    const ITYPE* phase_flip_mask_list,
+    const UINT* global_phase_90rot_count_list, const CTYPE* coef_list,
+    const CTYPE* state, CTYPE* dst_state, ITYPE dim) {
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(dim, 12);
+#endif
+    multi_qubit_Pauli_operator_sum_XZ_mask_impl(bit_flip_mask_list,
+        group_begin_list, group_count, phase_flip_mask_list,
+        global_phase_90rot_count_list, coef_list, state, dst_state, dim);
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
+
+void multi_qubit_Pauli_operator_sum_XZ_mask_single_thread(
+    const ITYPE* bit_flip_mask_list, const UINT* group_begin_list,
+    UINT group_count, const ITYPE* phase_flip_mask_list,
+    const UINT* global_phase_90rot_count_list, const CTYPE* coef_list,
+    const CTYPE* state, CTYPE* dst_state, ITYPE dim) {
+#ifdef _OPENMP
+    OMPutil::get_inst().set_qulacs_num_threads(1, 1);
+#endif
+    multi_qubit_Pauli_operator_sum_XZ_mask_impl(bit_flip_mask_list,
+        group_begin_list, group_count, phase_flip_mask_list,
+        global_phase_90rot_count_list, coef_list, state, dst_state, dim);
+#ifdef _OPENMP
+    OMPutil::get_inst().reset_qulacs_num_threads();
+#endif
+}
@@ -67,6 +67,21 @@ inline static UINT count_population(ITYPE x) {
     return (UINT)x;
 }
 
+// parity of the number of set bits
+inline static UINT count_population_parity(ITYPE x) {
+#if defined(__GNUC__)
+    return (UINT)__builtin_parityll(x);
+#else
+    x ^= x >> 32;
+    x ^= x >> 16;
+    x ^= x >> 8;
+    x ^= x >> 4;
+    x ^= x >> 2;
+    x ^= x >> 1;
+    return (UINT)(x & 1);
+#endif
+}
+
 void sort_ui(UINT* array, size_t array_size);
 UINT* create_sorted_ui_list(const UINT* array, size_t size);
 UINT* create_sorted_ui_list_value(const UINT* array, size_t size, UINT value);
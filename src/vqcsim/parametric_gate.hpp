@@ -8,6 +8,7 @@
 #include <cppsim/utility.hpp>
 #include <csim/update_ops.hpp>
 #include <csim/update_ops_dm.hpp>
+#include <csim/update_ops_float.hpp>
 
 #ifdef _USE_GPU
 #include <gpusim/update_ops_cuda.h>
@@ -44,6 +45,10 @@ protected:
 
 public:
     virtual void update_quantum_state(QuantumStateBase* state) override {
+        if (state->is_single_precision()) {
+            this->update_single_precision_state(state);
+            return;
+        }
         if (state->is_state_vector()) {
 #ifdef _USE_GPU
             if (state->get_device_name() == "gpu") {
@@ -237,6 +242,13 @@ public:
     virtual void update_quantum_state(QuantumStateBase* state) override {
         auto target_index_list = _pauli->get_index_list();
         auto pauli_id_list = _pauli->get_pauli_id_list();
+        if (state->is_single_precision() && state->is_state_vector()) {
+            float_multi_qubit_Pauli_rotation_gate_partial_list(
+                target_index_list.data(), pauli_id_list.data(),
+                (UINT)target_index_list.size(), _angle,
+                reinterpret_cast<CTYPE_F*>(state->data()), state->dim);
+            return;
+        }
         if (state->is_state_vector()) {
 #ifdef _USE_GPU
             if (state->get_device_name() == "gpu") {
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <cppsim/cache_blocked_executor.hpp>
+#include <cppsim/circuit.hpp>
+#include <cppsim/gate_factory.hpp>
+#include <cppsim/state.hpp>
+#include <cppsim/utility.hpp>
+
+#include "../util/util.hpp"
+
+TEST(CacheBlockedExecutorTest, MatchCircuitUpdate) {
+    const UINT n = 8;
+    const UINT block = 4;
+    const double eps = 1e-12;
+    Random random;
+
+    QuantumCircuit circuit(n);
+    for (UINT depth = 0; depth < 5; ++depth) {
+        for (UINT i = 0; i < block; ++i) {
+            circuit.add_H_gate(i);
+            circuit.add_RX_gate(i, random.uniform() * 3.14);
+            circuit.add_T_gate(i);
+        }
+        circuit.add_CNOT_gate(0, 1);
+        circuit.add_CZ_gate(3, 2);
+        circuit.add_SWAP_gate(1, 3);
+        circuit.add_multi_Pauli_rotation_gate({0, 2}, {1, 3}, 0.3);
+        circuit.add_random_unitary_gate({0, 1, 3});
+        auto matrix_gate = gate::RandomUnitary({2});
+        matrix_gate->add_control_qubit(0, 1);
+        circuit.add_gate(matrix_gate);
+        circuit.add_gate(gate::DiagonalMatrix(
+            {1, 3}, ComplexVector::Random(4).normalized()));
+        // a gate on a high qubit splits the segment
+        circuit.add_CNOT_gate(2, n - 1 - depth % 3);
+        circuit.add_RY_gate(n - 1, 0.7);
+    }
+
+    QuantumState expected(n), actual(n);
+    expected.set_Haar_random_state(0);
+    actual.load(&expected);
+    circuit.update_quantum_state(&expected);
+
+    CacheBlockedExecutor executor(block);
+    ASSERT_EQ(executor.get_block_qubit_count(), block);
+    executor.update_quantum_state(&circuit, &actual);
+
+    for (ITYPE i = 0; i < expected.dim; ++i) {
+        ASSERT_NEAR(abs(expected.data_cpp()[i] - actual.data_cpp()[i]), 0, eps);
+    }
+
+    const auto& report = executor.get_last_report();
+    ASSERT_EQ(report.segment_count, 5);
+    ASSERT_EQ(report.blocked_gate_count + report.unblocked_gate_count,
+        circuit.gate_list.size());
+    ASSERT_EQ(report.unblocked_gate_count, 10);
+    ASSERT_LT(report.transferred_bytes, report.unblocked_transferred_bytes);
+}
+
+TEST(CacheBlockedExecutorTest, NonBlockableGates) {
+    const UINT block = 4;
+    auto measurement = gate::Measurement(0, 0);
+    auto noise = gate::DepolarizingNoise(0, 0.1);
+    auto high = gate::X(block);
+    auto low = gate::X(block - 1);
+    auto wide = gate::RandomUnitary({0, 1, 2, 3, 4});
+
+    ASSERT_FALSE(CacheBlockedExecutor::is_blockable(measurement, block));
+    ASSERT_FALSE(CacheBlockedExecutor::is_blockable(noise, block));
+    ASSERT_FALSE(CacheBlockedExecutor::is_blockable(high, block));
+    ASSERT_TRUE(CacheBlockedExecutor::is_blockable(low, block));
+    ASSERT_FALSE(CacheBlockedExecutor::is_blockable(wide, 8));
+
+    delete measurement;
+    delete noise;
+    delete high;
+    delete low;
+    delete wide;
+}
+
+TEST(CacheBlockedExecutorTest, SmallState) {
+    // states which fit in a chunk are updated gate by gate
+    const UINT n = 3;
+    QuantumCircuit circuit(n);
+    circuit.add_H_gate(0);
+    circuit.add_CNOT_gate(0, 1);
+    circuit.add_CNOT_gate(1, 2);
+
+    QuantumState expected(n), actual(n);
+    circuit.update_quantum_state(&expected);
+    CacheBlockedExecutor executor(4);
+    executor.update_quantum_state(&circuit, &actual);
+
+    for (ITYPE i = 0; i < expected.dim; ++i) {
+        ASSERT_NEAR(abs(expected.data_cpp()[i] - actual.data_cpp()[i]), 0,
+            1e-12);
+    }
+    ASSERT_EQ(executor.get_last_report().segment_count, 0);
+    ASSERT_EQ(executor.get_last_report().unblocked_gate_count, 3);
+}
@@ -3,12 +3,15 @@
 
 #include <cppsim/circuit.hpp>
 #include <cppsim/circuit_optimizer.hpp>
+#include <cppsim/compiled_circuit.hpp>
+#include <cppsim/gate_cost_model.hpp>
 #include <cppsim/gate_factory.hpp>
 #include <cppsim/gate_matrix.hpp>
 #include <cppsim/gate_merge.hpp>
 #include <cppsim/observable.hpp>
 #include <cppsim/pauli_operator.hpp>
 #include <cppsim/state.hpp>
+#include <cppsim/state_dm.hpp>
 #include <cppsim/type.hpp>
 #include <cppsim/utility.hpp>
 #include <csim/constant.hpp>
@@ -819,6 +822,422 @@ TEST(CircuitTest, RandomCircuitOptimize3) {
     }
 }
 
+TEST(CircuitTest, LargeCircuitOptimize) {
+    // the optimization scales to circuits which the pairwise scan could not
+    // handle in a test
+    const UINT n = 6;
+    const UINT gate_count = 20000;
+    Random random;
+    random.set_seed(0);
+
+    QuantumCircuit circuit(n);
+    for (UINT i = 0; i < gate_count; ++i) {
+        const UINT target = random.int32() % n;
+        const UINT control = (target + 1 + random.int32() % (n - 1)) % n;
+        switch (random.int32() % 6) {
+            case 0:
+                circuit.add_RX_gate(target, random.uniform());
+                break;
+            case 1:
+                circuit.add_RZ_gate(target, random.uniform());
+                break;
+            case 2:
+                circuit.add_H_gate(target);
+                break;
+            case 3:
+                circuit.add_CNOT_gate(control, target);
+                break;
+            case 4:
+                circuit.add_CZ_gate(control, target);
+                break;
+            default:
+                circuit.add_gate(gate::Identity(target));
+                break;
+        }
+    }
+
+    QuantumState org_state(n), test_state(n), state(n);
+    org_state.set_Haar_random_state(0);
+    test_state.load(&org_state);
+    circuit.update_quantum_state(&test_state);
+    QuantumCircuitOptimizer qco;
+    for (UINT block_size = 1; block_size <= 3; ++block_size) {
+        QuantumCircuit* copy_circuit = circuit.copy();
+        qco.optimize(copy_circuit, block_size);
+        ASSERT_LT(copy_circuit->gate_list.size(), gate_count);
+        state.load(&org_state);
+        copy_circuit->update_quantum_state(&state);
+        ASSERT_STATE_NEAR(state, test_state, eps);
+        delete copy_circuit;
+    }
+}
+
+TEST(CircuitTest, OptimizeWithCostModel) {
+    const UINT n = 6;
+    const UINT gate_count = 2000;
+    Random random;
+    random.set_seed(0);
+
+    QuantumCircuit circuit(n);
+    for (UINT i = 0; i < gate_count; ++i) {
+        const UINT target = random.int32() % n;
+        const UINT control = (target + 1 + random.int32() % (n - 1)) % n;
+        switch (random.int32() % 5) {
+            case 0:
+                circuit.add_RX_gate(target, random.uniform());
+                break;
+            case 1:
+                circuit.add_RZ_gate(target, random.uniform());
+                break;
+            case 2:
+                circuit.add_H_gate(target);
+                break;
+            case 3:
+                circuit.add_CNOT_gate(control, target);
+                break;
+            default:
+                circuit.add_CZ_gate(control, target);
+                break;
+        }
+    }
+
+    QuantumState org_state(n), test_state(n), state(n);
+    org_state.set_Haar_random_state(0);
+    test_state.load(&org_state);
+    circuit.update_quantum_state(&test_state);
+
+    GateCostModel cost_model(n, 3);
+    ASSERT_EQ(cost_model.get_max_target_count(), 3);
+    QuantumCircuitOptimizer qco;
+    qco.optimize_with_cost_model(&circuit, cost_model);
+    ASSERT_LE(circuit.gate_list.size(), gate_count);
+    state.load(&org_state);
+    circuit.update_quantum_state(&state);
+    ASSERT_STATE_NEAR(state, test_state, eps);
+
+    QuantumCircuit wrong_circuit(n + 1);
+    ASSERT_THROW(qco.optimize_with_cost_model(&wrong_circuit, cost_model),
+        InvalidQubitCountException);
+}
+
+TEST(CircuitTest, OptimizeWithCostModelKeepsStructure) {
+    const UINT n = 4;
+    GateCostModel cost_model(n, 3, false);
+    for (UINT target_count = 1; target_count <= 3; ++target_count) {
+        cost_model.set_kernel_time(
+            GateCostModel::NAMED_KERNEL, target_count, 1.);
+        cost_model.set_kernel_time(
+            GateCostModel::DIAGONAL_KERNEL, target_count, 0.1);
+        cost_model.set_kernel_time(
+            GateCostModel::CONTROLLED_KERNEL, target_count, 0.5);
+        cost_model.set_kernel_time(
+            GateCostModel::DENSE_KERNEL, target_count, 10.);
+    }
+    QuantumCircuitOptimizer qco;
+    QuantumState org_state(n), test_state(n), state(n);
+    org_state.set_Haar_random_state(0);
+
+    // a run of Z-diagonal gates becomes one diagonal matrix gate, while
+    // merging Hadamard gates into a dense matrix is predicted to be slower
+    QuantumCircuit diagonal_circuit(n);
+    diagonal_circuit.add_RZ_gate(0, 0.1);
+    diagonal_circuit.add_RZ_gate(1, 0.2);
+    diagonal_circuit.add_CZ_gate(0, 1);
+    diagonal_circuit.add_T_gate(0);
+    diagonal_circuit.add_H_gate(2);
+    diagonal_circuit.add_H_gate(3);
+    test_state.load(&org_state);
+    diagonal_circuit.update_quantum_state(&test_state);
+    qco.optimize_with_cost_model(&diagonal_circuit, cost_model);
+    ASSERT_EQ(diagonal_circuit.gate_list.size(), 3);
+    ASSERT_EQ(diagonal_circuit.gate_list[0]->get_name(), "DiagonalMatrix");
+    ASSERT_EQ(diagonal_circuit.gate_list[0]->target_qubit_list.size(), 2);
+    ASSERT_EQ(diagonal_circuit.gate_list[1]->get_name(), "H");
+    ASSERT_EQ(diagonal_circuit.gate_list[2]->get_name(), "H");
+    state.load(&org_state);
+    diagonal_circuit.update_quantum_state(&state);
+    ASSERT_STATE_NEAR(state, test_state, eps);
+
+    // gates with a common control merge into a controlled matrix gate
+    QuantumCircuit control_circuit(n);
+    control_circuit.add_CNOT_gate(2, 0);
+    control_circuit.add_CNOT_gate(2, 1);
+    test_state.load(&org_state);
+    control_circuit.update_quantum_state(&test_state);
+    qco.optimize_with_cost_model(&control_circuit, cost_model);
+    ASSERT_EQ(control_circuit.gate_list.size(), 1);
+    ASSERT_EQ(control_circuit.gate_list[0]->control_qubit_list.size(), 1);
+    ASSERT_EQ(control_circuit.gate_list[0]->target_qubit_list.size(), 2);
+    state.load(&org_state);
+    control_circuit.update_quantum_state(&state);
+    ASSERT_STATE_NEAR(state, test_state, eps);
+}
+
+TEST(CircuitTest, OptimizePeephole) {
+    const UINT n = 3;
+    QuantumCircuitOptimizer qco;
+    QuantumState org_state(n), test_state(n), state(n);
+    org_state.set_Haar_random_state(0);
+    auto optimize = [&](QuantumCircuit& circuit) {
+        test_state.load(&org_state);
+        circuit.update_quantum_state(&test_state);
+        qco.optimize_peephole(&circuit);
+        state.load(&org_state);
+        circuit.update_quantum_state(&state);
+        ASSERT_STATE_NEAR(state, test_state, eps);
+    };
+
+    // inverse pairs cancel, which lets outer pairs cancel as well
+    QuantumCircuit inverse_circuit(n);
+    inverse_circuit.add_H_gate(0);
+    inverse_circuit.add_CNOT_gate(0, 1);
+    inverse_circuit.add_RZ_gate(2, 0.1);
+    inverse_circuit.add_CNOT_gate(0, 1);
+    inverse_circuit.add_H_gate(0);
+    inverse_circuit.add_multi_Pauli_rotation_gate({0, 2}, {1, 3}, 0.3);
+    inverse_circuit.add_multi_Pauli_rotation_gate({0, 2}, {1, 3}, -0.3);
+    optimize(inverse_circuit);
+    ASSERT_EQ(inverse_circuit.gate_list.size(), 1);
+    ASSERT_EQ(inverse_circuit.gate_list[0]->get_name(), "Z-rotation");
+
+    // rotations on the same axis are summed
+    QuantumCircuit rotation_circuit(n);
+    rotation_circuit.add_RX_gate(0, 0.1);
+    rotation_circuit.add_CNOT_gate(1, 0);
+    rotation_circuit.add_RX_gate(0, 0.2);
+    rotation_circuit.add_RY_gate(1, 0.3);
+    optimize(rotation_circuit);
+    ASSERT_EQ(rotation_circuit.gate_list.size(), 3);
+    UINT rotation_count = 0;
+    for (auto gate : rotation_circuit.gate_list) {
+        if (gate->get_name() == "X-rotation") ++rotation_count;
+    }
+    ASSERT_EQ(rotation_count, 1);
+
+    // diagonal gates commute with each other and form a diagonal matrix
+    QuantumCircuit diagonal_circuit(n);
+    diagonal_circuit.add_RZ_gate(0, 0.1);
+    diagonal_circuit.add_X_gate(2);
+    diagonal_circuit.add_CZ_gate(0, 1);
+    diagonal_circuit.add_T_gate(1);
+    diagonal_circuit.add_S_gate(0);
+    optimize(diagonal_circuit);
+    ASSERT_EQ(diagonal_circuit.gate_list.size(), 2);
+    UINT diagonal_count = 0;
+    for (auto gate : diagonal_circuit.gate_list) {
+        if (gate->get_name() == "DiagonalMatrix") ++diagonal_count;
+    }
+    ASSERT_EQ(diagonal_count, 1);
+
+    // a product of named gates keeps a named form
+    QuantumCircuit named_circuit(n);
+    named_circuit.add_S_gate(0);
+    named_circuit.add_S_gate(0);
+    optimize(named_circuit);
+    ASSERT_EQ(named_circuit.gate_list.size(), 1);
+    ASSERT_EQ(named_circuit.gate_list[0]->get_name(), "Z");
+
+    // matrix gates are replaced with specialized gates
+    QuantumCircuit matrix_circuit(n);
+    matrix_circuit.add_gate(gate::to_matrix_gate(gate::SWAP(0, 1)));
+    matrix_circuit.add_gate(gate::to_matrix_gate(gate::Pauli({0, 2}, {1, 2})));
+    matrix_circuit.add_gate(gate::to_matrix_gate(gate::CNOT(2, 1)));
+    matrix_circuit.add_gate(gate::to_matrix_gate(gate::T(2)));
+    matrix_circuit.add_gate(gate::to_matrix_gate(gate::Identity(1)));
+    optimize(matrix_circuit);
+    std::vector<std::string> name_list;
+    for (auto gate : matrix_circuit.gate_list) {
+        name_list.push_back(gate->get_name());
+    }
+    ASSERT_EQ(name_list,
+        std::vector<std::string>({"SWAP", "Pauli", "CNOT", "T"}));
+
+    // a controlled diagonal matrix is CZ only if it keeps |0> unchanged
+    QuantumCircuit controlled_circuit(n);
+    ComplexMatrix diagonal_matrix = ComplexMatrix::Zero(2, 2);
+    diagonal_matrix << -1, 0, 0, -1;
+    auto controlled_gate = gate::DenseMatrix(1, diagonal_matrix);
+    controlled_gate->add_control_qubit(0, 1);
+    controlled_circuit.add_gate(controlled_gate);
+    optimize(controlled_circuit);
+    ASSERT_EQ(controlled_circuit.gate_list.size(), 1);
+    ASSERT_NE(controlled_circuit.gate_list[0]->get_name(), "CZ");
+}
+
+TEST(CircuitTest, RandomCircuitOptimizePeephole) {
+    const UINT n = 5;
+    const UINT gate_count = 2000;
+    Random random;
+    random.set_seed(0);
+
+    QuantumCircuit circuit(n);
+    for (UINT i = 0; i < gate_count; ++i) {
+        const UINT target = random.int32() % n;
+        const UINT control = (target + 1 + random.int32() % (n - 1)) % n;
+        switch (random.int32() % 8) {
+            case 0:
+                circuit.add_RZ_gate(target, random.uniform());
+                break;
+            case 1:
+                circuit.add_RX_gate(target, random.uniform());
+                break;
+            case 2:
+                circuit.add_H_gate(target);
+                break;
+            case 3:
+                circuit.add_CNOT_gate(control, target);
+                break;
+            case 4:
+                circuit.add_CZ_gate(control, target);
+                break;
+            case 5:
+                circuit.add_S_gate(target);
+                break;
+            case 6:
+                circuit.add_gate(
+                    gate::to_matrix_gate(gate::SWAP(target, control)));
+                break;
+            default:
+                circuit.add_gate(gate::merge(
+                    gate::CZ(control, target), gate::RZ(target, 0.3)));
+                break;
+        }
+    }
+
+    QuantumState org_state(n), test_state(n), state(n);
+    org_state.set_Haar_random_state(0);
+    test_state.load(&org_state);
+    circuit.update_quantum_state(&test_state);
+    QuantumCircuitOptimizer qco;
+    qco.optimize_peephole(&circuit);
+    ASSERT_LT(circuit.gate_list.size(), gate_count);
+    for (auto gate : circuit.gate_list) {
+        ASSERT_NE(gate->get_name(), "DenseMatrix");
+    }
+    state.load(&org_state);
+    circuit.update_quantum_state(&state);
+    ASSERT_STATE_NEAR(state, test_state, eps);
+}
+
+TEST(CircuitTest, OptimizeForObservable) {
+    const UINT n = 4;
+    QuantumCircuitOptimizer qco;
+    QuantumState org_state(n), test_state(n), state(n);
+    org_state.set_Haar_random_state(0);
+
+    // gates outside the light cone and trailing diagonal gates are removed,
+    // while a projection is kept
+    Observable observable(n);
+    observable.add_operator(1.0, "Z 0");
+    QuantumCircuit circuit(n);
+    circuit.add_H_gate(0);
+    circuit.add_gate(gate::P0(3));
+    circuit.add_CNOT_gate(0, 1);
+    circuit.add_H_gate(3);
+    circuit.add_RZ_gate(0, 0.3);
+    circuit.add_CZ_gate(0, 1);
+    test_state.load(&org_state);
+    circuit.update_quantum_state(&test_state);
+    qco.optimize_for_observable(&circuit, observable);
+    ASSERT_EQ(circuit.gate_list.size(), 2);
+    ASSERT_EQ(circuit.gate_list[0]->get_name(), "H");
+    state.load(&org_state);
+    circuit.update_quantum_state(&state);
+    ASSERT_NEAR(std::abs(observable.get_expectation_value(&state) -
+                         observable.get_expectation_value(&test_state)),
+        0, eps);
+
+    // no gate commutes on a qubit measured in several bases
+    Observable mixed_observable(n);
+    mixed_observable.add_operator(1.0, "Z 0");
+    mixed_observable.add_operator(1.0, "X 0");
+    QuantumCircuit mixed_circuit(n);
+    mixed_circuit.add_H_gate(0);
+    mixed_circuit.add_RZ_gate(0, 0.3);
+    qco.optimize_for_observable(&mixed_circuit, mixed_observable);
+    ASSERT_EQ(mixed_circuit.gate_list.size(), 2);
+
+    // random circuits keep the expectation value
+    Random random;
+    random.set_seed(0);
+    Observable random_observable(n);
+    random_observable.add_operator(0.5, "Z 0 Z 1");
+    random_observable.add_operator(0.3, "X 1");
+    for (UINT repeat = 0; repeat < 10; ++repeat) {
+        QuantumCircuit random_circuit(n);
+        for (UINT i = 0; i < 12; ++i) {
+            const UINT target = random.int32() % n;
+            const UINT control = (target + 1 + random.int32() % (n - 1)) % n;
+            switch (random.int32() % 4) {
+                case 0:
+                    random_circuit.add_RX_gate(target, random.uniform());
+                    break;
+                case 1:
+                    random_circuit.add_RZ_gate(target, random.uniform());
+                    break;
+                case 2:
+                    random_circuit.add_CNOT_gate(control, target);
+                    break;
+                default:
+                    random_circuit.add_CZ_gate(control, target);
+                    break;
+            }
+        }
+        test_state.load(&org_state);
+        random_circuit.update_quantum_state(&test_state);
+        qco.optimize_for_observable(&random_circuit, random_observable);
+        state.load(&org_state);
+        random_circuit.update_quantum_state(&state);
+        ASSERT_NEAR(
+            std::abs(random_observable.get_expectation_value(&state) -
+                     random_observable.get_expectation_value(&test_state)),
+            0, eps);
+    }
+}
+
+TEST(CircuitTest, OptimizeForMeasurement) {
+    const UINT n = 5;
+    const std::vector<UINT> measured_qubit_list = {1, 3};
+    Random random;
+    random.set_seed(0);
+    QuantumCircuitOptimizer qco;
+    QuantumState org_state(n), test_state(n), state(n);
+    org_state.set_Haar_random_state(0);
+    for (UINT repeat = 0; repeat < 10; ++repeat) {
+        QuantumCircuit circuit(n);
+        for (UINT i = 0; i < 10; ++i) {
+            const UINT target = random.int32() % n;
+            const UINT control = (target + 1 + random.int32() % (n - 1)) % n;
+            switch (random.int32() % 4) {
+                case 0:
+                    circuit.add_H_gate(target);
+                    break;
+                case 1:
+                    circuit.add_T_gate(target);
+                    break;
+                case 2:
+                    circuit.add_CNOT_gate(control, target);
+                    break;
+                default:
+                    circuit.add_CZ_gate(control, target);
+                    break;
+            }
+        }
+        test_state.load(&org_state);
+        circuit.update_quantum_state(&test_state);
+        qco.optimize_for_measurement(&circuit, measured_qubit_list);
+        state.load(&org_state);
+        circuit.update_quantum_state(&state);
+        for (UINT value = 0; value < 4; ++value) {
+            std::vector<UINT> measured_value_list(n, 2);
+            measured_value_list[1] = value & 1;
+            measured_value_list[3] = value >> 1;
+            ASSERT_NEAR(state.get_marginal_probability(measured_value_list),
+                test_state.get_marginal_probability(measured_value_list), eps);
+        }
+    }
+}
+
 TEST(CircuitTest, SuzukiTrotterExpansion) {
     CPPCTYPE J(0.0, 1.0);
     const auto Identity = make_Identity();
@@ -987,3 +1406,92 @@ TEST(CircuitTest, MergeCircuits) {
     circuit1.update_quantum_state(&state);
     ASSERT_NEAR(abs(state.data_cpp()[3]), 1.0, 0.0001);
 }
+
+TEST(CircuitTest, CompiledCircuitMatchesGates) {
+    const UINT n = 6;
+    Random random;
+    random.set_seed(3);
+    QuantumCircuit circuit(n);
+    for (UINT i = 0; i < n; ++i) {
+        circuit.add_H_gate(i);
+        circuit.add_T_gate(i);
+        circuit.add_RX_gate(i, random.uniform() * 3.14);
+        circuit.add_RotZ_gate(i, random.uniform() * 3.14);
+    }
+    circuit.add_CNOT_gate(0, 3);
+    circuit.add_CZ_gate(4, 1);
+    circuit.add_SWAP_gate(2, 5);
+    circuit.add_multi_Pauli_gate({0, 2, 5}, {1, 2, 3});
+    circuit.add_multi_Pauli_rotation_gate({1, 3}, {2, 1}, 0.4);
+    circuit.add_random_unitary_gate({4});
+    circuit.add_random_unitary_gate({1, 4, 5});
+    auto controlled = gate::RandomUnitary({2});
+    controlled->add_control_qubit(3, 0);
+    circuit.add_gate(controlled);
+    auto double_controlled = gate::RandomUnitary({2, 0});
+    double_controlled->add_control_qubit(3, 0);
+    double_controlled->add_control_qubit(5, 1);
+    circuit.add_gate(double_controlled);
+    ComplexVector diagonal(4);
+    diagonal << 1., 1.i, -1., -1.i;
+    circuit.add_gate(gate::DiagonalMatrix({1, 3}, diagonal));
+    auto controlled_diagonal = gate::DiagonalMatrix({4, 0}, diagonal);
+    controlled_diagonal->add_control_qubit(2, 1);
+    circuit.add_gate(controlled_diagonal);
+    circuit.add_gate(gate::FusedSWAP(0, 3, 2));
+
+    QuantumState expected(n), state(n);
+    expected.set_Haar_random_state(7);
+    state.load(&expected);
+    circuit.update_quantum_state(&expected);
+
+    ASSERT_FALSE(circuit.is_compiled());
+    const CompiledCircuit* compiled = circuit.compile();
+    ASSERT_TRUE(circuit.is_compiled());
+    ASSERT_EQ(compiled->get_instruction_count(), circuit.gate_list.size());
+    // FusedSWAP is applied through the gate itself
+    ASSERT_EQ(compiled->get_generic_instruction_count(), 1);
+    circuit.update_quantum_state(&state);
+    for (ITYPE i = 0; i < state.dim; ++i) {
+        ASSERT_NEAR(abs(expected.data_cpp()[i] - state.data_cpp()[i]), 0, eps);
+    }
+
+    // editing the circuit discards the compiled program
+    circuit.add_X_gate(1);
+    ASSERT_FALSE(circuit.is_compiled());
+    circuit.compile();
+    circuit.remove_gate(0);
+    ASSERT_FALSE(circuit.is_compiled());
+    circuit.compile();
+    circuit.move_gate(0, 3);
+    ASSERT_FALSE(circuit.is_compiled());
+}
+
+TEST(CircuitTest, CompiledCircuitWithNoiseAndDensityMatrix) {
+    const UINT n = 3;
+    QuantumCircuit circuit(n);
+    circuit.add_H_gate(0);
+    circuit.add_CNOT_gate(0, 1);
+    // noises and measurements with deterministic outcomes
+    circuit.add_gate(gate::BitFlipNoise(2, 1.));
+    circuit.add_gate(gate::Measurement(2, 0));
+    circuit.add_RY_gate(2, 0.3);
+    QuantumCircuit reference(n);
+    reference.merge_circuit(&circuit);
+    circuit.compile();
+
+    QuantumState expected(n), state(n);
+    reference.update_quantum_state(&expected);
+    circuit.update_quantum_state(&state);
+    ASSERT_EQ(state.get_classical_value(0), 1);
+    for (ITYPE i = 0; i < state.dim; ++i) {
+        ASSERT_NEAR(abs(expected.data_cpp()[i] - state.data_cpp()[i]), 0, eps);
+    }
+
+    DensityMatrix expected_dm(n), dm(n);
+    reference.update_quantum_state(&expected_dm);
+    circuit.update_quantum_state(&dm);
+    for (ITYPE i = 0; i < dm.dim * dm.dim; ++i) {
+        ASSERT_NEAR(abs(expected_dm.data_cpp()[i] - dm.data_cpp()[i]), 0, eps);
+    }
+}
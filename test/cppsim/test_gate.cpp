@@ -1355,6 +1355,59 @@ TEST(GateTest, CPTPGate) {
     delete CPTP;
 }
 
+TEST(GateTest, SingleQubitCPTPSelectsKrausBranch) {
+    const UINT n = 4;
+    const UINT target = 2;
+    const UINT sample_count = 2000;
+    QuantumState initial_state(n);
+    initial_state.set_Haar_random_state(3);
+
+    auto amp_damp = gate::AmplitudeDampingNoise(target, 0.3);
+    auto measurement = gate::Measurement(target, 1);
+    for (auto cptp : {amp_damp, measurement}) {
+        // normalized K_i psi and its probability for each Kraus operator
+        std::vector<QuantumState*> branch_state_list;
+        std::vector<double> prob_list;
+        for (auto kraus : cptp->get_gate_list()) {
+            QuantumState* branch_state = initial_state.copy();
+            kraus->update_quantum_state(branch_state);
+            prob_list.push_back(branch_state->get_squared_norm());
+            branch_state->normalize(prob_list.back());
+            branch_state_list.push_back(branch_state);
+        }
+
+        std::vector<UINT> count_list(branch_state_list.size(), 0);
+        QuantumState state(n);
+        cptp->set_seed(7);
+        for (UINT sample = 0; sample < sample_count; ++sample) {
+            state.load(&initial_state);
+            cptp->update_quantum_state(&state);
+            ASSERT_NEAR(state.get_squared_norm(), 1., eps);
+            UINT matched = (UINT)branch_state_list.size();
+            for (UINT index = 0; index < branch_state_list.size(); ++index) {
+                if (abs(state::inner_product(branch_state_list[index],
+                            &state) -
+                        1.) < eps) {
+                    matched = index;
+                }
+            }
+            ASSERT_LT(matched, branch_state_list.size());
+            if (cptp == measurement) {
+                ASSERT_EQ(state.get_classical_value(1), matched);
+            }
+            ++count_list[matched];
+        }
+        for (UINT index = 0; index < branch_state_list.size(); ++index) {
+            const double prob = prob_list[index];
+            ASSERT_NEAR((double)count_list[index] / sample_count, prob,
+                5 * sqrt(prob * (1 - prob) / sample_count));
+            delete branch_state_list[index];
+        }
+    }
+    delete amp_damp;
+    delete measurement;
+}
+
 TEST(GateTest, InstrumentGate) {
     auto p0_first_qubit = gate::P0(0);
     auto p0_second_qubit = gate::P0(1);
@@ -638,6 +638,173 @@ TEST(ObservableTest, ApplyIdentityToState) {
     ASSERT_NEAR(0., state.get_squared_norm(), eps);
 }
 
+TEST(ObservableTest, GroupedExpectationValueMatchesTermSum) {
+    const UINT n = 6;
+    const UINT term_count = 200;
+    Random random;
+    random.set_seed(7);
+    GeneralQuantumOperator op(n);
+    for (UINT term = 0; term < term_count; ++term) {
+        // few bit flip masks so that groups contain many terms
+        std::vector<UINT> pauli_id_list(n);
+        const UINT x_pattern = term % 5;
+        for (UINT q = 0; q < n; ++q) {
+            if ((x_pattern >> (q % 3)) & 1) {
+                pauli_id_list[q] = 1 + (random.int32() % 2);
+            } else {
+                pauli_id_list[q] = 3 * (random.int32() % 2);
+            }
+        }
+        std::vector<UINT> index_list(n);
+        for (UINT q = 0; q < n; ++q) index_list[q] = q;
+        op.add_operator(index_list, pauli_id_list,
+            CPPCTYPE(random.uniform() - 0.5, random.uniform() - 0.5));
+    }
+
+    QuantumState state(n);
+    state.set_Haar_random_state(11);
+    auto term_sum = [&]() {
+        CPPCTYPE sum = 0.;
+        for (UINT term = 0; term < op.get_term_count(); ++term) {
+            sum += op.get_term(term)->get_expectation_value(&state);
+        }
+        return sum;
+    };
+    CPPCTYPE expected = term_sum();
+    CPPCTYPE res = op.get_expectation_value(&state);
+    ASSERT_NEAR(expected.real(), res.real(), eps);
+    ASSERT_NEAR(expected.imag(), res.imag(), eps);
+
+    // the cached grouping follows changes made through get_terms()
+    std::vector<PauliOperator*> terms = op.get_terms();
+    terms[0]->add_single_Pauli(0, 1);
+    terms[1]->change_coef(2.);
+    expected = term_sum();
+    res = op.get_expectation_value(&state);
+    ASSERT_NEAR(expected.real(), res.real(), eps);
+    ASSERT_NEAR(expected.imag(), res.imag(), eps);
+
+    op.add_operator(1.5, "Y 2 X 4");
+    expected = term_sum();
+    res = op.get_expectation_value(&state);
+    ASSERT_NEAR(expected.real(), res.real(), eps);
+    ASSERT_NEAR(expected.imag(), res.imag(), eps);
+}
+
+TEST(ObservableTest, GroupedApplyToStateMatchesTermSum) {
+    const UINT n = 12;
+    Random random;
+    random.set_seed(3);
+    GeneralQuantumOperator op(n);
+    for (UINT term = 0; term < 300; ++term) {
+        // groups with few or many qubits in their phase flip masks
+        const UINT qubit_range = (term % 2 == 0) ? 3 : n;
+        std::vector<UINT> index_list, pauli_id_list;
+        for (UINT q = 0; q < qubit_range; ++q) {
+            index_list.push_back(q);
+            pauli_id_list.push_back(random.int32() % 4);
+        }
+        op.add_operator(index_list, pauli_id_list,
+            CPPCTYPE(random.uniform() - 0.5, random.uniform() - 0.5));
+    }
+    op.add_operator(0.25, "");
+
+    QuantumState state(n);
+    state.set_Haar_random_state(5);
+    QuantumState expected(n);
+    expected.set_zero_norm_state();
+    QuantumState term_state(n);
+    for (UINT term = 0; term < op.get_term_count(); ++term) {
+        const PauliOperator* pauli = op.get_term(term);
+        term_state.load(&state);
+        multi_qubit_Pauli_gate_partial_list(pauli->get_index_list().data(),
+            pauli->get_pauli_id_list().data(),
+            (UINT)pauli->get_index_list().size(), term_state.data_c(),
+            term_state.dim);
+        expected.add_state_with_coef(pauli->get_coef(), &term_state);
+    }
+
+    QuantumState work_state(n);
+    QuantumState dst_state(n);
+    op.apply_to_state(&work_state, state, &dst_state);
+    for (ITYPE i = 0; i < state.dim; ++i) {
+        ASSERT_NEAR(abs(expected.data_cpp()[i] - dst_state.data_cpp()[i]), 0,
+            eps);
+    }
+    dst_state.set_Haar_random_state(1);
+    op.apply_to_state(&state, &dst_state);
+    for (ITYPE i = 0; i < state.dim; ++i) {
+        ASSERT_NEAR(abs(expected.data_cpp()[i] - dst_state.data_cpp()[i]), 0,
+            eps);
+    }
+    dst_state.set_Haar_random_state(1);
+    op.apply_to_state_single_thread(&state, &dst_state);
+    for (ITYPE i = 0; i < state.dim; ++i) {
+        ASSERT_NEAR(abs(expected.data_cpp()[i] - dst_state.data_cpp()[i]), 0,
+            eps);
+    }
+}
+
+TEST(ObservableTest, DiagonalObservableUsesCompiledDiagonal) {
+    const UINT n = 8;
+    Random random;
+    random.set_seed(13);
+    Observable observable(n);
+    for (UINT term = 0; term < 40; ++term) {
+        std::vector<UINT> index_list, pauli_id_list;
+        for (UINT q = 0; q < n; ++q) {
+            if (random.int32() % 3 == 0) {
+                index_list.push_back(q);
+                pauli_id_list.push_back(3);
+            }
+        }
+        PauliOperator pauli(index_list, pauli_id_list, random.uniform());
+        observable.add_operator(&pauli);
+    }
+    ASSERT_TRUE(observable.is_diagonal());
+
+    const auto matrix = observable.get_matrix();
+    std::vector<CPPCTYPE> diagonal = observable.get_diagonal();
+    ASSERT_EQ(diagonal.size(), observable.get_state_dim());
+    for (ITYPE i = 0; i < observable.get_state_dim(); ++i) {
+        ASSERT_NEAR(abs(diagonal[i] - matrix.coeff(i, i)), 0, eps);
+    }
+
+    // the state may have more qubits than the observable
+    QuantumState state(n + 2);
+    state.set_Haar_random_state(2);
+    auto term_sum = [&]() {
+        CPPCTYPE sum = 0.;
+        for (UINT term = 0; term < observable.get_term_count(); ++term) {
+            sum += observable.get_term(term)->get_expectation_value(&state);
+        }
+        return sum;
+    };
+    ASSERT_NEAR(
+        observable.get_expectation_value(&state).real(), term_sum().real(), eps);
+
+    // the diagonal follows changes of the coefficients
+    observable.get_terms()[3]->change_coef(-4.);
+    ASSERT_NEAR(
+        observable.get_expectation_value(&state).real(), term_sum().real(), eps);
+    diagonal = observable.get_diagonal();
+    const auto changed_matrix = observable.get_matrix();
+    for (ITYPE i = 0; i < observable.get_state_dim(); ++i) {
+        ASSERT_NEAR(abs(diagonal[i] - changed_matrix.coeff(i, i)), 0, eps);
+    }
+
+    observable.add_operator(0.5, "X 1 Z 2");
+    ASSERT_FALSE(observable.is_diagonal());
+    ASSERT_THROW(observable.get_diagonal(), InvalidObservableException);
+    ASSERT_NEAR(
+        observable.get_expectation_value(&state).real(), term_sum().real(), eps);
+
+    QuantumCircuit circuit(n);
+    ASSERT_THROW(circuit.add_diagonal_observable_rotation_gate(observable, 0.1),
+        InvalidObservableException);
+    ASSERT_EQ(circuit.gate_list.size(), 0);
+}
+
 TEST(gate_to_general_quantum_operatorTest, Random4bit) {
     QuantumGateBase* random_gate = gate::RandomUnitary({0, 1, 2, 3});
 
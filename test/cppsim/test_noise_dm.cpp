@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 
 #include <cmath>
+#include <cppsim/circuit.hpp>
+#include <cppsim/circuit_optimizer.hpp>
 #include <cppsim/gate.hpp>
 #include <cppsim/gate_factory.hpp>
 #include <cppsim/gate_matrix.hpp>
@@ -11,6 +13,7 @@
 #include <csim/update_ops.hpp>
 #include <functional>
 #include <numeric>
+#include <thread>
 
 #include "../util/util.hpp"
 
@@ -388,3 +391,101 @@ ITYPE { return (index + 1) % dim;
 }
 
 */
+
+TEST(DensityMatrixGeneralGateTest, ChannelFusionKeepsDensityMatrix) {
+    const UINT n = 4;
+    const ITYPE dim = 1ULL << n;
+
+    QuantumCircuit circuit(n);
+    circuit.add_H_gate(0);
+    circuit.add_gate(gate::DepolarizingNoise(0, 0.1));
+    circuit.add_CNOT_gate(0, 1);
+    circuit.add_gate(gate::TwoQubitDepolarizingNoise(0, 1, 0.05));
+    circuit.add_gate(gate::AmplitudeDampingNoise(2, 0.2));
+    circuit.add_RX_gate(2, 0.3);
+    auto y_gate = gate::Y(3);
+    circuit.add_gate(gate::Probabilistic({0.1}, {y_gate}));
+    delete y_gate;
+    circuit.add_CZ_gate(3, 1);
+    circuit.add_gate(gate::Measurement(1, 0));
+    circuit.add_multi_Pauli_rotation_gate({0, 2}, {1, 3}, 0.4);
+    circuit.add_gate(gate::BitFlipNoise(2, 0.3));
+    circuit.add_sqrtX_gate(3);
+    circuit.add_gate(gate::DephasingNoise(3, 0.15));
+    circuit.add_T_gate(0);
+
+    DensityMatrix initial_state(n);
+    initial_state.set_Haar_random_state(5);
+    DensityMatrix expected_state(n);
+    expected_state.load(&initial_state);
+    circuit.update_quantum_state(&expected_state);
+
+    for (UINT max_block_size = 1; max_block_size <= 3; ++max_block_size) {
+        QuantumCircuit* fused_circuit = circuit.copy();
+        QuantumCircuitOptimizer qco;
+        qco.optimize_channel(fused_circuit, max_block_size);
+        ASSERT_LT(fused_circuit->gate_list.size(), circuit.gate_list.size());
+        for (auto gate : fused_circuit->gate_list) {
+            ASSERT_LE(gate->get_target_index_list().size() +
+                          gate->get_control_index_list().size(),
+                std::max(max_block_size, 2U));
+        }
+
+        DensityMatrix state(n);
+        state.load(&initial_state);
+        fused_circuit->update_quantum_state(&state);
+        for (ITYPE i = 0; i < dim * dim; ++i) {
+            ASSERT_NEAR(
+                abs(state.data_cpp()[i] - expected_state.data_cpp()[i]), 0.,
+                eps);
+        }
+        delete fused_circuit;
+    }
+    QuantumCircuit* fused_circuit = circuit.copy();
+    QuantumCircuitOptimizer qco;
+    ASSERT_THROW(qco.optimize_channel(fused_circuit, 4),
+        InvalidQubitCountException);
+    delete fused_circuit;
+}
+
+TEST(DensityMatrixGeneralGateTest, SuperoperatorSharedAcrossThreads) {
+    const UINT n = 3, thread_count = 4;
+    const ITYPE dim = 1ULL << n;
+    DensityMatrix initial(n);
+    initial.set_Haar_random_state(5);
+
+    std::vector<QuantumGateBase*> gate_list = {
+        gate::TwoQubitDepolarizingNoise(0, 2, 0.3),
+        gate::AmplitudeDampingNoise(1, 0.4)};
+    DensityMatrix expected(n);
+    expected.load(&initial);
+    for (auto gate : gate_list) {
+        auto fresh = gate->copy();
+        fresh->update_quantum_state(&expected);
+        delete fresh;
+    }
+
+    // the superoperators of the shared gates are built by one of the threads
+    std::vector<DensityMatrix*> state_list;
+    for (UINT i = 0; i < thread_count; ++i) {
+        state_list.push_back(new DensityMatrix(n));
+        state_list.back()->load(&initial);
+    }
+    std::vector<std::thread> thread_list;
+    for (UINT i = 0; i < thread_count; ++i) {
+        thread_list.emplace_back([&, i]() {
+            for (auto gate : gate_list) {
+                gate->update_quantum_state(state_list[i]);
+            }
+        });
+    }
+    for (auto& thread : thread_list) thread.join();
+    for (auto state : state_list) {
+        for (ITYPE i = 0; i < dim * dim; ++i) {
+            ASSERT_NEAR(
+                abs(state->data_cpp()[i] - expected.data_cpp()[i]), 0, eps);
+        }
+        delete state;
+    }
+    for (auto gate : gate_list) delete gate;
+}
@@ -4,9 +4,14 @@
 #include <cppsim/gate_factory.hpp>
 #include <cppsim/gate_merge.hpp>
 #include <cppsim/noisesimulator.hpp>
+#include <cppsim/observable.hpp>
 #include <cppsim/state.hpp>
+#include <cppsim/state_dm.hpp>
 
 #include "../util/util.hpp"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 TEST(NoiseSimulatorTest, Random_with_State_Test) {
     // Just Check whether they run without Runtime Errors.
@@ -127,3 +132,303 @@ TEST(NoiseSimulatorTest, H_gate_twice_test) {
     ASSERT_NE(cnts[1], 0);
     ASSERT_GT(cnts[0], cnts[1]);
 }
+
+TEST(NoiseSimulatorTest, SameSeedGivesSameResultForAnyThreadCount) {
+    UINT n = 6, depth = 6;
+    QuantumCircuit circuit(n);
+    for (UINT d = 0; d < depth; ++d) {
+        for (UINT i = 0; i < n; ++i) {
+            circuit.add_noise_gate(gate::sqrtX(i), "Depolarizing", 0.1);
+            circuit.add_noise_gate(gate::T(i), "AmplitudeDamping", 0.1);
+        }
+        for (UINT i = 0; i + 1 < n; ++i) {
+            circuit.add_noise_gate(gate::CNOT(i, i + 1), "Depolarizing", 0.05);
+        }
+    }
+
+    const UINT seed = 2022, sample_count = 300;
+    std::vector<std::vector<ITYPE>> result_list;
+#ifdef _OPENMP
+    const int default_thread_count = omp_get_max_threads();
+    for (int thread_count : {1, 2, 3}) {
+#else
+    for (int repeat = 0; repeat < 2; ++repeat) {
+#endif
+        NoiseSimulator sim(&circuit);
+        sim.set_seed(seed);
+#ifdef _OPENMP
+        // the kernels reset the thread count, so it is set just before
+        omp_set_num_threads(thread_count);
+#endif
+        result_list.push_back(sim.execute(sample_count));
+    }
+#ifdef _OPENMP
+    omp_set_num_threads(default_thread_count);
+#endif
+
+    ASSERT_EQ(result_list[0].size(), sample_count);
+    for (UINT i = 1; i < result_list.size(); ++i) {
+        ASSERT_EQ(result_list[0], result_list[i]);
+    }
+}
+
+TEST(NoiseSimulatorTest, CheckpointBudgetDoesNotChangeResult) {
+    UINT n = 5, depth = 8;
+    QuantumCircuit circuit(n);
+    for (UINT d = 0; d < depth; ++d) {
+        for (UINT i = 0; i < n; ++i) {
+            circuit.add_noise_gate(gate::sqrtY(i), "Depolarizing", 0.05);
+        }
+        for (UINT i = 0; i + 1 < n; ++i) {
+            circuit.add_noise_gate(gate::CZ(i, i + 1), "Depolarizing", 0.02);
+        }
+        circuit.add_noise_gate(gate::T(d % n), "AmplitudeDamping", 0.1);
+    }
+
+    const UINT seed = 7, sample_count = 500;
+    const ITYPE state_bytes = sizeof(CPPCTYPE) * (1ULL << n);
+    std::vector<std::vector<ITYPE>> result_list;
+    for (ITYPE budget : {(ITYPE)0, 2 * state_bytes, 1ULL << 30}) {
+        NoiseSimulator sim(&circuit);
+        sim.set_seed(seed);
+        sim.set_checkpoint_memory_budget(budget);
+        result_list.push_back(sim.execute(sample_count));
+    }
+
+    ASSERT_EQ(result_list[0].size(), sample_count);
+    for (UINT i = 1; i < result_list.size(); ++i) {
+        ASSERT_EQ(result_list[0], result_list[i]);
+    }
+}
+
+TEST(NoiseSimulatorTest, ErrorLocationFrequencyMatchesNoiseProbability) {
+    // two bit flips with different probabilities on the same qubit
+    UINT n = 2;
+    QuantumCircuit circuit(n);
+    circuit.add_gate(gate::BitFlipNoise(0, 0.3));
+    circuit.add_X_gate(1);
+    circuit.add_gate(gate::BitFlipNoise(0, 0.1));
+    circuit.add_gate(gate::BitFlipNoise(1, 0.5));
+
+    const UINT sample_count = 20000;
+    NoiseSimulator sim(&circuit);
+    sim.set_seed(1);
+    std::vector<ITYPE> result = sim.execute(sample_count);
+    ASSERT_EQ(result.size(), sample_count);
+    UINT flip_count[2] = {};
+    for (ITYPE basis : result) {
+        flip_count[0] += (basis & 1) ? 1 : 0;
+        flip_count[1] += (basis & 2) ? 0 : 1;
+    }
+    const double eps = 0.02;
+    ASSERT_NEAR((double)flip_count[0] / sample_count,
+        0.3 * 0.9 + 0.7 * 0.1, eps);
+    ASSERT_NEAR((double)flip_count[1] / sample_count, 0.5, eps);
+}
+
+TEST(NoiseSimulatorTest, HistogramMatchesSamplingAndExpectationValues) {
+    UINT n = 4, depth = 4;
+    QuantumCircuit circuit(n);
+    for (UINT d = 0; d < depth; ++d) {
+        for (UINT i = 0; i < n; ++i) {
+            circuit.add_noise_gate(gate::sqrtX(i), "Depolarizing", 0.05);
+        }
+        for (UINT i = 0; i + 1 < n; ++i) {
+            circuit.add_noise_gate(gate::CNOT(i, i + 1), "Depolarizing", 0.05);
+        }
+    }
+    Observable observable(n);
+    observable.add_operator(1.0, "Z 0 Z 1");
+    observable.add_operator(0.5, "X 2");
+
+    const UINT seed = 3, sample_count = 1000;
+    NoiseSimulator sampling_sim(&circuit);
+    sampling_sim.set_seed(seed);
+    std::vector<ITYPE> sampling_result = sampling_sim.execute(sample_count);
+    std::map<ITYPE, UINT> expected_histogram;
+    for (ITYPE basis : sampling_result) ++expected_histogram[basis];
+
+    NoiseSimulator histogram_sim(&circuit);
+    histogram_sim.set_seed(seed);
+    NoiseSimulator::HistogramResult histogram_result =
+        histogram_sim.execute_and_get_histogram(sample_count, &observable);
+    ASSERT_EQ(histogram_result.histogram, expected_histogram);
+
+    // the final states are the same as those of execute_and_get_result
+    NoiseSimulator state_sim(&circuit);
+    state_sim.set_seed(seed);
+    NoiseSimulator::Result* result =
+        state_sim.execute_and_get_result(sample_count);
+    ASSERT_EQ(histogram_result.expectation_value_list.size(),
+        result->result.size());
+    CPPCTYPE expected_sum = 0.;
+    for (UINT i = 0; i < result->result.size(); ++i) {
+        const CPPCTYPE value =
+            observable.get_expectation_value(result->result[i].first);
+        ASSERT_NEAR(
+            abs(histogram_result.expectation_value_list[i].first - value), 0,
+            eps);
+        ASSERT_EQ(histogram_result.expectation_value_list[i].second,
+            result->result[i].second);
+        expected_sum += value * (double)result->result[i].second;
+    }
+    ASSERT_NEAR(abs(histogram_result.get_expectation_value() -
+                    expected_sum / (double)sample_count),
+        0, eps);
+    delete result;
+}
+
+TEST(NoiseSimulatorTest, PauliFrameInCliffordSuffixMatchesDensityMatrix) {
+    UINT n = 3;
+    QuantumCircuit circuit(n);
+    circuit.add_H_gate(0);
+    circuit.add_gate(gate::BitFlipNoise(0, 0.2));
+    circuit.add_T_gate(0);
+    // Clifford suffix with Pauli noise
+    circuit.add_gate(gate::DepolarizingNoise(0, 0.2));
+    circuit.add_noise_gate(gate::CNOT(0, 1), "Depolarizing", 0.1);
+    circuit.add_noise_gate(gate::H(1), "BitFlip", 0.2);
+    circuit.add_noise_gate(gate::S(1), "Dephasing", 0.2);
+    circuit.add_noise_gate(gate::sqrtX(2), "IndependentXZ", 0.1);
+    circuit.add_noise_gate(gate::CZ(1, 2), "Depolarizing", 0.2);
+    circuit.add_SWAP_gate(0, 2);
+    circuit.add_noise_gate(gate::sqrtY(0), "Depolarizing", 0.2);
+    circuit.add_noise_gate(gate::Sdag(2), "BitFlip", 0.1);
+    circuit.add_sqrtXdag_gate(1);
+    circuit.add_sqrtYdag_gate(2);
+    circuit.add_gate(gate::TwoQubitDepolarizingNoise(1, 2, 0.1));
+
+    DensityMatrix density_matrix(n);
+    density_matrix.set_zero_state();
+    circuit.update_quantum_state(&density_matrix);
+
+    // density matrix of the sampled trajectories
+    const UINT sample_count = 20000;
+    NoiseSimulator sim(&circuit);
+    sim.set_seed(11);
+    NoiseSimulator::Result* result = sim.execute_and_get_result(sample_count);
+    const ITYPE dim = 1ULL << n;
+    ComplexMatrix sampled_density_matrix = ComplexMatrix::Zero(dim, dim);
+    for (const auto& p : result->result) {
+        const Eigen::Map<const ComplexVector> vec(p.first->data_cpp(), dim);
+        sampled_density_matrix +=
+            (double)p.second / sample_count * vec * vec.adjoint();
+    }
+    delete result;
+    for (ITYPE row = 0; row < dim; ++row) {
+        for (ITYPE col = 0; col < dim; ++col) {
+            ASSERT_NEAR(abs(sampled_density_matrix(row, col) -
+                            density_matrix.data_cpp()[row * dim + col]),
+                0, 0.02)
+                << "element (" << row << ", " << col << ")";
+        }
+    }
+}
+
+TEST(NoiseSimulatorTest, PauliFrameStopsAtNonUnitaryGates) {
+    // The reset and the measurement of a basis state have a deterministic
+    // result, so the trajectories sharing an error pattern are the same.
+    UINT n = 2;
+    QuantumCircuit circuit(n);
+    circuit.add_H_gate(1);
+    circuit.add_gate(gate::BitFlipNoise(0, 0.5));
+    circuit.add_noise_gate(gate::CNOT(1, 0), "Depolarizing", 0.2);
+    circuit.add_gate(gate::AmplitudeDampingNoise(0, 1.0));
+    circuit.add_gate(gate::BitFlipNoise(0, 0.3));
+    circuit.add_gate(gate::Measurement(0, 0));
+    circuit.add_gate(gate::DephasingNoise(1, 0.2));
+    circuit.add_noise_gate(gate::CNOT(0, 1), "Depolarizing", 0.1);
+    circuit.add_H_gate(1);
+
+    DensityMatrix density_matrix(n);
+    density_matrix.set_zero_state();
+    circuit.update_quantum_state(&density_matrix);
+
+    const UINT sample_count = 20000;
+    NoiseSimulator sim(&circuit);
+    sim.set_seed(13);
+    NoiseSimulator::Result* result = sim.execute_and_get_result(sample_count);
+    const ITYPE dim = 1ULL << n;
+    ComplexMatrix sampled_density_matrix = ComplexMatrix::Zero(dim, dim);
+    for (const auto& p : result->result) {
+        const Eigen::Map<const ComplexVector> vec(p.first->data_cpp(), dim);
+        sampled_density_matrix +=
+            (double)p.second / sample_count * vec * vec.adjoint();
+    }
+    delete result;
+    for (ITYPE row = 0; row < dim; ++row) {
+        for (ITYPE col = 0; col < dim; ++col) {
+            ASSERT_NEAR(abs(sampled_density_matrix(row, col) -
+                            density_matrix.data_cpp()[row * dim + col]),
+                0, 0.02)
+                << "element (" << row << ", " << col << ")";
+        }
+    }
+
+    // all the population is moved to |0> on the qubit 0
+    QuantumCircuit damping_circuit(1);
+    damping_circuit.add_gate(gate::BitFlipNoise(0, 0.5));
+    damping_circuit.add_gate(gate::AmplitudeDampingNoise(0, 1.0));
+    NoiseSimulator damping_sim(&damping_circuit);
+    damping_sim.set_seed(17);
+    for (ITYPE basis : damping_sim.execute(1000)) {
+        ASSERT_EQ(basis, 0ULL);
+    }
+}
+
+TEST(NoiseSimulatorTest, PauliFramePropagatesThroughCliffordGates) {
+    const UINT n = 3;
+    QuantumState initial_state(n);
+    initial_state.set_Haar_random_state(2);
+    std::vector<QuantumGateBase*> clifford_list = {gate::H(0), gate::S(1),
+        gate::Sdag(2), gate::sqrtX(0), gate::sqrtXdag(1), gate::sqrtY(2),
+        gate::sqrtYdag(0), gate::CNOT(0, 2), gate::CZ(2, 1), gate::SWAP(1, 0)};
+    for (QuantumGateBase* clifford : clifford_list) {
+        std::vector<UINT> qubit_list = clifford->get_target_index_list();
+        for (UINT control : clifford->get_control_index_list()) {
+            qubit_list.push_back(control);
+        }
+        // A single Pauli error on one qubit, which is the 0-th gate of the
+        // optimized distribution, so that a wrong image of the error cannot
+        // coincide with the image of another branch.
+        for (UINT qubit : qubit_list) {
+            for (UINT pauli_id = 1; pauli_id <= 3; pauli_id += 2) {
+                QuantumGate_Probabilistic* noise =
+                    (pauli_id == 1) ? gate::BitFlipNoise(qubit, 0.9)
+                                    : gate::DephasingNoise(qubit, 0.9);
+                QuantumCircuit circuit(n);
+                circuit.add_gate(noise);
+                circuit.add_gate_copy(clifford);
+                circuit.add_CNOT_gate(0, 1);
+                circuit.add_sqrtY_gate(2);
+
+                std::vector<QuantumState*> expected_list;
+                for (QuantumGateBase* branch : noise->get_gate_list()) {
+                    QuantumState* expected = initial_state.copy();
+                    branch->update_quantum_state(expected);
+                    for (UINT q = 1; q < circuit.gate_list.size(); ++q) {
+                        circuit.gate_list[q]->update_quantum_state(expected);
+                    }
+                    expected_list.push_back(expected);
+                }
+
+                NoiseSimulator sim(&circuit, &initial_state);
+                sim.set_seed(5);
+                NoiseSimulator::Result* result =
+                    sim.execute_and_get_result(100);
+                for (const auto& p : result->result) {
+                    double max_overlap = 0.;
+                    for (QuantumState* expected : expected_list) {
+                        max_overlap = std::max(max_overlap,
+                            abs(state::inner_product(expected, p.first)));
+                    }
+                    ASSERT_NEAR(max_overlap, 1., 1e-10)
+                        << clifford->get_name() << " " << qubit;
+                }
+                delete result;
+                for (QuantumState* expected : expected_list) delete expected;
+            }
+        }
+        delete clifford;
+    }
+}
@@ -35,6 +35,31 @@ TEST(StateTest, GenerateAndRelease) {
     }
 }
 
+TEST(StateTest, AllocationPolicy) {
+    const UINT n = 12;
+    QuantumState state(n, ALLOCATION_HUGE_PAGE | ALLOCATION_FIRST_TOUCH);
+    ASSERT_EQ(state.get_allocation_policy(),
+        ALLOCATION_HUGE_PAGE | ALLOCATION_FIRST_TOUCH);
+    ASSERT_EQ(
+        reinterpret_cast<uintptr_t>(state.data_c()) % (2 * 1024 * 1024), 0U);
+    ASSERT_NEAR(abs(state.data_cpp()[0] - 1.), 0, eps);
+    for (ITYPE i = 1; i < state.dim; ++i) {
+        ASSERT_EQ(state.data_cpp()[i], CPPCTYPE(0.));
+    }
+    state.set_Haar_random_state(1);
+
+    QuantumState* copied = state.copy();
+    ASSERT_EQ(copied->get_allocation_policy(), state.get_allocation_policy());
+    for (ITYPE i = 0; i < state.dim; ++i) {
+        ASSERT_EQ(copied->data_cpp()[i], state.data_cpp()[i]);
+    }
+    delete copied;
+
+    QuantumState plain(n, ALLOCATION_MALLOC);
+    plain.load(&state);
+    ASSERT_NEAR(plain.get_squared_norm(), 1., eps);
+}
+
 TEST(StateTest, SamplingComputationalBasis) {
     const UINT n = 10;
     const UINT nshot = 1024;
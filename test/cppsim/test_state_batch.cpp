@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+
+#include <cppsim/circuit.hpp>
+#include <cppsim/gate_factory.hpp>
+#include <cppsim/observable.hpp>
+#include <cppsim/state.hpp>
+#include <cppsim/state_batch.hpp>
+#include <cppsim/utility.hpp>
+
+#include "../util/util.hpp"
+
+static void assert_batch_element_near(const QuantumState& expected,
+    const QuantumStateBatch& batch, UINT element) {
+    std::vector<CPPCTYPE> actual = batch.get_vector(element);
+    for (ITYPE i = 0; i < expected.dim; ++i) {
+        ASSERT_NEAR(abs(expected.data_cpp()[i] - actual[i]), 0, eps)
+            << element << " " << i;
+    }
+}
+
+TEST(StateBatchTest, CircuitMatchesEachState) {
+    const UINT n = 6;
+    const UINT batch_size = 5;
+    Random random;
+    random.set_seed(2);
+
+    QuantumCircuit circuit(n);
+    for (UINT i = 0; i < n; ++i) {
+        circuit.add_H_gate(i);
+        circuit.add_RX_gate(i, random.uniform() * 3.14);
+        circuit.add_RZ_gate(i, random.uniform() * 3.14);
+    }
+    circuit.add_CNOT_gate(0, 3);
+    circuit.add_CZ_gate(4, 1);
+    circuit.add_SWAP_gate(2, 5);
+    circuit.add_multi_Pauli_rotation_gate({1, 3}, {2, 1}, 0.4);
+    circuit.add_random_unitary_gate({1, 4, 5});
+    auto controlled = gate::RandomUnitary({2, 0});
+    controlled->add_control_qubit(3, 0);
+    circuit.add_gate(controlled);
+    circuit.add_gate(
+        gate::DiagonalMatrix({1, 5}, ComplexVector::Random(4).normalized()));
+
+    QuantumStateBatch batch(n, batch_size);
+    batch.set_Haar_random_state(7);
+    batch.update_quantum_state(&circuit);
+
+    QuantumState state(n);
+    for (UINT element = 0; element < batch_size; ++element) {
+        state.set_Haar_random_state(7 + element);
+        circuit.update_quantum_state(&state);
+        assert_batch_element_near(state, batch, element);
+    }
+}
+
+TEST(StateBatchTest, PerElementRotation) {
+    const UINT n = 5;
+    const UINT batch_size = 4;
+    const std::vector<double> angle_list = {0.1, -0.7, 1.3, 2.9};
+
+    QuantumStateBatch batch(n, batch_size);
+    batch.set_Haar_random_state(3);
+    batch.apply_RX_gate(1, angle_list);
+    batch.apply_RY_gate(4, angle_list);
+    batch.apply_RZ_gate(0, angle_list);
+    batch.apply_multi_Pauli_rotation_gate({0, 2, 3}, {1, 2, 3}, angle_list);
+
+    QuantumState state(n);
+    for (UINT element = 0; element < batch_size; ++element) {
+        const double angle = angle_list[element];
+        state.set_Haar_random_state(3 + element);
+        std::vector<QuantumGateBase*> gate_list = {gate::RX(1, angle),
+            gate::RY(4, angle), gate::RZ(0, angle),
+            gate::PauliRotation({0, 2, 3}, {1, 2, 3}, angle)};
+        for (auto gate : gate_list) {
+            gate->update_quantum_state(&state);
+            delete gate;
+        }
+        assert_batch_element_near(state, batch, element);
+    }
+    ASSERT_THROW(batch.apply_RX_gate(0, {0.1}), InvalidStateVectorSizeException);
+}
+
+TEST(StateBatchTest, ExpectationAndNorm) {
+    const UINT n = 6;
+    const UINT batch_size = 3;
+    QuantumStateBatch batch(n, batch_size);
+    batch.set_Haar_random_state(11);
+
+    Observable observable(n);
+    observable.add_operator(0.5, "X 0 Y 3 Z 5");
+    observable.add_operator(-1.2, "Z 1 Z 2");
+    observable.add_operator(0.3, "Y 4");
+    observable.add_operator(0.7, "");
+    std::vector<CPPCTYPE> expectation = batch.get_expectation_value(&observable);
+    std::vector<double> norm = batch.get_squared_norm();
+
+    QuantumState state(n);
+    for (UINT element = 0; element < batch_size; ++element) {
+        state.set_Haar_random_state(11 + element);
+        ASSERT_NEAR(abs(expectation[element] -
+                        observable.get_expectation_value(&state)),
+            0, eps);
+        ASSERT_NEAR(norm[element], 1., eps);
+    }
+
+    batch.normalize({4., 4., 4.});
+    for (double value : batch.get_squared_norm()) {
+        ASSERT_NEAR(value, 0.25, eps);
+    }
+}
+
+TEST(StateBatchTest, Sampling) {
+    const UINT n = 4;
+    QuantumStateBatch batch(n, 3);
+    batch.set_computational_basis(6);
+    for (auto& sample_list : batch.sampling(50, 1)) {
+        ASSERT_EQ(sample_list.size(), 50U);
+        for (auto sample : sample_list) ASSERT_EQ(sample, 6ULL);
+    }
+
+    QuantumState plus(n);
+    auto hadamard = gate::H(2);
+    hadamard->update_quantum_state(&plus);
+    batch.load(1, &plus);
+    auto result = batch.sampling(200, 5);
+    ASSERT_EQ(result, batch.sampling(200, 5));
+    for (auto sample : result[1]) {
+        ASSERT_TRUE(sample == 0ULL || sample == 4ULL);
+    }
+    delete hadamard;
+}
+
+TEST(StateBatchTest, RejectNonUnitaryGate) {
+    QuantumStateBatch batch(3, 2);
+    auto measurement = gate::Measurement(0, 0);
+    ASSERT_THROW(
+        batch.update_quantum_state(measurement), NotImplementedException);
+    delete measurement;
+}
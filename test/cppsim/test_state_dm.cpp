@@ -321,4 +321,32 @@ TEST(DensityMatrixTest, MakeMixture) {
         }
         delete mixture;
     }
-}
\ No newline at end of file
+}
+
+TEST(DensityMatrixTest, VectorizedExecution) {
+    const UINT n = 4;
+    const ITYPE dim = 1ULL << n;
+    ASSERT_FALSE(DensityMatrixCpu::is_vectorized_execution());
+    std::vector<QuantumGateBase*> gate_list = {gate::H(0), gate::CNOT(0, 2),
+        gate::RX(1, 0.3), gate::Pauli({0, 3}, {2, 3}),
+        gate::PauliRotation({1, 2}, {1, 2}, 0.7),
+        gate::DepolarizingNoise(3, 0.2), gate::AmplitudeDampingNoise(1, 0.4),
+        gate::RandomUnitary({0, 1, 3})};
+    auto controlled = gate::RandomUnitary({2, 3});
+    controlled->add_control_qubit(0, 1);
+    gate_list.push_back(controlled);
+
+    DensityMatrix expected(n), vectorized(n);
+    expected.set_Haar_random_state(1);
+    vectorized.load(&expected);
+    for (auto gate : gate_list) gate->update_quantum_state(&expected);
+    DensityMatrixCpu::set_vectorized_execution(true);
+    ASSERT_TRUE(DensityMatrixCpu::is_vectorized_execution());
+    for (auto gate : gate_list) gate->update_quantum_state(&vectorized);
+    DensityMatrixCpu::set_vectorized_execution(false);
+    for (ITYPE i = 0; i < dim * dim; ++i) {
+        ASSERT_NEAR(
+            abs(expected.data_cpp()[i] - vectorized.data_cpp()[i]), 0, eps);
+    }
+    for (auto gate : gate_list) delete gate;
+}
@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include <cppsim/circuit.hpp>
+#include <cppsim/gate_factory.hpp>
+#include <cppsim/gate_merge.hpp>
+#include <cppsim/observable.hpp>
+#include <cppsim/state.hpp>
+#include <cppsim/state_dm.hpp>
+#include <cppsim/state_dm_packed.hpp>
+#include <cppsim/utility.hpp>
+
+#include "../util/util.hpp"
+
+static void assert_packed_near(
+    const DensityMatrix& expected, const DensityMatrixPacked& packed) {
+    for (ITYPE y = 0; y < expected.dim; ++y) {
+        for (ITYPE x = 0; x < expected.dim; ++x) {
+            ASSERT_NEAR(abs(expected.data_cpp()[y * expected.dim + x] -
+                            packed.get_element(y, x)),
+                0, eps)
+                << y << " " << x;
+        }
+    }
+}
+
+TEST(DensityMatrixPackedTest, CircuitMatchesDensityMatrix) {
+    const UINT n = 6;
+    Random random;
+    random.set_seed(5);
+
+    QuantumState state1(n), state2(n);
+    state1.set_Haar_random_state(1);
+    state2.set_Haar_random_state(2);
+    DensityMatrix* dm = state::make_mixture(0.3, &state1, 0.7, &state2);
+    DensityMatrixPacked packed(n);
+    packed.load(dm);
+    assert_packed_near(*dm, packed);
+
+    QuantumCircuit circuit(n);
+    for (UINT i = 0; i < n; ++i) {
+        circuit.add_H_gate(i);
+        circuit.add_RX_gate(i, random.uniform() * 3.14);
+        circuit.add_RZ_gate(i, random.uniform() * 3.14);
+    }
+    circuit.add_CNOT_gate(0, 3);
+    circuit.add_CZ_gate(4, 1);
+    circuit.add_SWAP_gate(2, 5);
+    circuit.add_multi_Pauli_rotation_gate({1, 3}, {2, 1}, 0.4);
+    circuit.add_random_unitary_gate({1, 4, 5});
+    auto controlled = gate::RandomUnitary({2, 0});
+    controlled->add_control_qubit(3, 0);
+    circuit.add_gate(controlled);
+    circuit.add_gate(gate::DepolarizingNoise(2, 0.1));
+    circuit.add_gate(gate::AmplitudeDampingNoise(5, 0.2));
+    circuit.add_gate(gate::TwoQubitDepolarizingNoise(0, 4, 0.05));
+    circuit.add_gate(gate::Measurement(3, 0));
+    circuit.add_gate(gate::P0(1));
+
+    circuit.update_quantum_state(dm);
+    packed.update_quantum_state(&circuit);
+    assert_packed_near(*dm, packed);
+
+    ASSERT_NEAR(dm->get_squared_norm(), packed.get_squared_norm(), eps);
+    ASSERT_NEAR(dm->get_entropy(), packed.get_entropy(), eps);
+    for (UINT i = 0; i < n; ++i) {
+        ASSERT_NEAR(
+            dm->get_zero_probability(i), packed.get_zero_probability(i), eps);
+    }
+    std::vector<UINT> measured_values = {0, 2, 1, 2, 2, 0};
+    ASSERT_NEAR(dm->get_marginal_probability(measured_values),
+        packed.get_marginal_probability(measured_values), eps);
+
+    Observable observable(n);
+    observable.add_operator(0.5, "X 0 Y 2 Z 3");
+    observable.add_operator(-1.2, "Y 1 Y 4");
+    observable.add_operator(0.3, "Z 5");
+    observable.add_operator(0.7, "X 2 X 5 Y 0");
+    ASSERT_NEAR(abs(observable.get_expectation_value(dm) -
+                    packed.get_expectation_value(&observable)),
+        0, eps);
+
+    std::vector<UINT> target_traceout = {4, 1};
+    DensityMatrix* expected_trace = state::partial_trace(dm, target_traceout);
+    DensityMatrixPacked* packed_trace =
+        state::partial_trace(&packed, target_traceout);
+    assert_packed_near(*expected_trace, *packed_trace);
+
+    DensityMatrix* unpacked = packed.to_density_matrix();
+    for (ITYPE i = 0; i < dm->dim * dm->dim; ++i) {
+        ASSERT_NEAR(abs(dm->data_cpp()[i] - unpacked->data_cpp()[i]), 0, eps);
+    }
+
+    delete unpacked;
+    delete packed_trace;
+    delete expected_trace;
+    delete dm;
+}
+
+TEST(DensityMatrixPackedTest, SamplingFollowsDiagonal) {
+    const UINT n = 3;
+    DensityMatrixPacked packed(n);
+    packed.set_computational_basis(5);
+    for (ITYPE sample : packed.sampling(20, 3)) {
+        ASSERT_EQ(sample, 5);
+    }
+
+    // mixture of |1> and |6> with probabilities 1/4 and 3/4
+    auto flip = gate::Pauli({0, 1, 2}, {1, 1, 1});
+    auto mixture = gate::Probabilistic({0.75}, {flip});
+    packed.set_computational_basis(1);
+    packed.update_quantum_state(mixture);
+    const UINT sampling_count = 4000;
+    UINT count_1 = 0;
+    for (ITYPE sample : packed.sampling(sampling_count, 7)) {
+        ASSERT_TRUE(sample == 1 || sample == 6) << sample;
+        if (sample == 1) ++count_1;
+    }
+    ASSERT_NEAR((double)count_1 / sampling_count, 0.25, 0.03);
+    delete flip;
+    delete mixture;
+}
@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+
+#include <cppsim/circuit.hpp>
+#include <cppsim/gate_factory.hpp>
+#include <cppsim/gate_matrix.hpp>
+#include <cppsim/observable.hpp>
+#include <cppsim/state.hpp>
+#include <cppsim/state_float.hpp>
+#include <cppsim/utility.hpp>
+
+#include "../util/util.hpp"
+
+static void assert_float_state_near(
+    const QuantumState& expected, const QuantumStateFloat& actual, double eps) {
+    CPPCTYPE* data = actual.duplicate_data_cpp();
+    for (ITYPE i = 0; i < expected.dim; ++i) {
+        ASSERT_NEAR(abs(expected.data_cpp()[i] - data[i]), 0, eps) << i;
+    }
+    free(data);
+}
+
+TEST(StateFloatTest, GatesMatchDoublePrecision) {
+    const UINT n = 6;
+    const double eps = 1e-5;
+    Random random;
+    random.set_seed(3);
+
+    QuantumCircuit circuit(n);
+    for (UINT depth = 0; depth < 3; ++depth) {
+        for (UINT i = 0; i < n; ++i) {
+            circuit.add_X_gate(i);
+            circuit.add_Y_gate(i);
+            circuit.add_H_gate(i);
+            circuit.add_T_gate(i);
+            circuit.add_RX_gate(i, random.uniform() * 3.14);
+            circuit.add_RZ_gate(i, random.uniform() * 3.14);
+        }
+        circuit.add_CNOT_gate(0, 3);
+        circuit.add_CZ_gate(4, 1);
+        circuit.add_SWAP_gate(2, 5);
+        circuit.add_multi_Pauli_gate({0, 2, 5}, {1, 2, 3});
+        circuit.add_multi_Pauli_rotation_gate({1, 3}, {2, 1}, 0.4);
+        circuit.add_multi_Pauli_rotation_gate({0, 4}, {3, 3}, 0.7);
+        circuit.add_random_unitary_gate({1, 4, 5});
+        auto controlled = gate::RandomUnitary({2, 0});
+        controlled->add_control_qubit(3, 0);
+        circuit.add_gate(controlled);
+        circuit.add_gate(gate::DiagonalMatrix(
+            {1, 5}, ComplexVector::Random(4).normalized()));
+        circuit.add_gate(gate::SparseMatrix(
+            {3}, make_X().sparseView()));
+    }
+
+    QuantumState expected(n);
+    QuantumStateFloat actual(n);
+    expected.set_Haar_random_state(1);
+    actual.load(&expected);
+    circuit.update_quantum_state(&expected);
+    circuit.update_quantum_state(&actual);
+    assert_float_state_near(expected, actual, eps);
+}
+
+TEST(StateFloatTest, StatisticsMatchDoublePrecision) {
+    const UINT n = 8;
+    const double eps = 1e-5;
+    QuantumState expected(n);
+    QuantumStateFloat actual(n);
+    expected.set_Haar_random_state(2);
+    actual.set_Haar_random_state(2);
+    assert_float_state_near(expected, actual, eps);
+
+    ASSERT_NEAR(actual.get_squared_norm(), 1., eps);
+    ASSERT_NEAR(actual.get_squared_norm_single_thread(), 1., eps);
+    for (UINT i = 0; i < n; ++i) {
+        ASSERT_NEAR(actual.get_zero_probability(i),
+            expected.get_zero_probability(i), eps);
+    }
+    std::vector<UINT> measured = {0, 2, 1, 2, 2, 1, 0, 2};
+    ASSERT_NEAR(actual.get_marginal_probability(measured),
+        expected.get_marginal_probability(measured), eps);
+    ASSERT_NEAR(actual.get_entropy(), expected.get_entropy(), 1e-4);
+
+    Observable observable(n);
+    observable.add_operator(0.5, "X 0 Y 3 Z 7");
+    observable.add_operator(-1.2, "Z 1 Z 2");
+    observable.add_operator(0.3, "Y 5");
+    ASSERT_NEAR(abs(observable.get_expectation_value(&actual) -
+                    observable.get_expectation_value(&expected)),
+        0, eps);
+
+    QuantumStateFloat other(n);
+    other.set_computational_basis(5);
+    ASSERT_NEAR(abs(state::inner_product(&other, &actual) -
+                    expected.data_cpp()[5]),
+        0, eps);
+}
+
+TEST(StateFloatTest, SamplingUnderNormalizedState) {
+    const UINT n = 6;
+    const ITYPE dim = 1ULL << n;
+    QuantumStateFloat state(n);
+    state.set_computational_basis(dim - 1);
+    state.multiply_coef(sqrt(0.9));
+    for (ITYPE index : state.sampling(100000, 0)) {
+        ASSERT_EQ(index, dim - 1);
+    }
+
+    state.set_Haar_random_state(0);
+    state.multiply_coef(1. - 1e-6);
+    for (ITYPE index : state.sampling(100000, 1)) {
+        ASSERT_LT(index, dim);
+    }
+}
+
+TEST(StateFloatTest, NormalizeAndAddState) {
+    const UINT n = 4;
+    QuantumStateFloat state(n), other(n);
+    state.set_Haar_random_state(4);
+    other.load(&state);
+    state.add_state_with_coef(2., &other);
+    ASSERT_NEAR(state.get_squared_norm(), 9., 1e-5);
+    state.normalize(state.get_squared_norm());
+    ASSERT_NEAR(state.get_squared_norm(), 1., 1e-5);
+    state.multiply_coef(1.i);
+    ASSERT_NEAR(abs(state::inner_product(&other, &state) - 1.i), 0, 1e-5);
+
+    QuantumState double_state(n);
+    double_state.load(&state);
+    ASSERT_NEAR(double_state.get_squared_norm(), 1., 1e-5);
+    ASSERT_THROW(state.data_c(), NotImplementedException);
+    ASSERT_THROW(state.data_cpp(), NotImplementedException);
+}
+
+TEST(StateFloatTest, SamplingIsReproducible) {
+    const UINT n = 5;
+    QuantumStateFloat state(n);
+    state.set_computational_basis(9);
+    for (auto sample : state.sampling(20)) {
+        ASSERT_EQ(sample, 9ULL);
+    }
+    state.set_Haar_random_state(5);
+    ASSERT_EQ(state.sampling(100, 7), state.sampling(100, 7));
+}
+
+TEST(StateFloatTest, MeasurementCollapsesState) {
+    const UINT n = 3;
+    QuantumStateFloat state(n);
+    auto hadamard = gate::H(1);
+    auto measurement = gate::Measurement(1, 0);
+    hadamard->update_quantum_state(&state);
+    measurement->update_quantum_state(&state);
+    const UINT value = state.get_classical_value(0);
+    ASSERT_NEAR(state.get_zero_probability(1), value == 0 ? 1. : 0., 1e-6);
+    ASSERT_NEAR(state.get_squared_norm(), 1., 1e-6);
+    delete hadamard;
+    delete measurement;
+}
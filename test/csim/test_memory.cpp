@@ -43,3 +43,66 @@ TEST(MemoryOperationTest, LargeMemory) {
     initialize_quantum_state(ptr, dim);
     release_quantum_state(ptr);
 }
+
+TEST(MemoryOperationTest, AllocationPolicy) {
+    const UINT n = 18;
+    const ITYPE dim = 1ULL << n;
+    const std::vector<AllocationPolicy> policy_list = {ALLOCATION_MALLOC,
+        ALLOCATION_ALIGNED, ALLOCATION_ALIGNED | ALLOCATION_FIRST_TOUCH,
+        ALLOCATION_HUGE_PAGE | ALLOCATION_FIRST_TOUCH};
+    for (auto policy : policy_list) {
+        auto ptr = allocate_quantum_state_with_policy(dim, policy);
+        if (policy & ALLOCATION_ALIGNED) {
+            ASSERT_EQ(reinterpret_cast<uintptr_t>(ptr) % 64, 0U);
+        }
+        if (policy & ALLOCATION_HUGE_PAGE) {
+            ASSERT_EQ(reinterpret_cast<uintptr_t>(ptr) % (2 * 1024 * 1024), 0U);
+        }
+        if (policy & ALLOCATION_FIRST_TOUCH) {
+            ASSERT_EQ(ptr[0], CTYPE(1.));
+            for (ITYPE ind = 1; ind < dim; ++ind) {
+                ASSERT_EQ(ptr[ind], CTYPE(0.));
+            }
+        }
+        initialize_quantum_state(ptr, dim);
+        ASSERT_NEAR(_cabs(ptr[0] - 1.), 0., eps);
+        release_quantum_state(ptr);
+    }
+}
+
+TEST(MemoryOperationTest, DefaultAllocationPolicy) {
+    const AllocationPolicy original = get_default_allocation_policy();
+    set_default_allocation_policy(ALLOCATION_HUGE_PAGE);
+    ASSERT_EQ(get_default_allocation_policy(), ALLOCATION_HUGE_PAGE);
+    auto ptr = allocate_quantum_state(1ULL << 10);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(ptr) % (2 * 1024 * 1024), 0U);
+    release_quantum_state(ptr);
+    set_default_allocation_policy(original);
+}
+
+TEST(MemoryOperationTest, CopyWithPolicy) {
+    const UINT n = 12;
+    const ITYPE dim = 1ULL << n;
+    auto source = allocate_quantum_state(dim);
+    initialize_Haar_random_state_with_seed(source, dim, 1);
+    const std::vector<AllocationPolicy> policy_list = {ALLOCATION_MALLOC,
+        ALLOCATION_ALIGNED | ALLOCATION_FIRST_TOUCH,
+        ALLOCATION_HUGE_PAGE | ALLOCATION_FIRST_TOUCH};
+    for (auto policy : policy_list) {
+        auto ptr = allocate_quantum_state_copy_with_policy(source, dim, policy);
+        for (ITYPE ind = 0; ind < dim; ++ind) {
+            ASSERT_EQ(ptr[ind], source[ind]);
+        }
+        initialize_quantum_state(ptr, dim);
+        copy_quantum_state(source, ptr, dim);
+        for (ITYPE ind = 0; ind < dim; ++ind) {
+            ASSERT_EQ(ptr[ind], source[ind]);
+        }
+        // the buffer is released by its own kind, not by the default policy
+        const AllocationPolicy original = get_default_allocation_policy();
+        set_default_allocation_policy(ALLOCATION_MALLOC);
+        release_quantum_state(ptr);
+        set_default_allocation_policy(original);
+    }
+    release_quantum_state(source);
+}
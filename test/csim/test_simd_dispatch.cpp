@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+
+#include <csim/init_ops.hpp>
+#include <csim/memory_ops.hpp>
+#include <csim/simd_dispatch.hpp>
+#include <csim/stat_ops.hpp>
+#include <csim/update_ops.hpp>
+#include <string>
+
+#include "../util/util.hpp"
+
+TEST(SIMDutilTest, SingletonCheck) {
+    SIMDutil& simdutil_0 = SIMDutil::get_inst();
+    SIMDutil& simdutil_1 = SIMDutil::get_inst();
+
+    ASSERT_EQ(&simdutil_0, &simdutil_1);
+}
+
+TEST(SIMDutilTest, ScalarIsAlwaysSupported) {
+    SIMDutil& simdutil = SIMDutil::get_inst();
+    const SIMDVariant initial = simdutil.get_variant();
+
+    ASSERT_TRUE(simdutil.is_supported(SIMD_VARIANT_SCALAR));
+    ASSERT_TRUE(simdutil.is_supported(simdutil.get_detected_variant()));
+    ASSERT_TRUE(simdutil.set_variant(SIMD_VARIANT_SCALAR));
+    ASSERT_EQ(simdutil.get_variant(), SIMD_VARIANT_SCALAR);
+    ASSERT_EQ(std::string(get_simd_variant_name()), "scalar");
+
+    ASSERT_TRUE(simdutil.set_variant(initial));
+    ASSERT_EQ(simdutil.get_variant(), initial);
+}
+
+TEST(SIMDutilTest, VariantsAgree) {
+    const UINT n = 6;
+    const ITYPE dim = 1ULL << n;
+    SIMDutil& simdutil = SIMDutil::get_inst();
+    const SIMDVariant initial = simdutil.get_variant();
+
+    // unitary matrices keep the norm of the state bounded
+    const double theta = rand_real(), phi = rand_real();
+    const CTYPE matrix[4] = {cos(theta), -1.i * sin(theta) * exp(1.i * phi),
+        -1.i * sin(theta) * exp(-1.i * phi), cos(theta)};
+    const CTYPE diagonal[2] = {exp(1.i * theta), exp(1.i * phi)};
+    // distinct factors so that a mix-up of the target order is detected
+    const CTYPE other_matrix[4] = {diagonal[0] * cos(phi),
+        diagonal[0] * sin(phi), -diagonal[1] * sin(phi),
+        diagonal[1] * cos(phi)};
+    CTYPE matrix2[16];
+    for (UINT i = 0; i < 4; ++i) {
+        for (UINT j = 0; j < 4; ++j) {
+            matrix2[i * 4 + j] =
+                matrix[(i / 2) * 2 + j / 2] *
+                other_matrix[(i % 2) * 2 + j % 2];
+        }
+    }
+    CTYPE matrix3[64];
+    for (UINT i = 0; i < 8; ++i) {
+        for (UINT j = 0; j < 8; ++j) {
+            matrix3[i * 8 + j] =
+                matrix2[(i / 2) * 4 + j / 2] * matrix[(i % 2) * 2 + j % 2];
+        }
+    }
+    const UINT controls[2] = {1, 4};
+    const UINT values[2] = {1, 0};
+
+    auto apply_all = [&](CTYPE* state) {
+        for (UINT target = 0; target < n; ++target) {
+            const UINT other = (target + 2) % n;
+            X_gate(target, state, dim);
+            Y_gate(target, state, dim);
+            Z_gate(target, state, dim);
+            H_gate(target, state, dim);
+            CNOT_gate(other, target, state, dim);
+            CZ_gate(other, target, state, dim);
+            SWAP_gate(other, target, state, dim);
+            single_qubit_dense_matrix_gate(target, matrix, state, dim);
+            single_qubit_diagonal_matrix_gate(target, diagonal, state, dim);
+            single_qubit_phase_gate(target, diagonal[1], state, dim);
+            single_qubit_control_single_qubit_dense_matrix_gate(
+                other, 1, target, matrix, state, dim);
+            if (target != controls[0] && target != controls[1]) {
+                multi_qubit_control_single_qubit_dense_matrix_gate(
+                    controls, values, 2, target, matrix, state, dim);
+            }
+            double_qubit_dense_matrix_gate_c(
+                target, other, matrix2, state, dim);
+            const UINT targets[3] = {target, other, (target + 3) % n};
+            multi_qubit_dense_matrix_gate(targets, 3, matrix3, state, dim);
+        }
+    };
+
+    auto state_scalar = allocate_quantum_state(dim);
+    auto state_simd = allocate_quantum_state(dim);
+    initialize_Haar_random_state_with_seed(state_scalar, dim, 0);
+
+    ASSERT_TRUE(simdutil.set_variant(SIMD_VARIANT_SCALAR));
+    apply_all(state_scalar);
+    const UINT pauli[3] = {1, 2, 3};
+    const double value_scalar =
+        expectation_value_multi_qubit_Pauli_operator_whole_list(
+            pauli, 3, state_scalar, dim);
+
+    const SIMDVariant variants[3] = {
+        SIMD_VARIANT_AVX2, SIMD_VARIANT_AVX512, SIMD_VARIANT_SVE};
+    for (SIMDVariant variant : variants) {
+        if (!simdutil.is_supported(variant)) continue;
+        ASSERT_TRUE(simdutil.set_variant(variant));
+        initialize_Haar_random_state_with_seed(state_simd, dim, 0);
+        apply_all(state_simd);
+        const double value_simd =
+            expectation_value_multi_qubit_Pauli_operator_whole_list(
+                pauli, 3, state_simd, dim);
+
+        for (ITYPE i = 0; i < dim; ++i) {
+            ASSERT_NEAR(_creal(state_scalar[i]), _creal(state_simd[i]), 1e-8)
+                << SIMDutil::get_variant_name(variant);
+            ASSERT_NEAR(_cimag(state_scalar[i]), _cimag(state_simd[i]), 1e-8)
+                << SIMDutil::get_variant_name(variant);
+        }
+        ASSERT_NEAR(value_scalar, value_simd, 1e-8);
+    }
+
+    simdutil.set_variant(initial);
+    release_quantum_state(state_scalar);
+    release_quantum_state(state_simd);
+}
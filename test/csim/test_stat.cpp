@@ -3,7 +3,9 @@
 #include <Eigen/Core>
 #include <csim/init_ops.hpp>
 #include <csim/memory_ops.hpp>
+#include <csim/memory_ops_float.hpp>
 #include <csim/stat_ops.hpp>
+#include <csim/stat_ops_float.hpp>
 
 #include "../util/util.hpp"
 
@@ -43,6 +45,44 @@ TEST(StatOperationTest, ProbTest) {
     release_quantum_state(state);
 }
 
+// single-qubit reduced density matrix check
+TEST(StatOperationTest, ReducedDensityMatrixTest) {
+    const UINT n = 6;
+    const ITYPE dim = 1ULL << n;
+    const UINT max_repeat = 10;
+
+    CTYPE* state = allocate_quantum_state(dim);
+    for (UINT rep = 0; rep < max_repeat; ++rep) {
+        initialize_Haar_random_state(state, dim);
+        for (UINT target = 0; target < n; ++target) {
+            CTYPE reduced_matrix[4];
+            single_qubit_reduced_density_matrix(
+                target, state, dim, reduced_matrix);
+            const ITYPE mask = 1ULL << target;
+            Eigen::MatrixXcd test_matrix = Eigen::MatrixXcd::Zero(2, 2);
+            for (ITYPE i = 0; i < dim; ++i) {
+                if (i & mask) continue;
+                for (UINT a = 0; a < 2; ++a) {
+                    for (UINT b = 0; b < 2; ++b) {
+                        test_matrix(a, b) +=
+                            (std::complex<double>)state[i ^ (a * mask)] *
+                            std::conj(
+                                (std::complex<double>)state[i ^ (b * mask)]);
+                    }
+                }
+            }
+            for (UINT k = 0; k < 4; ++k) {
+                ASSERT_NEAR(abs((std::complex<double>)reduced_matrix[k] -
+                                test_matrix(k / 2, k % 2)),
+                    0, eps);
+            }
+            ASSERT_NEAR(
+                _creal(reduced_matrix[0]), M0_prob(target, state, dim), eps);
+        }
+    }
+    release_quantum_state(state);
+}
+
 // marginal probability check
 TEST(StatOperationTest, MarginalProbTest) {
     const UINT n = 6;
@@ -685,3 +725,76 @@ TEST(StatOperationTest, MultiQubitTransitionAmplitudeZopPartialTest) {
     release_quantum_state(state_ket);
     release_quantum_state(state_bra);
 }
+
+TEST(StatOperationTest, SamplingMatchesCumulativeSearch) {
+    const UINT n = 15;
+    const ITYPE dim = 1ULL << n;
+    const UINT sampling_count = 20000;
+    Random random;
+    random.set_seed(1);
+
+    auto state = allocate_quantum_state(dim);
+    initialize_Haar_random_state_with_seed(state, dim, 3);
+    // zero amplitudes must never be sampled
+    for (ITYPE i = 0; i < dim; i += 3) state[i] = 0;
+    // one amplitude carries most of the weight, so its block is resolved
+    // by the path for blocks with many shots
+    state[5000] = 30.;
+
+    std::vector<double> stacked_prob(dim + 1, 0.);
+    for (ITYPE i = 0; i < dim; ++i) {
+        stacked_prob[i + 1] = stacked_prob[i] + norm(state[i]);
+    }
+    const double total = stacked_prob[dim];
+
+    std::vector<double> uniform_list(sampling_count);
+    for (auto& r : uniform_list) r = random.uniform();
+    std::vector<ITYPE> result(sampling_count);
+    state_sampling(
+        state, dim, uniform_list.data(), sampling_count, result.data());
+
+    UINT peak_count = 0;
+    for (UINT shot = 0; shot < sampling_count; ++shot) {
+        const ITYPE index = result[shot];
+        ASSERT_LT(index, dim);
+        ASSERT_GT(norm(state[index]), 0.);
+        const double r = uniform_list[shot] * total;
+        ASSERT_LE(stacked_prob[index], r + 1e-12);
+        ASSERT_LT(r, stacked_prob[index + 1] + 1e-12);
+        if (index == 5000) ++peak_count;
+    }
+    ASSERT_GT(peak_count, sampling_count / 2);
+    release_quantum_state(state);
+}
+
+TEST(StatOperationTest, FloatSamplingMatchesDoubleSampling) {
+    const UINT n = 15;
+    const ITYPE dim = 1ULL << n;
+    const UINT sampling_count = 20000;
+    Random random;
+    random.set_seed(2);
+
+    auto state = allocate_quantum_state(dim);
+    initialize_Haar_random_state_with_seed(state, dim, 4);
+    for (ITYPE i = 0; i < dim; i += 5) state[i] = 0;
+    state[7000] = 30.;
+    // the norm of the float state is not 1, and its amplitudes are exactly
+    // those of the double state
+    auto float_state = float_allocate_quantum_state(dim);
+    float_state_from_double(state, float_state, dim);
+    float_state_to_double(float_state, state, dim);
+
+    std::vector<double> uniform_list(sampling_count);
+    for (auto& r : uniform_list) r = random.uniform();
+    std::vector<ITYPE> result(sampling_count), float_result(sampling_count);
+    state_sampling(
+        state, dim, uniform_list.data(), sampling_count, result.data());
+    float_state_sampling(float_state, dim, uniform_list.data(),
+        sampling_count, float_result.data());
+    for (UINT shot = 0; shot < sampling_count; ++shot) {
+        ASSERT_LT(float_result[shot], dim);
+        ASSERT_EQ(float_result[shot], result[shot]);
+    }
+    float_release_quantum_state(float_state);
+    release_quantum_state(state);
+}
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <csim/update_ops_dm.hpp>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "../util/util.hpp"
+
+// Apply func in the legacy and vectorized execution and compare the results.
+static void check_dm_vectorized(
+    std::function<void(CTYPE*, ITYPE)> func, UINT n, std::string name) {
+    const ITYPE dim = 1ULL << n;
+    std::vector<CTYPE> legacy(dim * dim), vectorized(dim * dim);
+    for (ITYPE i = 0; i < dim * dim; ++i) {
+        legacy[i] = vectorized[i] = CTYPE(rand_real() - 0.5, rand_real() - 0.5);
+    }
+    dm_set_vectorized_execution(false);
+    func(legacy.data(), dim);
+    dm_set_vectorized_execution(true);
+    func(vectorized.data(), dim);
+    dm_set_vectorized_execution(false);
+    for (ITYPE i = 0; i < dim * dim; ++i) {
+        ASSERT_NEAR(abs(legacy[i] - vectorized[i]), 0, eps) << name << " " << i;
+    }
+}
+
+static std::vector<CTYPE> random_matrix(ITYPE matrix_dim) {
+    std::vector<CTYPE> matrix(matrix_dim * matrix_dim);
+    for (auto& value : matrix) {
+        value = CTYPE(rand_real() - 0.5, rand_real() - 0.5);
+    }
+    return matrix;
+}
+
+TEST(DensityMatrixVectorizedTest, MatchesLegacyKernels) {
+    const UINT n = 5;
+    std::vector<UINT> index_list;
+    for (UINT i = 0; i < n; ++i) index_list.push_back(i);
+    std::mt19937 engine(0);
+
+    for (UINT rep = 0; rep < 5; ++rep) {
+        std::shuffle(index_list.begin(), index_list.end(), engine);
+        const UINT t0 = index_list[0], t1 = index_list[1], t2 = index_list[2];
+        const UINT c0 = index_list[3], c1 = index_list[4];
+
+        auto single = random_matrix(2);
+        check_dm_vectorized(
+            [&](CTYPE* state, ITYPE dim) {
+                dm_single_qubit_dense_matrix_gate(
+                    t0, single.data(), state, dim);
+            },
+            n, "single");
+
+        for (UINT k = 2; k <= 3; ++k) {
+            auto matrix = random_matrix(1ULL << k);
+            check_dm_vectorized(
+                [&](CTYPE* state, ITYPE dim) {
+                    dm_multi_qubit_dense_matrix_gate(
+                        index_list.data(), k, matrix.data(), state, dim);
+                },
+                n, "dense " + std::to_string(k));
+        }
+
+        UINT controls[2] = {c0, c1};
+        UINT values[2] = {1, 0};
+        UINT targets[2] = {t0, t1};
+        check_dm_vectorized(
+            [&](CTYPE* state, ITYPE dim) {
+                dm_multi_qubit_control_single_qubit_dense_matrix_gate(
+                    controls, values, 2, t2, single.data(), state, dim);
+            },
+            n, "control single");
+        auto double_matrix = random_matrix(4);
+        check_dm_vectorized(
+            [&](CTYPE* state, ITYPE dim) {
+                dm_multi_qubit_control_multi_qubit_dense_matrix_gate(controls,
+                    values, 2, targets, 2, double_matrix.data(), state, dim);
+            },
+            n, "control multi");
+
+        auto superoperator = random_matrix(16);
+        check_dm_vectorized(
+            [&](CTYPE* state, ITYPE dim) {
+                dm_multi_qubit_superoperator(
+                    targets, 2, superoperator.data(), state, dim);
+            },
+            n, "superoperator");
+
+        check_dm_vectorized(
+            [&](CTYPE* state, ITYPE dim) { dm_CNOT_gate(t0, t1, state, dim); },
+            n, "CNOT");
+        check_dm_vectorized(
+            [&](CTYPE* state, ITYPE dim) { dm_CZ_gate(t0, t1, state, dim); },
+            n, "CZ");
+        check_dm_vectorized(
+            [&](CTYPE* state, ITYPE dim) { dm_SWAP_gate(t0, t1, state, dim); },
+            n, "SWAP");
+
+        // odd and even numbers of Pauli-Y
+        const std::vector<std::vector<UINT>> Pauli_lists = {
+            {1, 2, 3}, {2, 2, 3}, {2, 1, 1}};
+        for (const auto& Pauli_list : Pauli_lists) {
+            check_dm_vectorized(
+                [&](CTYPE* state, ITYPE dim) {
+                    dm_multi_qubit_Pauli_gate_partial_list(
+                        index_list.data(), Pauli_list.data(), 3, state, dim);
+                },
+                n, "Pauli");
+            check_dm_vectorized(
+                [&](CTYPE* state, ITYPE dim) {
+                    dm_multi_qubit_Pauli_rotation_gate_partial_list(
+                        index_list.data(), Pauli_list.data(), 3, 0.7, state,
+                        dim);
+                },
+                n, "Pauli rotation");
+        }
+    }
+}
@@ -212,6 +212,43 @@ TEST(UpdateTest, ProjectionAndNormalizeTest) {
     test_projection_gate(P1_gate_parallel, M1_prob, P1);
 }
 
+TEST(UpdateTest, SingleQubitMeasurementTest) {
+    const UINT n = 6;
+    const ITYPE dim = 1ULL << n;
+    const UINT max_repeat = 10;
+    const auto P0 = make_P0();
+    const auto P1 = make_P1();
+
+    auto state = allocate_quantum_state(dim);
+    std::mt19937 engine(1);
+    std::uniform_real_distribution<double> uniform(0., 1.);
+    for (UINT rep = 0; rep < max_repeat; ++rep) {
+        for (UINT target = 0; target < n; ++target) {
+            initialize_Haar_random_state(state, dim);
+            // a state whose squared norm is not one
+            normalize(0.25, state, dim);
+            Eigen::VectorXcd test_state = Eigen::VectorXcd::Zero(dim);
+            for (ITYPE i = 0; i < dim; ++i)
+                test_state[i] = (std::complex<double>)state[i];
+            const double squared_norm = test_state.squaredNorm();
+            const double prob_0 = M0_prob(target, state, dim) / squared_norm;
+
+            const double random_value = uniform(engine);
+            const UINT outcome =
+                single_qubit_measurement(target, random_value, state, dim);
+            ASSERT_EQ(outcome, (random_value < prob_0) ? 0U : 1U);
+            ASSERT_NEAR(state_norm_squared(state, dim), squared_norm, eps);
+
+            test_state = get_expanded_eigen_matrix_with_identity(
+                             target, (outcome == 0) ? P0 : P1, n) *
+                         test_state;
+            test_state *= sqrt(squared_norm) / test_state.norm();
+            state_equal(state, test_state, dim, "Measurement");
+        }
+    }
+    release_quantum_state(state);
+}
+
 TEST(UpdateTest, SingleQubitRotationGateTest) {
     const UINT n = 6;
     const ITYPE dim = 1ULL << n;
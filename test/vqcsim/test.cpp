@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 
+#include <cppsim/circuit_optimizer.hpp>
 #include <cppsim/exception.hpp>
 #include <cppsim/gate_factory.hpp>
 #include <cppsim/state_dm.hpp>
@@ -160,6 +161,42 @@ TEST(ParametricCircuit, ParametricGatePosition) {
     ASSERT_EQ(circuit.get_parametric_gate_position(4), 6);
 }
 
+TEST(ParametricCircuit, OptimizeKeepsParametricGates) {
+    const UINT n = 3;
+    ParametricQuantumCircuit circuit(n);
+    circuit.add_H_gate(0);
+    circuit.add_parametric_RX_gate(0, 0.1);
+    circuit.add_T_gate(1);
+    circuit.add_CNOT_gate(0, 1);
+    circuit.add_parametric_RZ_gate(2, 0.2);
+    circuit.add_S_gate(1);
+    circuit.add_H_gate(2);
+    circuit.add_parametric_RY_gate(1, 0.3);
+    circuit.add_CZ_gate(1, 2);
+    circuit.add_X_gate(0);
+
+    ParametricQuantumCircuit* optimized_circuit = circuit.copy();
+    QuantumCircuitOptimizer optimizer;
+    optimizer.optimize(optimized_circuit, 2);
+    ASSERT_LT(optimized_circuit->gate_list.size(), circuit.gate_list.size());
+    ASSERT_EQ(optimized_circuit->get_parameter_count(), 3);
+
+    for (UINT index = 0; index < 3; ++index) {
+        circuit.set_parameter(index, 0.5 + index);
+        optimized_circuit->set_parameter(index, 0.5 + index);
+        const UINT position =
+            optimized_circuit->get_parametric_gate_position(index);
+        ASSERT_TRUE(optimized_circuit->gate_list[position]->is_parametric());
+    }
+    QuantumState state(n), optimized_state(n);
+    state.set_Haar_random_state(0);
+    optimized_state.load(&state);
+    circuit.update_quantum_state(&state);
+    optimized_circuit->update_quantum_state(&optimized_state);
+    ASSERT_STATE_NEAR(state, optimized_state, eps);
+    delete optimized_circuit;
+}
+
 class MyRandomCircuit : public ParametricCircuitBuilder {
     ParametricQuantumCircuit* create_circuit(
         UINT output_dim, UINT param_count) const override {